@@ -757,6 +757,10 @@ int main()
     fp.technique.active_modes_mask = shs::technique_mode_mask_all();
     fp.technique.depth_prepass = false;
     fp.technique.light_culling = false;
+    // Tile-binned, SIMD fragment, hierarchical-Z raster замуудыг асаана (default нь унтраалттай).
+    fp.raster.tile_binning = true;
+    fp.raster.simd_fragments = true;
+    fp.raster.hierarchical_z = true;
     shs::RenderTechniquePreset render_technique_preset =
         shs::render_technique_preset_from_shading_model(fp.shading_model);
     shs::RenderTechniqueRecipe render_technique_recipe =
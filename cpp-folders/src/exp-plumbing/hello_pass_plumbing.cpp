@@ -244,6 +244,7 @@ int main(int argc, char* argv[])
     (void)pipeline.add_pass_from_registry(pass_registry, shs::PassId::Tonemap);
     (void)pipeline.add_pass_from_registry(pass_registry, "light_shafts");
     pipeline.set_strict_graph_validation(true);
+    pipeline.frame_budget().set_dynamic_resolution_targets(rt_ldr_h, {rt_hdr_h, rt_motion_h, rt_shafts_tmp_h});
 
     shs::FrameParams fp{};
     fp.w = CANVAS_W;
@@ -267,6 +268,13 @@ int main(int argc, char* argv[])
     fp.technique.active_modes_mask = shs::technique_mode_mask_all();
     fp.technique.depth_prepass = false;
     fp.technique.light_culling = false;
+    // Tile-binned, SIMD fragment, hierarchical-Z raster замуудыг асаана (default нь унтраалттай).
+    fp.raster.tile_binning = true;
+    fp.raster.simd_fragments = true;
+    fp.raster.hierarchical_z = true;
+    // Capture нь тогтмол зураг гаргах ёстой тул budget governor-ийг зөвхөн интерактив үед асаана.
+    fp.budget.enable = !capture.enabled;
+    fp.budget.target_ms = 1000.0f / 60.0f;
 
     shs::RuntimeState runtime_state{};
     runtime_state.camera.pos = preset.pos;
@@ -427,6 +435,7 @@ int main(int argc, char* argv[])
                 + "fps=" + std::to_string((int)std::lround(fps))
                 + " | backend=" + ctx.active_backend_name()
                 + " | shafts=" + (fp.pass.light_shafts.enable ? "on" : "off")
+                + " | scale=" + std::to_string((int)std::lround(ctx.debug.budget_render_scale * 100.0f)) + "%"
                 + " | bot=" + (runtime_state.bot_enabled ? "on" : "off")
                 + " | vary=" + std::to_string((int)std::lround(varying_probe_checksum));
             runtime.set_title(title);
@@ -0,0 +1,196 @@
+/*
+    Triangle raster core microbenchmark
+
+    Хуучин "bbox-ийн пиксел бүрд barycentric_2d (хуваалттай)" аргыг
+    shs::rasterize_edges (fixed-point, incremental edge stepping, 8x8 block
+    trivial accept/reject)-тэй гурвалжны хэмжээний хэд хэдэн тархалт дээр харьцуулна.
+    Хоёулаа ижил depth-only buffer бичнэ (z = barycentric interpolation, min test).
+
+    Тархалтууд:
+      tiny   : 1-4 px хэмжээтэй
+      small  : ~16 px
+      medium : ~64 px
+      large  : ~256 px
+      sliver : урт нимгэн диагональ гурвалжин (bbox-ийн ихэнх нь хоосон)
+
+    Ажиллуулах: ./HelloRasterEdgeBench [triangles_per_set]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <shs/sw_render/edge_raster.hpp>
+#include <shs/sw_render/rasterizer.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int k_w = 1280;
+    constexpr int k_h = 720;
+
+    struct BenchTri
+    {
+        glm::vec2 s0{};
+        glm::vec2 s1{};
+        glm::vec2 s2{};
+        float z0 = 0.0f;
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+    };
+
+    std::vector<BenchTri> make_set(int count, float size, bool sliver, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> ux(0.0f, (float)k_w);
+        std::uniform_real_distribution<float> uy(0.0f, (float)k_h);
+        std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+        std::vector<BenchTri> out{};
+        out.reserve((size_t)count);
+        for (int i = 0; i < count; ++i)
+        {
+            BenchTri t{};
+            const glm::vec2 c{ux(rng), uy(rng)};
+            if (sliver)
+            {
+                // Диагональ чиглэлд урт, перпендикуляр чиглэлд ~1 px өргөн.
+                const glm::vec2 dir = glm::normalize(glm::vec2(1.0f, 0.6f + u01(rng) * 0.8f));
+                const glm::vec2 nrm{-dir.y, dir.x};
+                t.s0 = c - dir * size * 0.5f;
+                t.s1 = c + dir * size * 0.5f;
+                t.s2 = c + nrm * (0.5f + u01(rng));
+            }
+            else
+            {
+                t.s0 = c + glm::vec2(u01(rng) - 0.5f, u01(rng) - 0.5f) * size;
+                t.s1 = c + glm::vec2(u01(rng) - 0.5f, u01(rng) - 0.5f) * size;
+                t.s2 = c + glm::vec2(u01(rng) - 0.5f, u01(rng) - 0.5f) * size;
+            }
+            t.z0 = u01(rng);
+            t.z1 = u01(rng);
+            t.z2 = u01(rng);
+            out.push_back(t);
+        }
+        return out;
+    }
+
+    void bbox(const BenchTri& t, int& minx, int& maxx, int& miny, int& maxy)
+    {
+        minx = std::max(0, (int)std::floor(std::min({t.s0.x, t.s1.x, t.s2.x})));
+        maxx = std::min(k_w - 1, (int)std::ceil(std::max({t.s0.x, t.s1.x, t.s2.x})));
+        miny = std::max(0, (int)std::floor(std::min({t.s0.y, t.s1.y, t.s2.y})));
+        maxy = std::min(k_h - 1, (int)std::ceil(std::max({t.s0.y, t.s1.y, t.s2.y})));
+    }
+
+    uint64_t run_legacy(const std::vector<BenchTri>& tris, std::vector<float>& depth)
+    {
+        uint64_t written = 0;
+        for (const BenchTri& t : tris)
+        {
+            int minx, maxx, miny, maxy;
+            bbox(t, minx, maxx, miny, maxy);
+            for (int y = miny; y <= maxy; ++y)
+            {
+                for (int x = minx; x <= maxx; ++x)
+                {
+                    const glm::vec2 p{(float)x + 0.5f, (float)y + 0.5f};
+                    const glm::vec3 bc = shs::barycentric_2d(p, t.s0, t.s1, t.s2);
+                    if (bc.x < 0.0f || bc.y < 0.0f || bc.z < 0.0f) continue;
+                    const float z = bc.x * t.z0 + bc.y * t.z1 + bc.z * t.z2;
+                    float& d = depth[(size_t)y * k_w + (size_t)x];
+                    if (z < d) d = z;
+                    ++written;
+                }
+            }
+        }
+        return written;
+    }
+
+    uint64_t run_edges(const std::vector<BenchTri>& tris, std::vector<float>& depth, shs::RasterBlockStats& stats)
+    {
+        uint64_t written = 0;
+        shs::RasterEdgeSetup e{};
+        for (const BenchTri& t : tris)
+        {
+            int minx, maxx, miny, maxy;
+            bbox(t, minx, maxx, miny, maxy);
+            if (!shs::setup_raster_edges(t.s0, t.s1, t.s2, e)) continue;
+            shs::rasterize_edges(e, minx, maxx, miny, maxy, [&](int x, int y, const glm::vec3& bc) {
+                const float z = bc.x * t.z0 + bc.y * t.z1 + bc.z * t.z2;
+                float& d = depth[(size_t)y * k_w + (size_t)x];
+                if (z < d) d = z;
+                ++written;
+            }, &stats);
+        }
+        return written;
+    }
+
+    template<typename Fn>
+    double best_ms(int reps, std::vector<float>& depth, Fn&& fn)
+    {
+        double best = 1e30;
+        for (int r = 0; r < reps; ++r)
+        {
+            std::fill(depth.begin(), depth.end(), 1.0f);
+            const auto t0 = Clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int count = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 20000;
+    std::vector<float> depth((size_t)k_w * (size_t)k_h, 1.0f);
+
+    struct SetDesc
+    {
+        const char* name;
+        float size;
+        bool sliver;
+        int divisor;
+    };
+    const SetDesc sets[] = {
+        {"tiny", 3.0f, false, 1},
+        {"small", 16.0f, false, 1},
+        {"medium", 64.0f, false, 4},
+        {"large", 256.0f, false, 32},
+        {"sliver", 300.0f, true, 8},
+    };
+
+    std::printf("%-8s %8s | %10s %10s | %10s %10s | %7s | %8s %8s %8s\n",
+        "set", "tris", "legacy ms", "Mpix/s", "edge ms", "Mpix/s", "speedup", "reject", "accept", "partial");
+    for (const SetDesc& sd : sets)
+    {
+        const int n = std::max(1, count / sd.divisor);
+        const std::vector<BenchTri> tris = make_set(n, sd.size, sd.sliver, 1234u);
+
+        uint64_t px_legacy = 0;
+        uint64_t px_edges = 0;
+        shs::RasterBlockStats stats{};
+        const double ms_legacy = best_ms(5, depth, [&]() { px_legacy = run_legacy(tris, depth); });
+        const double ms_edges = best_ms(5, depth, [&]() {
+            stats = shs::RasterBlockStats{};
+            px_edges = run_edges(tris, depth, stats);
+        });
+
+        std::printf("%-8s %8d | %10.3f %10.1f | %10.3f %10.1f | %6.2fx | %8llu %8llu %8llu\n",
+            sd.name,
+            n,
+            ms_legacy,
+            (double)px_legacy / (ms_legacy * 1000.0),
+            ms_edges,
+            (double)px_edges / (ms_edges * 1000.0),
+            ms_legacy / std::max(1e-9, ms_edges),
+            (unsigned long long)stats.blocks_rejected,
+            (unsigned long long)stats.blocks_accepted,
+            (unsigned long long)stats.blocks_partial);
+    }
+    return 0;
+}
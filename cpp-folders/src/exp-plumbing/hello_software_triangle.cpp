@@ -184,7 +184,7 @@ private:
 
         shs::RasterizerTarget target{};
         target.hdr = &color_hdr_;
-        const shs::RasterizerStats stats = shs::rasterize_mesh(triangle_, program_, uniforms_, target, rast_cfg_);
+        const shs::RasterizerStats stats = shs::rasterize_mesh(triangle_, program_, uniforms_, target, rast_cfg_, vertex_cache_);
         ctx_.debug.tri_input = stats.tri_input;
         ctx_.debug.tri_after_clip = stats.tri_after_clip;
         ctx_.debug.tri_raster = stats.tri_raster;
@@ -207,6 +207,7 @@ private:
     shs::ShaderProgram program_{};
     shs::ShaderUniforms uniforms_{};
     shs::RasterizerConfig rast_cfg_{};
+    shs::RasterVertexCache vertex_cache_{};
 
     shs::RT_ColorHDR color_hdr_{kSurfaceW, kSurfaceH};
     std::vector<uint8_t> rgba_staging_{};
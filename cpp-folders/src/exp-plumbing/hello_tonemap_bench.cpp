@@ -0,0 +1,167 @@
+/*
+    Tonemap kernel microbenchmark
+
+    PassTonemap-ийн lane зам (simd_lanes.hpp: SHS_HAS_XSIMD үед xsimd::batch<float>, эсрэг
+    тохиолдолд 8 lane-тэй массив fallback)-ыг пиксел тус бүрийн scalar замтай 1080p болон 4K
+    RGBA32F HDR дээр харьцуулна. Гурван хувилбар ижил LDR бичнэ:
+
+      scalar     : пиксел бүрт exposure, operator, std::pow gamma (lane-гүй лавлагаа)
+      lanes+pow  : PassTonemap::tonemap, gamma_lut = false (scalar-тай бит тэнцүү)
+      lanes+lut  : PassTonemap::tonemap, gamma_lut = true (12 битийн sqrt LUT, ±1 LSB)
+
+    Ажиллуулах: ./HelloTonemapBench [reps] [threads]
+      threads = 0 (default) үед нэг thread, эс бөгөөс WorkStealingJobSystem дээр.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <shs/core/context.hpp>
+#include <shs/job/work_stealing_job_system.hpp>
+#include <shs/passes/pass_tonemap.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    shs::PixelBuffer2D<shs::ColorF> make_hdr(int w, int h, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+        shs::PixelBuffer2D<shs::ColorF> hdr{w, h, shs::ColorF{}};
+        for (shs::ColorF& c : hdr.data)
+        {
+            // Ихэнх нь [0, 2] муж, цөөн тод highlight.
+            const float t = u01(rng);
+            const float boost = (u01(rng) < 0.02f) ? 40.0f : 2.0f;
+            c = shs::ColorF{t * t * boost, u01(rng) * boost, u01(rng) * 0.5f, 1.0f};
+        }
+        return hdr;
+    }
+
+    uint8_t scalar_channel(float v, const shs::PassTonemap::Curve& c)
+    {
+        float x = v * c.exposure;
+        x = (x > 0.0f) ? x : 0.0f;
+        float y = (c.op == shs::TonemapOperator::ACESFit)
+            ? (x * (x * 2.51f + 0.03f)) / (x * (x * 2.43f + 0.59f) + 0.14f)
+            : x / (1.0f + x);
+        y = (y < 1.0f) ? y : 1.0f;
+        return (uint8_t)std::min(255, (int)(std::pow(y, c.inv_gamma) * 255.0f + 0.5f));
+    }
+
+    void run_scalar(shs::IJobSystem* js, const shs::PixelBuffer2D<shs::ColorF>& hdr, shs::PixelBuffer2D<shs::Color>& ldr, const shs::PassTonemap::Curve& c)
+    {
+        shs::parallel_for_1d(js, 0, hdr.h, 8, [&](int yb, int ye)
+        {
+            for (int y = yb; y < ye; ++y)
+            {
+                for (int x = 0; x < hdr.w; ++x)
+                {
+                    const shs::ColorF& s = hdr.at(x, y);
+                    ldr.at(x, y) = shs::Color{scalar_channel(s.r, c), scalar_channel(s.g, c), scalar_channel(s.b, c), 255};
+                }
+            }
+        });
+    }
+
+    template<typename Fn>
+    double best_ms(int reps, Fn&& fn)
+    {
+        double best = 1e30;
+        for (int r = 0; r < reps; ++r)
+        {
+            const auto t0 = Clock::now();
+            fn();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+        return best;
+    }
+
+    int max_abs_diff(const shs::PixelBuffer2D<shs::Color>& a, const shs::PixelBuffer2D<shs::Color>& b)
+    {
+        int d = 0;
+        for (size_t i = 0; i < a.data.size(); ++i)
+        {
+            d = std::max(d, std::abs((int)a.data[i].r - (int)b.data[i].r));
+            d = std::max(d, std::abs((int)a.data[i].g - (int)b.data[i].g));
+            d = std::max(d, std::abs((int)a.data[i].b - (int)b.data[i].b));
+        }
+        return d;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int reps = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 5;
+    const int threads = (argc > 2) ? std::max(0, std::atoi(argv[2])) : 0;
+
+    std::unique_ptr<shs::WorkStealingJobSystem> pool{};
+    if (threads > 0) pool = std::make_unique<shs::WorkStealingJobSystem>((size_t)threads);
+    shs::IJobSystem* js = pool.get();
+
+#if defined(SHS_HAS_XSIMD) && SHS_HAS_XSIMD
+    const char* backend = "xsimd::batch<float>";
+#else
+    const char* backend = "array fallback";
+#endif
+    std::printf("lanes: %s, %d wide | threads: %d | best of %d\n", backend, shs::simd::k_lanes, threads, reps);
+
+    struct ResDesc
+    {
+        const char* name;
+        int w;
+        int h;
+    };
+    const ResDesc resolutions[] = {
+        {"1080p", 1920, 1080},
+        {"4K", 3840, 2160},
+    };
+    const shs::TonemapOperator ops[] = {shs::TonemapOperator::Reinhard, shs::TonemapOperator::ACESFit};
+
+    std::printf("%-6s %-9s | %10s | %10s %7s %5s | %10s %7s %5s\n",
+        "res", "op", "scalar ms", "pow ms", "speedup", "diff", "lut ms", "speedup", "diff");
+    for (const ResDesc& rd : resolutions)
+    {
+        const shs::PixelBuffer2D<shs::ColorF> hdr = make_hdr(rd.w, rd.h, 77u);
+        shs::PixelBuffer2D<shs::Color> ldr_scalar{rd.w, rd.h, shs::Color{}};
+        shs::PixelBuffer2D<shs::Color> ldr_pow{rd.w, rd.h, shs::Color{}};
+        shs::PixelBuffer2D<shs::Color> ldr_lut{rd.w, rd.h, shs::Color{}};
+
+        for (const shs::TonemapOperator op : ops)
+        {
+            shs::TonemapParams tp{};
+            tp.exposure = 1.2f;
+            tp.gamma = 2.2f;
+            tp.op = op;
+
+            shs::PassTonemap::GammaLut lut{};
+            tp.gamma_lut = false;
+            const shs::PassTonemap::Curve curve_pow = shs::PassTonemap::make_curve(tp, lut);
+            tp.gamma_lut = true;
+            const shs::PassTonemap::Curve curve_lut = shs::PassTonemap::make_curve(tp, lut);
+
+            const double ms_scalar = best_ms(reps, [&]() { run_scalar(js, hdr, ldr_scalar, curve_pow); });
+            const double ms_pow = best_ms(reps, [&]() { shs::PassTonemap::tonemap(js, hdr, ldr_pow, rd.w, rd.h, curve_pow); });
+            const double ms_lut = best_ms(reps, [&]() { shs::PassTonemap::tonemap(js, hdr, ldr_lut, rd.w, rd.h, curve_lut); });
+
+            std::printf("%-6s %-9s | %10.2f | %10.2f %6.2fx %5d | %10.2f %6.2fx %5d\n",
+                rd.name,
+                op == shs::TonemapOperator::ACESFit ? "aces" : "reinhard",
+                ms_scalar,
+                ms_pow,
+                ms_scalar / std::max(1e-9, ms_pow),
+                max_abs_diff(ldr_scalar, ldr_pow),
+                ms_lut,
+                ms_scalar / std::max(1e-9, ms_lut),
+                max_abs_diff(ldr_scalar, ldr_lut));
+        }
+    }
+    return 0;
+}
@@ -1237,6 +1237,10 @@ private:
         fp.hybrid.allow_cross_backend_passes = false;
         fp.hybrid.strict_backend_availability = true;
         fp.hybrid.emulate_vulkan_runtime = false;
+        // Tile-binned, SIMD fragment, hierarchical-Z raster замуудыг асаана (default нь унтраалттай).
+        fp.raster.tile_binning = true;
+        fp.raster.simd_fragments = true;
+        fp.raster.hierarchical_z = true;
         const shs::RenderTechniqueRecipe tech_recipe =
             shs::make_builtin_render_technique_recipe(technique_preset, "phase_i_sw_runtime");
         shs::apply_render_technique_recipe_to_frame_params(tech_recipe, fp);
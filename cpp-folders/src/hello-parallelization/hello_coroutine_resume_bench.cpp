@@ -0,0 +1,135 @@
+/*
+    shs::Task coroutine resume overhead vs IJobSystem::enqueue benchmark
+
+    Хувилбарууд:
+      1. chain    : нэг урсгал N удаа job system руу "үсэрнэ".
+                    enqueue хувилбарт job бүр дараагийн std::function-ийг enqueue хийнэ,
+                    coroutine хувилбарт нэг coroutine co_await schedule_on(js)-ийг N удаа хийнэ.
+      2. wide     : M урсгал тус бүр K удаа үсэрнэ (throughput).
+      3. job      : co_await run_async(js, fn) (илгээгээд хариуг хүлээх) round-trip.
+
+    Ажиллуулах: ./HelloCoroutineResumeBench [worker_count]
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <shs/job/task.hpp>
+#include <shs/job/thread_pool_job_system.hpp>
+#include <shs/job/work_stealing_job_system.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ns_per(Clock::time_point t0, long long ops)
+    {
+        const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        return ns / (double)std::max(1ll, ops);
+    }
+
+    // Job бүр дараагийнхаа job-ийг enqueue хийнэ.
+    void enqueue_chain(shs::IJobSystem& js, int remaining, std::atomic<int>& hops)
+    {
+        hops.fetch_add(1, std::memory_order_relaxed);
+        if (remaining <= 1) return;
+        js.enqueue([&js, remaining, &hops]() { enqueue_chain(js, remaining - 1, hops); });
+    }
+
+    shs::Task<void> coro_chain(shs::IJobSystem* js, int hops, std::atomic<int>& counter)
+    {
+        for (int i = 0; i < hops; ++i)
+        {
+            co_await shs::schedule_on(js);
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    shs::Task<long long> coro_job_roundtrips(shs::IJobSystem* js, int count)
+    {
+        long long sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            sum += co_await shs::run_async(js, [i]() { return (long long)i; });
+        }
+        co_return sum;
+    }
+
+    void run_suite(const char* name, shs::IJobSystem& js)
+    {
+        const int chain_hops = 200000;
+        const int wide_streams = 256;
+        const int wide_hops = 1000;
+
+        // Халаалт.
+        std::atomic<int> hops{0};
+        shs::sync_wait(&js, coro_chain(&js, 1000, hops));
+
+        hops.store(0);
+        auto t0 = Clock::now();
+        js.enqueue([&js, &hops, chain_hops]() { enqueue_chain(js, chain_hops, hops); });
+        js.wait_idle();
+        const double enqueue_chain_ns = ns_per(t0, hops.load());
+
+        hops.store(0);
+        t0 = Clock::now();
+        shs::sync_wait(&js, coro_chain(&js, chain_hops, hops));
+        const double coro_chain_ns = ns_per(t0, hops.load());
+
+        hops.store(0);
+        t0 = Clock::now();
+        for (int s = 0; s < wide_streams; ++s)
+        {
+            js.enqueue([&js, &hops, wide_hops]() { enqueue_chain(js, wide_hops, hops); });
+        }
+        js.wait_idle();
+        const double enqueue_wide_ns = ns_per(t0, hops.load());
+
+        hops.store(0);
+        t0 = Clock::now();
+        for (int s = 0; s < wide_streams; ++s)
+        {
+            shs::start_detached(coro_chain(&js, wide_hops, hops));
+        }
+        while (hops.load(std::memory_order_acquire) != wide_streams * wide_hops) std::this_thread::yield();
+        js.wait_idle();
+        const double coro_wide_ns = ns_per(t0, hops.load());
+
+        t0 = Clock::now();
+        const long long sum = shs::sync_wait(&js, coro_job_roundtrips(&js, chain_hops));
+        const double roundtrip_ns = ns_per(t0, chain_hops);
+        if (sum != (long long)chain_hops * (chain_hops - 1) / 2) std::fprintf(stderr, "job: wrong sum\n");
+
+        std::printf(
+            "%-14s chain enqueue: %7.1f ns/hop | chain co_await: %7.1f ns/hop | wide enqueue: %7.1f ns/hop | wide co_await: %7.1f ns/hop | run_async: %7.1f ns\n",
+            name,
+            enqueue_chain_ns,
+            coro_chain_ns,
+            enqueue_wide_ns,
+            coro_wide_ns,
+            roundtrip_ns);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) workers = (size_t)std::max(1, std::atoi(argv[1]));
+    std::printf("workers: %zu\n", workers);
+
+    {
+        shs::ThreadPoolJobSystem pool{workers};
+        run_suite("thread_pool", pool);
+    }
+    {
+        shs::WorkStealingJobSystem stealing{workers};
+        run_suite("work_stealing", stealing);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+    ThreadPoolJobSystem vs WorkStealingJobSystem стресс/throughput benchmark
+
+    Хувилбарууд:
+      1. flat     : main thread-ээс олон жижиг ажил enqueue хийнэ
+      2. pfor     : frame дахь post/raster pass-уудыг дууриаж parallel_for_1d-г олон удаа дуудна
+      3. fanout   : worker дотроос дэд ажлууд spawn хийнэ (worker-local deque-ийн ашиг)
+
+    Ажиллуулах: ./HelloJobSystemStealingBench [worker_count]
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <shs/job/parallel_for.hpp>
+#include <shs/job/thread_pool_job_system.hpp>
+#include <shs/job/work_stealing_job_system.hpp>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ms_since(Clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    // Нэг пикселийн shading-ийг дууриасан жижиг ачаалал.
+    inline float busy_work(int seed, int iters)
+    {
+        float v = (float)seed * 0.001f;
+        for (int i = 0; i < iters; ++i) v = v * 0.999f + std::sqrt(v + 1.0f) * 0.001f;
+        return v;
+    }
+
+    double bench_flat(shs::IJobSystem& js, int jobs, int work)
+    {
+        std::atomic<int> done{0};
+        const auto t0 = Clock::now();
+        for (int i = 0; i < jobs; ++i)
+        {
+            js.enqueue([i, work, &done]() {
+                volatile float sink = busy_work(i, work);
+                (void)sink;
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        js.wait_idle();
+        const double ms = ms_since(t0);
+        if (done.load() != jobs) std::fprintf(stderr, "flat: lost jobs\n");
+        return ms;
+    }
+
+    double bench_parallel_for(shs::IJobSystem& js, int passes, int pixels, int work)
+    {
+        std::vector<float> buf((size_t)pixels, 0.0f);
+        const auto t0 = Clock::now();
+        for (int p = 0; p < passes; ++p)
+        {
+            shs::parallel_for_1d(&js, 0, pixels, 256, [&buf, p, work](int b, int e) {
+                for (int i = b; i < e; ++i) buf[(size_t)i] += busy_work(i + p, work);
+            });
+        }
+        return ms_since(t0);
+    }
+
+    double bench_fanout(shs::IJobSystem& js, int roots, int leaves, int work)
+    {
+        std::atomic<int> done{0};
+        const auto t0 = Clock::now();
+        for (int r = 0; r < roots; ++r)
+        {
+            js.enqueue([&js, &done, leaves, work, r]() {
+                for (int k = 0; k < leaves; ++k)
+                {
+                    js.enqueue([&done, work, r, k]() {
+                        volatile float sink = busy_work(r * 31 + k, work);
+                        (void)sink;
+                        done.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            });
+        }
+        js.wait_idle();
+        const double ms = ms_since(t0);
+        if (done.load() != roots * leaves) std::fprintf(stderr, "fanout: lost jobs\n");
+        return ms;
+    }
+
+    void run_suite(const char* name, shs::IJobSystem& js)
+    {
+        // Эхний удаагийн thread wake-up, cache халаалт.
+        (void)bench_flat(js, 10000, 8);
+
+        const int flat_jobs = 200000;
+        const double flat_ms = bench_flat(js, flat_jobs, 16);
+        const double pfor_ms = bench_parallel_for(js, 240, 1920 * 1080 / 8, 4);
+        const double fan_ms = bench_fanout(js, 128, 1024, 16);
+
+        std::printf(
+            "%-14s flat: %8.2f ms (%6.2f Mjobs/s) | pfor 240 passes: %8.2f ms | fanout 128x1024: %8.2f ms\n",
+            name,
+            flat_ms,
+            (double)flat_jobs / (flat_ms * 1000.0),
+            pfor_ms,
+            fan_ms);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) workers = (size_t)std::max(1, std::atoi(argv[1]));
+    std::printf("workers: %zu\n", workers);
+
+    {
+        shs::ThreadPoolJobSystem pool{workers};
+        run_suite("thread_pool", pool);
+    }
+    {
+        shs::WorkStealingJobSystem stealing{workers};
+        run_suite("work_stealing", stealing);
+        std::printf("work_stealing steals: %llu\n", (unsigned long long)stealing.steal_count());
+    }
+    return 0;
+}
@@ -31,6 +31,12 @@ namespace shs
         uint64_t tri_input = 0;
         uint64_t tri_after_clip = 0;
         uint64_t tri_raster = 0;
+        uint64_t vs_invocations = 0;
+        uint64_t hiz_tris_rejected = 0;
+        uint64_t hiz_blocks_rejected = 0;
+        // fragments_passed / fs_invocations = shading overdraw (visibility-buffer горимд ~1).
+        uint64_t fragments_passed = 0;
+        uint64_t fs_invocations = 0;
         float ms_shadow = 0.0f;
         float ms_pbr = 0.0f;
         float ms_tonemap = 0.0f;
@@ -39,12 +45,35 @@ namespace shs
         uint64_t vk_like_submissions = 0;
         uint64_t vk_like_tasks = 0;
         uint64_t vk_like_stalls = 0;
+        // RTRegistry transient-уудын санах ой (aliasing-ийн өмнө/дараа), байтаар.
+        uint32_t transient_count = 0;
+        uint32_t transient_slots = 0;
+        uint64_t transient_bytes_dedicated = 0;
+        uint64_t transient_bytes_aliased = 0;
+        // Frame budget governor (pipeline/frame_budget_governor.hpp)-ийн төлөв. budget_frame_ms нь
+        // гөлгөршүүлсэн pipeline хугацаа, budget_steps_down/up нь эхнээс хойших нийт шатны тоо.
+        float budget_frame_ms = 0.0f;
+        float budget_target_ms = 0.0f;
+        float budget_render_scale = 1.0f;
+        int budget_render_w = 0;
+        int budget_render_h = 0;
+        int budget_shadow_pcf_radius = 0;
+        int budget_shafts_steps = 0;
+        int budget_motion_blur_samples = 0;
+        uint32_t budget_quality_level = 0;
+        uint32_t budget_steps_down = 0;
+        uint32_t budget_steps_up = 0;
 
         void reset()
         {
             tri_input = 0;
             tri_after_clip = 0;
             tri_raster = 0;
+            vs_invocations = 0;
+            hiz_tris_rejected = 0;
+            hiz_blocks_rejected = 0;
+            fragments_passed = 0;
+            fs_invocations = 0;
             ms_shadow = 0.0f;
             ms_pbr = 0.0f;
             ms_tonemap = 0.0f;
@@ -53,6 +82,21 @@ namespace shs
             vk_like_submissions = 0;
             vk_like_tasks = 0;
             vk_like_stalls = 0;
+            transient_count = 0;
+            transient_slots = 0;
+            transient_bytes_dedicated = 0;
+            transient_bytes_aliased = 0;
+            budget_frame_ms = 0.0f;
+            budget_target_ms = 0.0f;
+            budget_render_scale = 1.0f;
+            budget_render_w = 0;
+            budget_render_h = 0;
+            budget_shadow_pcf_radius = 0;
+            budget_shafts_steps = 0;
+            budget_motion_blur_samples = 0;
+            budget_quality_level = 0;
+            budget_steps_down = 0;
+            budget_steps_up = 0;
         }
     };
 
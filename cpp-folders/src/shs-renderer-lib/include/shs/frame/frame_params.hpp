@@ -13,13 +13,23 @@
 #include <cstdint>
 
 #include "shs/frame/technique_mode.hpp"
+#include "shs/gfx/hdr_pixel.hpp"
 
 namespace shs
 {
+    enum class TonemapOperator : uint8_t
+    {
+        Reinhard = 0,
+        ACESFit = 1
+    };
+
     struct TonemapParams
     {
         float exposure = 1.0f;
         float gamma = 2.2f;
+        TonemapOperator op = TonemapOperator::Reinhard;
+        // true үед gamma-г 12 битийн LUT-аар (pow-той ялгаа ±1 LSB), false үед std::pow-оор.
+        bool gamma_lut = true;
     };
 
     struct ShadowPassParams
@@ -56,6 +66,18 @@ namespace shs
         float depth_reject = 0.08f;
     };
 
+    // Fused post stack (pass_post_stack.hpp): tonemap/light shafts/motion blur/TAA-г дэлгэцийн
+    // tile-аар нэг дамжилтад гинжлэн ажиллуулна.
+    struct PostStackPassParams
+    {
+        int tile_size = 64;
+        // Tonemap-ийн араас шууд ирэх хөрш уншдаг stage (motion blur)-ийн halo үүнээс ихгүй бол
+        // tile бүр halo-гоо tonemap-аар дахин тооцож нэг дамжилтад нэгтгэнэ. Их бол дундын
+        // full-frame buffer-аар хоёр дамжилтад хуваана. LUT-тай lane tonemap-тай ч гэсэн 64 tile-ийн
+        // ~11px halo-г дахин тооцох нь нэг LDR buffer бичиж/уншихаас үнэтэй тул default нь хуваана.
+        int max_fused_halo = 0;
+    };
+
     struct HybridPipelineParams
     {
         // true үед pass бүр өөр backend дээр ажиллахыг зөвшөөрнө.
@@ -68,6 +90,34 @@ namespace shs
         bool emulate_parallel_recording = true;
         // Vulkan frame-in-flight дуурайлтын slot тоо.
         uint32_t emulated_frames_in_flight = 2;
+        // true үед (Vulkan-like дуурайлт унтраалттай) resource dependency-гүй pass-уудыг
+        // FrameGraph-аас байгуулсан TaskGraph-аар зэрэг ажиллуулна (shadow || light culling г.м.).
+        bool parallel_pass_graph = false;
+    };
+
+    struct SoftwareRasterParams
+    {
+        // Доорх raster замууд бүгд opt-in (default false): асаагаагүй app-ууд өмнөх scalar,
+        // draw тус бүрийн rasterize_mesh замаараа үргэлжилнэ.
+        // true үед forward/depth prepass/shadow pass-ууд draw-уудаа sort-middle tile-binned
+        // rasterizer руу илгээж, бүх кадрыг tile-аар зэрэг raster хийнэ (job system шаардлагатай).
+        bool tile_binning = false;
+        int tile_size = 64;
+        // Нэг front-end (VS/clip/setup/binning) job-ийн эх гурвалжны тоо.
+        int front_end_tris_per_job = 512;
+        // Built-in PBR/Blinn-Phong program-уудын fragment-ийг SIMD lane-ээр shade хийнэ.
+        // false үед пиксел тус бүрийн scalar fs (харьцуулах/debug зорилгоор).
+        bool simd_fragments = false;
+        // Forward/depth prepass-ийн raster-т 8x8 block-ийн hierarchical-Z early rejection.
+        bool hierarchical_z = false;
+        // Tile-binned forward-ийг visibility-buffer горимоор ажиллуулна: эхлээд зөвхөн depth +
+        // гурвалжны id бичээд, дараа нь харагдах пиксел бүрийг нэг л удаа shade хийнэ.
+        // Discard хийдэг fragment program-уудыг дэмжихгүй (alpha-test-тэй материал).
+        bool visibility_buffer = false;
+        // Pipeline-ийн HDR хадгалалтын формат: PluggablePipeline нь pass-уудынхаа бичдэг software
+        // HDR target-ууд болон pipeline-ийн HDR transient-уудад хэрэглэнэ. RGBA16F нь санах ойн
+        // урсгалыг хоёр, R11G11B10F (alpha-гүй, сөрөг утгагүй) нь дөрөв дахин багасгана.
+        HdrFormat hdr_format = HdrFormat::RGBA32F;
     };
 
     struct TechniqueParams
@@ -91,6 +141,28 @@ namespace shs
         LightShaftsPassParams light_shafts{};
         MotionVectorParams motion_vectors{};
         MotionBlurPassParams motion_blur{};
+        PostStackPassParams post_stack{};
+    };
+
+    // Frame-time budget governor (pipeline/frame_budget_governor.hpp): pipeline-ийн хугацааг
+    // target_ms-д барихын тулд дотоод resolution болон pass-уудын чанарын knob-уудыг шатлан өөрчилнө.
+    struct FrameBudgetParams
+    {
+        bool enable = false;
+        float target_ms = 16.6f;
+        // Гөлгөршүүлсэн хугацаа target_ms * over_ratio-оос settle_frames_down кадр дараалан их бол
+        // нэг шат буулгана, target_ms * under_ratio-оос settle_frames_up кадр дараалан бага бол нэг
+        // шат өргөнө. Хоёрын хоорондох зай нь hysteresis.
+        float over_ratio = 1.0f;
+        float under_ratio = 0.8f;
+        int settle_frames_down = 4;
+        int settle_frames_up = 30;
+        // Дотоод resolution (тэнхлэг бүрийн харьцаа)-ийн нэг шат ба доод хязгаар.
+        bool dynamic_resolution = true;
+        float resolution_step = 0.125f;
+        float min_resolution_scale = 0.5f;
+        // shadow pcf_radius, light_shafts.steps, motion_blur.samples-ийг бууруулахыг зөвшөөрөх эсэх.
+        bool quality_scaling = true;
     };
 
     enum class DebugViewMode : uint8_t
@@ -155,6 +227,7 @@ namespace shs
         CullMode cull_mode = CullMode::Back;
         bool front_face_ccw = true;
         ShadingModel shading_model = ShadingModel::PBRMetalRough;
+        SoftwareRasterParams raster{};
 
         // Shadow softness controls.
         float shadow_bias_const = 0.0008f;
@@ -167,6 +240,7 @@ namespace shs
         PassParamBlocks pass{};
         HybridPipelineParams hybrid{};
         TechniqueParams technique{};
+        FrameBudgetParams budget{};
 
     };
 }
@@ -24,6 +24,7 @@
 #include "shs/geometry/aabb.hpp"
 #include "shs/geometry/culling_runtime.hpp"
 #include "shs/geometry/jolt_debug_draw.hpp"
+#include "shs/sw_render/edge_raster.hpp"
 
 namespace shs::culling_sw
 {
@@ -73,9 +74,6 @@ namespace shs::culling_sw
         if (depth_buffer.empty() || width <= 0 || height <= 0) return;
         if (depth_buffer.size() < static_cast<size_t>(width) * static_cast<size_t>(height)) return;
 
-        const float area = edge_function(p0, p1, p2);
-        if (std::abs(area) <= 1e-6f) return;
-
         const float min_xf = std::min(p0.x, std::min(p1.x, p2.x));
         const float min_yf = std::min(p0.y, std::min(p1.y, p2.y));
         const float max_xf = std::max(p0.x, std::max(p1.x, p2.x));
@@ -87,31 +85,18 @@ namespace shs::culling_sw
         const int max_y = std::min(height - 1, static_cast<int>(std::ceil(max_yf)));
         if (min_x > max_x || min_y > max_y) return;
 
-        const bool ccw = area > 0.0f;
-        for (int y = min_y; y <= max_y; ++y)
+        RasterEdgeSetup edges{};
+        if (!setup_raster_edges(p0, p1, p2, edges)) return;
+
+        rasterize_edges(edges, min_x, max_x, min_y, max_y, [&](int x, int y, const glm::vec3& bc)
         {
-            for (int x = min_x; x <= max_x; ++x)
-            {
-                const glm::vec2 p(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f);
-                const float w0 = edge_function(p1, p2, p);
-                const float w1 = edge_function(p2, p0, p);
-                const float w2 = edge_function(p0, p1, p);
-                const bool inside = ccw
-                    ? (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)
-                    : (w0 <= 0.0f && w1 <= 0.0f && w2 <= 0.0f);
-                if (!inside) continue;
-
-                const float iw0 = w0 / area;
-                const float iw1 = w1 / area;
-                const float iw2 = w2 / area;
-                const float depth = iw0 * z0 + iw1 * z1 + iw2 * z2;
-                if (depth < 0.0f || depth > 1.0f) continue;
+            const float depth = bc.x * z0 + bc.y * z1 + bc.z * z2;
+            if (depth < 0.0f || depth > 1.0f) return;
 
-                const size_t depth_idx =
-                    static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
-                if (depth < depth_buffer[depth_idx]) depth_buffer[depth_idx] = depth;
-            }
-        }
+            const size_t depth_idx =
+                static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+            if (depth < depth_buffer[depth_idx]) depth_buffer[depth_idx] = depth;
+        });
     }
 
     inline void rasterize_mesh_depth_transformed(
@@ -0,0 +1,187 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: hdr_pixel.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: HDR render target-ийн нягт пикселийн формат: RGBA16F (8 байт) болон
+            R11G11B10F (4 байт, alpha-гүй). float <-> half хөрвүүлэлтийг F16C үед
+            vcvtps2ph/vcvtph2ps-ээр (4 суваг нэг заавраар), бусад үед битийн
+            round-to-nearest-even кодоор хийнэ.
+*/
+
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// MSVC нь __F16C__ тодорхойлдоггүй; /arch:AVX2 нь F16C-г агуулна.
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SHS_HDR_F16C 1
+#include <immintrin.h>
+#endif
+
+namespace shs
+{
+    // RT_ColorHDR-ийн хадгалалтын формат. Pipeline бүр RT үүсгэхдээ сонгоно.
+    enum class HdrFormat : uint8_t
+    {
+        RGBA32F = 0,
+        RGBA16F = 1,
+        // Сөрөг/NaN утга 0, alpha үргэлж 1 болно.
+        R11G11B10F = 2
+    };
+
+    inline constexpr size_t hdr_format_bytes(HdrFormat f)
+    {
+        switch (f)
+        {
+            case HdrFormat::RGBA16F: return 8;
+            case HdrFormat::R11G11B10F: return 4;
+            case HdrFormat::RGBA32F:
+            default: return 16;
+        }
+    }
+
+    inline const char* hdr_format_name(HdrFormat f)
+    {
+        switch (f)
+        {
+            case HdrFormat::RGBA16F: return "rgba16f";
+            case HdrFormat::R11G11B10F: return "r11g11b10f";
+            case HdrFormat::RGBA32F:
+            default: return "rgba32f";
+        }
+    }
+
+    struct ColorHalf4
+    {
+        uint16_t r = 0;
+        uint16_t g = 0;
+        uint16_t b = 0;
+        uint16_t a = 0;
+    };
+
+    // bit 0..10: R (5 exp, 6 mant), 11..21: G, 22..31: B (5 exp, 5 mant). Bias нь half-тай ижил (15).
+    struct ColorR11G11B10
+    {
+        uint32_t bits = 0;
+    };
+
+    // half-ийн хамгийн их төгсгөлөг утга. HDR-ийг inf болгохгүйн тулд encode үүгээр хязгаарлана.
+    inline constexpr float k_half_max = 65504.0f;
+
+    inline uint16_t float_to_half_bits(float f)
+    {
+        const uint32_t x = std::bit_cast<uint32_t>(f);
+        const uint32_t sign = (x >> 16) & 0x8000u;
+        const uint32_t ax = x & 0x7FFFFFFFu;
+        if (ax >= 0x7F800000u) return (uint16_t)(sign | (ax > 0x7F800000u ? 0x7E00u : 0x7C00u));
+        if (ax >= 0x477FF000u) return (uint16_t)(sign | 0x7C00u);
+        if (ax < 0x38800000u)
+        {
+            // half subnormal: нэгж нь 2^-24.
+            if (ax <= 0x33000000u) return (uint16_t)sign;
+            const uint32_t m = (ax & 0x007FFFFFu) | 0x00800000u;
+            const uint32_t shift = 126u - (ax >> 23);
+            uint32_t h = m >> shift;
+            const uint32_t rem = m & ((1u << shift) - 1u);
+            const uint32_t mid = 1u << (shift - 1u);
+            if (rem > mid || (rem == mid && (h & 1u))) ++h;
+            return (uint16_t)(sign | h);
+        }
+        // Exponent-ийг 127 -> 15 bias руу шилжүүлж, доод 13 битийг round-to-nearest-even хийнэ.
+        uint32_t h = (ax - 0x38000000u) >> 13;
+        const uint32_t rem = ax & 0x1FFFu;
+        if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h;
+        return (uint16_t)(sign | h);
+    }
+
+    inline float half_bits_to_float(uint16_t h)
+    {
+        const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+        const uint32_t e = ((uint32_t)h >> 10) & 0x1Fu;
+        const uint32_t m = (uint32_t)h & 0x3FFu;
+        if (e == 0u)
+        {
+            const float v = (float)m * 5.9604644775390625e-8f;
+            return sign ? -v : v;
+        }
+        if (e == 31u) return std::bit_cast<float>(sign | 0x7F800000u | (m << 13));
+        return std::bit_cast<float>(sign | ((e + 112u) << 23) | (m << 13));
+    }
+
+    // (r, g, b, a) -> ColorHalf4. Утгууд [-k_half_max, k_half_max]-д хязгаарлагдана. Сувгуудыг
+    // регистрээс шууд угсарна: stack массиваар дамжвал 4 scalar store -> 128 бит load нь
+    // store-forwarding-д бүтэлгүйтэж vcvtps2ph-ийн ашгийг идчихдэг.
+    inline ColorHalf4 encode_half4(float r, float g, float b, float a)
+    {
+#if defined(SHS_HDR_F16C)
+        const __m128 lim = _mm_set1_ps(k_half_max);
+        const __m128 v = _mm_max_ps(_mm_min_ps(_mm_setr_ps(r, g, b, a), lim), _mm_sub_ps(_mm_setzero_ps(), lim));
+        ColorHalf4 out{};
+        _mm_storel_epi64((__m128i*)&out, _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+        return out;
+#else
+        // minps/maxps-тай ижил дараалал: NaN нь k_half_max болно.
+        auto enc = [](float v)
+        {
+            v = (v < k_half_max) ? v : k_half_max;
+            v = (v > -k_half_max) ? v : -k_half_max;
+            return float_to_half_bits(v);
+        };
+        return ColorHalf4{enc(r), enc(g), enc(b), enc(a)};
+#endif
+    }
+
+    inline void decode_half4(const ColorHalf4& c, float* out)
+    {
+#if defined(SHS_HDR_F16C)
+        _mm_storeu_ps(out, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)&c)));
+#else
+        out[0] = half_bits_to_float(c.r);
+        out[1] = half_bits_to_float(c.g);
+        out[2] = half_bits_to_float(c.b);
+        out[3] = half_bits_to_float(c.a);
+#endif
+    }
+
+    namespace detail
+    {
+        // Эерэг float-ийг exp 5 бит (bias 15), mant_bits mantissa-тай unsigned float руу шууд
+        // round-to-nearest-even хийнэ (half-аар дамжвал давхар дугуйрна). max_bits-ээр хязгаарлана.
+        inline uint32_t float_to_small_float(float v, uint32_t mant_bits, uint32_t max_bits)
+        {
+            if (!(v > 0.0f)) return 0u;
+            const uint32_t ax = std::bit_cast<uint32_t>(v);
+            if (ax >= 0x7F800000u) return max_bits;
+            if (ax < 0x38800000u)
+            {
+                // 2^-14-өөс бага: subnormal, нэгж нь 2^-(14 + mant_bits).
+                return (uint32_t)std::nearbyint(v * (float)(1u << (14u + mant_bits)));
+            }
+            const uint32_t drop = 23u - mant_bits;
+            const uint32_t x = ax - 0x38000000u;
+            const uint32_t r = (x + ((1u << (drop - 1u)) - 1u) + ((x >> drop) & 1u)) >> drop;
+            return r < max_bits ? r : max_bits;
+        }
+    }
+
+    // rgb[3] -> R11G11B10F. Сөрөг/NaN 0, хэт их утга хамгийн их төгсгөлөг утгадаа очно.
+    inline ColorR11G11B10 encode_r11g11b10(const float* rgb)
+    {
+        const uint32_t r = detail::float_to_small_float(rgb[0], 6u, 0x7BFu);
+        const uint32_t g = detail::float_to_small_float(rgb[1], 6u, 0x7BFu);
+        const uint32_t b = detail::float_to_small_float(rgb[2], 5u, 0x3DFu);
+        return ColorR11G11B10{r | (g << 11) | (b << 22)};
+    }
+
+    inline void decode_r11g11b10(const ColorR11G11B10& c, float* rgb)
+    {
+        rgb[0] = half_bits_to_float((uint16_t)((c.bits & 0x7FFu) << 4));
+        rgb[1] = half_bits_to_float((uint16_t)(((c.bits >> 11) & 0x7FFu) << 4));
+        rgb[2] = half_bits_to_float((uint16_t)(((c.bits >> 22) & 0x3FFu) << 5));
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: pixel_layout.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: PixelBuffer2D болон texture-ийн санах ойн байршил (layout). Мөр дараалсан
+            (linear) болон 2^N x 2^N блок (tiled) байршлыг (x, y) -> index функцээр ялгана.
+            Багана/диагональ дагуу уншдаг gather (PCF, motion blur, bilinear) tiled дээр
+            цөөн cache line-д багтана.
+*/
+
+
+#include <cstddef>
+
+namespace shs
+{
+    // Мөр дараалсан байршил. Мөр бүр тасралтгүй тул &at(x, y)-ээс мөрийн заагч авч болно.
+    struct PixelLayoutLinear
+    {
+        static constexpr int tile_log2 = 0;
+
+        static size_t storage_size(int w, int h)
+        {
+            return (size_t)w * (size_t)h;
+        }
+
+        static size_t index(int x, int y, int w)
+        {
+            return (size_t)y * (size_t)w + (size_t)x;
+        }
+    };
+
+    // 2^TileLog2 квадрат блокуудад хуваасан байршил: блок дотор мөрөөр, блокууд өөрсдөө
+    // мөрөөр дараалсан. Хадгалалт блокын хэмжээнд дээш дугуйрна (захын блокууд бүтэн).
+    // Мөрийн заагч ашигладаг код (rasterizer) энэ байршилтай ажиллахгүй.
+    template<int TileLog2>
+    struct PixelLayoutTiled
+    {
+        static_assert(TileLog2 >= 1 && TileLog2 <= 5, "PixelLayoutTiled: tile 2x2..32x32");
+
+        static constexpr int tile_log2 = TileLog2;
+        static constexpr int tile = 1 << TileLog2;
+        static constexpr int tile_mask = tile - 1;
+
+        static int tiles_along(int n)
+        {
+            return (n + tile_mask) >> TileLog2;
+        }
+
+        static size_t storage_size(int w, int h)
+        {
+            return ((size_t)tiles_along(w) * (size_t)tiles_along(h)) << (2 * TileLog2);
+        }
+
+        static size_t index(int x, int y, int w)
+        {
+            const size_t block = (size_t)(y >> TileLog2) * (size_t)tiles_along(w) + (size_t)(x >> TileLog2);
+            return (block << (2 * TileLog2)) | ((size_t)(y & tile_mask) << TileLog2) | (size_t)(x & tile_mask);
+        }
+    };
+
+    // 4x4: float/RGBA16 texel-ийн блок 1-2 cache line. 8x8: урт gather-т (motion blur).
+    using PixelLayoutTiled4x4 = PixelLayoutTiled<2>;
+    using PixelLayoutTiled8x8 = PixelLayoutTiled<3>;
+
+    template<typename Layout>
+    inline constexpr bool pixel_layout_is_linear = (Layout::tile_log2 == 0);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: pixel_layout_convert.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: Buffer-уудыг layout хооронд хөрвүүлнэ. Rasterizer мөр дараалсан buffer бичдэг
+            тул gather хийдэг pass-ийн өмнө tiled хуулбар гаргах, эсвэл present/tonemap
+            хил дээр linear руу буцаахад ашиглана.
+*/
+
+
+#include <algorithm>
+
+#include "shs/gfx/rt_types.hpp"
+#include "shs/job/parallel_for.hpp"
+
+namespace shs
+{
+    // src нь w/h/at(x, y)-тай дурын buffer (PixelBuffer2D-ийн аль ч layout, RT_ShadowDepth).
+    // dst-ийн хэмжээ өөр бол src-ийнхээр дахин үүсгэнэ. Ажлыг dst-ийн блок мөрөөр хуваах тул
+    // thread бүр тасралтгүй санах ойд бичнэ.
+    template<typename TSrc, typename TPixel, typename Layout>
+    inline void convert_pixel_layout(const TSrc& src, PixelBuffer2D<TPixel, Layout>& dst, IJobSystem* js)
+    {
+        if (src.w <= 0 || src.h <= 0) return;
+        if (dst.w != src.w || dst.h != src.h || dst.data.size() != Layout::storage_size(src.w, src.h))
+        {
+            dst.resize(src.w, src.h, TPixel{});
+        }
+
+        constexpr int T = 1 << Layout::tile_log2;
+        const int w = src.w;
+        const int h = src.h;
+        const int bands = (h + T - 1) / T;
+        // Linear dst-д "блок" нь бүтэн мөр.
+        const int bw = (T == 1) ? w : T;
+        parallel_for_1d(js, 0, bands, std::max(1, 8 / T), [&](int bb, int be)
+        {
+            for (int b = bb; b < be; ++b)
+            {
+                const int y0 = b * T;
+                const int y1 = std::min(h, y0 + T);
+                for (int x0 = 0; x0 < w; x0 += bw)
+                {
+                    const int x1 = std::min(w, x0 + bw);
+                    for (int y = y0; y < y1; ++y)
+                    {
+                        for (int x = x0; x < x1; ++x) dst.at(x, y) = src.at(x, y);
+                    }
+                }
+            }
+        });
+    }
+}
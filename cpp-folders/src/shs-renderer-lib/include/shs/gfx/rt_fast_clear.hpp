@@ -0,0 +1,77 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: rt_fast_clear.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: Render target-ийн хурдан (lazy) clear. Clear нь 8x8 tile бүрд "clear утгаа
+            хүлээж буй" flag тавьж O(tile) зардалтай; пикселийг анх бичих (raster tile/band)
+            эсвэл pass-ийн төгсгөлд resolve хийх үед л бөглөнө. Hi-Z мэт уншигч pending
+            tile-ийг санах ой уншилгүйгээр clear утгаар ойлгоно.
+*/
+
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace shs
+{
+    struct FastClearTiles
+    {
+        // Hi-Z block / edge raster block-той ижил: raster tile болон 8 мөрийн band-ууд tile-д
+        // зэрэгцдэг тул нэг tile-ийг зөвхөн нэг job resolve хийнэ.
+        static constexpr int k_tile_log2 = 3;
+        static constexpr int k_tile = 1 << k_tile_log2;
+
+        int tiles_x = 0;
+        int tiles_y = 0;
+        // false үед pending-ийн агуулга хамаагүй (buffer бүрэн бодит утгатай).
+        bool active = false;
+        std::vector<uint8_t> pending{};
+
+        void mark_all(int w, int h)
+        {
+            tiles_x = (std::max(0, w) + k_tile - 1) >> k_tile_log2;
+            tiles_y = (std::max(0, h) + k_tile - 1) >> k_tile_log2;
+            pending.assign((size_t)tiles_x * (size_t)tiles_y, 1u);
+            active = !pending.empty();
+        }
+
+        void reset()
+        {
+            active = false;
+        }
+
+        bool tile_pending(int tx, int ty) const
+        {
+            return active && pending[(size_t)ty * (size_t)tiles_x + (size_t)tx] != 0u;
+        }
+
+        // [x0, x1] x [y0, y1] (inclusive) тэгш өнцөгттэй давхцах pending tile бүрд
+        // fill(px0, px1, py0, py1)-ийг (w/h-аар хязгаарласан бүтэн tile) дуудаж flag-ийг арилгана.
+        template<typename FillFn>
+        void resolve_rect(int w, int h, int x0, int x1, int y0, int y1, FillFn&& fill)
+        {
+            if (!active) return;
+            x0 = std::max(0, x0);
+            y0 = std::max(0, y0);
+            x1 = std::min(w - 1, x1);
+            y1 = std::min(h - 1, y1);
+            if (x0 > x1 || y0 > y1) return;
+            for (int ty = y0 >> k_tile_log2; ty <= (y1 >> k_tile_log2); ++ty)
+            {
+                for (int tx = x0 >> k_tile_log2; tx <= (x1 >> k_tile_log2); ++tx)
+                {
+                    uint8_t& p = pending[(size_t)ty * (size_t)tiles_x + (size_t)tx];
+                    if (!p) continue;
+                    const int px0 = tx << k_tile_log2;
+                    const int py0 = ty << k_tile_log2;
+                    fill(px0, std::min(w, px0 + k_tile) - 1, py0, std::min(h, py0 + k_tile) - 1);
+                    p = 0u;
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: rt_fast_clear_resolve.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: clear_fast()-аар тэмдэглэгдээд хэн ч хүрээгүй үлдсэн tile-уудыг parallel-аар
+            бөглөнө. Buffer-ийг ерөнхий уншигчид (post pass, debug, upload) дамжуулахаас өмнө
+            бичигч pass төгсгөлдөө дуудна.
+*/
+
+
+#include "shs/gfx/rt_fast_clear.hpp"
+#include "shs/gfx/rt_types.hpp"
+#include "shs/job/parallel_for.hpp"
+
+namespace shs
+{
+    // TBuffer: w/h, fast_clear, resolve_fast_clear_rect()-тэй (PixelBuffer2D, RT_ShadowDepth).
+    template<typename TBuffer>
+    inline void resolve_fast_clear(TBuffer& buf, IJobSystem* js)
+    {
+        if (!buf.fast_clear.active) return;
+        constexpr int T = FastClearTiles::k_tile;
+        // Tile мөр бүр нэг job-д: өөр job-ууд нэг tile-ийн flag-д хүрэхгүй.
+        parallel_for_1d(js, 0, buf.fast_clear.tiles_y, 4, [&](int tb, int te)
+        {
+            buf.resolve_fast_clear_rect(0, buf.w - 1, tb * T, te * T - 1);
+        });
+        buf.fast_clear.reset();
+    }
+
+    // HDR target-ийн идэвхтэй форматын хадгалалтыг resolve хийнэ.
+    inline void resolve_fast_clear(RT_ColorHDR& hdr, IJobSystem* js)
+    {
+        hdr.visit([&](auto& buf) { resolve_fast_clear(buf, js); });
+    }
+}
@@ -10,16 +10,20 @@
 */
 
 
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "shs/gfx/rt_handle.hpp"
 #include "shs/gfx/rt_shadow.hpp"
 #include "shs/gfx/rt_types.hpp"
+#include "shs/gfx/transient_alias.hpp"
 
 namespace shs
 {
@@ -41,6 +45,8 @@ namespace shs
         template <> struct rt_kind_of<RT_ColorDepthMotion> { static constexpr RTKind value = RTKind::Motion; };
     }
 
+    // Thread-safe биш: бүртгэл (reg/ensure_transient_*/rebind) нь зөвхөн нэг thread-ээс хийгдэнэ.
+    // Parallel pass graph горимд pipeline бүх request-ийг graph эхлэхээс өмнө serial resolve хийдэг.
     class RTRegistry
     {
     public:
@@ -59,6 +65,8 @@ namespace shs
             transient_hdr_.clear();
             transient_motion_.clear();
             transient_shadow_.clear();
+            transient_frame_active_ = false;
+            transient_stats_ = TransientMemoryStats{};
         }
 
         // Register an existing RT pointer from demo code.
@@ -88,6 +96,18 @@ namespace shs
             return (it == map_.end()) ? nullptr : it->second.ptr;
         }
 
+        // Бүртгэлтэй handle-ийг ижил төрлийн өөр RT руу түр заана (dynamic resolution-ий үед
+        // жижигрүүлсэн RT г.м.). Өмнөх заагчийг буцаана; handle бүртгэлгүй бол nullptr.
+        template<typename THandle>
+        void* rebind(THandle h, void* ptr)
+        {
+            auto it = map_.find(h.id);
+            if (it == map_.end()) return nullptr;
+            void* prev = it->second.ptr;
+            it->second.ptr = ptr;
+            return prev;
+        }
+
         template<typename THandle>
         RTKind kind(THandle h) const
         {
@@ -97,88 +117,111 @@ namespace shs
 
         RTHandle ensure_transient_color_ldr(const std::string& name, int w, int h, Color clear = {0, 0, 0, 255})
         {
-            auto it = transient_ldr_.find(name);
-            if (it == transient_ldr_.end())
-            {
-                auto rt = std::make_unique<RT_ColorLDR>(w, h, clear);
-                RTHandle hdl = reg_impl<RTHandle>((void*)rt.get(), RTKind::ColorLDR);
-                auto [ins_it, _] = transient_ldr_.emplace(name, TransientLdr{hdl, std::move(rt)});
-                return ins_it->second.handle;
-            }
+            return ensure_transient(
+                transient_ldr_, name, RTKind::ColorLDR,
+                [&]() { return std::make_unique<RT_ColorLDR>(w, h, clear); },
+                [&](const RT_ColorLDR& rt) { return rt.w == w && rt.h == h; },
+                [&](RT_ColorLDR& rt)
+                {
+                    rt.w = w;
+                    rt.h = h;
+                    rt.color.resize(w, h, clear);
+                });
+        }
 
-            RT_ColorLDR* rt = it->second.rt.get();
-            if (!rt) return RTHandle{};
-            if (rt->w != w || rt->h != h)
-            {
-                rt->w = w;
-                rt->h = h;
-                rt->color.resize(w, h, clear);
-            }
-            return it->second.handle;
+        // format: pipeline-ийн HDR хадгалалт (hdr_pixel.hpp). Өөр форматаар дахин дуудвал дахин хуваарилна.
+        RTHandle ensure_transient_color_hdr(
+            const std::string& name,
+            int w,
+            int h,
+            ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f},
+            HdrFormat format = HdrFormat::RGBA32F)
+        {
+            return ensure_transient(
+                transient_hdr_, name, RTKind::ColorHDR,
+                [&]() { return std::make_unique<RT_ColorHDR>(w, h, clear, format); },
+                [&](const RT_ColorHDR& rt) { return rt.w == w && rt.h == h && rt.format == format; },
+                [&](RT_ColorHDR& rt)
+                {
+                    rt.format = format;
+                    rt.resize(w, h, clear);
+                });
         }
 
-        RTHandle ensure_transient_color_hdr(const std::string& name, int w, int h, ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f})
+        RTHandle ensure_transient_motion(const std::string& name, int w, int h, float zn, float zf, Color clear = {0, 0, 0, 255})
         {
-            auto it = transient_hdr_.find(name);
-            if (it == transient_hdr_.end())
-            {
-                auto rt = std::make_unique<RT_ColorHDR>(w, h, clear);
-                RTHandle hdl = reg_impl<RTHandle>((void*)rt.get(), RTKind::ColorHDR);
-                auto [ins_it, _] = transient_hdr_.emplace(name, TransientHdr{hdl, std::move(rt)});
-                return ins_it->second.handle;
-            }
+            return ensure_transient(
+                transient_motion_, name, RTKind::Motion,
+                [&]() { return std::make_unique<RT_ColorDepthMotion>(w, h, zn, zf, clear); },
+                [&](const RT_ColorDepthMotion& rt)
+                {
+                    return rt.w == w && rt.h == h && std::abs(rt.zn - zn) <= 1e-6f && std::abs(rt.zf - zf) <= 1e-6f;
+                },
+                [&](RT_ColorDepthMotion& rt) { rt = RT_ColorDepthMotion(w, h, zn, zf, clear); });
+        }
 
-            RT_ColorHDR* rt = it->second.rt.get();
-            if (!rt) return RTHandle{};
-            if (rt->w != w || rt->h != h)
-            {
-                rt->w = w;
-                rt->h = h;
-                rt->color.resize(w, h, clear);
-            }
-            return it->second.handle;
+        RTHandle ensure_transient_shadow(const std::string& name, int w, int h)
+        {
+            return ensure_transient(
+                transient_shadow_, name, RTKind::Shadow,
+                [&]() { return std::make_unique<RT_ShadowDepth>(w, h); },
+                [&](const RT_ShadowDepth& rt) { return rt.w == w && rt.h == h; },
+                [&](RT_ShadowDepth& rt) { rt.resize(w, h); });
         }
 
-        RTHandle ensure_transient_motion(const std::string& name, int w, int h, float zn, float zf, Color clear = {0, 0, 0, 255})
+        // Transient-уудын санах ойн aliasing (transient_alias.hpp). Executor frame-ийн эхэнд
+        // begin_transient_frame(), pass бүрийн өмнө set_transient_pass(pass_index) дуудна.
+        // ensure_transient_*() нь тухайн нэрийн эхний/сүүлийн pass-ийг тэмдэглэж,
+        // end_transient_frame() нь ижил төрөл/хэмжээтэй, амьдрал нь давхцахгүй transient-уудыг
+        // нэг RT объектод багцална: дараагийн frame-ээс тэдгээрийн handle ижил backing руу заана.
+        // allow_aliasing=false (pass-ууд зэрэг ажиллах үед) бол бүгд тусдаа backing-тэй болно.
+        struct TransientMemoryStats
         {
-            auto it = transient_motion_.find(name);
-            if (it == transient_motion_.end())
-            {
-                auto rt = std::make_unique<RT_ColorDepthMotion>(w, h, zn, zf, clear);
-                RTHandle hdl = reg_impl<RTHandle>((void*)rt.get(), RTKind::Motion);
-                auto [ins_it, _] = transient_motion_.emplace(name, TransientMotion{hdl, std::move(rt)});
-                return ins_it->second.handle;
-            }
+            uint32_t transients = 0u;
+            uint32_t slots = 0u;
+            // Transient бүр тусдаа buffer-тэй үеийн нийт байт.
+            size_t bytes_dedicated = 0u;
+            // Alias хийсний дараах backing-ийн нийт байт.
+            size_t bytes_aliased = 0u;
+        };
 
-            RT_ColorDepthMotion* rt = it->second.rt.get();
-            if (!rt) return RTHandle{};
-            if (rt->w != w || rt->h != h || std::abs(rt->zn - zn) > 1e-6f || std::abs(rt->zf - zf) > 1e-6f)
-            {
-                *rt = RT_ColorDepthMotion(w, h, zn, zf, clear);
-            }
-            return it->second.handle;
+        void begin_transient_frame(bool allow_aliasing)
+        {
+            ++transient_frame_;
+            transient_pass_ = 0u;
+            transient_frame_active_ = allow_aliasing;
+            if (allow_aliasing) return;
+
+            // Pass-ууд зэрэг ажиллах frame: өмнө нь alias хийгдсэн transient-уудыг салгаж, pass
+            // бүрийн дуудлагаас хуваалцсан төлөв бичихгүйн тулд хэрэглээг тэмдэглэхгүй.
+            TransientMemoryStats stats{};
+            detach_transients(transient_ldr_, stats);
+            detach_transients(transient_hdr_, stats);
+            detach_transients(transient_motion_, stats);
+            detach_transients(transient_shadow_, stats);
+            transient_stats_ = stats;
         }
 
-        RTHandle ensure_transient_shadow(const std::string& name, int w, int h)
+        void set_transient_pass(uint32_t pass_index)
         {
-            auto it = transient_shadow_.find(name);
-            if (it == transient_shadow_.end())
-            {
-                auto rt = std::make_unique<RT_ShadowDepth>(w, h);
-                RTHandle hdl = reg_impl<RTHandle>((void*)rt.get(), RTKind::Shadow);
-                auto [ins_it, _] = transient_shadow_.emplace(name, TransientShadow{hdl, std::move(rt)});
-                return ins_it->second.handle;
-            }
+            transient_pass_ = pass_index;
+        }
 
-            RT_ShadowDepth* rt = it->second.rt.get();
-            if (!rt) return RTHandle{};
-            if (rt->w != w || rt->h != h)
-            {
-                rt->resize(w, h);
-            }
-            return it->second.handle;
+        void end_transient_frame()
+        {
+            if (!transient_frame_active_) return;
+            transient_frame_active_ = false;
+
+            TransientMemoryStats stats{};
+            plan_transients(transient_ldr_, stats);
+            plan_transients(transient_hdr_, stats);
+            plan_transients(transient_motion_, stats);
+            plan_transients(transient_shadow_, stats);
+            transient_stats_ = stats;
         }
 
+        const TransientMemoryStats& transient_memory_stats() const { return transient_stats_; }
+
         template<typename THandle>
         Extent extent(THandle h) const
         {
@@ -238,32 +281,218 @@ namespace shs
             return h;
         }
 
-        struct TransientLdr
+        template<typename TRT>
+        struct Transient
         {
             RTHandle handle{};
-            std::unique_ptr<RT_ColorLDR> rt{};
+            // Slot-ын эзэн бол backing RT. Өөр transient-ийн backing-д alias хийгдсэн бол хоосон.
+            std::unique_ptr<TRT> own{};
+            uint64_t frame = 0u;
+            uint32_t first_pass = 0u;
+            uint32_t last_pass = 0u;
         };
-        struct TransientHdr
+
+        template<typename TRT>
+        using TransientMap = std::unordered_map<std::string, Transient<TRT>>;
+
+        template<typename TRT, typename MakeFn, typename FitsFn, typename ReshapeFn>
+        RTHandle ensure_transient(
+            TransientMap<TRT>& set,
+            const std::string& name,
+            RTKind kind,
+            MakeFn&& make,
+            FitsFn&& fits,
+            ReshapeFn&& reshape)
         {
-            RTHandle handle{};
-            std::unique_ptr<RT_ColorHDR> rt{};
-        };
-        struct TransientMotion
+            auto it = set.find(name);
+            if (it == set.end())
+            {
+                Transient<TRT> t{};
+                t.own = make();
+                t.handle = reg_impl<RTHandle>((void*)t.own.get(), kind);
+                it = set.emplace(name, std::move(t)).first;
+            }
+            else
+            {
+                Transient<TRT>& t = it->second;
+                TRT* rt = static_cast<TRT*>(get(t.handle));
+                if (!rt) return RTHandle{};
+                if (!fits(*rt))
+                {
+                    if (t.own)
+                    {
+                        reshape(*rt);
+                    }
+                    else
+                    {
+                        // Хуваалцсан backing-ийг бусдад нь хэвээр үлдээж, өөрийн шинэ RT-тэй болно.
+                        t.own = make();
+                        bind_transient(t, t.own.get());
+                    }
+                }
+            }
+
+            Transient<TRT>& t = it->second;
+            if (transient_frame_active_)
+            {
+                if (t.frame != transient_frame_)
+                {
+                    t.frame = transient_frame_;
+                    t.first_pass = transient_pass_;
+                    t.last_pass = transient_pass_;
+                }
+                else
+                {
+                    t.first_pass = std::min(t.first_pass, transient_pass_);
+                    t.last_pass = std::max(t.last_pass, transient_pass_);
+                }
+            }
+            return t.handle;
+        }
+
+        template<typename TRT>
+        void bind_transient(Transient<TRT>& t, TRT* rt)
         {
-            RTHandle handle{};
-            std::unique_ptr<RT_ColorDepthMotion> rt{};
-        };
-        struct TransientShadow
+            map_[t.handle.id].ptr = (void*)rt;
+        }
+
+        // Alias-ийн бүлэг: ижил төрөл, хэмжээ, формат бүхий RT-ууд нэг объектыг хуваалцаж болно.
+        static size_t transient_bytes(const RT_ColorLDR& rt) { return (size_t)rt.w * (size_t)rt.h * sizeof(Color); }
+        static size_t transient_bytes(const RT_ColorHDR& rt) { return rt.storage_bytes(); }
+        static size_t transient_bytes(const RT_ColorDepthMotion& rt)
         {
-            RTHandle handle{};
-            std::unique_ptr<RT_ShadowDepth> rt{};
-        };
+            return (size_t)rt.w * (size_t)rt.h * (sizeof(Color) + sizeof(float) + sizeof(Motion2f));
+        }
+        static size_t transient_bytes(const RT_ShadowDepth& rt) { return (size_t)rt.w * (size_t)rt.h * sizeof(float); }
+
+        static bool transient_same_class(const RT_ColorLDR& a, const RT_ColorLDR& b) { return a.w == b.w && a.h == b.h; }
+        static bool transient_same_class(const RT_ColorHDR& a, const RT_ColorHDR& b)
+        {
+            return a.w == b.w && a.h == b.h && a.format == b.format;
+        }
+        static bool transient_same_class(const RT_ColorDepthMotion& a, const RT_ColorDepthMotion& b)
+        {
+            return a.w == b.w && a.h == b.h && a.zn == b.zn && a.zf == b.zf;
+        }
+        static bool transient_same_class(const RT_ShadowDepth& a, const RT_ShadowDepth& b) { return a.w == b.w && a.h == b.h; }
+
+        template<typename TRT>
+        void detach_transients(TransientMap<TRT>& set, TransientMemoryStats& stats)
+        {
+            for (auto& [name, t] : set)
+            {
+                (void)name;
+                if (!t.own)
+                {
+                    t.own = std::make_unique<TRT>(*static_cast<TRT*>(get(t.handle)));
+                    bind_transient(t, t.own.get());
+                }
+            }
+            for (auto& [name, t] : set)
+            {
+                (void)name;
+                const size_t bytes = transient_bytes(*t.own);
+                ++stats.transients;
+                ++stats.slots;
+                stats.bytes_dedicated += bytes;
+                stats.bytes_aliased += bytes;
+            }
+        }
+
+        // Нэг RT төрлийн transient-уудыг ижил хэмжээтэй бүлгүүдэд хувааж, бүлэг бүрт
+        // assign_alias_slots()-ийг ажиллуулна. Backing шаардлагатай эзэд (own хоосон) одоогийн
+        // объектоосоо хуулбар авна. Хуучин backing-ийг өөр бүлэгт орсон transient заасан байж
+        // болох тул бүх эзэн бэлэн болсны дараа л дахин холбож, дараа нь чөлөөлнө.
+        template<typename TRT>
+        void plan_transients(TransientMap<TRT>& set, TransientMemoryStats& stats)
+        {
+            std::vector<Transient<TRT>*> used{};
+            for (auto& [name, t] : set)
+            {
+                (void)name;
+                if (t.frame == transient_frame_)
+                {
+                    used.push_back(&t);
+                }
+                else if (!t.own)
+                {
+                    // Энэ frame-д хэрэглэгдээгүй alias гишүүн: backing нь чөлөөлөгдөж болзошгүй тул
+                    // өөрийн хуулбартай болно.
+                    t.own = std::make_unique<TRT>(*static_cast<TRT*>(get(t.handle)));
+                    bind_transient(t, t.own.get());
+                }
+            }
+            std::sort(used.begin(), used.end(), [](const Transient<TRT>* a, const Transient<TRT>* b)
+            {
+                return a->handle.id < b->handle.id;
+            });
+
+            std::vector<std::pair<Transient<TRT>*, Transient<TRT>*>> members{};
+            std::vector<std::vector<Transient<TRT>*>> classes{};
+            for (Transient<TRT>* t : used)
+            {
+                const TRT& rt = *static_cast<const TRT*>(get(t->handle));
+                auto cls = std::find_if(classes.begin(), classes.end(), [&](const std::vector<Transient<TRT>*>& c)
+                {
+                    return transient_same_class(*static_cast<const TRT*>(get(c.front()->handle)), rt);
+                });
+                if (cls == classes.end()) classes.push_back({t});
+                else cls->push_back(t);
+            }
+
+            for (const auto& cls : classes)
+            {
+                std::vector<AliasInterval> intervals{};
+                intervals.reserve(cls.size());
+                for (const Transient<TRT>* t : cls)
+                {
+                    const size_t bytes = transient_bytes(*static_cast<const TRT*>(get(t->handle)));
+                    intervals.push_back(AliasInterval{t->first_pass, t->last_pass, bytes});
+                }
+                const AliasSlotPlan plan = assign_alias_slots(intervals);
+                stats.transients += (uint32_t)cls.size();
+                stats.slots += plan.slot_count();
+                stats.bytes_dedicated += plan.bytes_dedicated;
+                stats.bytes_aliased += plan.bytes_aliased;
+
+                // Slot бүрийн эзэн: backing-тай гишүүнийг илүүд үзэж хуулбар гаргахаас зайлсхийнэ.
+                std::vector<Transient<TRT>*> owner(plan.slot_count(), nullptr);
+                for (size_t i = 0; i < cls.size(); ++i)
+                {
+                    Transient<TRT>*& o = owner[plan.slot_of[i]];
+                    if (!o || (!o->own && cls[i]->own)) o = cls[i];
+                }
+                for (Transient<TRT>* o : owner)
+                {
+                    if (o->own) continue;
+                    o->own = std::make_unique<TRT>(*static_cast<TRT*>(get(o->handle)));
+                    bind_transient(*o, o->own.get());
+                }
+                for (size_t i = 0; i < cls.size(); ++i)
+                {
+                    Transient<TRT>* t = cls[i];
+                    Transient<TRT>* o = owner[plan.slot_of[i]];
+                    if (t != o) members.emplace_back(t, o);
+                }
+            }
+
+            for (auto& [t, o] : members) bind_transient(*t, o->own.get());
+            for (auto& [t, o] : members)
+            {
+                (void)o;
+                t->own.reset();
+            }
+        }
 
         uint32_t next_id_ = 1;
         std::unordered_map<uint32_t, Entry> map_{};
-        std::unordered_map<std::string, TransientLdr> transient_ldr_{};
-        std::unordered_map<std::string, TransientHdr> transient_hdr_{};
-        std::unordered_map<std::string, TransientMotion> transient_motion_{};
-        std::unordered_map<std::string, TransientShadow> transient_shadow_{};
+        TransientMap<RT_ColorLDR> transient_ldr_{};
+        TransientMap<RT_ColorHDR> transient_hdr_{};
+        TransientMap<RT_ColorDepthMotion> transient_motion_{};
+        TransientMap<RT_ShadowDepth> transient_shadow_{};
+        uint64_t transient_frame_ = 0u;
+        uint32_t transient_pass_ = 0u;
+        bool transient_frame_active_ = false;
+        TransientMemoryStats transient_stats_{};
     };
 }
@@ -13,12 +13,16 @@
 #include <vector>
 #include <algorithm>
 
+#include "shs/gfx/rt_fast_clear.hpp"
+
 namespace shs {
 
 struct RT_ShadowDepth {
     int w = 0;
     int h = 0;
     std::vector<float> depth;
+    FastClearTiles fast_clear{};
+    float fast_clear_value = 1.0f;
 
     RT_ShadowDepth() = default;
     RT_ShadowDepth(int W, int H) { resize(W, H); }
@@ -26,10 +30,27 @@ struct RT_ShadowDepth {
     inline void resize(int W, int H) {
         w = W; h = H;
         depth.assign((size_t)w * (size_t)h, 1.0f);
+        fast_clear.reset();
     }
 
     inline void clear(float v = 1.0f) {
         std::fill(depth.begin(), depth.end(), v);
+        fast_clear.reset();
+    }
+
+    // PixelBuffer2D::clear_fast-тай ижил гэрээ: raster tile анх хүрэхдээ, PassShadowMap
+    // төгсгөлдөө үлдсэн tile-уудыг resolve хийнэ.
+    inline void clear_fast(float v = 1.0f) {
+        fast_clear_value = v;
+        fast_clear.mark_all(w, h);
+    }
+
+    inline void resolve_fast_clear_rect(int x0, int x1, int y0, int y1) {
+        fast_clear.resolve_rect(w, h, x0, x1, y0, y1, [&](int px0, int px1, int py0, int py1) {
+            for (int y = py0; y <= py1; ++y) {
+                std::fill_n(depth.data() + (size_t)y * (size_t)w + (size_t)px0, (size_t)(px1 - px0 + 1), fast_clear_value);
+            }
+        });
     }
 
     inline float* data() { return depth.data(); }
@@ -11,9 +11,14 @@
 
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 #include <algorithm>
 
+#include "shs/gfx/hdr_pixel.hpp"
+#include "shs/gfx/pixel_layout.hpp"
+#include "shs/gfx/rt_fast_clear.hpp"
+
 namespace shs
 {
     struct Motion2f
@@ -32,12 +37,20 @@ namespace shs
         float r, g, b, a;
     };
 
-    template<typename TPixel>
+    // Layout нь хадгалалтын дарааллыг тодорхойлно (pixel_layout.hpp). Анхдагч нь мөр дараалсан;
+    // data-г шууд индексжүүлдэг эсвэл мөрийн заагч авдаг код зөвхөн linear дээр хүчинтэй.
+    template<typename TPixel, typename Layout = PixelLayoutLinear>
     struct PixelBuffer2D
     {
+        using pixel_type = TPixel;
+        using layout_type = Layout;
+
         int w = 0;
         int h = 0;
         std::vector<TPixel> data;
+        // clear_fast()-ийн tile flag ба утга (rt_fast_clear.hpp).
+        FastClearTiles fast_clear{};
+        TPixel fast_clear_value{};
 
         PixelBuffer2D() = default;
         PixelBuffer2D(int W, int H, const TPixel& clear) { resize(W, H, clear); }
@@ -46,18 +59,50 @@ namespace shs
         {
             w = W;
             h = H;
-            data.assign((size_t)w * (size_t)h, clear);
+            data.assign(Layout::storage_size(w, h), clear);
+            fast_clear.reset();
         }
 
         void clear(const TPixel& clear_value)
         {
             std::fill(data.begin(), data.end(), clear_value);
+            fast_clear.reset();
+        }
+
+        // O(tile) clear: пиксел бичихгүй. Бичигч нь resolve_fast_clear_rect()-ээр анх хүрэх
+        // хэсгээ, pass-ийн төгсгөлд resolve_fast_clear() (rt_fast_clear_resolve.hpp)-ээр
+        // үлдсэнийг бөглөнө. Хооронд нь data/at()-ийг шууд уншиж болохгүй.
+        void clear_fast(const TPixel& clear_value)
+        {
+            fast_clear_value = clear_value;
+            fast_clear.mark_all(w, h);
         }
 
-        TPixel& at(int x, int y) { return data[(size_t)y * (size_t)w + (size_t)x]; }
-        const TPixel& at(int x, int y) const { return data[(size_t)y * (size_t)w + (size_t)x]; }
+        void resolve_fast_clear_rect(int x0, int x1, int y0, int y1)
+        {
+            fast_clear.resolve_rect(w, h, x0, x1, y0, y1, [&](int px0, int px1, int py0, int py1)
+            {
+                for (int y = py0; y <= py1; ++y)
+                {
+                    for (int x = px0; x <= px1; ++x) at(x, y) = fast_clear_value;
+                }
+            });
+        }
+
+        TPixel& at(int x, int y) { return data[Layout::index(x, y, w)]; }
+        const TPixel& at(int x, int y) const { return data[Layout::index(x, y, w)]; }
     };
 
+    // w/h/at(x, y)-тай дурын buffer (PixelBuffer2D-ийн аль ч layout, RT_ShadowDepth)-ээс
+    // захад clamp хийж уншина. Gather хийдэг pass-ууд үүгээр layout-оос үл хамаарна.
+    template<typename TBuffer>
+    inline decltype(auto) pixel_fetch_clamped(const TBuffer& buf, int x, int y)
+    {
+        x = std::clamp(x, 0, buf.w - 1);
+        y = std::clamp(y, 0, buf.h - 1);
+        return buf.at(x, y);
+    }
+
     struct RT_ColorLDR
     {
         int w = 0;
@@ -76,16 +121,160 @@ namespace shs
         }
     };
 
+    // HDR пикселийн төрөл <-> ColorF (hdr_pixel.hpp).
+    template<typename TPixel> struct HdrPixelCodec;
+
+    template<> struct HdrPixelCodec<ColorF>
+    {
+        static ColorF decode(const ColorF& p) { return p; }
+        static ColorF encode(const ColorF& c) { return c; }
+    };
+
+    template<> struct HdrPixelCodec<ColorHalf4>
+    {
+        static ColorF decode(const ColorHalf4& p)
+        {
+            float v[4];
+            decode_half4(p, v);
+            return ColorF{v[0], v[1], v[2], v[3]};
+        }
+        static ColorHalf4 encode(const ColorF& c)
+        {
+            return encode_half4(c.r, c.g, c.b, c.a);
+        }
+    };
+
+    template<> struct HdrPixelCodec<ColorR11G11B10>
+    {
+        static ColorF decode(const ColorR11G11B10& p)
+        {
+            float v[3];
+            decode_r11g11b10(p, v);
+            return ColorF{v[0], v[1], v[2], 1.0f};
+        }
+        static ColorR11G11B10 encode(const ColorF& c)
+        {
+            const float v[3] = {c.r, c.g, c.b};
+            return encode_r11g11b10(v);
+        }
+    };
+
+    // Дурын HDR pixel buffer-ээс (формат/layout-оос үл хамааран) ColorF уншиж бичнэ.
+    template<typename TBuffer>
+    inline ColorF hdr_load(const TBuffer& buf, int x, int y)
+    {
+        return HdrPixelCodec<typename TBuffer::pixel_type>::decode(buf.at(x, y));
+    }
+
+    template<typename TBuffer>
+    inline void hdr_store(TBuffer& buf, int x, int y, const ColorF& c)
+    {
+        buf.at(x, y) = HdrPixelCodec<typename TBuffer::pixel_type>::encode(c);
+    }
+
+    // format-ийн дагуу color / color_half / color_packed-ийн зөвхөн нэг нь хуваарилагдана.
+    // Pass-ууд load()/store() эсвэл visit()-ээр (давталтын гадна нэг удаа формат сонгож)
+    // хандвал кодчилол нуугдана. color-ийг шууд ашигладаг код зөвхөн RGBA32F дээр хүчинтэй.
     struct RT_ColorHDR
     {
         int w = 0;
         int h = 0;
+        HdrFormat format = HdrFormat::RGBA32F;
         PixelBuffer2D<ColorF> color;
+        PixelBuffer2D<ColorHalf4> color_half;
+        PixelBuffer2D<ColorR11G11B10> color_packed;
+
+        // fn(PixelBuffer2D<P>&)-ийг идэвхтэй хадгалалтаар дуудна.
+        template<typename Fn>
+        decltype(auto) visit(Fn&& fn)
+        {
+            switch (format)
+            {
+                case HdrFormat::RGBA16F: return fn(color_half);
+                case HdrFormat::R11G11B10F: return fn(color_packed);
+                case HdrFormat::RGBA32F:
+                default: return fn(color);
+            }
+        }
+
+        template<typename Fn>
+        decltype(auto) visit(Fn&& fn) const
+        {
+            switch (format)
+            {
+                case HdrFormat::RGBA16F: return fn(color_half);
+                case HdrFormat::R11G11B10F: return fn(color_packed);
+                case HdrFormat::RGBA32F:
+                default: return fn(color);
+            }
+        }
 
         RT_ColorHDR() = default;
-        RT_ColorHDR(int W, int H, ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f}) : w(W), h(H), color(W, H, clear) {}
+        RT_ColorHDR(int W, int H, ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f}, HdrFormat fmt = HdrFormat::RGBA32F)
+            : format(fmt)
+        {
+            resize(W, H, clear);
+        }
+
+        // Формат солигдвол өмнөх хадгалалтыг чөлөөлнө.
+        void resize(int W, int H, ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f})
+        {
+            w = W;
+            h = H;
+            if (format != HdrFormat::RGBA32F) color = PixelBuffer2D<ColorF>{};
+            if (format != HdrFormat::RGBA16F) color_half = PixelBuffer2D<ColorHalf4>{};
+            if (format != HdrFormat::R11G11B10F) color_packed = PixelBuffer2D<ColorR11G11B10>{};
+            visit([&](auto& buf)
+            {
+                using P = typename std::remove_reference_t<decltype(buf)>::pixel_type;
+                buf.resize(W, H, HdrPixelCodec<P>::encode(clear));
+            });
+        }
+
+        void set_format(HdrFormat fmt, ColorF clear = {0.0f, 0.0f, 0.0f, 1.0f})
+        {
+            if (fmt == format && w > 0 && h > 0) return;
+            format = fmt;
+            resize(w, h, clear);
+        }
+
+        ColorF load(int x, int y) const
+        {
+            return visit([&](const auto& buf) { return hdr_load(buf, x, y); });
+        }
 
-        void clear(ColorF c = {0.0f, 0.0f, 0.0f, 1.0f}) { color.clear(c); }
+        void store(int x, int y, const ColorF& c)
+        {
+            visit([&](auto& buf) { hdr_store(buf, x, y, c); });
+        }
+
+        void clear(ColorF c = {0.0f, 0.0f, 0.0f, 1.0f})
+        {
+            visit([&](auto& buf)
+            {
+                using P = typename std::remove_reference_t<decltype(buf)>::pixel_type;
+                buf.clear(HdrPixelCodec<P>::encode(c));
+            });
+        }
+
+        void clear_fast(ColorF c = {0.0f, 0.0f, 0.0f, 1.0f})
+        {
+            visit([&](auto& buf)
+            {
+                using P = typename std::remove_reference_t<decltype(buf)>::pixel_type;
+                buf.clear_fast(HdrPixelCodec<P>::encode(c));
+            });
+        }
+
+        void resolve_fast_clear_rect(int x0, int x1, int y0, int y1)
+        {
+            visit([&](auto& buf) { buf.resolve_fast_clear_rect(x0, x1, y0, y1); });
+        }
+
+        size_t storage_bytes() const
+        {
+            return (size_t)w * (size_t)h * hdr_format_bytes(format);
+        }
     };
 
     struct RT_DepthBuffer
@@ -150,6 +339,14 @@ namespace shs
             depth.clear(1.0f);
             motion.clear(Motion2f{});
         }
+
+        // clear_all()-ийн lazy хувилбар (PixelBuffer2D::clear_fast).
+        void clear_all_fast()
+        {
+            color.clear_fast(clear);
+            depth.clear_fast(1.0f);
+            motion.clear_fast(Motion2f{});
+        }
     };
 
     
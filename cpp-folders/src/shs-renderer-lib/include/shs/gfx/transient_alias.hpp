@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: transient_alias.hpp
+    МОДУЛЬ: gfx
+    ЗОРИЛГО: Амьдралын хугацаа (pass индексийн интервал) нь давхцахгүй transient resource-уудыг
+            нэг backing slot-д багцлах interval-graph будалт. Software RTRegistry болон
+            Vulkan-ий barrier plan хоёул энэ нэг хэрэгжүүлэлтийг ашиглана.
+*/
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace shs
+{
+    // [first, last] (хоёулаа орно) pass индексийн интервал. bytes = 0 бол зөвхөн slot-ын тоог багасгана.
+    struct AliasInterval
+    {
+        uint32_t first = 0u;
+        uint32_t last = 0u;
+        size_t bytes = 0u;
+    };
+
+    struct AliasSlotPlan
+    {
+        // slot_of[i]: intervals[i]-д оногдсон slot.
+        std::vector<uint32_t> slot_of{};
+        // Slot бүрийн backing хэмжээ (тухайн slot-ын хамгийн том resource).
+        std::vector<size_t> slot_bytes{};
+        // Resource бүр тусдаа санах ойтой үеийн нийт хэмжээ.
+        size_t bytes_dedicated = 0u;
+        // Slot-уудын нийт хэмжээ.
+        size_t bytes_aliased = 0u;
+
+        uint32_t slot_count() const { return (uint32_t)slot_bytes.size(); }
+    };
+
+    // Интервалуудыг эхлэлээр нь эрэмбэлж, тус бүрийг сул (сүүлийн хэрэглээ нь эхлэлээс өмнө
+    // дууссан) slot-д оноох greedy будалт. Эхлэлээр эрэмбэлсэн interval graph дээр энэ нь
+    // хамгийн цөөн slot өгнө. Сул slot-уудаас багтах хамгийн жижгийг (best fit), багтах нь
+    // байхгүй бол хамгийн томыг нь томруулж сонгоно; ижил үед бага индекс.
+    inline AliasSlotPlan assign_alias_slots(const std::vector<AliasInterval>& intervals)
+    {
+        AliasSlotPlan out{};
+        out.slot_of.assign(intervals.size(), 0u);
+
+        std::vector<size_t> order(intervals.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            if (intervals[a].first != intervals[b].first) return intervals[a].first < intervals[b].first;
+            return intervals[a].last < intervals[b].last;
+        });
+
+        std::vector<uint32_t> slot_last{};
+        for (const size_t i : order)
+        {
+            const AliasInterval& iv = intervals[i];
+            out.bytes_dedicated += iv.bytes;
+
+            uint32_t fit = UINT32_MAX;
+            uint32_t largest = UINT32_MAX;
+            for (uint32_t s = 0u; s < (uint32_t)slot_last.size(); ++s)
+            {
+                if (iv.first <= slot_last[s]) continue;
+                if (out.slot_bytes[s] >= iv.bytes && (fit == UINT32_MAX || out.slot_bytes[s] < out.slot_bytes[fit])) fit = s;
+                if (largest == UINT32_MAX || out.slot_bytes[s] > out.slot_bytes[largest]) largest = s;
+            }
+
+            uint32_t chosen = (fit != UINT32_MAX) ? fit : largest;
+            if (chosen == UINT32_MAX)
+            {
+                chosen = (uint32_t)slot_last.size();
+                slot_last.push_back(iv.last);
+                out.slot_bytes.push_back(iv.bytes);
+            }
+            else
+            {
+                slot_last[chosen] = iv.last;
+                out.slot_bytes[chosen] = std::max(out.slot_bytes[chosen], iv.bytes);
+            }
+            out.slot_of[i] = chosen;
+        }
+
+        for (const size_t b : out.slot_bytes) out.bytes_aliased += b;
+        return out;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: job_arena.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: JobRecord-уудад зориулсан chunk-тэй bump allocator.
+            Chunk-ууд frame хооронд хадгалагдаж дахин ашиглагдах тул steady state-д
+            heap allocation гарахгүй. Thread бүр өөрийн arena-тай (thread_job_arena).
+*/
+
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "shs/job/job_record.hpp"
+
+namespace shs
+{
+    class JobArena
+    {
+    public:
+        struct Marker
+        {
+            size_t chunk = 0;
+            size_t used = 0;
+        };
+
+        explicit JobArena(size_t chunk_records = 256)
+            : chunk_records_(std::max<size_t>(1, chunk_records))
+        {}
+
+        JobArena(const JobArena&) = delete;
+        JobArena& operator=(const JobArena&) = delete;
+
+        // Дараалсан count ширхэг бичлэг буцаана. Хуучин chunk-д багтахгүй бол
+        // дараагийн (эсвэл шинэ) chunk руу шилжинэ.
+        JobRecord* allocate(size_t count)
+        {
+            if (count == 0) return nullptr;
+            while (cur_ < chunks_.size())
+            {
+                Chunk& c = chunks_[cur_];
+                if (c.capacity - used_ >= count)
+                {
+                    JobRecord* out = c.records.get() + used_;
+                    used_ += count;
+                    return out;
+                }
+                ++cur_;
+                used_ = 0;
+            }
+
+            Chunk c{};
+            c.capacity = std::max(chunk_records_, count);
+            c.records = std::make_unique<JobRecord[]>(c.capacity);
+            chunks_.push_back(std::move(c));
+            cur_ = chunks_.size() - 1;
+            used_ = count;
+            return chunks_[cur_].records.get();
+        }
+
+        Marker mark() const
+        {
+            return Marker{cur_, used_};
+        }
+
+        // Marker-аас хойш олгосон бичлэгүүдийг буцаана. Бичлэгүүд гүйцэтгэгдсэн байх ёстой.
+        void rewind(const Marker& m)
+        {
+            cur_ = m.chunk;
+            used_ = m.used;
+        }
+
+        // Frame эхлэхэд бүхэлд нь хоослоно. Санах ой хадгалагдана.
+        void reset()
+        {
+            cur_ = 0;
+            used_ = 0;
+        }
+
+        size_t chunk_count() const
+        {
+            return chunks_.size();
+        }
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<JobRecord[]> records{};
+            size_t capacity = 0;
+        };
+
+        size_t chunk_records_ = 256;
+        std::vector<Chunk> chunks_{};
+        size_t cur_ = 0;
+        size_t used_ = 0;
+    };
+
+    inline JobArena& thread_job_arena()
+    {
+        static thread_local JobArena arena{};
+        return arena;
+    }
+
+    // Scope-оос гарахад arena-г эхлэх цэг рүү нь буцаана. Nested parallel_for-д stack шиг ажиллана.
+    class JobArenaScope
+    {
+    public:
+        explicit JobArenaScope(JobArena& arena)
+            : arena_(arena), mark_(arena.mark())
+        {}
+
+        ~JobArenaScope()
+        {
+            arena_.rewind(mark_);
+        }
+
+        JobArenaScope(const JobArenaScope&) = delete;
+        JobArenaScope& operator=(const JobArenaScope&) = delete;
+
+        JobRecord* allocate(size_t count)
+        {
+            return arena_.allocate(count);
+        }
+
+    private:
+        JobArena& arena_;
+        JobArena::Marker mark_{};
+    };
+}
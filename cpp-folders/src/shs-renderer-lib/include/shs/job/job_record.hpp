@@ -0,0 +1,121 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: job_record.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Callable-ийг дотроо тогтмол хэмжээтэй буферт хадгалдаг job бичлэг.
+            std::function шиг type-erase хийдэг ч жижиг lambda-д heap огт ашиглахгүй,
+            нэг бичлэг нэг cache line эзэлнэ.
+*/
+
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace shs
+{
+    class alignas(64) JobRecord
+    {
+    public:
+        static constexpr size_t k_inline_bytes = 40;
+
+        template<typename Fn>
+        static constexpr bool stores_inline =
+            sizeof(std::decay_t<Fn>) <= k_inline_bytes &&
+            alignof(std::decay_t<Fn>) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible_v<std::decay_t<Fn>>;
+
+        JobRecord() = default;
+        JobRecord(const JobRecord&) = delete;
+        JobRecord& operator=(const JobRecord&) = delete;
+
+        ~JobRecord()
+        {
+            reset();
+        }
+
+        // Inline багтахгүй callable-ийг heap дээр box хийнэ (fallback, hot path-д хэрэглэхгүй).
+        template<typename Fn>
+        void bind(Fn&& fn)
+        {
+            using F = std::decay_t<Fn>;
+            reset();
+            if constexpr (stores_inline<F>)
+            {
+                ::new ((void*)storage_) F(std::forward<Fn>(fn));
+                invoke_ = [](JobRecord& r) { (*r.inline_ptr<F>())(); };
+                if constexpr (!std::is_trivially_destructible_v<F>)
+                {
+                    destroy_ = [](JobRecord& r) { r.inline_ptr<F>()->~F(); };
+                }
+            }
+            else
+            {
+                F* boxed = new F(std::forward<Fn>(fn));
+                ::new ((void*)storage_) F*(boxed);
+                invoke_ = [](JobRecord& r) { (**r.inline_ptr<F*>())(); };
+                destroy_ = [](JobRecord& r) { delete *r.inline_ptr<F*>(); };
+            }
+        }
+
+        // Ажлыг гүйцэтгээд callable-ийг устгана. Дараа нь бичлэгийг дахин bind хийж болно.
+        // Thunk-уудыг урьдчилан цэвэрлэдэг тул trivially destructible callable-ийн хувьд
+        // дуудлагын дараа бичлэгт хүрэхгүй: callable дотроо WaitGroup::done() хийж,
+        // эзэмшигч нь бичлэгийг шууд дахин ашиглаж болно.
+        void execute()
+        {
+            const Thunk invoke = invoke_;
+            const Thunk destroy = destroy_;
+            if (!invoke) return;
+            invoke_ = nullptr;
+            destroy_ = nullptr;
+            invoke(*this);
+            if (destroy) destroy(*this);
+        }
+
+        void reset()
+        {
+            if (destroy_) destroy_(*this);
+            invoke_ = nullptr;
+            destroy_ = nullptr;
+        }
+
+        bool bound() const
+        {
+            return invoke_ != nullptr;
+        }
+
+        // Job system өөрөө new хийсэн бичлэгийг гүйцэтгэсний дараа delete хийх тэмдэг.
+        bool heap_owned() const
+        {
+            return (flags_ & k_flag_heap_owned) != 0;
+        }
+
+        void set_heap_owned(bool v)
+        {
+            flags_ = v ? (flags_ | k_flag_heap_owned) : (flags_ & ~k_flag_heap_owned);
+        }
+
+    private:
+        using Thunk = void (*)(JobRecord&);
+        static constexpr uint32_t k_flag_heap_owned = 1u;
+
+        template<typename F>
+        F* inline_ptr()
+        {
+            return std::launder(reinterpret_cast<F*>(storage_));
+        }
+
+        alignas(std::max_align_t) unsigned char storage_[k_inline_bytes]{};
+        Thunk invoke_ = nullptr;
+        Thunk destroy_ = nullptr;
+        uint32_t flags_ = 0;
+    };
+
+    static_assert(sizeof(JobRecord) == 64, "JobRecord should stay one cache line");
+}
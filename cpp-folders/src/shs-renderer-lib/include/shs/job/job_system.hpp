@@ -11,17 +11,82 @@
 
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <utility>
+
+#include "shs/job/job_record.hpp"
 
 namespace shs
 {
+    // Job-ийн ач холбогдлын ангилал. Бага утга нь түрүүлж гүйцэтгэгдэнэ.
+    // FrameCritical: тухайн frame-ийн raster/post chunk (дуудагч хүлээж байгаа).
+    // Normal: ерөнхий ажил. Background: IBL prefilter, asset decode зэрэг урт ажил.
+    enum class JobPriority : uint8_t
+    {
+        FrameCritical = 0,
+        Normal = 1,
+        Background = 2,
+    };
+
+    inline constexpr size_t k_job_priority_count = 3;
+
+    // Starvation хамгаалалт: idle worker-ийн job сонголт бүрийн k_job_starvation_interval дахь
+    // удаад lane-уудыг урвуу (Background -> FrameCritical) дарааллаар шалгана. Ингэснээр
+    // frame-critical ажил тасралтгүй ирсэн ч background ажил тогтмол урагшилна. Хүлээх зуураа
+    // туслах (try_run_one) үед хэрэглэхгүй.
+    inline constexpr uint32_t k_job_starvation_interval = 16;
+
+    // tick дахь сонголтын order дахь lane-ийн индекс.
+    inline size_t job_lane_in_pick_order(uint32_t tick, size_t order)
+    {
+        return (tick % k_job_starvation_interval == 0) ? (k_job_priority_count - 1 - order) : order;
+    }
+
     class IJobSystem
     {
     public:
         virtual ~IJobSystem() = default;
-        virtual void enqueue(std::function<void()> job) = 0;
+
+        void enqueue(std::function<void()> job)
+        {
+            enqueue(std::move(job), JobPriority::Normal);
+        }
+
+        // Ажлыг async гүйцэтгэлд илгээнэ. Job нь дуудагч thread дээр enqueue дотроос хэзээ ч
+        // (inline) ажиллахгүй: дуудагч lock барьж байсан ч, дараа илгээх ах дүү job-оо хүлээдэг
+        // job илгээсэн ч deadlock үүсэхгүй. Хязгаартай дараалалтай хэрэгжүүлэлт дүүрсэн үедээ
+        // overflow жагсаалт руу хийнэ (WorkStealingJobSystem::overflow_count()).
+        virtual void enqueue(std::function<void()> job, JobPriority priority) = 0;
+
+        void enqueue_batch(JobRecord* jobs, size_t count)
+        {
+            enqueue_batch(jobs, count, JobPriority::Normal);
+        }
+
+        // Дараалсан count бичлэгийг нэг дор илгээнэ. Бичлэгүүд гүйцэтгэгдэх хүртэл
+        // дуудагч тал амьд байлгана. enqueue-тэй адил inline ажиллуулахгүй.
+        // Default хэрэгжүүлэлт нь бичлэг бүрийг enqueue руу дамжуулна.
+        virtual void enqueue_batch(JobRecord* jobs, size_t count, JobPriority priority)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                JobRecord* r = jobs + i;
+                enqueue([r]() { r->execute(); }, priority);
+            }
+        }
+
+        // Дараалалд хүлээгдэж буй нэг ажлыг дуудагч thread дээр гүйцэтгэнэ.
+        // WaitGroup::wait_help-ээс дуудагдана. Зөвхөн min_priority буюу түүнээс чухал lane-уудаас
+        // priority дарааллаар авна: FrameCritical хүлээгч урт Background ажил (IBL bake, asset
+        // decode) авч frame-ээ гацаахгүй. Ажил олдоогүй бол false.
+        virtual bool try_run_one(JobPriority min_priority)
+        {
+            (void)min_priority;
+            return false;
+        }
+
         virtual void wait_idle() = 0;
         virtual size_t worker_count() const = 0;
     };
 }
-
@@ -0,0 +1,160 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: mpmc_queue.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Хязгаартай багтаамжтай, lock-гүй multi-producer/multi-consumer дараалал
+            (Dmitry Vyukov-ийн sequence-тэй ring buffer загвар).
+*/
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "shs/job/spin_pause.hpp"
+
+namespace shs
+{
+    template<typename T>
+    class BoundedMPMCQueue
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "BoundedMPMCQueue stores trivially copyable handles");
+
+    public:
+        explicit BoundedMPMCQueue(size_t capacity = 4096)
+        {
+            size_t cap = 2;
+            while (cap < capacity) cap <<= 1;
+            mask_ = cap - 1;
+            cells_.reset(new Cell[cap]);
+            for (size_t i = 0; i < cap; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+        BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+
+        // Дүүрсэн үед false буцаана. Дуудагч өөрөө fallback шийднэ.
+        bool try_push(T v)
+        {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell* c = nullptr;
+            while (true)
+            {
+                c = &cells_[pos & mask_];
+                const size_t seq = c->seq.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            c->value = v;
+            c->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // count элементийг нэг CAS-аар дараалсан байрлалд нийтэлнэ. Бүгд багтахгүй бол false.
+        // value_at(i) нь i дэх элементийг буцаана.
+        template<typename ValueAt>
+        bool try_push_bulk(size_t count, ValueAt&& value_at)
+        {
+            if (count == 0) return true;
+            if (count > mask_ + 1) return false;
+
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                const size_t first_seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+                const size_t last = pos + count - 1;
+                const size_t last_seq = cells_[last & mask_].seq.load(std::memory_order_acquire);
+                const intptr_t diff_first = (intptr_t)first_seq - (intptr_t)pos;
+                const intptr_t diff_last = (intptr_t)last_seq - (intptr_t)last;
+                if (diff_first == 0 && diff_last == 0)
+                {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) break;
+                }
+                else if (diff_first < 0 || diff_last < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                Cell& c = cells_[(pos + i) & mask_];
+                // Сүүлчийн нүд чөлөөтэй тул завсрын нүднүүдийг consumer аль хэдийн авсан,
+                // зөвхөн seq-ээ буцааж тавих хүртэл богино хугацаанд хүлээнэ.
+                while (c.seq.load(std::memory_order_acquire) != pos + i) cpu_relax();
+                c.value = value_at(i);
+                c.seq.store(pos + i + 1, std::memory_order_release);
+            }
+            return true;
+        }
+
+        bool try_pop(T& out)
+        {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Cell* c = nullptr;
+            while (true)
+            {
+                c = &cells_[pos & mask_];
+                const size_t seq = c->seq.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0)
+                {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            out = c->value;
+            c->seq.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty_approx() const
+        {
+            return enqueue_pos_.load(std::memory_order_relaxed) == dequeue_pos_.load(std::memory_order_relaxed);
+        }
+
+        size_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> seq{0};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> cells_{};
+        size_t mask_ = 0;
+        alignas(64) std::atomic<size_t> enqueue_pos_{0};
+        alignas(64) std::atomic<size_t> dequeue_pos_{0};
+    };
+}
@@ -13,18 +13,31 @@
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <utility>
 
+#include "shs/job/job_arena.hpp"
 #include "shs/job/job_system.hpp"
 #include "shs/job/wait_group.hpp"
 
 namespace shs
 {
+    struct ParallelForOptions
+    {
+        // true үед дуудагч thread эхний chunk-ийг өөрөө ажиллуулж, дараа нь
+        // дараалалд үлдсэн chunk-уудыг гүйцэтгэн туслана. false үед WaitGroup дээр зүгээр хүлээнэ.
+        bool help_while_waiting = true;
+        // Дуудагч chunk-уудыг шууд хүлээдэг тул default нь frame-critical lane.
+        // Background ажил дотроос дуудахдаа Background-ийг дамжуулна.
+        JobPriority priority = JobPriority::FrameCritical;
+    };
+
     template<typename Fn>
     inline void parallel_for_1d(
         IJobSystem* js,
         int begin,
         int end,
         int min_grain,
+        const ParallelForOptions& opts,
         Fn&& fn
     )
     {
@@ -42,19 +55,65 @@ namespace shs
         const int chunks = std::max(1, std::min(workers * 2, (count + min_grain - 1) / std::max(1, min_grain)));
         const int chunk_size = (count + chunks - 1) / chunks;
 
+        // Chunk бичлэгүүд thread-local arena-аас авагдаж, scope дуусахад буцна.
+        // Ингэснээр frame бүрийн pass-ууд heap allocation хийхгүй.
+        JobArenaScope arena_scope{thread_job_arena()};
+        JobRecord* records = arena_scope.allocate((size_t)chunks);
+        int record_count = 0;
+
+        // Help горимд эхний chunk-ийг дараалалд оруулахгүй, дуудагч өөрөө ажиллуулна.
+        const int first_queued = opts.help_while_waiting ? 1 : 0;
+
         WaitGroup wg{};
-        for (int i = 0; i < chunks; ++i)
+        for (int i = first_queued; i < chunks; ++i)
         {
             const int b = begin + i * chunk_size;
             const int e = std::min(end, b + chunk_size);
             if (b >= e) continue;
 
-            wg.add(1);
-            js->enqueue([b, e, &fn, &wg]() {
+            records[record_count++].bind([b, e, &fn, &wg]() {
                 fn(b, e);
                 wg.done();
             });
         }
-        wg.wait();
+        wg.add(record_count);
+        js->enqueue_batch(records, (size_t)record_count, opts.priority);
+
+        if (opts.help_while_waiting)
+        {
+            fn(begin, std::min(end, begin + chunk_size));
+            wg.wait_help(js, opts.priority);
+        }
+        else
+        {
+            wg.wait();
+        }
+    }
+
+    template<typename Fn>
+    inline void parallel_for_1d(
+        IJobSystem* js,
+        int begin,
+        int end,
+        int min_grain,
+        JobPriority priority,
+        Fn&& fn
+    )
+    {
+        ParallelForOptions opts{};
+        opts.priority = priority;
+        parallel_for_1d(js, begin, end, min_grain, opts, std::forward<Fn>(fn));
+    }
+
+    template<typename Fn>
+    inline void parallel_for_1d(
+        IJobSystem* js,
+        int begin,
+        int end,
+        int min_grain,
+        Fn&& fn
+    )
+    {
+        parallel_for_1d(js, begin, end, min_grain, ParallelForOptions{}, std::forward<Fn>(fn));
     }
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: spin_pause.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Spin-wait давталтад CPU-д "хүлээж байна" гэсэн дохио өгөх жижиг туслах функцууд.
+*/
+
+
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace shs
+{
+    // Hyper-thread хөршдөө pipeline-аа тавьж өгөх pause заавар. Бусад архитектурт хоосон.
+    inline void cpu_relax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    // Эхний хэдэн удаа pause, дараа нь OS scheduler-т thread-ээ өгнө.
+    inline void spin_backoff(int iteration)
+    {
+        if (iteration < 16)
+        {
+            for (int i = 0; i < (1 << (iteration >> 2)); ++i) cpu_relax();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
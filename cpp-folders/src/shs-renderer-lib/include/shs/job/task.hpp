@@ -0,0 +1,417 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: task.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: IJobSystem дээр ажилладаг C++20 stackless coroutine (shs::Task<T>).
+            Дэд ажил хүлээх үед worker thread-ийг WaitGroup::wait()-д хаахын оронд
+            coroutine-ийг түр зогсоож, ажил дуусахад job system дээр үргэлжлүүлнэ.
+*/
+
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "shs/job/job_arena.hpp"
+#include "shs/job/job_record.hpp"
+#include "shs/job/job_system.hpp"
+#include "shs/job/wait_group.hpp"
+
+namespace shs
+{
+    template<typename T = void>
+    class Task;
+
+    namespace detail
+    {
+        struct TaskPromiseBase
+        {
+            // Lazy эхлэл: co_await хийх эсвэл sync_wait/start_detached дуудах үед л ажиллана.
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+
+                // Symmetric transfer: хүлээж буй coroutine руу stack өсгөлгүй шилжинэ.
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+                {
+                    std::coroutine_handle<> cont = h.promise().continuation;
+                    return cont ? cont : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept
+            {
+                error = std::current_exception();
+            }
+
+            void rethrow_if_failed()
+            {
+                if (error) std::rethrow_exception(error);
+            }
+
+            std::coroutine_handle<> continuation{};
+            std::exception_ptr error{};
+        };
+
+        template<typename T>
+        struct TaskPromise : TaskPromiseBase
+        {
+            Task<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U&& v)
+            {
+                value.emplace(std::forward<U>(v));
+            }
+
+            T take()
+            {
+                rethrow_if_failed();
+                return std::move(*value);
+            }
+
+            std::optional<T> value{};
+        };
+
+        template<>
+        struct TaskPromise<void> : TaskPromiseBase
+        {
+            Task<void> get_return_object() noexcept;
+            void return_void() noexcept {}
+
+            void take()
+            {
+                rethrow_if_failed();
+            }
+        };
+
+        // sync_wait/start_detached-ийн дотоод eager coroutine. Frame нь дуусмагцаа өөрөө устна.
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { std::terminate(); }
+            };
+        };
+    }
+
+    template<typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        Task() = default;
+        explicit Task(handle_type h) noexcept : h_(h) {}
+
+        Task(Task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (h_) h_.destroy();
+                h_ = std::exchange(other.h_, {});
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            if (h_) h_.destroy();
+        }
+
+        bool valid() const { return (bool)h_; }
+        bool done() const { return !h_ || h_.done(); }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                handle_type h;
+
+                bool await_ready() noexcept { return !h || h.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+                {
+                    h.promise().continuation = caller;
+                    return h;
+                }
+
+                T await_resume()
+                {
+                    return h.promise().take();
+                }
+            };
+            return Awaiter{h_};
+        }
+
+    private:
+        handle_type h_{};
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        inline Task<T> TaskPromise<T>::get_return_object() noexcept
+        {
+            return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept
+        {
+            return Task<void>{std::coroutine_handle<TaskPromise<void>>::from_promise(*this)};
+        }
+    }
+
+    // co_await schedule_on(js): үлдсэн хэсгийг job system-ийн worker дээр үргэлжлүүлнэ.
+    // JobRecord нь awaiter дотор (coroutine frame-д) байрлах тул heap allocation хийхгүй.
+    class ScheduleOnAwaiter
+    {
+    public:
+        ScheduleOnAwaiter(IJobSystem* js, JobPriority priority) : js_(js), priority_(priority) {}
+
+        bool await_ready() const noexcept { return js_ == nullptr; }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            record_.bind([h]() { h.resume(); });
+            js_->enqueue_batch(&record_, 1, priority_);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        IJobSystem* js_ = nullptr;
+        JobPriority priority_ = JobPriority::Normal;
+        JobRecord record_{};
+    };
+
+    inline ScheduleOnAwaiter schedule_on(IJobSystem* js, JobPriority priority = JobPriority::Normal)
+    {
+        return ScheduleOnAwaiter{js, priority};
+    }
+
+    // co_await wait_for(js, wg): WaitGroup тэглэгдэх хүртэл thread хаалгүй зогсоно.
+    // Сүүлийн done() continuation-ийг js-ийн priority lane дээр илгээнэ.
+    class WaitGroupAwaiter
+    {
+    public:
+        WaitGroupAwaiter(IJobSystem* js, WaitGroup& wg, JobPriority priority) : js_(js), wg_(wg), priority_(priority) {}
+
+        bool await_ready() const noexcept { return wg_.is_done(); }
+
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            record_.bind([h]() { h.resume(); });
+            return wg_.set_continuation(&record_, js_, priority_);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        IJobSystem* js_ = nullptr;
+        WaitGroup& wg_;
+        JobPriority priority_ = JobPriority::Normal;
+        JobRecord record_{};
+    };
+
+    inline WaitGroupAwaiter wait_for(IJobSystem* js, WaitGroup& wg, JobPriority priority = JobPriority::Normal)
+    {
+        return WaitGroupAwaiter{js, wg, priority};
+    }
+
+    // co_await run_async(js, fn): fn-ийг job болгон илгээж, дуусахад түүнийг гүйцэтгэсэн
+    // worker дээр үр дүнтэйгээ үргэлжилнэ. js == nullptr бол fn-ийг шууд ажиллуулна.
+    template<typename Fn>
+    class JobAwaiter
+    {
+    public:
+        using result_type = std::invoke_result_t<Fn&>;
+
+        JobAwaiter(IJobSystem* js, Fn fn, JobPriority priority)
+            : js_(js), fn_(std::move(fn)), priority_(priority)
+        {}
+
+        bool await_ready() const noexcept { return js_ == nullptr; }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            record_.bind([this, h]() {
+                invoke();
+                h.resume();
+            });
+            js_->enqueue_batch(&record_, 1, priority_);
+        }
+
+        result_type await_resume()
+        {
+            if (js_ == nullptr) invoke();
+            if constexpr (!std::is_void_v<result_type>)
+            {
+                return std::move(*result_);
+            }
+        }
+
+    private:
+        void invoke()
+        {
+            if constexpr (std::is_void_v<result_type>) fn_();
+            else result_.emplace(fn_());
+        }
+
+        struct Empty {};
+
+        IJobSystem* js_ = nullptr;
+        Fn fn_;
+        JobPriority priority_ = JobPriority::Normal;
+        [[no_unique_address]] std::conditional_t<std::is_void_v<result_type>, Empty, std::optional<result_type>> result_{};
+        JobRecord record_{};
+    };
+
+    template<typename Fn>
+    inline JobAwaiter<std::decay_t<Fn>> run_async(IJobSystem* js, Fn&& fn, JobPriority priority = JobPriority::Normal)
+    {
+        return JobAwaiter<std::decay_t<Fn>>{js, std::forward<Fn>(fn), priority};
+    }
+
+    // parallel_for_1d-ийн coroutine хувилбар: chunk-уудыг илгээж, эхний chunk-ийг дуудагч өөрөө
+    // ажиллуулаад, үлдсэн нь дуусах хүртэл coroutine-ийг зогсооно. Continuation нь chunk-уудтай
+    // ижил priority lane-д орно. Awaiter нь өөрөө coroutine биш
+    // тул frame үүсгэхгүй; chunk бичлэгүүд зогсолтын турш амьд байх ёстой тул thread-local arena
+    // биш дуудагчийн arena-аас авагдана (эзэмшигч нь frame бүрд reset хийнэ).
+    template<typename Fn>
+    class ParallelForAwaiter
+    {
+    public:
+        ParallelForAwaiter(IJobSystem* js, JobArena& arena, int begin, int end, int min_grain, Fn fn, JobPriority priority)
+            : js_(js), arena_(arena), begin_(begin), end_(end), min_grain_(min_grain), fn_(std::move(fn)), priority_(priority)
+        {}
+
+        ParallelForAwaiter(const ParallelForAwaiter&) = delete;
+        ParallelForAwaiter& operator=(const ParallelForAwaiter&) = delete;
+
+        // Chunk-уудыг энд илгээнэ: дуудагчийн chunk дуусахад бусад нь бас дууссан бол зогсохгүй.
+        bool await_ready()
+        {
+            if (end_ <= begin_) return true;
+            const int count = end_ - begin_;
+            if (!js_ || count <= std::max(1, min_grain_))
+            {
+                fn_(begin_, end_);
+                return true;
+            }
+
+            const int workers = (int)std::max<size_t>(1, js_->worker_count());
+            const int chunks = std::max(1, std::min(workers * 2, (count + min_grain_ - 1) / std::max(1, min_grain_)));
+            const int chunk_size = (count + chunks - 1) / chunks;
+
+            JobRecord* records = arena_.allocate((size_t)chunks);
+            int record_count = 0;
+            for (int i = 1; i < chunks; ++i)
+            {
+                const int b = begin_ + i * chunk_size;
+                const int e = std::min(end_, b + chunk_size);
+                if (b >= e) continue;
+                records[record_count++].bind([this, b, e]() {
+                    fn_(b, e);
+                    wg_.done();
+                });
+            }
+            wg_.add(record_count);
+            if (record_count > 0) js_->enqueue_batch(records, (size_t)record_count, priority_);
+
+            fn_(begin_, std::min(end_, begin_ + chunk_size));
+            return wg_.is_done();
+        }
+
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            record_.bind([h]() { h.resume(); });
+            return wg_.set_continuation(&record_, js_, priority_);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        IJobSystem* js_ = nullptr;
+        JobArena& arena_;
+        int begin_ = 0;
+        int end_ = 0;
+        int min_grain_ = 1;
+        Fn fn_;
+        JobPriority priority_ = JobPriority::Normal;
+        WaitGroup wg_{};
+        JobRecord record_{};
+    };
+
+    template<typename Fn>
+    inline ParallelForAwaiter<std::decay_t<Fn>> parallel_for_1d_async(
+        IJobSystem* js,
+        JobArena& arena,
+        int begin,
+        int end,
+        int min_grain,
+        Fn&& fn,
+        JobPriority priority = JobPriority::Normal)
+    {
+        return ParallelForAwaiter<std::decay_t<Fn>>{js, arena, begin, end, min_grain, std::forward<Fn>(fn), priority};
+    }
+
+    // Task-ийг эхлүүлээд дуусахыг нь хүлээнэ. Хүлээх хооронд дуудагч thread job system-ийн
+    // priority буюу түүнээс чухал lane-ийн ажилд тусална.
+    template<typename T>
+    inline T sync_wait(IJobSystem* js, Task<T> task, JobPriority priority = JobPriority::Normal)
+    {
+        WaitGroup wg{};
+        std::exception_ptr error{};
+        std::conditional_t<std::is_void_v<T>, bool, std::optional<T>> result{};
+
+        wg.add(1);
+        [](Task<T>& t, WaitGroup& done_wg, std::exception_ptr& err, auto& out) -> detail::DetachedTask {
+            try
+            {
+                if constexpr (std::is_void_v<T>) co_await std::move(t);
+                else out.emplace(co_await std::move(t));
+            }
+            catch (...)
+            {
+                err = std::current_exception();
+            }
+            done_wg.done();
+        }(task, wg, error, result);
+        wg.wait_help(js, priority);
+
+        if (error) std::rethrow_exception(error);
+        if constexpr (!std::is_void_v<T>) return std::move(*result);
+    }
+
+    // Task<void>-ийг хэн ч хүлээхгүйгээр (fire-and-forget) эхлүүлнэ. Алдаа гарвал std::terminate.
+    inline void start_detached(Task<void> task)
+    {
+        [](Task<void> t) -> detail::DetachedTask {
+            co_await std::move(t);
+        }(std::move(task));
+    }
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: task_graph.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Atomic dependency counter-тэй хөнгөн task graph (Cull -> Record -> Submit гэх мэт
+            frame stage-ийн параллелизм). Граф нэг удаа compile хийгдээд frame бүр
+            allocation-гүйгээр дахин ажиллана. Дууссан node-ийн бэлэн болсон эхний
+            залгамжлагчийг тухайн thread дээр шууд continuation болгон гүйцэтгэнэ.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "shs/job/job_record.hpp"
+#include "shs/job/job_system.hpp"
+#include "shs/job/wait_group.hpp"
+
+namespace shs
+{
+    struct TaskGraphStats
+    {
+        uint32_t nodes_executed = 0;
+        uint32_t nodes_enqueued = 0;
+        uint32_t continuations_inline = 0;
+    };
+
+    class TaskGraph
+    {
+    public:
+        using NodeId = uint32_t;
+        static constexpr NodeId k_invalid_node = 0xffffffffu;
+
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        void clear()
+        {
+            tasks_.clear();
+            labels_.clear();
+            edges_.clear();
+            succ_offsets_.clear();
+            succ_.clear();
+            indegree_.clear();
+            roots_.clear();
+            topo_order_.clear();
+            // Node runtime буферийг хадгалж, дахин build хийхэд allocation гаргахгүй.
+            compiled_ = false;
+        }
+
+        NodeId add_node(std::function<void()> task, std::string label = {})
+        {
+            tasks_.push_back(std::move(task));
+            labels_.push_back(std::move(label));
+            compiled_ = false;
+            return (NodeId)(tasks_.size() - 1);
+        }
+
+        // before дууссаны дараа after эхэлнэ.
+        void add_edge(NodeId before, NodeId after)
+        {
+            if (before == after || before >= tasks_.size() || after >= tasks_.size()) return;
+            edges_.emplace_back(before, after);
+            compiled_ = false;
+        }
+
+        // Ирмэгүүдийг CSR хэлбэрт шилжүүлж, cycle шалгана. Cycle байвал false.
+        bool compile()
+        {
+            const size_t n = tasks_.size();
+            std::sort(edges_.begin(), edges_.end());
+            edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+
+            succ_offsets_.assign(n + 1, 0);
+            indegree_.assign(n, 0);
+            for (const auto& e : edges_)
+            {
+                succ_offsets_[e.first + 1]++;
+                indegree_[e.second]++;
+            }
+            for (size_t i = 0; i < n; ++i) succ_offsets_[i + 1] += succ_offsets_[i];
+            succ_.assign(edges_.size(), 0);
+            {
+                std::vector<uint32_t> cursor(succ_offsets_.begin(), succ_offsets_.end() - 1);
+                for (const auto& e : edges_) succ_[cursor[e.first]++] = e.second;
+            }
+
+            roots_.clear();
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (indegree_[i] == 0) roots_.push_back((NodeId)i);
+            }
+
+            // Kahn-ийн алгоритмаар topo дараалал (serial fallback болон cycle шалгалтад).
+            topo_order_.clear();
+            topo_order_.reserve(n);
+            std::vector<int> deg(indegree_.begin(), indegree_.end());
+            std::vector<NodeId> stack(roots_.rbegin(), roots_.rend());
+            while (!stack.empty())
+            {
+                const NodeId v = stack.back();
+                stack.pop_back();
+                topo_order_.push_back(v);
+                for (uint32_t k = succ_offsets_[v]; k < succ_offsets_[v + 1]; ++k)
+                {
+                    if (--deg[succ_[k]] == 0) stack.push_back(succ_[k]);
+                }
+            }
+
+            if (runtime_capacity_ < n)
+            {
+                runtime_ = std::make_unique<NodeRuntime[]>(n);
+                runtime_capacity_ = n;
+            }
+            compiled_ = topo_order_.size() == n;
+            return compiled_;
+        }
+
+        bool compiled() const { return compiled_; }
+        size_t node_count() const { return tasks_.size(); }
+        const std::string& label(NodeId id) const { return labels_[id]; }
+        const std::vector<NodeId>& topo_order() const { return topo_order_; }
+        const TaskGraphStats& last_stats() const { return stats_; }
+
+        // Графыг бүхэлд нь гүйцэтгээд буцна. Дуудагч thread хүлээх хооронд ажилд тусална.
+        // js байхгүй бол topo дарааллаар serial ажиллана. Cycle-тэй граф dependency-гээ
+        // хангах дараалалгүй тул нэг ч node ажиллуулалгүй false буцаана.
+        [[nodiscard]] bool run(IJobSystem* js, JobPriority priority = JobPriority::Normal)
+        {
+            stats_ = TaskGraphStats{};
+            if (!compiled_ && !compile()) return false;
+
+            const size_t n = tasks_.size();
+            if (n == 0) return true;
+
+            if (!js || js->worker_count() <= 1 || n == 1)
+            {
+                for (NodeId v : topo_order_)
+                {
+                    if (tasks_[v]) tasks_[v]();
+                }
+                stats_.nodes_executed = (uint32_t)n;
+                return true;
+            }
+
+            js_ = js;
+            priority_ = priority;
+            for (size_t i = 0; i < n; ++i)
+            {
+                runtime_[i].pending.store(indegree_[i], std::memory_order_relaxed);
+            }
+            executed_.store(0, std::memory_order_relaxed);
+            enqueued_.store(0, std::memory_order_relaxed);
+            inline_.store(0, std::memory_order_relaxed);
+            wg_.add((int)n);
+
+            // Эхний root-ийг дуудагч thread өөрөө авч, бусдыг нь дараалалд оруулна.
+            for (size_t r = 1; r < roots_.size(); ++r) schedule(roots_[r]);
+            execute_chain(roots_[0]);
+            wg_.wait_help(js, priority);
+
+            stats_.nodes_executed = executed_.load(std::memory_order_relaxed);
+            stats_.nodes_enqueued = enqueued_.load(std::memory_order_relaxed);
+            stats_.continuations_inline = inline_.load(std::memory_order_relaxed);
+            js_ = nullptr;
+            return true;
+        }
+
+    private:
+        struct NodeRuntime
+        {
+            alignas(64) std::atomic<int> pending{0};
+            JobRecord record{};
+        };
+
+        void schedule(NodeId v)
+        {
+            enqueued_.fetch_add(1, std::memory_order_relaxed);
+            JobRecord& rec = runtime_[v].record;
+            rec.bind([this, v]() { execute_chain(v); });
+            js_->enqueue_batch(&rec, 1, priority_);
+        }
+
+        void execute_chain(NodeId v)
+        {
+            while (v != k_invalid_node)
+            {
+                if (tasks_[v]) tasks_[v]();
+                executed_.fetch_add(1, std::memory_order_relaxed);
+
+                NodeId next = k_invalid_node;
+                for (uint32_t k = succ_offsets_[v]; k < succ_offsets_[v + 1]; ++k)
+                {
+                    const NodeId s = succ_[k];
+                    if (runtime_[s].pending.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                    // Бэлэн болсон эхний залгамжлагчийг continuation болгон энэ thread дээр үлдээнэ.
+                    if (next == k_invalid_node) next = s;
+                    else schedule(s);
+                }
+                if (next != k_invalid_node) inline_.fetch_add(1, std::memory_order_relaxed);
+                wg_.done();
+                v = next;
+            }
+        }
+
+        std::vector<std::function<void()>> tasks_{};
+        std::vector<std::string> labels_{};
+        std::vector<std::pair<NodeId, NodeId>> edges_{};
+        std::vector<uint32_t> succ_offsets_{};
+        std::vector<NodeId> succ_{};
+        std::vector<int> indegree_{};
+        std::vector<NodeId> roots_{};
+        std::vector<NodeId> topo_order_{};
+        std::unique_ptr<NodeRuntime[]> runtime_{};
+        size_t runtime_capacity_ = 0;
+        bool compiled_ = false;
+
+        IJobSystem* js_ = nullptr;
+        JobPriority priority_ = JobPriority::Normal;
+        WaitGroup wg_{};
+        std::atomic<uint32_t> executed_{0};
+        std::atomic<uint32_t> enqueued_{0};
+        std::atomic<uint32_t> inline_{0};
+        TaskGraphStats stats_{};
+    };
+}
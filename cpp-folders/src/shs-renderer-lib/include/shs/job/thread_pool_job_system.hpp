@@ -5,20 +5,22 @@
 
     ФАЙЛ: thread_pool_job_system.hpp
     МОДУЛЬ: job
-    ЗОРИЛГО: Энэ файл нь shs-renderer-lib-ийн job модульд хамаарах төрөл/функцийн
-            интерфэйс эсвэл хэрэгжүүлэлтийг тодорхойлно.
+    ЗОРИЛГО: Нэг mutex-тэй энгийн thread pool. Priority lane бүр JobRecord*-ийн өсдөг ring
+            buffer тул enqueue_batch нь steady state-д heap allocation хийхгүй.
 */
 
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "shs/job/job_record.hpp"
 #include "shs/job/job_system.hpp"
 
 namespace shs
@@ -48,25 +50,66 @@ namespace shs
             {
                 if (w.joinable()) w.join();
             }
+            for (auto& lane : jobs_)
+            {
+                while (!lane.empty())
+                {
+                    JobRecord* r = lane.pop();
+                    if (r->heap_owned()) delete r;
+                    else r->reset();
+                }
+            }
         }
 
-        void enqueue(std::function<void()> job) override
+        using IJobSystem::enqueue;
+        using IJobSystem::enqueue_batch;
+
+        // Хуучин API: std::function-ийг heap дээрх JobRecord-д боож илгээнэ.
+        void enqueue(std::function<void()> job, JobPriority priority) override
         {
+            JobRecord* r = new JobRecord();
+            r->bind(std::move(job));
+            r->set_heap_owned(true);
             {
                 std::lock_guard<std::mutex> lock(mtx_);
-                jobs_.push(std::move(job));
+                jobs_[(size_t)priority].push(r);
             }
             cv_.notify_one();
         }
 
+        void enqueue_batch(JobRecord* jobs, size_t count, JobPriority priority) override
+        {
+            if (count == 0) return;
+            {
+                // Batch-ийг нэг lock дор хийнэ.
+                std::lock_guard<std::mutex> lock(mtx_);
+                JobRing& lane = jobs_[(size_t)priority];
+                for (size_t i = 0; i < count; ++i) lane.push(jobs + i);
+            }
+            if (count == 1) cv_.notify_one();
+            else cv_.notify_all();
+        }
+
         void wait_idle() override
         {
             std::unique_lock<std::mutex> lock(mtx_);
             idle_cv_.wait(lock, [this]() {
-                return jobs_.empty() && active_.load(std::memory_order_acquire) == 0;
+                return queued_empty() && active_.load(std::memory_order_acquire) == 0;
             });
         }
 
+        bool try_run_one(JobPriority min_priority) override
+        {
+            JobRecord* job = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if (!pop_next_locked(job, (size_t)min_priority + 1, false)) return false;
+                active_.fetch_add(1, std::memory_order_relaxed);
+            }
+            run_and_retire(job);
+            return true;
+        }
+
         size_t worker_count() const override
         {
             return workers_.size();
@@ -77,31 +120,93 @@ namespace shs
         {
             while (true)
             {
-                std::function<void()> job{};
+                JobRecord* job = nullptr;
                 {
                     std::unique_lock<std::mutex> lock(mtx_);
-                    cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
-                    if (stop_ && jobs_.empty()) return;
-                    job = std::move(jobs_.front());
-                    jobs_.pop();
+                    cv_.wait(lock, [this]() { return stop_ || !queued_empty(); });
+                    if (!pop_next_locked(job, k_job_priority_count, true)) return;
                     active_.fetch_add(1, std::memory_order_relaxed);
                 }
 
-                job();
+                run_and_retire(job);
+            }
+        }
 
-                {
-                    std::lock_guard<std::mutex> lock(mtx_);
-                    active_.fetch_sub(1, std::memory_order_relaxed);
-                    if (jobs_.empty() && active_.load(std::memory_order_relaxed) == 0)
-                    {
-                        idle_cv_.notify_all();
-                    }
-                }
+        void run_and_retire(JobRecord* job)
+        {
+            const bool owned = job->heap_owned();
+            job->execute();
+            if (owned) delete job;
+
+            std::lock_guard<std::mutex> lock(mtx_);
+            active_.fetch_sub(1, std::memory_order_relaxed);
+            if (queued_empty() && active_.load(std::memory_order_relaxed) == 0)
+            {
+                idle_cv_.notify_all();
+            }
+        }
+
+        bool queued_empty() const
+        {
+            for (const auto& lane : jobs_)
+            {
+                if (!lane.empty()) return false;
             }
+            return true;
         }
 
+        // mtx_ түгжигдсэн үед дуудна. Эхний lane_end lane-аас priority дарааллаар сонгоно.
+        // starvation_tick нь зөвхөн idle worker loop-д: туслагч урвуу дарааллаар хэзээ ч шалгахгүй.
+        bool pop_next_locked(JobRecord*& out, size_t lane_end, bool starvation_tick)
+        {
+            const uint32_t tick = starvation_tick ? ++pick_tick_ : 1u;
+            for (size_t k = 0; k < lane_end; ++k)
+            {
+                JobRing& lane = jobs_[job_lane_in_pick_order(tick, k)];
+                if (lane.empty()) continue;
+                out = lane.pop();
+                return true;
+            }
+            return false;
+        }
+
+        // JobRecord*-ийн FIFO ring buffer. Багтаамж нь зөвхөн хоёр дахин өсдөг тул дээд
+        // ачааллаа нэг хүрсний дараа push/pop allocation хийхгүй.
+        struct JobRing
+        {
+            std::vector<JobRecord*> slots = std::vector<JobRecord*>(64, nullptr);
+            size_t head = 0;
+            size_t count = 0;
+
+            bool empty() const { return count == 0; }
+
+            void push(JobRecord* r)
+            {
+                if (count == slots.size()) grow();
+                slots[(head + count) & (slots.size() - 1)] = r;
+                ++count;
+            }
+
+            JobRecord* pop()
+            {
+                JobRecord* r = slots[head];
+                head = (head + 1) & (slots.size() - 1);
+                --count;
+                return r;
+            }
+
+            void grow()
+            {
+                std::vector<JobRecord*> next(slots.size() * 2, nullptr);
+                for (size_t i = 0; i < count; ++i) next[i] = slots[(head + i) & (slots.size() - 1)];
+                slots.swap(next);
+                head = 0;
+            }
+        };
+
         std::vector<std::thread> workers_{};
-        std::queue<std::function<void()>> jobs_{};
+        std::array<JobRing, k_job_priority_count> jobs_{};
+        uint32_t pick_tick_ = 0;
         mutable std::mutex mtx_{};
         std::condition_variable cv_{};
         std::condition_variable idle_cv_{};
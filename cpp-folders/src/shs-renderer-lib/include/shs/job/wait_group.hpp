@@ -11,14 +11,20 @@
 
 
 #include <atomic>
-#include <condition_variable>
-#include <mutex>
+
+#include "shs/job/job_system.hpp"
+#include "shs/job/spin_pause.hpp"
 
 namespace shs
 {
+    // Mutex-гүй WaitGroup. Хүлээгч эхлээд богино хугацаанд spin хийж,
+    // дараа нь std::atomic::wait (Linux дээр futex)-аар унтана.
+    // Мөн нэг coroutine continuation бүртгэж болно (shs/job/task.hpp-ийн wait_for).
     class WaitGroup
     {
     public:
+        static constexpr int k_spin_rounds = 32;
+
         void add(int n = 1)
         {
             count_.fetch_add(n, std::memory_order_relaxed);
@@ -26,23 +32,110 @@ namespace shs
 
         void done()
         {
-            if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            const int prev = count_.fetch_sub(1, std::memory_order_acq_rel);
+            if ((prev & k_count_mask) != 1) return;
+
+            if ((prev & k_continuation_flag) != 0)
             {
-                std::lock_guard<std::mutex> lock(mtx_);
-                cv_.notify_all();
+                // Continuation хүлээж буй coroutine сэрээгдэх хүртэл WaitGroup-ээ устгаж
+                // чадахгүй тул энд гишүүдэд хандах нь аюулгүй.
+                JobRecord* cont = continuation_;
+                IJobSystem* cont_js = continuation_js_;
+                const JobPriority cont_priority = continuation_priority_;
+                continuation_ = nullptr;
+                continuation_js_ = nullptr;
+                count_.fetch_and(~k_continuation_flag, std::memory_order_acq_rel);
+                count_.notify_all();
+                if (cont_js) cont_js->enqueue_batch(cont, 1, cont_priority);
+                else cont->execute();
+                return;
             }
+
+            // notify нь хаягаар л futex сэрээдэг тул хүлээгч WaitGroup-ээ устгасан ч
+            // объектын санах ойд хандахгүй (std::latch-тай ижил загвар).
+            count_.notify_all();
+        }
+
+        bool is_done() const
+        {
+            return (count_.load(std::memory_order_acquire) & k_count_mask) == 0;
+        }
+
+        // Тоолуур 0 болоход cont-ийг js-ийн priority lane дээр (js == nullptr бол done() дуудсан
+        // thread дээр) гүйцэтгэнэ. priority нь хүлээгчийнхтэй ижил байх ёстой: wait_help зөвхөн
+        // түүнээс чухал lane-д тусалдаг тул доогуур lane-д орсон continuation-ийг хүлээгч авахгүй.
+        // Аль хэдийн 0 байвал юу ч бүртгэхгүйгээр false буцаана. Нэг удаад зөвхөн нэг continuation.
+        bool set_continuation(JobRecord* cont, IJobSystem* js, JobPriority priority)
+        {
+            continuation_ = cont;
+            continuation_js_ = js;
+            continuation_priority_ = priority;
+            const int prev = count_.fetch_or(k_continuation_flag, std::memory_order_acq_rel);
+            if ((prev & k_count_mask) != 0) return true;
+
+            count_.fetch_and(~k_continuation_flag, std::memory_order_relaxed);
+            continuation_ = nullptr;
+            continuation_js_ = nullptr;
+            return false;
         }
 
         void wait()
         {
-            std::unique_lock<std::mutex> lock(mtx_);
-            cv_.wait(lock, [&]() { return count_.load(std::memory_order_acquire) == 0; });
+            for (int i = 0; i < k_spin_rounds; ++i)
+            {
+                if (is_done()) return;
+                spin_backoff(i);
+            }
+            park();
+        }
+
+        // Хүлээх хооронд job system-ийн дараалалд байгаа ажлыг дуудагч thread өөрөө гүйцэтгэнэ.
+        // Worker дотроос nested parallel_for дуудахад deadlock үүсэхээс сэргийлнэ.
+        // priority нь хүлээгчийн өөрийн lane: түүнээс бага ач холбогдолтой ажилд тусалахгүй.
+        void wait_help(IJobSystem* js, JobPriority priority)
+        {
+            if (!js)
+            {
+                wait();
+                return;
+            }
+
+            int idle_rounds = 0;
+            while (!is_done())
+            {
+                if (js->try_run_one(priority))
+                {
+                    idle_rounds = 0;
+                    continue;
+                }
+                if (idle_rounds >= k_spin_rounds)
+                {
+                    // Гүйцэтгэх ажил үлдээгүй: үлдсэн chunk-ууд бусад thread дээр явж байна.
+                    park();
+                    return;
+                }
+                spin_backoff(idle_rounds++);
+            }
         }
 
     private:
+        // Дээд бит нь бүртгэгдсэн continuation-ийг тэмдэглэнэ; тоолуур доод битүүдэд.
+        static constexpr int k_continuation_flag = 1 << 30;
+        static constexpr int k_count_mask = k_continuation_flag - 1;
+
+        void park()
+        {
+            int v = count_.load(std::memory_order_acquire);
+            while ((v & k_count_mask) != 0)
+            {
+                count_.wait(v, std::memory_order_acquire);
+                v = count_.load(std::memory_order_acquire);
+            }
+        }
+
         std::atomic<int> count_{0};
-        std::mutex mtx_{};
-        std::condition_variable cv_{};
+        JobRecord* continuation_ = nullptr;
+        IJobSystem* continuation_js_ = nullptr;
+        JobPriority continuation_priority_ = JobPriority::Normal;
     };
 }
-
@@ -0,0 +1,151 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: work_stealing_deque.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Chase-Lev work-stealing deque. Эзэмшигч worker доод үзүүрээс push/pop хийж,
+            бусад worker-ууд дээд үзүүрээс lock-гүйгээр хулгайлна.
+            Санах ойн дараалал нь Lê, Pop, Cohen, Zappa Nardelli (PPoPP 2013)-ийн
+            weak memory model-д зориулсан хувилбарыг дагана.
+*/
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace shs
+{
+    template<typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque stores trivially copyable handles");
+
+    public:
+        explicit WorkStealingDeque(size_t capacity = 1024)
+        {
+            size_t cap = 16;
+            while (cap < capacity) cap <<= 1;
+            rings_.push_back(std::make_unique<Ring>(cap));
+            ring_.store(rings_.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // Зөвхөн эзэмшигч thread дуудна.
+        void push(T v)
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_acquire);
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            if (b - t > (int64_t)r->capacity - 1)
+            {
+                r = grow(r, t, b);
+            }
+            r->put(b, v);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // Зөвхөн эзэмшигч thread дуудна. LIFO тул cache-д халуун байгаа ажлыг түрүүлж авна.
+        bool pop(T& out)
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            out = r->get(b);
+            if (t == b)
+            {
+                // Сүүлчийн элемент дээр хулгайчтай уралдана.
+                const bool won = top_.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // Дурын thread дуудаж болно. FIFO үзүүрээс хамгийн хуучин ажлыг авна.
+        bool steal(T& out)
+        {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) return false;
+
+            Ring* r = ring_.load(std::memory_order_acquire);
+            const T v = r->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return false;
+            }
+            out = v;
+            return true;
+        }
+
+        size_t size_approx() const
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? (size_t)(b - t) : 0;
+        }
+
+        bool empty_approx() const
+        {
+            return size_approx() == 0;
+        }
+
+    private:
+        struct Ring
+        {
+            explicit Ring(size_t cap)
+                : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap])
+            {}
+
+            void put(int64_t i, T v)
+            {
+                slots[(size_t)i & mask].store(v, std::memory_order_relaxed);
+            }
+
+            T get(int64_t i) const
+            {
+                return slots[(size_t)i & mask].load(std::memory_order_relaxed);
+            }
+
+            size_t capacity = 0;
+            size_t mask = 0;
+            std::unique_ptr<std::atomic<T>[]> slots{};
+        };
+
+        Ring* grow(Ring* old, int64_t t, int64_t b)
+        {
+            // Хуучин ring-ийг хулгайч уншиж байж болох тул deque устах хүртэл хадгална.
+            auto next = std::make_unique<Ring>(old->capacity * 2);
+            for (int64_t i = t; i < b; ++i) next->put(i, old->get(i));
+            Ring* raw = next.get();
+            rings_.push_back(std::move(next));
+            ring_.store(raw, std::memory_order_release);
+            return raw;
+        }
+
+        alignas(64) std::atomic<int64_t> top_{0};
+        alignas(64) std::atomic<int64_t> bottom_{0};
+        alignas(64) std::atomic<Ring*> ring_{nullptr};
+        std::vector<std::unique_ptr<Ring>> rings_{};
+    };
+}
@@ -0,0 +1,425 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: work_stealing_job_system.hpp
+    МОДУЛЬ: job
+    ЗОРИЛГО: Worker бүр өөрийн Chase-Lev deque-тэй work-stealing job system.
+            Worker дотроос enqueue хийсэн ажил тухайн worker-ийн deque рүү орж,
+            гаднаас ирсэн ажил lock-гүй injection дараалалд орно. Сул worker бусдаас хулгайлна.
+            Deque болон injection дараалал JobPriority бүрт тусдаа lane-тэй.
+*/
+
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "shs/job/job_record.hpp"
+#include "shs/job/job_system.hpp"
+#include "shs/job/mpmc_queue.hpp"
+#include "shs/job/spin_pause.hpp"
+#include "shs/job/work_stealing_deque.hpp"
+
+namespace shs
+{
+    struct WorkStealingJobSystemConfig
+    {
+        size_t deque_capacity = 1024;
+        // Priority lane бүрийн injection дарааллын багтаамж. Дүүрвэл илүүдэл нь lane-ийн
+        // overflow жагсаалт руу орно (overflow_count()).
+        size_t injection_capacity = 4096;
+        // Унтахаас өмнө ажил хайх давталтын тоо.
+        int spin_rounds = 64;
+    };
+
+    class WorkStealingJobSystem final : public IJobSystem
+    {
+    public:
+        explicit WorkStealingJobSystem(size_t worker_count, const WorkStealingJobSystemConfig& cfg = {})
+            : cfg_(cfg)
+            , injection_{{
+                BoundedMPMCQueue<JobPtr>(cfg.injection_capacity),
+                BoundedMPMCQueue<JobPtr>(cfg.injection_capacity),
+                BoundedMPMCQueue<JobPtr>(cfg.injection_capacity)}}
+        {
+            const size_t n = worker_count == 0 ? 1 : worker_count;
+            workers_.reserve(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                workers_.push_back(std::make_unique<Worker>(cfg_.deque_capacity, (uint32_t)(i * 2654435761u + 1u)));
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                workers_[i]->thread = std::thread([this, i]() { worker_loop(i); });
+            }
+        }
+
+        ~WorkStealingJobSystem() override
+        {
+            stop_.store(true, std::memory_order_seq_cst);
+            wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            wake_epoch_.notify_all();
+            for (auto& w : workers_)
+            {
+                if (w->thread.joinable()) w->thread.join();
+            }
+
+            // Зогсоох үед үлдсэн ажлууд байвал санах ойг нь чөлөөлнө.
+            JobPtr j = nullptr;
+            for (auto& q : injection_)
+            {
+                while (q.try_pop(j)) discard_job(j);
+            }
+            for (auto& o : overflow_)
+            {
+                for (JobPtr r : o.jobs) discard_job(r);
+                o.jobs.clear();
+            }
+            for (auto& w : workers_)
+            {
+                for (auto& dq : w->deques)
+                {
+                    while (dq.pop(j)) discard_job(j);
+                }
+            }
+        }
+
+        using IJobSystem::enqueue;
+        using IJobSystem::enqueue_batch;
+
+        // Хуучин API: std::function-ийг heap дээрх JobRecord-д боож илгээнэ.
+        void enqueue(std::function<void()> job, JobPriority priority) override
+        {
+            JobRecord* r = new JobRecord();
+            r->bind(std::move(job));
+            r->set_heap_owned(true);
+            submit(r, priority);
+        }
+
+        void enqueue_batch(JobRecord* jobs, size_t count, JobPriority priority) override
+        {
+            if (count == 0) return;
+            outstanding_.fetch_add((int)count, std::memory_order_relaxed);
+
+            const size_t lane = (size_t)priority;
+            const TlsWorker& tls = tls_worker();
+            if (tls.owner == this)
+            {
+                WorkStealingDeque<JobPtr>& dq = workers_[tls.index]->deques[lane];
+                for (size_t i = 0; i < count; ++i) dq.push(jobs + i);
+            }
+            else if (!injection_[lane].try_push_bulk(count, [jobs](size_t i) { return jobs + i; }))
+            {
+                // Бүхэлд нь багтаагүй бол багтсанаараа нь оруулж, үлдсэнийг overflow руу.
+                size_t i = 0;
+                while (i < count && injection_[lane].try_push(jobs + i)) ++i;
+                push_overflow(lane, jobs + i, count - i);
+            }
+            wake_many(count);
+        }
+
+        void wait_idle() override
+        {
+            int v = outstanding_.load(std::memory_order_acquire);
+            while (v != 0)
+            {
+                outstanding_.wait(v, std::memory_order_acquire);
+                v = outstanding_.load(std::memory_order_acquire);
+            }
+        }
+
+        bool try_run_one(JobPriority min_priority) override
+        {
+            JobPtr j = nullptr;
+            const size_t lane_end = (size_t)min_priority + 1;
+            const TlsWorker& tls = tls_worker();
+            if (tls.owner == this)
+            {
+                if (!find_job(tls.index, j, lane_end, false)) return false;
+            }
+            else if (!find_external_job(j, lane_end))
+            {
+                return false;
+            }
+            run_job(j);
+            return true;
+        }
+
+        size_t worker_count() const override
+        {
+            return workers_.size();
+        }
+
+        // Одоогийн thread энэ pool-ийн worker мөн эсэх.
+        bool on_worker_thread() const
+        {
+            return tls_worker().owner == this;
+        }
+
+        uint64_t steal_count() const
+        {
+            return steals_.load(std::memory_order_relaxed);
+        }
+
+        // Injection дараалал дүүрсэн тул overflow жагсаалт руу орсон job-ийн нийт тоо. Тэг биш бол
+        // injection_capacity-г томруулах хэрэгтэй (overflow нь mutex-тэй, өсөхдөө allocate хийнэ).
+        uint64_t overflow_count() const
+        {
+            return overflow_pushes_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        using JobPtr = JobRecord*;
+
+        struct alignas(64) Worker
+        {
+            Worker(size_t deque_capacity, uint32_t seed)
+                : deques{{
+                    WorkStealingDeque<JobPtr>(deque_capacity),
+                    WorkStealingDeque<JobPtr>(deque_capacity),
+                    WorkStealingDeque<JobPtr>(deque_capacity)}}
+                , rng(seed)
+            {}
+
+            std::array<WorkStealingDeque<JobPtr>, k_job_priority_count> deques;
+            std::thread thread{};
+            uint32_t rng = 1;
+            uint32_t pick_tick = 0;
+        };
+
+        // Injection lane дүүрсэн үеийн FIFO нөөц. Ховор зам тул энгийн mutex; size нь хоосон
+        // үед lock авалгүй алгасахад.
+        struct Overflow
+        {
+            std::mutex mtx{};
+            std::deque<JobPtr> jobs{};
+            std::atomic<size_t> size{0};
+        };
+
+        struct TlsWorker
+        {
+            const WorkStealingJobSystem* owner = nullptr;
+            size_t index = 0;
+        };
+
+        static TlsWorker& tls_worker()
+        {
+            static thread_local TlsWorker tls{};
+            return tls;
+        }
+
+        void submit(JobPtr j, JobPriority priority)
+        {
+            outstanding_.fetch_add(1, std::memory_order_relaxed);
+
+            const size_t lane = (size_t)priority;
+            const TlsWorker& tls = tls_worker();
+            if (tls.owner == this)
+            {
+                workers_[tls.index]->deques[lane].push(j);
+            }
+            else if (!injection_[lane].try_push(j))
+            {
+                push_overflow(lane, j, 1);
+            }
+            wake_one();
+        }
+
+        // first-ээс эхэлсэн дараалсан count бичлэг.
+        void push_overflow(size_t lane, JobPtr first, size_t count)
+        {
+            if (count == 0) return;
+            Overflow& o = overflow_[lane];
+            {
+                std::lock_guard<std::mutex> lock(o.mtx);
+                for (size_t i = 0; i < count; ++i) o.jobs.push_back(first + i);
+                o.size.store(o.jobs.size(), std::memory_order_release);
+            }
+            overflow_pushes_.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        bool pop_overflow(size_t lane, JobPtr& out)
+        {
+            Overflow& o = overflow_[lane];
+            if (o.size.load(std::memory_order_acquire) == 0) return false;
+            std::lock_guard<std::mutex> lock(o.mtx);
+            if (o.jobs.empty()) return false;
+            out = o.jobs.front();
+            o.jobs.pop_front();
+            o.size.store(o.jobs.size(), std::memory_order_release);
+            return true;
+        }
+
+        void wake_one()
+        {
+            wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0)
+            {
+                wake_epoch_.notify_one();
+            }
+        }
+
+        void wake_many(size_t count)
+        {
+            if (count <= 1)
+            {
+                wake_one();
+                return;
+            }
+            wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0)
+            {
+                wake_epoch_.notify_all();
+            }
+        }
+
+        void run_job(JobPtr j)
+        {
+            const bool owned = j->heap_owned();
+            j->execute();
+            if (owned) delete j;
+            if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                outstanding_.notify_all();
+            }
+        }
+
+        static void discard_job(JobPtr j)
+        {
+            if (j->heap_owned()) delete j;
+            else j->reset();
+        }
+
+        // Эхний lane_end lane-ийг priority дарааллаар шалгана; starvation_tick үед (зөвхөн idle
+        // worker loop) tick дээр урвуу. Lane дотор: өөрийн deque -> injection -> overflow -> хулгайлах.
+        bool find_job(size_t self, JobPtr& out, size_t lane_end, bool starvation_tick)
+        {
+            Worker& me = *workers_[self];
+            const size_t n = workers_.size();
+
+            // xorshift-ээр санамсаргүй хохирогч сонгож, бүх worker-ийг нэг тойрно.
+            me.rng ^= me.rng << 13;
+            me.rng ^= me.rng >> 17;
+            me.rng ^= me.rng << 5;
+            const size_t start = (size_t)me.rng % n;
+            const uint32_t tick = starvation_tick ? ++me.pick_tick : 1u;
+
+            for (size_t k = 0; k < lane_end; ++k)
+            {
+                const size_t lane = job_lane_in_pick_order(tick, k);
+                if (me.deques[lane].pop(out)) return true;
+                if (injection_[lane].try_pop(out)) return true;
+                if (pop_overflow(lane, out)) return true;
+
+                for (size_t v = 0; v < n; ++v)
+                {
+                    const size_t victim = (start + v) % n;
+                    if (victim == self) continue;
+                    if (workers_[victim]->deques[lane].steal(out))
+                    {
+                        steals_.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Worker биш thread (жишээ нь main) хүлээж байхдаа injection болон worker-уудын
+        // deque-ээс эхний lane_end lane-аас priority дарааллаар ажил авна.
+        bool find_external_job(JobPtr& out, size_t lane_end)
+        {
+            const size_t n = workers_.size();
+            const uint32_t cursor = external_steal_cursor_.fetch_add(1, std::memory_order_relaxed);
+            const size_t start = (size_t)cursor % n;
+            for (size_t lane = 0; lane < lane_end; ++lane)
+            {
+                if (injection_[lane].try_pop(out)) return true;
+                if (pop_overflow(lane, out)) return true;
+                for (size_t v = 0; v < n; ++v)
+                {
+                    if (workers_[(start + v) % n]->deques[lane].steal(out))
+                    {
+                        steals_.fetch_add(1, std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void worker_loop(size_t self)
+        {
+            TlsWorker& tls = tls_worker();
+            tls.owner = this;
+            tls.index = self;
+
+            JobPtr j = nullptr;
+            while (true)
+            {
+                if (find_job(self, j, k_job_priority_count, true))
+                {
+                    run_job(j);
+                    continue;
+                }
+
+                bool found = false;
+                for (int i = 0; i < cfg_.spin_rounds && !found; ++i)
+                {
+                    spin_backoff(i);
+                    found = find_job(self, j, k_job_priority_count, true);
+                }
+                if (found)
+                {
+                    run_job(j);
+                    continue;
+                }
+
+                // Унтахын өмнө epoch-оо авч, sleeper гэж бүртгүүлээд дахин шалгана.
+                // enqueue талын epoch нэмэгдэл нь wait()-ийг шууд буцаах тул wakeup алдагдахгүй.
+                const uint32_t epoch = wake_epoch_.load(std::memory_order_seq_cst);
+                if (stop_.load(std::memory_order_seq_cst))
+                {
+                    if (find_job(self, j, k_job_priority_count, true))
+                    {
+                        run_job(j);
+                        continue;
+                    }
+                    break;
+                }
+                sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                if (find_job(self, j, k_job_priority_count, true))
+                {
+                    sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+                    run_job(j);
+                    continue;
+                }
+                wake_epoch_.wait(epoch, std::memory_order_seq_cst);
+                sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            }
+
+            tls.owner = nullptr;
+        }
+
+        WorkStealingJobSystemConfig cfg_{};
+        std::vector<std::unique_ptr<Worker>> workers_{};
+        std::array<BoundedMPMCQueue<JobPtr>, k_job_priority_count> injection_;
+        std::array<Overflow, k_job_priority_count> overflow_{};
+        alignas(64) std::atomic<int> outstanding_{0};
+        alignas(64) std::atomic<uint32_t> wake_epoch_{0};
+        std::atomic<int> sleepers_{0};
+        std::atomic<bool> stop_{false};
+        std::atomic<uint64_t> steals_{0};
+        std::atomic<uint64_t> overflow_pushes_{0};
+        std::atomic<uint32_t> external_steal_cursor_{0};
+    };
+}
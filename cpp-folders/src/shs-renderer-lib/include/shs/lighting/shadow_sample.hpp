@@ -12,6 +12,7 @@
 #include <glm/glm.hpp>
 #include <algorithm>
 #include <shs/gfx/rt_shadow.hpp>
+#include <shs/gfx/rt_types.hpp>
 
 namespace shs {
 
@@ -55,15 +56,17 @@ inline float shadow_bias(
     return bias_const + bias_slope * slope;
 }
 
-inline float shadow_fetch_depth_clamped(const RT_ShadowDepth& sm, int x, int y){
-    x = std::clamp(x, 0, sm.w - 1);
-    y = std::clamp(y, 0, sm.h - 1);
-    return sm.at(x,y);
+// TShadowMap: w/h/at(x,y)-тай дурын depth buffer (RT_ShadowDepth эсвэл
+// convert_pixel_layout-оор гаргасан tiled PixelBuffer2D<float, ...>).
+template<typename TShadowMap>
+inline float shadow_fetch_depth_clamped(const TShadowMap& sm, int x, int y){
+    return pixel_fetch_clamped(sm, x, y);
 }
 
 // returns visibility in [0..1] (1 = lit, 0 = fully shadowed)
+template<typename TShadowMap>
 inline float shadow_visibility_dir(
-    const RT_ShadowDepth& sm,
+    const TShadowMap& sm,
     const ShadowParams& sp,
     const glm::vec3& pos_ws,
     float ndotl
@@ -15,6 +15,7 @@
 #include "shs/gfx/rt_handle.hpp"
 #include "shs/gfx/rt_registry.hpp"
 #include "shs/job/parallel_for.hpp"
+#include "shs/job/task.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -41,177 +42,234 @@ namespace shs
             RTHandle rt_shafts_tmp{};
         };
 
-        void execute(Context& ctx, const Inputs& in)
+        struct ShaftsKernelParams
         {
-            if (!in.scene || !in.fp || !in.rtr) return;
-            if (!in.rt_input_ldr.valid() || !in.rt_output_ldr.valid()) return;
+            glm::vec2 sun_uv{0.5f, 0.2f};
+            int steps = 48;
+            float density = 0.8f;
+            float weight = 0.9f;
+            float decay = 0.95f;
+        };
 
-            auto* inldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_input_ldr));
-            auto* outldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_output_ldr));
-            if (!inldr || !outldr || inldr->w <= 0 || inldr->h <= 0 || outldr->w <= 0 || outldr->h <= 0) return;
+        // Scene camera + нарны чиглэлээс нарны дэлгэцийн uv-г тооцно. Нар камерын урд, дэлгэц дотор
+        // проекцлогдсон үед л true.
+        static bool sun_screen_uv(const Scene& scene, glm::vec2& out_uv)
+        {
+            out_uv = glm::vec2(0.5f, 0.2f);
+            const glm::vec3 sun_pos_ws = scene.cam.pos + (-scene.sun.dir_ws) * 100.0f;
+            const glm::vec4 clip = scene.cam.viewproj * glm::vec4(sun_pos_ws, 1.0f);
+            if (std::abs(clip.w) <= 1e-6f) return false;
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            out_uv = glm::vec2(ndc.x * 0.5f + 0.5f, ndc.y * 0.5f + 0.5f);
+            return (clip.w > 0.0f) &&
+                   (ndc.z >= -1.0f && ndc.z <= 1.0f) &&
+                   (out_uv.x >= 0.0f && out_uv.x <= 1.0f) &&
+                   (out_uv.y >= 0.0f && out_uv.y <= 1.0f);
+        }
 
-            // Light shafts унтраалттай үед input-ийг output руу шууд дамжуулна.
-            if (!in.fp->pass.light_shafts.enable)
-            {
-                if (inldr == outldr) return;
-                const int w = std::min(inldr->w, outldr->w);
-                const int h = std::min(inldr->h, outldr->h);
-                parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
-                {
-                    for (int y = yb; y < ye; ++y)
-                    {
-                        for (int x = 0; x < w; ++x) outldr->color.at(x, y) = inldr->color.at(x, y);
-                    }
-                });
-                return;
-            }
+        static ShaftsKernelParams kernel_params(const FrameParams& fp, const glm::vec2& sun_uv)
+        {
+            ShaftsKernelParams kp{};
+            kp.sun_uv = sun_uv;
+            kp.steps = std::max(8, fp.pass.light_shafts.steps);
+            kp.density = std::max(0.0f, fp.pass.light_shafts.density);
+            kp.weight = std::max(0.0f, fp.pass.light_shafts.weight);
+            kp.decay = std::clamp(fp.pass.light_shafts.decay, 0.0f, 1.0f);
+            return kp;
+        }
 
-            auto* depth_like = in.rt_depth_like.valid() ? static_cast<RT_ColorDepthMotion*>(in.rtr->get(in.rt_depth_like)) : nullptr;
-            auto* tmp = in.rt_shafts_tmp.valid() ? static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_shafts_tmp)) : nullptr;
+        static float luma(const Color& c)
+        {
+            const float r = (float)c.r / 255.0f;
+            const float g = (float)c.g / 255.0f;
+            const float b = (float)c.b / 255.0f;
+            return 0.2126f * r + 0.7152f * g + 0.0722f * b;
+        }
 
-            const int w = std::min(inldr->w, outldr->w);
-            const int h = std::min(inldr->h, outldr->h);
-            if (tmp && (tmp->w != w || tmp->h != h)) tmp = nullptr;
-            const bool in_place_no_tmp = (tmp == nullptr && inldr == outldr);
+        // (x, y) пикселээс нар руу luma-г ray march хийж base өнгөнд нэмнэ. luma нь w*h мөр дараалсан;
+        // depth_like (w x h хэмжээтэй эсвэл nullptr) нь ойрын объектын ард shafts-ийг дарна.
+        static Color shaft_pixel(
+            const Color& base,
+            int x,
+            int y,
+            int w,
+            int h,
+            const float* luma_wh,
+            const PixelBuffer2D<float>* depth_like,
+            const ShaftsKernelParams& kp)
+        {
+            const float u = (float)x / (float)std::max(1, w - 1);
+            const float v = (float)y / (float)std::max(1, h - 1);
 
-            // Estimate sun position on screen from scene camera + sun direction.
-            glm::vec2 sun_uv(0.5f, 0.2f);
-            bool sun_valid = false;
+            float illum_decay = 1.0f;
+            float accum = 0.0f;
+            for (int i = 0; i < kp.steps; ++i)
             {
-                const glm::vec3 sun_pos_ws = in.scene->cam.pos + (-in.scene->sun.dir_ws) * 100.0f;
-                const glm::vec4 clip = in.scene->cam.viewproj * glm::vec4(sun_pos_ws, 1.0f);
-                if (std::abs(clip.w) > 1e-6f)
+                const float t = (float)i / (float)kp.steps;
+                const float su = u + (kp.sun_uv.x - u) * t * kp.density;
+                const float sv = v + (kp.sun_uv.y - v) * t * kp.density;
+                const int sx = std::clamp((int)std::lround(su * (float)(w - 1)), 0, w - 1);
+                const int sy = std::clamp((int)std::lround(sv * (float)(h - 1)), 0, h - 1);
+
+                float s = luma_wh[(size_t)sy * (size_t)w + (size_t)sx];
+                if (depth_like)
                 {
-                    const glm::vec3 ndc = glm::vec3(clip) / clip.w;
-                    sun_uv = glm::vec2(ndc.x * 0.5f + 0.5f, ndc.y * 0.5f + 0.5f);
-                    sun_valid = (clip.w > 0.0f) &&
-                                (ndc.z >= -1.0f && ndc.z <= 1.0f) &&
-                                (sun_uv.x >= 0.0f && sun_uv.x <= 1.0f) &&
-                                (sun_uv.y >= 0.0f && sun_uv.y <= 1.0f);
+                    // Depth нь [near=0 .. far=1] тул sky/far пикселүүд дээр shafts үлдээнэ.
+                    s *= std::clamp(depth_like->at(sx, sy), 0.0f, 1.0f);
                 }
+
+                accum += s * illum_decay * kp.weight;
+                illum_decay *= kp.decay;
             }
 
-            // Нар дэлгэц дээр хүчинтэй проекцлогдоогүй үед эффектийг алгасна.
-            if (!sun_valid)
+            const int boost = std::clamp((int)std::lround(accum * 80.0f), 0, 120);
+            return Color{
+                (uint8_t)std::clamp((int)base.r + boost, 0, 255),
+                (uint8_t)std::clamp((int)base.g + boost, 0, 255),
+                (uint8_t)std::clamp((int)base.b + boost / 2, 0, 255),
+                255
+            };
+        }
+
+        void execute(Context& ctx, const Inputs& in)
+        {
+            Frame f{};
+            if (!prepare(in, f)) return;
+            IJobSystem* js = ctx.job_system;
+
+            if (!f.shafts)
             {
-                if (inldr == outldr) return;
-                parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
-                {
-                    for (int y = yb; y < ye; ++y)
-                    {
-                        for (int x = 0; x < w; ++x) outldr->color.at(x, y) = inldr->color.at(x, y);
-                    }
-                });
+                parallel_for_1d(js, 0, f.h, 8, [&](int yb, int ye) { copy_rows(f, yb, ye); });
                 return;
             }
+            parallel_for_1d(js, 0, f.h, 8, [&](int yb, int ye) { luma_rows(f, yb, ye); });
+            parallel_for_1d(js, 0, f.h, 4, [&](int yb, int ye) { march_rows(f, yb, ye); });
+            if (f.tmp || f.in_place) parallel_for_1d(js, 0, f.h, 8, [&](int yb, int ye) { resolve_rows(f, yb, ye); });
+        }
 
-            // Luma-г нэг удаа урьдчилан тооцоолж, ray marching доторх sample хөрвүүлэлтийн зардлыг бууруулна.
-            std::vector<float> luma{};
-            luma.resize((size_t)w * (size_t)h, 0.0f);
-            parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
+        // execute()-ийн coroutine хувилбар: frame timeline зэрэг coroutine дотроос дуудахад үе шат
+        // бүрийн chunk-уудыг co_await-аар хүлээх тул worker thread хаагдахгүй. Chunk бичлэгүүд
+        // pass-ийн arena-аас авагдах тул steady state-д зөвхөн coroutine frame л хуваарилагдана.
+        // ctx болон in-ийн заасан RT-ууд Task дуусах хүртэл амьд байх ёстой.
+        Task<void> execute_async(Context& ctx, Inputs in)
+        {
+            Frame f{};
+            if (!prepare(in, f)) co_return;
+            IJobSystem* js = ctx.job_system;
+            records_.reset();
+
+            if (!f.shafts)
             {
-                for (int y = yb; y < ye; ++y)
-                {
-                    for (int x = 0; x < w; ++x)
-                    {
-                        const Color c = inldr->color.at(x, y);
-                        const float r = (float)c.r / 255.0f;
-                        const float g = (float)c.g / 255.0f;
-                        const float b = (float)c.b / 255.0f;
-                        luma[(size_t)y * (size_t)w + (size_t)x] = 0.2126f * r + 0.7152f * g + 0.0722f * b;
-                    }
-                }
-            });
+                co_await parallel_for_1d_async(js, records_, 0, f.h, 8, [&](int yb, int ye) { copy_rows(f, yb, ye); }, JobPriority::FrameCritical);
+                co_return;
+            }
+            co_await parallel_for_1d_async(js, records_, 0, f.h, 8, [&](int yb, int ye) { luma_rows(f, yb, ye); }, JobPriority::FrameCritical);
+            co_await parallel_for_1d_async(js, records_, 0, f.h, 4, [&](int yb, int ye) { march_rows(f, yb, ye); }, JobPriority::FrameCritical);
+            if (f.tmp || f.in_place)
+            {
+                co_await parallel_for_1d_async(js, records_, 0, f.h, 8, [&](int yb, int ye) { resolve_rows(f, yb, ye); }, JobPriority::FrameCritical);
+            }
+        }
+
+    private:
+        // Нэг дуудлагын RT-ууд ба горим. shafts == false үед input-ийг output руу шууд хуулна.
+        struct Frame
+        {
+            RT_ColorLDR* inldr = nullptr;
+            RT_ColorLDR* outldr = nullptr;
+            RT_ColorLDR* tmp = nullptr;
+            const PixelBuffer2D<float>* depth = nullptr;
+            int w = 0;
+            int h = 0;
+            bool shafts = false;
+            bool in_place = false;
+            ShaftsKernelParams kp{};
+        };
+
+        // Хийх ажилгүй (буруу input эсвэл in-place дамжуулалт) үед false.
+        bool prepare(const Inputs& in, Frame& f)
+        {
+            if (!in.scene || !in.fp || !in.rtr) return false;
+            if (!in.rt_input_ldr.valid() || !in.rt_output_ldr.valid()) return false;
 
-            auto sample_luma = [&](int sx, int sy) -> float
+            f.inldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_input_ldr));
+            f.outldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_output_ldr));
+            if (!f.inldr || !f.outldr || f.inldr->w <= 0 || f.inldr->h <= 0 || f.outldr->w <= 0 || f.outldr->h <= 0) return false;
+            f.w = std::min(f.inldr->w, f.outldr->w);
+            f.h = std::min(f.inldr->h, f.outldr->h);
+
+            // Light shafts унтраалттай эсвэл нар дэлгэц дээр хүчинтэй проекцлогдоогүй үед
+            // input-ийг output руу шууд дамжуулна.
+            glm::vec2 sun_uv{};
+            if (!in.fp->pass.light_shafts.enable || !sun_screen_uv(*in.scene, sun_uv))
             {
-                sx = std::clamp(sx, 0, w - 1);
-                sy = std::clamp(sy, 0, h - 1);
-                return luma[(size_t)sy * (size_t)w + (size_t)sx];
-            };
+                f.shafts = false;
+                return f.inldr != f.outldr;
+            }
 
-            const int steps = std::max(8, in.fp->pass.light_shafts.steps);
-            const float density = std::max(0.0f, in.fp->pass.light_shafts.density);
-            const float weight = std::max(0.0f, in.fp->pass.light_shafts.weight);
-            const float decay = std::clamp(in.fp->pass.light_shafts.decay, 0.0f, 1.0f);
+            auto* depth_like = in.rt_depth_like.valid() ? static_cast<RT_ColorDepthMotion*>(in.rtr->get(in.rt_depth_like)) : nullptr;
+            f.tmp = in.rt_shafts_tmp.valid() ? static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_shafts_tmp)) : nullptr;
+            if (f.tmp && (f.tmp->w != f.w || f.tmp->h != f.h)) f.tmp = nullptr;
+            f.in_place = (f.tmp == nullptr && f.inldr == f.outldr);
+            f.depth = (depth_like && depth_like->w == f.w && depth_like->h == f.h) ? &depth_like->depth : nullptr;
+            f.kp = kernel_params(*in.fp, sun_uv);
+            f.shafts = true;
 
-            std::vector<Color> scratch{};
-            if (in_place_no_tmp) scratch.resize((size_t)w * (size_t)h);
+            // Luma-г нэг удаа урьдчилан тооцоолж, ray marching доторх sample хөрвүүлэлтийн зардлыг бууруулна.
+            luma_.resize((size_t)f.w * (size_t)f.h);
+            if (f.in_place) scratch_.resize((size_t)f.w * (size_t)f.h);
+            return true;
+        }
 
-            parallel_for_1d(ctx.job_system, 0, h, 4, [&](int yb, int ye)
+        static void copy_rows(const Frame& f, int yb, int ye)
+        {
+            for (int y = yb; y < ye; ++y)
             {
-                for (int y = yb; y < ye; ++y)
+                for (int x = 0; x < f.w; ++x) f.outldr->color.at(x, y) = f.inldr->color.at(x, y);
+            }
+        }
+
+        void luma_rows(const Frame& f, int yb, int ye)
+        {
+            for (int y = yb; y < ye; ++y)
+            {
+                for (int x = 0; x < f.w; ++x)
                 {
-                    for (int x = 0; x < w; ++x)
-                    {
-                        const float u = (float)x / (float)std::max(1, w - 1);
-                        const float v = (float)y / (float)std::max(1, h - 1);
-
-                        float illum_decay = 1.0f;
-                        float accum = 0.0f;
-                        for (int i = 0; i < steps; ++i)
-                        {
-                            const float t = (float)i / (float)steps;
-                            const float su = u + (sun_uv.x - u) * t * density;
-                            const float sv = v + (sun_uv.y - v) * t * density;
-                            const int sx = (int)std::lround(su * (float)(w - 1));
-                            const int sy = (int)std::lround(sv * (float)(h - 1));
-
-                            float s = sample_luma(sx, sy);
-                            if (depth_like && depth_like->w == w && depth_like->h == h)
-                            {
-                                // Depth нь [near=0 .. far=1] тул sky/far пикселүүд дээр shafts үлдээнэ.
-                                const int dx = std::clamp(sx, 0, w - 1);
-                                const int dy = std::clamp(sy, 0, h - 1);
-                                const float d = depth_like->depth.at(dx, dy);
-                                s *= std::clamp(d, 0.0f, 1.0f);
-                            }
-
-                            accum += s * illum_decay * weight;
-                            illum_decay *= decay;
-                        }
-
-                        const Color base = inldr->color.at(x, y);
-                        const int boost = std::clamp((int)std::lround(accum * 80.0f), 0, 120);
-                        Color out{
-                            (uint8_t)std::clamp((int)base.r + boost, 0, 255),
-                            (uint8_t)std::clamp((int)base.g + boost, 0, 255),
-                            (uint8_t)std::clamp((int)base.b + boost / 2, 0, 255),
-                            255
-                        };
-                        if (tmp) tmp->color.at(x, y) = out;
-                        else if (in_place_no_tmp) scratch[(size_t)y * (size_t)w + (size_t)x] = out;
-                        else outldr->color.at(x, y) = out;
-                    }
+                    luma_[(size_t)y * (size_t)f.w + (size_t)x] = luma(f.inldr->color.at(x, y));
                 }
-            });
+            }
+        }
 
-            if (tmp)
+        void march_rows(const Frame& f, int yb, int ye)
+        {
+            for (int y = yb; y < ye; ++y)
             {
-                parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
+                for (int x = 0; x < f.w; ++x)
                 {
-                    for (int y = yb; y < ye; ++y)
-                    {
-                        for (int x = 0; x < w; ++x)
-                        {
-                            outldr->color.at(x, y) = tmp->color.at(x, y);
-                        }
-                    }
-                });
+                    const Color out = shaft_pixel(f.inldr->color.at(x, y), x, y, f.w, f.h, luma_.data(), f.depth, f.kp);
+                    if (f.tmp) f.tmp->color.at(x, y) = out;
+                    else if (f.in_place) scratch_[(size_t)y * (size_t)f.w + (size_t)x] = out;
+                    else f.outldr->color.at(x, y) = out;
+                }
             }
-            else if (in_place_no_tmp)
+        }
+
+        void resolve_rows(const Frame& f, int yb, int ye)
+        {
+            for (int y = yb; y < ye; ++y)
             {
-                parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
+                for (int x = 0; x < f.w; ++x)
                 {
-                    for (int y = yb; y < ye; ++y)
-                    {
-                        for (int x = 0; x < w; ++x)
-                        {
-                            outldr->color.at(x, y) = scratch[(size_t)y * (size_t)w + (size_t)x];
-                        }
-                    }
-                });
+                    f.outldr->color.at(x, y) = f.tmp
+                        ? f.tmp->color.at(x, y)
+                        : scratch_[(size_t)y * (size_t)f.w + (size_t)x];
+                }
             }
         }
+
+        // Frame бүр дахин хуваарилахгүйн тулд pass дээр хадгална.
+        std::vector<float> luma_{};
+        std::vector<Color> scratch_{};
+        JobArena records_{64};
     };
 }
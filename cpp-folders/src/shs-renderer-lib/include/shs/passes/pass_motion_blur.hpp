@@ -37,6 +37,117 @@ namespace shs
             RTHandle rt_tmp{};
         };
 
+        struct MotionBlurKernelParams
+        {
+            int samples = 8;
+            // strength * dt scale.
+            float velocity_scale = 1.0f;
+            float max_velocity_px = 32.0f;
+            float min_velocity_px = 0.0f;
+            float depth_reject = 0.0f;
+        };
+
+        // Хурдны векторын дагуух хамгийн хол sample-ийн пикселийн зай. Fused post stack нь tile-ийн
+        // halo-г үүгээр тооцно.
+        static int max_sample_offset_px(const MotionBlurKernelParams& kp)
+        {
+            return (int)std::ceil(std::max(0.0f, kp.max_velocity_px) * 0.5f) + 1;
+        }
+
+        // Нэг пикселийн motion blur. color/depth/motion нь at(x, y)-тай дурын view; sample-ууд
+        // [0, w) x [0, h)-д хязгаарлагдаж, төвөөс max_sample_offset_px()-ээс хол гарахгүй.
+        template<typename TColor, typename TDepth, typename TMotion>
+        static Color blur_pixel(
+            const TColor& color,
+            const TDepth& depth,
+            const TMotion& motion,
+            int x,
+            int y,
+            int w,
+            int h,
+            const MotionBlurKernelParams& kp)
+        {
+            const int samples = std::max(2, kp.samples);
+            const Motion2f mv = motion.at(x, y);
+            float vx = mv.x * kp.velocity_scale;
+            float vy = mv.y * kp.velocity_scale;
+            const float len = std::sqrt(vx * vx + vy * vy);
+            if (len < kp.min_velocity_px) return color.at(x, y);
+            if (len > kp.max_velocity_px && len > 1e-6f)
+            {
+                const float s = kp.max_velocity_px / len;
+                vx *= s;
+                vy *= s;
+            }
+
+            const float center_depth = depth.at(x, y);
+            float ar = 0.0f;
+            float ag = 0.0f;
+            float ab = 0.0f;
+            float aw = 0.0f;
+            for (int i = 0; i < samples; ++i)
+            {
+                const float t = ((float)i / (float)(samples - 1) - 0.5f);
+                const int sx = std::clamp((int)std::lround((float)x + vx * t), 0, w - 1);
+                const int sy = std::clamp((int)std::lround((float)y + vy * t), 0, h - 1);
+                const float sd = depth.at(sx, sy);
+                if (std::abs(sd - center_depth) > kp.depth_reject) continue;
+                const Color sc = color.at(sx, sy);
+                ar += (float)sc.r;
+                ag += (float)sc.g;
+                ab += (float)sc.b;
+                aw += 1.0f;
+            }
+
+            if (aw < 1.0f) return color.at(x, y);
+
+            return Color{
+                (uint8_t)std::clamp((int)std::lround(ar / aw), 0, 255),
+                (uint8_t)std::clamp((int)std::lround(ag / aw), 0, 255),
+                (uint8_t)std::clamp((int)std::lround(ab / aw), 0, 255),
+                255
+            };
+        }
+
+        // Frame params-аас kernel-ийн параметрүүд.
+        static MotionBlurKernelParams kernel_params(const FrameParams& fp)
+        {
+            MotionBlurKernelParams kp{};
+            kp.samples = std::clamp(fp.pass.motion_blur.samples, 4, 32);
+            const float dt_scale = std::clamp(std::max(fp.dt, 1e-4f) * 60.0f, 0.5f, 2.5f);
+            kp.velocity_scale = std::max(0.0f, fp.pass.motion_blur.strength) * dt_scale;
+            kp.max_velocity_px = std::max(1.0f, fp.pass.motion_blur.max_velocity_px);
+            kp.min_velocity_px = std::max(0.0f, fp.pass.motion_blur.min_velocity_px);
+            kp.depth_reject = std::max(0.0f, fp.pass.motion_blur.depth_reject);
+            return kp;
+        }
+
+        // Motion blur-ийн гол kernel. Оролтын buffer-ууд w/h/at(x, y)-тай дурын layout байж болно
+        // (pixel_layout.hpp): хурдны чиглэлийн дагуух gather tiled байршилд цөөн cache line-д
+        // багтана. write(x, y, color)-оор гаралтыг бичнэ.
+        template<typename TColor, typename TDepth, typename TMotion, typename WriteFn>
+        static void blur(
+            IJobSystem* js,
+            const TColor& color,
+            const TDepth& depth,
+            const TMotion& motion,
+            int w,
+            int h,
+            const MotionBlurKernelParams& kp,
+            WriteFn&& write_pixel)
+        {
+            parallel_for_1d(js, 0, h, 4, [&](int yb, int ye)
+            {
+                for (int y = yb; y < ye; ++y)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        write_pixel(x, y, blur_pixel(color, depth, motion, x, y, w, h, kp));
+                    }
+                }
+            });
+        }
+
         void execute(Context& ctx, const Inputs& in)
         {
             if (!in.fp || !in.rtr) return;
@@ -62,114 +173,35 @@ namespace shs
             {
                 tmp = nullptr;
             }
-            const bool in_place = (src == dst);
-
-            std::vector<Color> scratch{};
-            if (!tmp && in_place)
+            const bool use_scratch = !tmp && src == dst;
+            if (use_scratch)
             {
-                scratch.resize((size_t)w * (size_t)h);
+                scratch_.resize((size_t)w * (size_t)h);
             }
 
-            const int samples = std::clamp(in.fp->pass.motion_blur.samples, 4, 32);
-            const float strength = std::max(0.0f, in.fp->pass.motion_blur.strength);
-            const float max_vel = std::max(1.0f, in.fp->pass.motion_blur.max_velocity_px);
-            const float min_vel = std::max(0.0f, in.fp->pass.motion_blur.min_velocity_px);
-            const float depth_eps = std::max(0.0f, in.fp->pass.motion_blur.depth_reject);
-            const float dt_scale = std::clamp(std::max(in.fp->dt, 1e-4f) * 60.0f, 0.5f, 2.5f);
-
-            auto sample_color = [&](int sx, int sy) -> Color
-            {
-                sx = std::clamp(sx, 0, w - 1);
-                sy = std::clamp(sy, 0, h - 1);
-                return src->color.at(sx, sy);
-            };
-
-            auto sample_depth = [&](int sx, int sy) -> float
-            {
-                sx = std::clamp(sx, 0, w - 1);
-                sy = std::clamp(sy, 0, h - 1);
-                return motion->depth.at(sx, sy);
-            };
+            const MotionBlurKernelParams kp = kernel_params(*in.fp);
 
-            auto write_pixel = [&](int x, int y, const Color& c)
+            blur(ctx.job_system, src->color, motion->depth, motion->motion, w, h, kp, [&](int x, int y, const Color& c)
             {
                 if (tmp)
                 {
                     tmp->color.at(x, y) = c;
                 }
-                else if (!scratch.empty())
+                else if (use_scratch)
                 {
-                    scratch[(size_t)y * (size_t)w + (size_t)x] = c;
+                    scratch_[(size_t)y * (size_t)w + (size_t)x] = c;
                 }
                 else
                 {
                     dst->color.at(x, y) = c;
                 }
-            };
-
-            parallel_for_1d(ctx.job_system, 0, h, 4, [&](int yb, int ye)
-            {
-                for (int y = yb; y < ye; ++y)
-                {
-                    for (int x = 0; x < w; ++x)
-                    {
-                        Motion2f mv = motion->motion.at(x, y);
-                        float vx = mv.x * strength * dt_scale;
-                        float vy = mv.y * strength * dt_scale;
-                        float len = std::sqrt(vx * vx + vy * vy);
-                        if (len < min_vel)
-                        {
-                            write_pixel(x, y, src->color.at(x, y));
-                            continue;
-                        }
-                        if (len > max_vel && len > 1e-6f)
-                        {
-                            const float s = max_vel / len;
-                            vx *= s;
-                            vy *= s;
-                        }
-
-                        const float center_depth = motion->depth.at(x, y);
-                        float ar = 0.0f;
-                        float ag = 0.0f;
-                        float ab = 0.0f;
-                        float aw = 0.0f;
-                        for (int i = 0; i < samples; ++i)
-                        {
-                            const float t = ((float)i / (float)(samples - 1) - 0.5f);
-                            const int sx = (int)std::lround((float)x + vx * t);
-                            const int sy = (int)std::lround((float)y + vy * t);
-                            const float sd = sample_depth(sx, sy);
-                            if (std::abs(sd - center_depth) > depth_eps) continue;
-                            const Color sc = sample_color(sx, sy);
-                            ar += (float)sc.r;
-                            ag += (float)sc.g;
-                            ab += (float)sc.b;
-                            aw += 1.0f;
-                        }
-
-                        if (aw < 1.0f)
-                        {
-                            write_pixel(x, y, src->color.at(x, y));
-                            continue;
-                        }
-
-                        const Color out{
-                            (uint8_t)std::clamp((int)std::lround(ar / aw), 0, 255),
-                            (uint8_t)std::clamp((int)std::lround(ag / aw), 0, 255),
-                            (uint8_t)std::clamp((int)std::lround(ab / aw), 0, 255),
-                            255
-                        };
-                        write_pixel(x, y, out);
-                    }
-                }
             });
 
             if (tmp)
             {
                 copy_ldr(ctx, *tmp, *dst, w, h);
             }
-            else if (!scratch.empty())
+            else if (use_scratch)
             {
                 parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
                 {
@@ -177,7 +209,7 @@ namespace shs
                     {
                         for (int x = 0; x < w; ++x)
                         {
-                            dst->color.at(x, y) = scratch[(size_t)y * (size_t)w + (size_t)x];
+                            dst->color.at(x, y) = scratch_[(size_t)y * (size_t)w + (size_t)x];
                         }
                     }
                 });
@@ -185,6 +217,9 @@ namespace shs
         }
 
     private:
+        // In-place ажиллах үеийн гаралт. Frame бүр дахин хуваарилахгүйн тулд pass дээр хадгална.
+        std::vector<Color> scratch_{};
+
         static void copy_ldr(Context& ctx, const RT_ColorLDR& src, RT_ColorLDR& dst, int w, int h)
         {
             parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
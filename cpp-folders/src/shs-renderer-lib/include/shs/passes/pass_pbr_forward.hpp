@@ -10,18 +10,22 @@
 
 
 #include "shs/sw_render/rasterizer.hpp"
+#include "shs/sw_render/tiled_rasterizer.hpp"
 #include "shs/resources/resource_registry.hpp"
 #include "shs/scene/scene_types.hpp"
 #include "shs/frame/frame_params.hpp"
+#include "shs/gfx/rt_fast_clear_resolve.hpp"
 #include "shs/gfx/rt_handle.hpp"
 #include "shs/gfx/rt_registry.hpp"
 #include "shs/gfx/rt_shadow.hpp"
 #include "shs/job/parallel_for.hpp"
 #include "shs/shader/builtin_shaders.hpp"
+#include "shs/shader/shader_permutations.hpp"
 #include "shs/sky/skybox_renderer.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -53,6 +57,11 @@ namespace shs
             ctx.debug.tri_input = 0;
             ctx.debug.tri_after_clip = 0;
             ctx.debug.tri_raster = 0;
+            ctx.debug.vs_invocations = 0;
+            ctx.debug.hiz_tris_rejected = 0;
+            ctx.debug.hiz_blocks_rejected = 0;
+            ctx.debug.fragments_passed = 0;
+            ctx.debug.fs_invocations = 0;
 
             auto* hdr = static_cast<RT_ColorHDR*>(in.rtr->get(in.rt_hdr));
             if (!hdr || hdr->w <= 0 || hdr->h <= 0) return;
@@ -68,50 +77,55 @@ namespace shs
             else
             {
                 // Sky model байхгүй үед HDR background градиент зурна.
-                parallel_for_1d(ctx.job_system, 0, hdr->h, 8, [&](int yb, int ye)
+                hdr->visit([&](auto& buf)
                 {
-                    for (int y = yb; y < ye; ++y)
+                    using P = typename std::remove_reference_t<decltype(buf)>::pixel_type;
+                    parallel_for_1d(ctx.job_system, 0, hdr->h, 8, [&](int yb, int ye)
                     {
-                        const float t = (float)y / (float)std::max(1, hdr->h - 1);
-                        const ColorF clear = {
-                            0.06f + 0.08f * t,
-                            0.08f + 0.10f * t,
-                            0.12f + 0.12f * t,
-                            1.0f
-                        };
-                        for (int x = 0; x < hdr->w; ++x) hdr->color.at(x, y) = clear;
-                    }
+                        for (int y = yb; y < ye; ++y)
+                        {
+                            const float t = (float)y / (float)std::max(1, hdr->h - 1);
+                            const P clear = HdrPixelCodec<P>::encode(ColorF{
+                                0.06f + 0.08f * t,
+                                0.08f + 0.10f * t,
+                                0.12f + 0.12f * t,
+                                1.0f
+                            });
+                            for (int x = 0; x < hdr->w; ++x) buf.at(x, y) = clear;
+                        }
+                    });
                 });
             }
 
+            // Clear нь tile flag (O(tile)): raster tile/band анх хүрэхдээ бөглөж, Hi-Z rebuild
+            // pending block-ийг уншихгүй. Хүрээгүй үлдсэнийг pass-ийн төгсгөлд бөглөнө.
             if (motion && motion->w == hdr->w && motion->h == hdr->h)
             {
                 if (in.preserve_existing_depth)
                 {
-                    motion->color.clear(motion->clear);
-                    motion->motion.clear(Motion2f{});
+                    motion->color.clear_fast(motion->clear);
+                    motion->motion.clear_fast(Motion2f{});
                 }
                 else
                 {
-                    motion->clear_all();
+                    motion->clear_all_fast();
                 }
             }
 
-            ShaderProgram prog = make_pbr_mr_program();
-            if (in.fp->shading_model == ShadingModel::BlinnPhong)
-            {
-                prog = make_blinn_phong_program();
-            }
-            if (in.fp->debug_view != DebugViewMode::Final)
-            {
-                prog = make_debug_view_shader_program(in.fp->debug_view);
-            }
             RasterizerTarget tgt{};
             tgt.hdr = hdr;
             tgt.depth_motion = (motion && motion->w == hdr->w && motion->h == hdr->h) ? motion : nullptr;
             RasterizerConfig rast_cfg{};
             rast_cfg.front_face_ccw = in.fp->front_face_ccw;
             rast_cfg.job_system = ctx.job_system;
+            rast_cfg.simd_fragments = in.fp->raster.simd_fragments;
+            rast_cfg.hierarchical_z = in.fp->raster.hierarchical_z;
+            if (tgt.depth_motion && rast_cfg.hierarchical_z)
+            {
+                // Prepass-ийн depth (эсвэл clear) дээрээс Hi-Z-ийг сэргээнэ.
+                hiz_.rebuild(tgt.depth_motion->depth);
+                tgt.hiz = &hiz_;
+            }
             switch (in.fp->cull_mode)
             {
             case CullMode::None: rast_cfg.cull_mode = RasterizerCullMode::None; break;
@@ -120,6 +134,13 @@ namespace shs
             default: rast_cfg.cull_mode = RasterizerCullMode::Back; break;
             }
 
+            // Tile-binned горимд draw-ууд энд цуглаад давталтын дараа нэг flush-аар raster хийгдэнэ.
+            const bool tiled = in.fp->raster.tile_binning && ctx.job_system != nullptr;
+            if (tiled)
+            {
+                tiled_.begin(tgt, make_tiled_rasterizer_config(in.fp->raster, ctx.job_system));
+            }
+
             std::unordered_map<uint64_t, glm::mat4> next_prev_model_by_object{};
             next_prev_model_by_object.reserve(in.scene->items.size() * 2 + 1);
 
@@ -158,6 +179,8 @@ namespace shs
                 u.model = model;
                 u.viewproj = in.scene->cam.viewproj;
                 u.prev_model = prev_model;
+                // Хөдлөөгүй объектын motion нь зөвхөн камерын шилжилт (model-ийн inverse-гүй).
+                u.motion_static = (prev_model == model);
                 u.prev_viewproj = ctx.history.has_prev_frame ? in.scene->cam.prev_viewproj : in.scene->cam.viewproj;
                 u.light_dir_ws = in.scene->sun.dir_ws;
                 u.light_color = in.scene->sun.color;
@@ -203,14 +226,58 @@ namespace shs
                 set_uniform_vec4(u, 3, glm::vec4(u.camera_pos, 1.0f));
                 set_uniform_vec4(u, 4, glm::vec4(u.metallic, u.roughness, u.ao, 0.0f));
 
-                const RasterizerStats rs = rasterize_mesh(*mesh, prog, u, tgt, rast_cfg);
+                // Material/pass-ийн feature-уудаар permutation сонгож, kernel-ийг төрлөөр нь
+                // rasterizer-т дамжуулна (хэрэггүй texture/shadow/motion салаа inner loop-д орохгүй).
+                ShaderPermutationKey key{};
+                key.model = in.fp->shading_model;
+                key.debug_view = in.fp->debug_view;
+                key.features = shader_features_for_draw(u, tgt.depth_motion != nullptr, in.fp->debug_view);
+                with_shader_permutation(key, [&](const auto& prog)
+                {
+                    if (tiled)
+                    {
+                        tiled_.submit(*mesh, prog, u, rast_cfg);
+                        return;
+                    }
+                    const RasterizerStats rs = rasterize_mesh(*mesh, prog, u, tgt, rast_cfg, vertex_cache_);
+                    ctx.debug.tri_input += rs.tri_input;
+                    ctx.debug.tri_after_clip += rs.tri_after_clip;
+                    ctx.debug.tri_raster += rs.tri_raster;
+                    ctx.debug.vs_invocations += rs.vs_invocations;
+                    ctx.debug.hiz_tris_rejected += rs.hiz_tris_rejected;
+                    ctx.debug.hiz_blocks_rejected += rs.hiz_blocks_rejected;
+                    ctx.debug.fragments_passed += rs.fragments_passed;
+                    ctx.debug.fs_invocations += rs.fs_invocations;
+                });
+            }
+
+            if (tiled)
+            {
+                const RasterizerStats rs = tiled_.flush();
                 ctx.debug.tri_input += rs.tri_input;
                 ctx.debug.tri_after_clip += rs.tri_after_clip;
                 ctx.debug.tri_raster += rs.tri_raster;
+                ctx.debug.vs_invocations += rs.vs_invocations;
+                ctx.debug.hiz_tris_rejected += rs.hiz_tris_rejected;
+                ctx.debug.hiz_blocks_rejected += rs.hiz_blocks_rejected;
+                ctx.debug.fragments_passed += rs.fragments_passed;
+                ctx.debug.fs_invocations += rs.fs_invocations;
+            }
+
+            if (tgt.depth_motion)
+            {
+                resolve_fast_clear(tgt.depth_motion->color, ctx.job_system);
+                resolve_fast_clear(tgt.depth_motion->depth, ctx.job_system);
+                resolve_fast_clear(tgt.depth_motion->motion, ctx.job_system);
             }
 
             ctx.history.prev_model_by_object.swap(next_prev_model_by_object);
             ctx.history.has_prev_frame = true;
         }
+
+    private:
+        TiledRasterizer tiled_{};
+        RasterHiZ hiz_{};
+        RasterVertexCache vertex_cache_{};
     };
 }
@@ -0,0 +1,469 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: pass_post_stack.hpp
+    МОДУЛЬ: passes
+    ЗОРИЛГО: Tonemap, light shafts, motion blur, TAA-г тусдаа full-screen дамжилт, ping-pong
+            buffer, copy-гүйгээр дэлгэцийн tile-аар нэгтгэж ажиллуулах fused post stack.
+            Пиксел бүр идэвхтэй stage-уудын гинжийг регистр дээр дамжиж, зөвхөн эцсийн
+            өнгө LDR target руу бичигдэнэ.
+*/
+
+
+#include "shs/frame/frame_params.hpp"
+#include "shs/gfx/rt_handle.hpp"
+#include "shs/gfx/rt_registry.hpp"
+#include "shs/job/parallel_for.hpp"
+#include "shs/passes/pass_light_shafts.hpp"
+#include "shs/passes/pass_motion_blur.hpp"
+#include "shs/passes/pass_temporal_aa.hpp"
+#include "shs/passes/pass_tonemap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace shs
+{
+    enum class PostStage : uint8_t
+    {
+        // HDR -> LDR. Байвал гинжийн эхэнд байх ёстой (оролт нь HDR target).
+        Tonemap = 0,
+        LightShafts = 1,
+        MotionBlur = 2,
+        TAA = 3
+    };
+
+    inline const char* post_stage_name(PostStage s)
+    {
+        switch (s)
+        {
+            case PostStage::Tonemap: return "tonemap";
+            case PostStage::LightShafts: return "light_shafts";
+            case PostStage::MotionBlur: return "motion_blur";
+            case PostStage::TAA: return "taa";
+            default: return "unknown";
+        }
+    }
+
+    // Stage-уудыг хөршөө хэрхэн уншдагаар нь гурав ангилна:
+    //  - pointwise (tonemap, TAA): зөвхөн өөрийн пикселийг уншина; tile дотор шууд гинжлэгдэнэ.
+    //  - local (motion blur): halo радиус доторх хөршийг уншина. Өмнө нь зөвхөн tonemap байвал
+    //    tile бүр halo-тойгоо tonemap-ийг per-thread scratch-д тооцоод нэг дамжилтад нэгтгэнэ.
+    //  - global (light shafts): нар хүртэлх бүх luma-г уншина. Оролтын luma бүтэн кадраар бэлэн байх
+    //    ёстой тул өмнөх хэсэг нь өнгө + luma-г full-frame buffer-т бичиж дамжилт хуваагдана.
+    // Хуваагдсан хэсэг (segment) бүр нэг tile-ийн parallel дамжилт бөгөөд эцсийнх нь LDR target-д бичнэ.
+    class PassPostStack
+    {
+    public:
+        struct Inputs
+        {
+            const Scene* scene = nullptr;
+            const FrameParams* fp = nullptr;
+            RTRegistry* rtr = nullptr;
+
+            // Tonemap stage-ийн оролт.
+            RTHandle rt_hdr{};
+            // Гаралт. Tonemap байхгүй үед оролт бас.
+            RTHandle rt_ldr{};
+            // Depth + motion (light shafts-ийн occlusion, motion blur).
+            RTHandle rt_motion{};
+            // Хэсгүүдийн хоорондох LDR (LDR-тэй ижил хэмжээтэй). Хүчингүй бол pass өөрөө эзэмшинэ.
+            RTHandle rt_tmp{};
+
+            const PostStage* stages = nullptr;
+            size_t stage_count = 0;
+        };
+
+        struct Stats
+        {
+            // Идэвхтэй stage-ууд (tonemap орно).
+            uint32_t stages = 0;
+            // Full-frame дамжилтын тоо (luma/copy-ийн урьдчилсан дамжилт орно).
+            uint32_t sweeps = 0;
+            // Tonemap-аар дахин тооцсон halo-ийн өргөн (0 бол halo fusion хийгдээгүй).
+            int fused_halo = 0;
+        };
+
+        bool execute(Context& ctx, const Inputs& in)
+        {
+            stats_ = Stats{};
+            if (!in.fp || !in.rtr || !in.rt_ldr.valid()) return false;
+            auto* ldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_ldr));
+            if (!ldr || ldr->w <= 0 || ldr->h <= 0) return false;
+
+            FramePlan plan{};
+            plan.w = ldr->w;
+            plan.h = ldr->h;
+            plan.ldr = ldr;
+
+            size_t first = 0;
+            if (in.stage_count > 0 && in.stages[0] == PostStage::Tonemap)
+            {
+                auto* hdr = in.rt_hdr.valid() ? static_cast<RT_ColorHDR*>(in.rtr->get(in.rt_hdr)) : nullptr;
+                if (!hdr || hdr->w <= 0 || hdr->h <= 0) return false;
+                plan.hdr = hdr;
+                plan.w = std::min(plan.w, hdr->w);
+                plan.h = std::min(plan.h, hdr->h);
+                plan.tone = PassTonemap::make_curve(in.fp->pass.tonemap, gamma_lut_);
+                first = 1;
+            }
+
+            auto* motion = in.rt_motion.valid() ? static_cast<RT_ColorDepthMotion*>(in.rtr->get(in.rt_motion)) : nullptr;
+            plan.motion = (motion && motion->w >= plan.w && motion->h >= plan.h) ? motion : nullptr;
+
+            // Идэвхгүй stage-ууд гинжнээс хасагдана (тусдаа pass-ууд шиг copy хийхгүй).
+            std::array<PostStage, k_max_stages> active{};
+            size_t active_count = 0;
+            for (size_t i = first; i < in.stage_count && active_count < k_max_stages; ++i)
+            {
+                const PostStage s = in.stages[i];
+                if (s == PostStage::LightShafts)
+                {
+                    glm::vec2 sun_uv{};
+                    if (!in.scene || !in.fp->pass.light_shafts.enable || !PassLightShafts::sun_screen_uv(*in.scene, sun_uv)) continue;
+                    plan.shafts = PassLightShafts::kernel_params(*in.fp, sun_uv);
+                    plan.shafts_depth = (motion && motion->w == plan.w && motion->h == plan.h) ? &motion->depth : nullptr;
+                }
+                else if (s == PostStage::MotionBlur)
+                {
+                    if (!in.fp->pass.motion_blur.enable || !plan.motion) continue;
+                    plan.blur = PassMotionBlur::kernel_params(*in.fp);
+                }
+                else if (s == PostStage::TAA)
+                {
+                    plan.taa = &ctx.temporal_aa;
+                }
+                else
+                {
+                    continue;
+                }
+                active[active_count++] = s;
+            }
+            if (!plan.hdr && active_count == 0) return true;
+
+            build_segments(plan, active.data(), active_count, in.fp->pass.post_stack);
+            if (!bind_buffers(plan, in)) return false;
+            if (plan.taa) PassTemporalAA::prepare_history(*plan.taa, plan.w, plan.h);
+
+            stats_.stages = (uint32_t)active_count + (plan.hdr ? 1u : 0u);
+            const int tile = std::clamp(in.fp->pass.post_stack.tile_size, 8, 512);
+            if (plan.pre_copy || plan.pre_luma) run_presweep(ctx, plan);
+            for (size_t si = 0; si < plan.segment_count; ++si)
+            {
+                const Segment& seg = plan.segments[si];
+                if (si == 0 && plan.hdr)
+                {
+                    plan.hdr->visit([&](const auto& buf)
+                    {
+                        const ToneSource<std::decay_t<decltype(buf)>> src{&buf, plan.tone};
+                        run_segment(ctx, plan, seg, src, tile);
+                    });
+                }
+                else
+                {
+                    run_segment(ctx, plan, seg, seg.in->color, tile);
+                }
+                ++stats_.sweeps;
+            }
+            if (plan.taa) plan.taa->history_valid = true;
+            return true;
+        }
+
+        const Stats& stats() const { return stats_; }
+
+    private:
+        static constexpr size_t k_max_stages = 8;
+
+        enum class StageReach : uint8_t
+        {
+            Pointwise = 0,
+            Local = 1,
+            Global = 2
+        };
+
+        static StageReach stage_reach(PostStage s)
+        {
+            switch (s)
+            {
+                case PostStage::LightShafts: return StageReach::Global;
+                case PostStage::MotionBlur: return StageReach::Local;
+                default: return StageReach::Pointwise;
+            }
+        }
+
+        struct Segment
+        {
+            // stages[0] нь хөрш уншдаг stage байж болно; бусад нь бүгд pointwise.
+            std::array<PostStage, k_max_stages> stages{};
+            size_t stage_count = 0;
+            // HDR-ээс эхэлбэл tonemap-ийг tile + halo (энэ утга)-д scratch руу тооцоод эхний stage түүнээс уншина.
+            int halo = 0;
+            // Дараагийн хэсэг light shafts-аар эхэлбэл гаралтынхаа luma-г бичнэ.
+            bool write_luma = false;
+            int luma_slot = 0;
+            // Эхний stage light shafts бол уншиж буй luma.
+            int read_luma_slot = 0;
+            RT_ColorLDR* in = nullptr;
+            RT_ColorLDR* out = nullptr;
+        };
+
+        struct FramePlan
+        {
+            int w = 0;
+            int h = 0;
+            RT_ColorLDR* ldr = nullptr;
+            const RT_ColorHDR* hdr = nullptr;
+            PassTonemap::Curve tone{};
+            const RT_ColorDepthMotion* motion = nullptr;
+            PassLightShafts::ShaftsKernelParams shafts{};
+            const PixelBuffer2D<float>* shafts_depth = nullptr;
+            PassMotionBlur::MotionBlurKernelParams blur{};
+            TemporalAARuntimeState* taa = nullptr;
+
+            std::array<Segment, k_max_stages + 1> segments{};
+            size_t segment_count = 0;
+            // Tonemap-гүй гинж хөрш уншдаг stage-аар эхэлбэл: LDR-ийг tmp руу хуулах ба/эсвэл luma бэлдэх.
+            bool pre_copy = false;
+            bool pre_luma = false;
+        };
+
+        // HDR эх: run_segment нь tile (+ halo)-ийг мөрөөр нь scratch руу tonemap хийгээд уншина.
+        template<typename THdr>
+        struct ToneSource
+        {
+            const THdr* hdr = nullptr;
+            PassTonemap::Curve tone{};
+
+            void fill_row(int y, int x0, int x1, Color* out) const
+            {
+                PassTonemap::tonemap_span(*hdr, x0, x1 + 1, y, out, tone);
+            }
+        };
+
+        // Tile + halo-ийн per-thread scratch-ийг кадрын координатаар уншина.
+        struct TileView
+        {
+            const Color* data = nullptr;
+            int x0 = 0;
+            int y0 = 0;
+            int stride = 0;
+
+            const Color& at(int x, int y) const
+            {
+                return data[(size_t)(y - y0) * (size_t)stride + (size_t)(x - x0)];
+            }
+        };
+
+        static std::vector<Color>& tile_scratch()
+        {
+            thread_local std::vector<Color> scratch{};
+            return scratch;
+        }
+
+        static void build_segments(FramePlan& plan, const PostStage* active, size_t count, const PostStackPassParams& params)
+        {
+            plan.segment_count = 1;
+            Segment* cur = &plan.segments[0];
+            for (size_t i = 0; i < count; ++i)
+            {
+                const PostStage s = active[i];
+                const StageReach reach = stage_reach(s);
+                bool fits = true;
+                if (reach != StageReach::Pointwise)
+                {
+                    if (cur->stage_count > 0)
+                    {
+                        fits = false;
+                    }
+                    else if (plan.segment_count == 1 && plan.hdr)
+                    {
+                        // Зөвхөн tonemap-ийн дараа: motion blur-ийн halo-г tonemap-аар дахин тооцох нь
+                        // full-frame бичилт/уншилтаас хямд байвал нэгтгэнэ.
+                        const int halo = PassMotionBlur::max_sample_offset_px(plan.blur);
+                        fits = (reach == StageReach::Local) && halo <= std::max(0, params.max_fused_halo);
+                        if (fits) cur->halo = halo;
+                    }
+                }
+                if (!fits)
+                {
+                    cur = &plan.segments[plan.segment_count++];
+                }
+                cur->stages[cur->stage_count++] = s;
+            }
+
+            for (size_t si = 0; si < plan.segment_count; ++si)
+            {
+                Segment& seg = plan.segments[si];
+                seg.luma_slot = (int)(si & 1u);
+                seg.read_luma_slot = (int)((si + 1u) & 1u);
+                if (si + 1 < plan.segment_count)
+                {
+                    seg.write_luma = plan.segments[si + 1].stages[0] == PostStage::LightShafts;
+                }
+            }
+            const Segment& s0 = plan.segments[0];
+            if (!plan.hdr && s0.stage_count > 0 && s0.stages[0] == PostStage::LightShafts)
+            {
+                plan.pre_luma = true;
+            }
+        }
+
+        bool bind_buffers(FramePlan& plan, const Inputs& in)
+        {
+            // Эцсийн хэсэг LDR-д бичих ба хэсэг бүр өмнөхийнхөө гаралтаас уншина: гаралтыг
+            // ардаас нь LDR / tmp ээлжлэн оноож, хөрш уншдаг хэсэг нэг buffer-т бичихгүй байлгана.
+            const bool s0_reads_neighbours =
+                plan.segments[0].stage_count > 0 && stage_reach(plan.segments[0].stages[0]) != StageReach::Pointwise;
+            const bool needs_tmp = plan.segment_count > 1 || (!plan.hdr && s0_reads_neighbours);
+            RT_ColorLDR* tmp = nullptr;
+            if (needs_tmp)
+            {
+                tmp = in.rt_tmp.valid() ? static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_tmp)) : nullptr;
+                if (!tmp || tmp->w != plan.w || tmp->h != plan.h || tmp == plan.ldr)
+                {
+                    if (owned_tmp_.w != plan.w || owned_tmp_.h != plan.h) owned_tmp_ = RT_ColorLDR(plan.w, plan.h);
+                    tmp = &owned_tmp_;
+                }
+            }
+
+            RT_ColorLDR* out = plan.ldr;
+            for (size_t i = plan.segment_count; i-- > 0;)
+            {
+                plan.segments[i].out = out;
+                out = (out == plan.ldr) ? tmp : plan.ldr;
+            }
+            for (size_t i = 1; i < plan.segment_count; ++i)
+            {
+                plan.segments[i].in = plan.segments[i - 1].out;
+            }
+
+            Segment& s0 = plan.segments[0];
+            s0.in = plan.ldr;
+            if (!plan.hdr && s0_reads_neighbours && s0.out == plan.ldr)
+            {
+                plan.pre_copy = true;
+                s0.in = tmp;
+            }
+            bool needs_luma = plan.pre_luma;
+            for (size_t i = 0; i < plan.segment_count; ++i) needs_luma = needs_luma || plan.segments[i].write_luma;
+            if (needs_luma)
+            {
+                const size_t count = (size_t)plan.w * (size_t)plan.h;
+                for (auto& l : luma_) l.resize(count);
+            }
+            return true;
+        }
+
+        // Tonemap-гүй гинж хөрш уншдаг stage-аар эхлэх үед: LDR-ийг tmp руу хуулах / luma бэлдэх.
+        void run_presweep(Context& ctx, const FramePlan& plan)
+        {
+            const Segment& s0 = plan.segments[0];
+            RT_ColorLDR* copy_dst = plan.pre_copy ? s0.in : nullptr;
+            float* luma = plan.pre_luma ? luma_[s0.read_luma_slot].data() : nullptr;
+            const int w = plan.w;
+            parallel_for_1d(ctx.job_system, 0, plan.h, 8, [&](int yb, int ye)
+            {
+                for (int y = yb; y < ye; ++y)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        const Color c = plan.ldr->color.at(x, y);
+                        if (copy_dst) copy_dst->color.at(x, y) = c;
+                        if (luma) luma[(size_t)y * (size_t)w + (size_t)x] = PassLightShafts::luma(c);
+                    }
+                }
+            });
+            ++stats_.sweeps;
+        }
+
+        template<typename TSrc>
+        Color eval_first(const FramePlan& plan, const Segment& seg, const TSrc& src, int x, int y)
+        {
+            switch (seg.stages[0])
+            {
+                case PostStage::LightShafts:
+                    return PassLightShafts::shaft_pixel(
+                        src.at(x, y), x, y, plan.w, plan.h, luma_[seg.read_luma_slot].data(), plan.shafts_depth, plan.shafts);
+                case PostStage::MotionBlur:
+                    return PassMotionBlur::blur_pixel(src, plan.motion->depth, plan.motion->motion, x, y, plan.w, plan.h, plan.blur);
+                case PostStage::TAA:
+                    return PassTemporalAA::apply_pixel(*plan.taa, src.at(x, y), x, y);
+                default:
+                    return src.at(x, y);
+            }
+        }
+
+        // Хэсгийн нэг tile-ийн core пикселүүд: эхний stage (src-ээс), дараа нь pointwise stage-ууд.
+        template<typename TSrc>
+        void shade_tile(const FramePlan& plan, const Segment& seg, const TSrc& src, int x0, int x1, int y0, int y1)
+        {
+            float* luma = seg.write_luma ? luma_[seg.luma_slot].data() : nullptr;
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    Color c = (seg.stage_count > 0) ? eval_first(plan, seg, src, x, y) : Color(src.at(x, y));
+                    for (size_t k = 1; k < seg.stage_count; ++k)
+                    {
+                        // stages[1..] нь бүгд pointwise; одоогоор зөвхөн TAA.
+                        if (seg.stages[k] == PostStage::TAA) c = PassTemporalAA::apply_pixel(*plan.taa, c, x, y);
+                    }
+                    seg.out->color.at(x, y) = c;
+                    if (luma) luma[(size_t)y * (size_t)plan.w + (size_t)x] = PassLightShafts::luma(c);
+                }
+            }
+        }
+
+        template<typename TSrc>
+        void run_segment(Context& ctx, const FramePlan& plan, const Segment& seg, const TSrc& src, int tile)
+        {
+            const int tiles_x = (plan.w + tile - 1) / tile;
+            const int tiles_y = (plan.h + tile - 1) / tile;
+            constexpr bool k_tone_source = requires { src.fill_row(0, 0, 0, nullptr); };
+            if (seg.halo > 0) stats_.fused_halo = seg.halo;
+            parallel_for_1d(ctx.job_system, 0, tiles_x * tiles_y, 2, [&](int tb, int te)
+            {
+                for (int t = tb; t < te; ++t)
+                {
+                    const int x0 = (t % tiles_x) * tile;
+                    const int y0 = (t / tiles_x) * tile;
+                    const int x1 = std::min(plan.w, x0 + tile) - 1;
+                    const int y1 = std::min(plan.h, y0 + tile) - 1;
+                    if constexpr (!k_tone_source)
+                    {
+                        shade_tile(plan, seg, src, x0, x1, y0, y1);
+                    }
+                    else
+                    {
+                        // Tile + halo-г (кадрын хязгаарт) мөрөөр нь lane-аар tonemap хийж scratch-д;
+                        // motion blur-ийн sample-ууд кадрт clamp хийгдэж halo-оос гарахгүй тул бүгд энд олдоно.
+                        const int rx0 = std::max(0, x0 - seg.halo);
+                        const int ry0 = std::max(0, y0 - seg.halo);
+                        const int rx1 = std::min(plan.w - 1, x1 + seg.halo);
+                        const int ry1 = std::min(plan.h - 1, y1 + seg.halo);
+                        const int rw = rx1 - rx0 + 1;
+                        std::vector<Color>& scratch = tile_scratch();
+                        scratch.resize((size_t)rw * (size_t)(ry1 - ry0 + 1));
+                        for (int y = ry0; y <= ry1; ++y)
+                        {
+                            src.fill_row(y, rx0, rx1, scratch.data() + (size_t)(y - ry0) * (size_t)rw);
+                        }
+                        shade_tile(plan, seg, TileView{scratch.data(), rx0, ry0, rw}, x0, x1, y0, y1);
+                    }
+                }
+            });
+        }
+
+        // Хэсэг бүр өөрийн гаралтын luma-г бичиж, дараагийнх нь уншина (ээлжлэн хоёр slot).
+        std::array<std::vector<float>, 2> luma_{};
+        PassTonemap::GammaLut gamma_lut_{};
+        RT_ColorLDR owned_tmp_{};
+        Stats stats_{};
+    };
+}
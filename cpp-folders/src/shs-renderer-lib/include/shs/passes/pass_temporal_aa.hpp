@@ -0,0 +1,101 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: pass_temporal_aa.hpp
+    МОДУЛЬ: passes
+    ЗОРИЛГО: LDR өнгийг өмнөх кадрын history-тэй тогтмол жингээр холих энгийн temporal AA.
+            History нь Context::temporal_aa-д хадгалагдана.
+*/
+
+
+#include "shs/core/context.hpp"
+#include "shs/gfx/rt_handle.hpp"
+#include "shs/gfx/rt_registry.hpp"
+#include "shs/job/parallel_for.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace shs
+{
+    class PassTemporalAA
+    {
+    public:
+        struct Inputs
+        {
+            RTRegistry* rtr = nullptr;
+
+            RTHandle rt_ldr{}; // input/output
+        };
+
+        // Шинэ кадрын жин.
+        static constexpr float k_blend = 0.12f;
+
+        static Color resolve_pixel(const Color& cur, const Color& prev)
+        {
+            constexpr float keep = 1.0f - k_blend;
+            auto lerp_chan = [](uint8_t a, uint8_t b) -> uint8_t {
+                const float v = keep * static_cast<float>(a) + k_blend * static_cast<float>(b);
+                const int iv = static_cast<int>(v + 0.5f);
+                return static_cast<uint8_t>(std::clamp(iv, 0, 255));
+            };
+
+            Color out{};
+            out.r = lerp_chan(cur.r, prev.r);
+            out.g = lerp_chan(cur.g, prev.g);
+            out.b = lerp_chan(cur.b, prev.b);
+            out.a = cur.a;
+            return out;
+        }
+
+        // History-г w x h хэмжээнд бэлдэнэ. Хэмжээ өөрчлөгдвөл history хүчингүй болно.
+        static void prepare_history(TemporalAARuntimeState& taa, int w, int h)
+        {
+            const size_t count = static_cast<size_t>(w) * static_cast<size_t>(h);
+            if (taa.history_w != w || taa.history_h != h || taa.history.size() != count)
+            {
+                taa.history.assign(count, Color{0, 0, 0, 255});
+                taa.history_w = w;
+                taa.history_h = h;
+                taa.history_valid = false;
+            }
+        }
+
+        // history_valid=false үед (эхний кадр) өнгө өөрчлөгдөхгүй, зөвхөн history-д бичигдэнэ.
+        static Color apply_pixel(TemporalAARuntimeState& taa, const Color& cur, int x, int y)
+        {
+            Color& prev = taa.history[static_cast<size_t>(y) * static_cast<size_t>(taa.history_w) + static_cast<size_t>(x)];
+            const Color out = taa.history_valid ? resolve_pixel(cur, prev) : cur;
+            prev = out;
+            return out;
+        }
+
+        bool execute(Context& ctx, const Inputs& in)
+        {
+            if (!in.rtr || !in.rt_ldr.valid()) return false;
+            auto* ldr = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_ldr));
+            if (!ldr || ldr->w <= 0 || ldr->h <= 0) return false;
+
+            auto& taa = ctx.temporal_aa;
+            const int w = ldr->w;
+            const int h = ldr->h;
+            prepare_history(taa, w, h);
+
+            parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
+            {
+                for (int y = yb; y < ye; ++y)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        Color& c = ldr->color.at(x, y);
+                        c = apply_pixel(taa, c, x, y);
+                    }
+                }
+            });
+            taa.history_valid = true;
+            return true;
+        }
+    };
+}
@@ -5,8 +5,9 @@
 
     ФАЙЛ: pass_tonemap.hpp
     МОДУЛЬ: passes
-    ЗОРИЛГО: Энэ файл нь shs-renderer-lib-ийн passes модульд хамаарах төрөл/функцийн
-            интерфэйс эсвэл хэрэгжүүлэлтийг тодорхойлно.
+    ЗОРИЛГО: HDR -> LDR tonemap (exposure, Reinhard/ACES fit, gamma). Мөрийг simd_lanes.hpp-ийн
+            lane-аар (xsimd эсвэл 8 lane-тэй fallback) тооцож, RGBA8-ийг lane-ийн багцаар бичнэ.
+            Gamma нь анхдагчаар 12 битийн LUT-аар (pow-гүй) хийгдэнэ.
 */
 
 
@@ -14,9 +15,13 @@
 #include "shs/gfx/rt_handle.hpp"
 #include "shs/gfx/rt_registry.hpp"
 #include "shs/job/parallel_for.hpp"
+#include "shs/shader/simd_lanes.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 namespace shs
 {
@@ -34,6 +39,94 @@ namespace shs
             RTHandle rt_ldr{}; // output
         };
 
+        // Tonemap хийсэн [0, 1] утгын gamma -> 8 битийн код. sqrt(v)-ээр 12 битэд индексжүүлнэ:
+        // шугаман индекс бол 1/2.2 gamma-ийн тэг орчмын огцом налуу дээр нэг алхам нь хэдэн LSB
+        // болдог бол sqrt домэйнд v^(inv_gamma) ≈ u^0.91 бараг шугаман тул pow-той ялгаа ±1 LSB.
+        struct GammaLut
+        {
+            static constexpr int k_bits = 12;
+            static constexpr int k_size = 1 << k_bits;
+
+            float inv_gamma = -1.0f;
+            std::array<uint8_t, k_size> code{};
+
+            // inv_gamma өөрчлөгдөөгүй бол дахин бүтээхгүй.
+            void build(float ig)
+            {
+                if (ig == inv_gamma) return;
+                inv_gamma = ig;
+                for (int i = 0; i < k_size; ++i)
+                {
+                    const float u = (float)i / (float)(k_size - 1);
+                    code[(size_t)i] = quantize_exact(u * u, ig);
+                }
+            }
+        };
+
+        struct Curve
+        {
+            float exposure = 1.0f;
+            float inv_gamma = 1.0f;
+            TonemapOperator op = TonemapOperator::Reinhard;
+            // nullptr үед gamma-г lane бүрт std::pow-оор тооцно.
+            const GammaLut* lut = nullptr;
+        };
+
+        // Frame params-аас curve. gamma_lut үед lut-ийг (шаардлагатай бол) бүтээж холбоно.
+        static Curve make_curve(const TonemapParams& p, GammaLut& lut)
+        {
+            Curve c{};
+            c.exposure = std::max(0.0001f, p.exposure);
+            c.inv_gamma = 1.0f / std::max(0.001f, p.gamma);
+            c.op = p.op;
+            if (p.gamma_lut)
+            {
+                lut.build(c.inv_gamma);
+                c.lut = &lut;
+            }
+            return c;
+        }
+
+        // HDR мөрийн [x0, x1) хэсгийг out[0 .. x1 - x0)-д. hdr нь дурын HDR формат (hdr_pixel.hpp),
+        // layout-тай (pixel_layout.hpp) байж болно. Fused post stack (pass_post_stack.hpp) мөн үүнийг ашиглана.
+        template<typename THdr>
+        static void tonemap_span(const THdr& hdr, int x0, int x1, int y, Color* out, const Curve& c)
+        {
+            constexpr int L = simd::k_lanes;
+            simd::LaneArray r{};
+            simd::LaneArray g{};
+            simd::LaneArray b{};
+            std::array<Color, (size_t)L> px{};
+            px.fill(Color{0, 0, 0, 255});
+            for (int x = x0; x < x1; x += L)
+            {
+                const int n = std::min(L, x1 - x);
+                for (int i = 0; i < n; ++i)
+                {
+                    const ColorF s = hdr_load(hdr, x + i, y);
+                    r[(size_t)i] = s.r;
+                    g[(size_t)i] = s.g;
+                    b[(size_t)i] = s.b;
+                }
+                for (int i = n; i < L; ++i) r[(size_t)i] = g[(size_t)i] = b[(size_t)i] = 0.0f;
+
+                encode_channel(r, c, px, &Color::r);
+                encode_channel(g, c, px, &Color::g);
+                encode_channel(b, c, px, &Color::b);
+                std::memcpy(out + (x - x0), px.data(), (size_t)n * sizeof(Color));
+            }
+        }
+
+        // Present хийгддэг LDR нь үргэлж мөр дараалсан тул энэ нь layout-ын хөрвүүлэлтийн хил болно.
+        template<typename THdr>
+        static void tonemap(IJobSystem* js, const THdr& hdr, PixelBuffer2D<Color>& ldr, int w, int h, const Curve& c)
+        {
+            parallel_for_1d(js, 0, h, 8, [&](int yb, int ye)
+            {
+                for (int y = yb; y < ye; ++y) tonemap_span(hdr, 0, w, y, &ldr.at(0, y), c);
+            });
+        }
+
         void execute(Context& ctx, const Inputs& in)
         {
             (void)ctx;
@@ -46,41 +139,43 @@ namespace shs
 
             const int w = std::min(hdr->w, ldr->w);
             const int h = std::min(hdr->h, ldr->h);
-            const float exposure = std::max(0.0001f, in.fp->pass.tonemap.exposure);
-            const float inv_gamma = 1.0f / std::max(0.001f, in.fp->pass.tonemap.gamma);
+            const Curve c = make_curve(in.fp->pass.tonemap, lut_);
+
+            hdr->visit([&](const auto& buf) { tonemap(ctx.job_system, buf, ldr->color, w, h, c); });
+        }
 
-            parallel_for_1d(ctx.job_system, 0, h, 8, [&](int yb, int ye)
+    private:
+        static uint8_t quantize_exact(float v, float inv_gamma)
+        {
+            return (uint8_t)std::min(255, (int)(std::pow(v, inv_gamma) * 255.0f + 0.5f));
+        }
+
+        // Нэг сувгийн lane-ууд: exposure, operator ([0, 1], сөрөг/NaN 0, inf 1), gamma -> px[i].*chan.
+        // fallback f32-ийг функцийн хооронд утгаар дамжуулбал GCC хагасаар нь хуулж store-forwarding
+        // алддаг тул бүх lane тооцоо энэ нэг функц дотор.
+        template<size_t N>
+        static void encode_channel(simd::LaneArray& a, const Curve& c, std::array<Color, N>& px, uint8_t Color::*chan)
+        {
+            const simd::f32 zero(0.0f);
+            const simd::f32 one(1.0f);
+            simd::f32 x = simd::load(a.data()) * simd::f32(c.exposure);
+            x = simd::select(x > zero, x, zero);
+            simd::f32 v = (c.op == TonemapOperator::ACESFit)
+                ? (x * (x * simd::f32(2.51f) + simd::f32(0.03f))) / (x * (x * simd::f32(2.43f) + simd::f32(0.59f)) + simd::f32(0.14f))
+                : x / (one + x);
+            v = simd::select(v < one, v, one);
+            if (c.lut)
             {
-                for (int y = yb; y < ye; ++y)
-                {
-                    for (int x = 0; x < w; ++x)
-                    {
-                        const ColorF s = hdr->color.at(x, y);
-
-                        // Exposure
-                        float r = std::max(0.0f, s.r * exposure);
-                        float g = std::max(0.0f, s.g * exposure);
-                        float b = std::max(0.0f, s.b * exposure);
-
-                        // Reinhard tone map
-                        r = r / (1.0f + r);
-                        g = g / (1.0f + g);
-                        b = b / (1.0f + b);
-
-                        // Gamma
-                        r = std::pow(r, inv_gamma);
-                        g = std::pow(g, inv_gamma);
-                        b = std::pow(b, inv_gamma);
-
-                        ldr->color.at(x, y) = Color{
-                            (uint8_t)std::clamp((int)std::lround(r * 255.0f), 0, 255),
-                            (uint8_t)std::clamp((int)std::lround(g * 255.0f), 0, 255),
-                            (uint8_t)std::clamp((int)std::lround(b * 255.0f), 0, 255),
-                            255
-                        };
-                    }
-                }
-            });
+                simd::store(a.data(), simd::sqrt(v) * simd::f32((float)(GammaLut::k_size - 1)) + simd::f32(0.5f));
+                for (size_t i = 0; i < N; ++i) px[i].*chan = c.lut->code[(size_t)(int)a[i]];
+            }
+            else
+            {
+                simd::store(a.data(), v);
+                for (size_t i = 0; i < N; ++i) px[i].*chan = quantize_exact(a[i], c.inv_gamma);
+            }
         }
+
+        GammaLut lut_{};
     };
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: pass_upscale.hpp
+    МОДУЛЬ: passes
+    ЗОРИЛГО: Бага resolution-оор рендерлэсэн LDR-ийг present LDR руу bilinear-аар томруулна.
+            Dynamic resolution (pipeline/frame_budget_governor.hpp)-ий сүүлийн алхам.
+*/
+
+
+#include "shs/core/context.hpp"
+#include "shs/gfx/rt_handle.hpp"
+#include "shs/gfx/rt_registry.hpp"
+#include "shs/job/parallel_for.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace shs
+{
+    class PassUpscale
+    {
+    public:
+        struct Inputs
+        {
+            RTRegistry* rtr = nullptr;
+
+            RTHandle rt_src{}; // input
+            RTHandle rt_dst{}; // output
+        };
+
+        // Гаралтын нэг тэнхлэгийн пиксел бүрийн хоёр эх индекс ба 8 битийн жин (pixel center-ээр).
+        struct Tap
+        {
+            int i0 = 0;
+            int i1 = 0;
+            uint32_t f = 0;
+        };
+
+        static void build_taps(int src_n, int dst_n, std::vector<Tap>& out)
+        {
+            out.resize((size_t)std::max(0, dst_n));
+            const float s = (float)src_n / (float)std::max(1, dst_n);
+            for (int i = 0; i < dst_n; ++i)
+            {
+                const float p = std::max(0.0f, ((float)i + 0.5f) * s - 0.5f);
+                const int i0 = std::min((int)p, src_n - 1);
+                Tap& t = out[(size_t)i];
+                t.i0 = i0;
+                t.i1 = std::min(i0 + 1, src_n - 1);
+                t.f = (uint32_t)std::clamp((int)((p - (float)i0) * 256.0f + 0.5f), 0, 256);
+            }
+        }
+
+        static uint8_t blend(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint32_t fx, uint32_t fy)
+        {
+            const uint32_t top = (uint32_t)a * (256u - fx) + (uint32_t)b * fx;
+            const uint32_t bot = (uint32_t)c * (256u - fx) + (uint32_t)d * fx;
+            return (uint8_t)((top * (256u - fy) + bot * fy + 32768u) >> 16);
+        }
+
+        // src-ийг dst-ийн бүх хэмжээнд сунгана (dst бүтнээрээ бичигдэх тул fast clear-ийг цуцална).
+        // Хэмжээ ижил бол шууд хуулна.
+        static void bilinear(IJobSystem* js, const PixelBuffer2D<Color>& src, PixelBuffer2D<Color>& dst)
+        {
+            if (src.w <= 0 || src.h <= 0 || dst.w <= 0 || dst.h <= 0) return;
+            dst.fast_clear.reset();
+            if (src.w == dst.w && src.h == dst.h)
+            {
+                dst.data = src.data;
+                return;
+            }
+
+            std::vector<Tap> cols{};
+            std::vector<Tap> rows{};
+            build_taps(src.w, dst.w, cols);
+            build_taps(src.h, dst.h, rows);
+
+            parallel_for_1d(js, 0, dst.h, 8, [&](int yb, int ye)
+            {
+                for (int y = yb; y < ye; ++y)
+                {
+                    const Tap& r = rows[(size_t)y];
+                    for (int x = 0; x < dst.w; ++x)
+                    {
+                        const Tap& c = cols[(size_t)x];
+                        const Color& p00 = src.at(c.i0, r.i0);
+                        const Color& p10 = src.at(c.i1, r.i0);
+                        const Color& p01 = src.at(c.i0, r.i1);
+                        const Color& p11 = src.at(c.i1, r.i1);
+                        Color& o = dst.at(x, y);
+                        o.r = blend(p00.r, p10.r, p01.r, p11.r, c.f, r.f);
+                        o.g = blend(p00.g, p10.g, p01.g, p11.g, c.f, r.f);
+                        o.b = blend(p00.b, p10.b, p01.b, p11.b, c.f, r.f);
+                        o.a = blend(p00.a, p10.a, p01.a, p11.a, c.f, r.f);
+                    }
+                }
+            });
+        }
+
+        bool execute(Context& ctx, const Inputs& in)
+        {
+            if (!in.rtr || !in.rt_src.valid() || !in.rt_dst.valid()) return false;
+            const auto* src = static_cast<const RT_ColorLDR*>(in.rtr->get(in.rt_src));
+            auto* dst = static_cast<RT_ColorLDR*>(in.rtr->get(in.rt_dst));
+            if (!src || !dst || src == dst) return false;
+            bilinear(ctx.job_system, src->color, dst->color);
+            return true;
+        }
+    };
+}
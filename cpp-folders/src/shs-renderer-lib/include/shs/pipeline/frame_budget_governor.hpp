@@ -0,0 +1,421 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: frame_budget_governor.hpp
+    МОДУЛЬ: pipeline
+    ЗОРИЛГО: Кадрын хугацааг FrameBudgetParams::target_ms-д барих governor. Хэмжсэн хугацаа болон
+            record_pass_timing-ийн pass бүрийн хугацаагаар дотоод resolution, shadow PCF, light
+            shafts-ийн алхам, motion blur-ийн sample-ийг hysteresis-тэйгээр шатлан бууруулж/өргөнө.
+            Бууруулсан resolution-той кадрт дэлгэцийн RT-уудын handle жижиг RT руу түр заагдаж,
+            төгсгөлд нь present LDR руу bilinear-аар томруулна (pass_upscale.hpp).
+*/
+
+
+#include "shs/core/context.hpp"
+#include "shs/frame/frame_params.hpp"
+#include "shs/gfx/rt_handle.hpp"
+#include "shs/gfx/rt_registry.hpp"
+#include "shs/passes/pass_upscale.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace shs
+{
+    enum class BudgetKnob : uint8_t
+    {
+        Resolution = 0,
+        ShadowPcf = 1,
+        LightShafts = 2,
+        MotionBlur = 3
+    };
+
+    inline constexpr size_t k_budget_knob_count = 4;
+
+    class FrameBudgetGovernor
+    {
+    public:
+        // light_shafts.steps, motion_blur.samples-ийн нэг шат нь үндсэн утгын 1/4-ийг хасна.
+        static constexpr int k_sample_levels = 3;
+        // Forward shading-ийн хугацаанаас PCF шүүлтүүрт ногдох гэж тооцох хэсэг.
+        static constexpr float k_pcf_shading_share = 0.5f;
+        // Resolution-ийн алдагдал бүх дэлгэцэнд харагддаг тул түүний ашгийг ийм жингээр тооцож
+        // тухайн pass-ийн knob-уудыг түрүүлж буулгана.
+        static constexpr float k_resolution_gain_weight = 0.5f;
+        static constexpr float k_smoothing = 0.25f;
+        // Өргөсний дараахан буцаж буулгавал (хэлбэлзэл) дараагийн өргөлтийн хүлээлтийг ийм хүртэл үржүүлнэ.
+        static constexpr int k_max_up_backoff = 8;
+
+        // present_ldr: app-ийн upload хийдэг LDR. screen_targets: pipeline дотор бичигддэг, дэлгэцтэй
+        // хамт масштаблагдах бусад RT (HDR, motion, shafts tmp г.м.). present_ldr тохируулаагүй бол
+        // resolution өөрчлөгдөхгүй, зөвхөн чанарын knob-ууд ажиллана.
+        void set_dynamic_resolution_targets(RTHandle present_ldr, std::vector<RTHandle> screen_targets = {})
+        {
+            targets_.clear();
+            targets_.push_back(ScaledTarget{present_ldr});
+            for (const RTHandle h : screen_targets) targets_.push_back(ScaledTarget{h});
+        }
+
+        void reset()
+        {
+            levels_.fill(0);
+            history_.clear();
+            smoothed_ms_ = 0.0f;
+            has_sample_ = false;
+            over_frames_ = 0;
+            under_frames_ = 0;
+            up_backoff_ = 1;
+            frames_since_change_ = 0;
+            last_change_up_ = false;
+        }
+
+        int level(BudgetKnob k) const { return levels_[(size_t)k]; }
+        // Нийт буулгасан шат.
+        uint32_t quality_level() const { return (uint32_t)history_.size(); }
+        float smoothed_ms() const { return smoothed_ms_; }
+        uint32_t steps_down() const { return steps_down_; }
+        uint32_t steps_up() const { return steps_up_; }
+
+        static float resolution_scale(const FrameBudgetParams& p, int level)
+        {
+            const float lo = std::clamp(p.min_resolution_scale, 0.05f, 1.0f);
+            return std::max(lo, 1.0f - std::max(0.0f, p.resolution_step) * (float)level);
+        }
+
+        // Тухайн level дээрх knob-ийн утга (pass-ууд өөрсдөө хэрэглэдэг clamp-ийг тооцсон).
+        static int knob_value(BudgetKnob k, const FrameParams& fp, int level)
+        {
+            auto scaled = [&](int base, int lo, int hi)
+            {
+                const float f = 1.0f - 0.25f * (float)std::min(level, k_sample_levels);
+                return std::clamp((int)std::lround((float)base * f), lo, hi);
+            };
+            switch (k)
+            {
+                case BudgetKnob::ShadowPcf: return std::max(0, fp.pass.shadow.pcf_radius - level);
+                case BudgetKnob::LightShafts: return scaled(fp.pass.light_shafts.steps, 8, std::max(8, fp.pass.light_shafts.steps));
+                case BudgetKnob::MotionBlur: return scaled(fp.pass.motion_blur.samples, 4, 32);
+                case BudgetKnob::Resolution:
+                default: return 0;
+            }
+        }
+
+        // Level-үүдийг fp-ийн хуулбарт хэрэглэнэ. Resolution нь present_ldr тохируулсан үед л.
+        void apply(const FrameParams& fp, FrameParams& out) const
+        {
+            apply_impl(fp, out, has_present());
+        }
+
+        // Кадрын хугацаа (ms) ба тухайн кадрын pass-уудын хугацаа (RenderDebugStats::ms_*)-аар
+        // level-үүдийг шинэчилнэ. Шат өөрчлөгдсөн бол true.
+        bool update(const FrameParams& fp, float frame_ms, const RenderDebugStats& pass_ms)
+        {
+            const FrameBudgetParams& p = fp.budget;
+            if (!p.enable)
+            {
+                if (!history_.empty() || has_sample_) reset();
+                return false;
+            }
+            drop_disallowed(p);
+
+            smoothed_ms_ = has_sample_ ? smoothed_ms_ + (frame_ms - smoothed_ms_) * k_smoothing : frame_ms;
+            has_sample_ = true;
+            ++frames_since_change_;
+
+            const float target = std::max(0.1f, p.target_ms);
+            if (smoothed_ms_ > target * p.over_ratio)
+            {
+                ++over_frames_;
+                under_frames_ = 0;
+            }
+            else if (smoothed_ms_ < target * p.under_ratio)
+            {
+                ++under_frames_;
+                over_frames_ = 0;
+            }
+            else
+            {
+                over_frames_ = 0;
+                under_frames_ = 0;
+            }
+
+            if (over_frames_ >= std::max(1, p.settle_frames_down)) return step_down(fp, pass_ms);
+            if (under_frames_ >= std::max(1, p.settle_frames_up) * up_backoff_) return step_up();
+            return false;
+        }
+
+        // Кадрын эхэнд: budget идэвхгүй бол fp-г өөрийг нь, үгүй бол governed хуулбарыг буцаана.
+        // Resolution буурсан бол дэлгэцийн RT-уудын handle-ийг жижиг RT руу заана.
+        const FrameParams& begin_frame(RTRegistry& rtr, const FrameParams& fp)
+        {
+            if (!fp.budget.enable) return fp;
+            const bool scale = has_present() && rtr.kind(targets_[0].handle) == RTKind::ColorLDR;
+            apply_impl(fp, governed_, scale);
+            if (scale && (governed_.w != fp.w || governed_.h != fp.h))
+            {
+                bind_scaled(rtr, (float)governed_.w / (float)std::max(1, fp.w), (float)governed_.h / (float)std::max(1, fp.h));
+            }
+            return governed_;
+        }
+
+        // Кадрын төгсгөлд: жижиг LDR-ийг present руу томруулж handle-уудыг сэргээгээд, t0-оос хойших
+        // хугацаагаар level-үүдийг шинэчилж RenderDebugStats-д бичнэ.
+        void end_frame(Context& ctx, RTRegistry& rtr, const FrameParams& fp, std::chrono::steady_clock::time_point t0)
+        {
+            if (bound_)
+            {
+                ScaledTarget& present = targets_[0];
+                PassUpscale::bilinear(ctx.job_system, present.ldr->color, static_cast<RT_ColorLDR*>(present.original)->color);
+                for (ScaledTarget& t : targets_)
+                {
+                    if (t.original) rtr.rebind(t.handle, t.original);
+                    t.original = nullptr;
+                }
+                bound_ = false;
+            }
+
+            const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            update(fp, ms, ctx.debug);
+            publish(ctx.debug, fp, ms);
+        }
+
+    private:
+        struct ScaledTarget
+        {
+            RTHandle handle{};
+            void* original = nullptr;
+            std::unique_ptr<RT_ColorLDR> ldr{};
+            std::unique_ptr<RT_ColorHDR> hdr{};
+            std::unique_ptr<RT_ColorDepthMotion> motion{};
+        };
+
+        bool has_present() const { return !targets_.empty() && targets_[0].handle.valid(); }
+
+        static bool allowed(BudgetKnob k, const FrameBudgetParams& p)
+        {
+            return (k == BudgetKnob::Resolution) ? p.dynamic_resolution : p.quality_scaling;
+        }
+
+        void apply_impl(const FrameParams& fp, FrameParams& out, bool scale_resolution) const
+        {
+            out = fp;
+            const FrameBudgetParams& p = fp.budget;
+            if (!p.enable) return;
+            if (p.quality_scaling)
+            {
+                out.pass.shadow.pcf_radius = knob_value(BudgetKnob::ShadowPcf, fp, level(BudgetKnob::ShadowPcf));
+                out.pass.light_shafts.steps = knob_value(BudgetKnob::LightShafts, fp, level(BudgetKnob::LightShafts));
+                out.pass.motion_blur.samples = knob_value(BudgetKnob::MotionBlur, fp, level(BudgetKnob::MotionBlur));
+            }
+            const float s = resolution_scale(p, level(BudgetKnob::Resolution));
+            if (p.dynamic_resolution && scale_resolution && s < 1.0f)
+            {
+                out.w = std::max(1, (int)std::lround((float)fp.w * s));
+                out.h = std::max(1, (int)std::lround((float)fp.h * s));
+                // Velocity нь пикселээр тул blur-ийн урт дэлгэцийн харьцаагаараа хэвээр үлдэнэ.
+                out.pass.motion_blur.max_velocity_px *= s;
+                out.pass.motion_blur.min_velocity_px *= s;
+            }
+        }
+
+        bool has_room(BudgetKnob k, const FrameParams& fp) const
+        {
+            const int l = level(k);
+            if (k == BudgetKnob::Resolution)
+            {
+                return has_present() && resolution_scale(fp.budget, l + 1) < resolution_scale(fp.budget, l);
+            }
+            return knob_value(k, fp, l + 1) < knob_value(k, fp, l);
+        }
+
+        // Дараагийн шатаар хэмнэгдэх хугацааны тооцоо (ms): тухайн ажлыг хийдэг pass-ийн хугацаа x
+        // хасагдах ажлын хувь. Resolution-д shadow map-аас бусад бүх хугацаа пикселийн тоотой пропорц.
+        float estimate_gain(BudgetKnob k, const FrameParams& fp, const RenderDebugStats& pass_ms) const
+        {
+            const int l = level(k);
+            const float v0 = (float)knob_value(k, fp, l);
+            const float v1 = (float)knob_value(k, fp, l + 1);
+            switch (k)
+            {
+                case BudgetKnob::Resolution:
+                {
+                    const float s0 = resolution_scale(fp.budget, l);
+                    const float s1 = resolution_scale(fp.budget, l + 1);
+                    const float pixel_ms = std::max(0.0f, smoothed_ms_ - pass_ms.ms_shadow);
+                    return k_resolution_gain_weight * pixel_ms * (1.0f - (s1 * s1) / (s0 * s0));
+                }
+                case BudgetKnob::ShadowPcf:
+                {
+                    const float t0 = (2.0f * v0 + 1.0f) * (2.0f * v0 + 1.0f);
+                    const float t1 = (2.0f * v1 + 1.0f) * (2.0f * v1 + 1.0f);
+                    return pass_ms.ms_pbr * k_pcf_shading_share * (1.0f - t1 / t0);
+                }
+                case BudgetKnob::LightShafts: return pass_ms.ms_shafts * (1.0f - v1 / std::max(1.0f, v0));
+                case BudgetKnob::MotionBlur: return pass_ms.ms_motion_blur * (1.0f - v1 / std::max(1.0f, v0));
+                default: return 0.0f;
+            }
+        }
+
+        bool step_down(const FrameParams& fp, const RenderDebugStats& pass_ms)
+        {
+            over_frames_ = 0;
+            int best = -1;
+            float best_gain = 0.0f;
+            for (size_t i = 0; i < k_budget_knob_count; ++i)
+            {
+                const BudgetKnob k = (BudgetKnob)i;
+                if (!allowed(k, fp.budget) || !has_room(k, fp)) continue;
+                const float gain = estimate_gain(k, fp, pass_ms);
+                if (gain > best_gain)
+                {
+                    best_gain = gain;
+                    best = (int)i;
+                }
+            }
+            if (best < 0) return false;
+
+            // Өргөлтийн дараа settle_frames_up-ийн хугацаанд буцаж буулгасан бол хэлбэлзэл гэж үзнэ.
+            const int up_window = std::max(1, fp.budget.settle_frames_up) * up_backoff_;
+            if (last_change_up_ && frames_since_change_ <= up_window) up_backoff_ = std::min(k_max_up_backoff, up_backoff_ * 2);
+            else up_backoff_ = 1;
+
+            ++levels_[(size_t)best];
+            history_.push_back((BudgetKnob)best);
+            ++steps_down_;
+            last_change_up_ = false;
+            on_step();
+            return true;
+        }
+
+        // Хамгийн сүүлд буулгасан knob-оос эхэлж өргөнө.
+        bool step_up()
+        {
+            under_frames_ = 0;
+            if (history_.empty()) return false;
+            const BudgetKnob k = history_.back();
+            history_.pop_back();
+            --levels_[(size_t)k];
+            ++steps_up_;
+            last_change_up_ = true;
+            on_step();
+            return true;
+        }
+
+        // Шатны дараа хуучин хугацаа гөлгөршүүлэлтэд үлдэхгүйн тулд хэмжилтийг шинээр эхлүүлнэ.
+        void on_step()
+        {
+            has_sample_ = false;
+            over_frames_ = 0;
+            under_frames_ = 0;
+            frames_since_change_ = 0;
+        }
+
+        void drop_disallowed(const FrameBudgetParams& p)
+        {
+            const auto it = std::remove_if(history_.begin(), history_.end(), [&](BudgetKnob k) { return !allowed(k, p); });
+            if (it == history_.end()) return;
+            history_.erase(it, history_.end());
+            for (size_t i = 0; i < k_budget_knob_count; ++i)
+            {
+                if (!allowed((BudgetKnob)i, p)) levels_[i] = 0;
+            }
+        }
+
+        template<typename TRT, typename TMake>
+        static TRT* ensure_scaled(std::unique_ptr<TRT>& rt, int w, int h, TMake&& make)
+        {
+            if (!rt || rt->w != w || rt->h != h) rt = make();
+            return rt.get();
+        }
+
+        void bind_scaled(RTRegistry& rtr, float sx, float sy)
+        {
+            for (ScaledTarget& t : targets_)
+            {
+                t.original = nullptr;
+                void* src = rtr.get(t.handle);
+                if (!src) continue;
+                const RTRegistry::Extent e = rtr.extent(t.handle);
+                const int w = std::max(1, (int)std::lround((float)e.w * sx));
+                const int h = std::max(1, (int)std::lround((float)e.h * sy));
+                void* scaled = nullptr;
+                switch (rtr.kind(t.handle))
+                {
+                    case RTKind::ColorLDR:
+                        scaled = ensure_scaled(t.ldr, w, h, [&] { return std::make_unique<RT_ColorLDR>(w, h); });
+                        break;
+                    case RTKind::ColorHDR:
+                    {
+                        const HdrFormat fmt = static_cast<const RT_ColorHDR*>(src)->format;
+                        if (t.hdr && t.hdr->format != fmt) t.hdr.reset();
+                        scaled = ensure_scaled(t.hdr, w, h, [&] { return std::make_unique<RT_ColorHDR>(w, h, ColorF{0.0f, 0.0f, 0.0f, 1.0f}, fmt); });
+                        break;
+                    }
+                    case RTKind::Motion:
+                    {
+                        const auto* m = static_cast<const RT_ColorDepthMotion*>(src);
+                        scaled = ensure_scaled(t.motion, w, h, [&] { return std::make_unique<RT_ColorDepthMotion>(w, h, m->zn, m->zf, m->clear); });
+                        t.motion->zn = m->zn;
+                        t.motion->zf = m->zf;
+                        break;
+                    }
+                    default:
+                        break;
+                }
+                if (scaled) t.original = rtr.rebind(t.handle, scaled);
+            }
+            bound_ = targets_[0].original != nullptr;
+            if (!bound_)
+            {
+                for (ScaledTarget& t : targets_)
+                {
+                    if (t.original) rtr.rebind(t.handle, t.original);
+                    t.original = nullptr;
+                }
+            }
+        }
+
+        void publish(RenderDebugStats& st, const FrameParams& fp, float frame_ms) const
+        {
+            const bool on = fp.budget.enable;
+            const FrameParams& g = on ? governed_ : fp;
+            st.budget_frame_ms = (on && has_sample_) ? smoothed_ms_ : frame_ms;
+            st.budget_target_ms = on ? fp.budget.target_ms : 0.0f;
+            st.budget_render_scale = (fp.w > 0) ? (float)g.w / (float)fp.w : 1.0f;
+            st.budget_render_w = g.w;
+            st.budget_render_h = g.h;
+            st.budget_shadow_pcf_radius = g.pass.shadow.pcf_radius;
+            st.budget_shafts_steps = g.pass.light_shafts.steps;
+            st.budget_motion_blur_samples = g.pass.motion_blur.samples;
+            st.budget_quality_level = quality_level();
+            st.budget_steps_down = steps_down_;
+            st.budget_steps_up = steps_up_;
+        }
+
+        std::vector<ScaledTarget> targets_{};
+        bool bound_ = false;
+        FrameParams governed_{};
+
+        std::array<int, k_budget_knob_count> levels_{};
+        // Буулгасан дарааллаар; өргөхдөө сүүлээс нь авна.
+        std::vector<BudgetKnob> history_{};
+        float smoothed_ms_ = 0.0f;
+        bool has_sample_ = false;
+        int over_frames_ = 0;
+        int under_frames_ = 0;
+        int up_backoff_ = 1;
+        int frames_since_change_ = 0;
+        bool last_change_up_ = false;
+        uint32_t steps_down_ = 0;
+        uint32_t steps_up_ = 0;
+    };
+}
@@ -44,6 +44,7 @@ namespace shs
         {
             nodes_.clear();
             execution_order_.clear();
+            edges_.clear();
             report_ = FrameGraphReport{};
         }
 
@@ -55,6 +56,8 @@ namespace shs
         const std::vector<FrameGraphNode>& nodes() const { return nodes_; }
         const std::vector<size_t>& execution_order() const { return execution_order_; }
         const FrameGraphReport& report() const { return report_; }
+        // edges()[i] нь i node-ийн дараа ажиллах ёстой node-уудын индекс.
+        const std::vector<std::vector<size_t>>& edges() const { return edges_; }
 
         const std::vector<IRenderPass*> ordered_passes() const
         {
@@ -71,10 +74,12 @@ namespace shs
         {
             report_ = FrameGraphReport{};
             execution_order_.clear();
+            edges_.clear();
             if (nodes_.empty()) return true;
 
             const size_t n = nodes_.size();
-            std::vector<std::vector<size_t>> edges(n);
+            edges_.assign(n, {});
+            std::vector<std::vector<size_t>>& edges = edges_;
             std::vector<int> indegree(n, 0);
 
             auto add_edge = [&](size_t a, size_t b)
@@ -199,6 +204,7 @@ namespace shs
     private:
         std::vector<FrameGraphNode> nodes_{};
         std::vector<size_t> execution_order_{};
+        std::vector<std::vector<size_t>> edges_{};
         FrameGraphReport report_{};
     };
 }
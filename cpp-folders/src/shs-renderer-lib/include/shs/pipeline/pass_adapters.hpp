@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 #include <glm/gtc/matrix_transform.hpp>
@@ -19,17 +20,21 @@
 #include "shs/geometry/jolt_culling.hpp"
 #include "shs/geometry/jolt_adapter.hpp"
 #include "shs/geometry/jolt_shapes.hpp"
+#include "shs/gfx/rt_fast_clear_resolve.hpp"
 #include "shs/gfx/rt_handle.hpp"
 #include "shs/lighting/light_set.hpp"
 #include "shs/passes/pass_light_shafts.hpp"
 #include "shs/passes/pass_motion_blur.hpp"
 #include "shs/passes/pass_pbr_forward.hpp"
+#include "shs/passes/pass_post_stack.hpp"
 #include "shs/passes/pass_shadow_map.hpp"
+#include "shs/passes/pass_temporal_aa.hpp"
 #include "shs/passes/pass_tonemap.hpp"
 #include "shs/pipeline/pass_registry.hpp"
 #include "shs/pipeline/pass_contract_registry.hpp"
 #include "shs/pipeline/render_pass.hpp"
 #include "shs/sw_render/rasterizer.hpp"
+#include "shs/sw_render/tiled_rasterizer.hpp"
 #include "shs/resources/resource_registry.hpp"
 #include "shs/shader/program.hpp"
 
@@ -332,25 +337,27 @@ namespace shs
             return true;
         }
 
-        inline ShaderProgram make_depth_prepass_program()
+        // Prepass зөвхөн depth бичнэ; fs нь scratch HDR-т хар өнгө өгнө.
+        struct DepthPrepassProgram
         {
-            ShaderProgram p{};
-            p.vs = [](const ShaderVertex& vin, const ShaderUniforms& u) -> VertexOut {
+            static VertexOut vs(const ShaderVertex& vin, const ShaderUniforms& u)
+            {
                 VertexOut out{};
                 const glm::vec4 wp4 = u.model * glm::vec4(vin.position, 1.0f);
                 out.world_pos = glm::vec3(wp4);
                 out.clip = u.viewproj * wp4;
                 return out;
-            };
-            p.fs = [](const FragmentIn& fin, const ShaderUniforms& u) -> FragmentOut {
+            }
+
+            static FragmentOut fs(const FragmentIn& fin, const ShaderUniforms& u)
+            {
                 (void)fin;
                 (void)u;
                 FragmentOut out{};
                 out.color = ColorF{0.0f, 0.0f, 0.0f, 1.0f};
                 return out;
-            };
-            return p;
-        }
+            }
+        };
     }
 
     class PassShadowMapAdapter final : public IRenderPass
@@ -443,7 +450,8 @@ namespace shs
             RTHandle scratch_hdr = rt_scratch_hdr_;
             if (!scratch_hdr.valid())
             {
-                scratch_hdr = rtr.ensure_transient_color_hdr("depth_prepass.auto_hdr", motion->w, motion->h);
+                scratch_hdr = rtr.ensure_transient_color_hdr(
+                    "depth_prepass.auto_hdr", motion->w, motion->h, ColorF{0.0f, 0.0f, 0.0f, 1.0f}, fp.raster.hdr_format);
             }
             if (!scratch_hdr.valid())
             {
@@ -487,12 +495,14 @@ namespace shs
             auto* hdr = static_cast<RT_ColorHDR*>(rtr.get(scratch_hdr));
             if (!hdr || hdr->w <= 0 || hdr->h <= 0) return false;
 
-            motion->depth.clear(1.0f);
-            motion->motion.clear(Motion2f{});
+            // Lazy clear (rt_fast_clear.hpp): raster хүрсэн tile-ууд л бөглөгдөнө. Scratch HDR-ийг
+            // хэн ч уншдаггүй тул түүний хүрээгүй tile-уудыг огт бичихгүй.
+            motion->depth.clear_fast(1.0f);
+            motion->motion.clear_fast(Motion2f{});
 
-            hdr->clear(ColorF{0.0f, 0.0f, 0.0f, 1.0f});
+            hdr->clear_fast(ColorF{0.0f, 0.0f, 0.0f, 1.0f});
 
-            const ShaderProgram depth_prog = detail::make_depth_prepass_program();
+            const detail::DepthPrepassProgram depth_prog{};
             RasterizerTarget target{};
             target.hdr = hdr;
             target.depth_motion = motion;
@@ -500,6 +510,7 @@ namespace shs
             RasterizerConfig rast_cfg{};
             rast_cfg.front_face_ccw = fp.front_face_ccw;
             rast_cfg.job_system = ctx.job_system;
+            rast_cfg.hierarchical_z = fp.raster.hierarchical_z;
             switch (fp.cull_mode)
             {
                 case CullMode::None: rast_cfg.cull_mode = RasterizerCullMode::None; break;
@@ -507,7 +518,20 @@ namespace shs
                 case CullMode::Back:
                 default: rast_cfg.cull_mode = RasterizerCullMode::Back; break;
             }
+            if (rast_cfg.hierarchical_z)
+            {
+                hiz_.rebuild(motion->depth);
+                target.hiz = &hiz_;
+            }
 
+            const bool tiled = fp.raster.tile_binning && ctx.job_system != nullptr;
+            if (tiled)
+            {
+                TiledRasterizerConfig tiled_cfg = make_tiled_rasterizer_config(fp.raster, ctx.job_system);
+                // Prepass-ийн fs хямд тул id buffer-ийн нэмэлт шат ашиггүй.
+                tiled_cfg.visibility_buffer = false;
+                tiled_.begin(target, tiled_cfg);
+            }
             for (const auto& item : scene.items)
             {
                 if (!item.visible) continue;
@@ -519,12 +543,20 @@ namespace shs
                 uniforms.model = detail::make_item_model_matrix(item);
                 uniforms.viewproj = scene.cam.viewproj;
                 uniforms.enable_motion_vectors = false;
-                (void)rasterize_mesh(*mesh, depth_prog, uniforms, target, rast_cfg);
+                if (tiled) tiled_.submit(*mesh, depth_prog, uniforms, rast_cfg);
+                else (void)rasterize_mesh(*mesh, depth_prog, uniforms, target, rast_cfg, vertex_cache_);
             }
+            if (tiled) (void)tiled_.flush();
+            // Light culling/forward зэрэг дараагийн pass-ууд depth-ийг шууд уншина.
+            resolve_fast_clear(motion->depth, ctx.job_system);
+            resolve_fast_clear(motion->motion, ctx.job_system);
             return true;
         }
         RT_Motion rt_motion_{};
         RTHandle rt_scratch_hdr_{};
+        TiledRasterizer tiled_{};
+        RasterHiZ hiz_{};
+        RasterVertexCache vertex_cache_{};
     };
 
     class PassLightCullingAdapter final : public IRenderPass
@@ -1440,58 +1472,124 @@ namespace shs
         {
             if (!request.valid) return PassExecutionResult::not_executed();
             if (!request.inputs.registry) return PassExecutionResult::not_executed();
-            RTRegistry& rtr = *request.inputs.registry;
-            auto* ldr = static_cast<RT_ColorLDR*>(rtr.get(rt_ldr_));
-            if (!ldr || ldr->w <= 0 || ldr->h <= 0) return PassExecutionResult::not_executed();
-
-            auto& taa = ctx.temporal_aa;
-            const int w = ldr->w;
-            const int h = ldr->h;
-            const size_t count = static_cast<size_t>(w) * static_cast<size_t>(h);
-            if (taa.history_w != w || taa.history_h != h || taa.history.size() != count)
+            PassTemporalAA::Inputs in{};
+            in.rtr = request.inputs.registry;
+            in.rt_ldr = rt_ldr_;
+            if (!pass_.execute(ctx, in)) return PassExecutionResult::not_executed();
+            return PassExecutionResult::executed_no_outputs();
+        }
+
+    private:
+        RTHandle rt_ldr_{};
+        PassTemporalAA pass_{};
+    };
+
+    // Tonemap -> light shafts / motion blur / TAA гинжийг нэг fused pass болгон ажиллуулна
+    // (pass_post_stack.hpp). Тусдаа tonemap/light_shafts/motion_blur/taa pass-уудын оронд тавина.
+    class PassPostStackAdapter final : public IRenderPass
+    {
+    public:
+        PassPostStackAdapter(RTHandle rt_hdr, RTHandle rt_ldr, RTHandle rt_motion, RTHandle rt_tmp, std::vector<PostStage> stages)
+            : rt_hdr_(rt_hdr), rt_ldr_(rt_ldr), rt_motion_(rt_motion), rt_tmp_(rt_tmp), stages_(std::move(stages))
+        {}
+
+        const char* id() const override { return "post_stack"; }
+        RenderBackendType preferred_backend() const override { return RenderBackendType::Software; }
+        bool supports_backend(RenderBackendType backend) const override { return backend == RenderBackendType::Software; }
+        TechniquePassContract describe_contract() const override
+        {
+            TechniquePassContract c{};
+            c.role = TechniquePassRole::Composite;
+            c.supported_modes_mask = technique_mode_mask_all();
+            c.semantics = {
+                read_semantic(PassSemantic::ColorHDR, ContractDomain::Software, "hdr"),
+                read_semantic(PassSemantic::MotionVectors, ContractDomain::Software, "motion"),
+                read_write_semantic(PassSemantic::ColorLDR, ContractDomain::Software, "ldr")
+            };
+            if (has_stage(PostStage::TAA))
             {
-                taa.history.assign(count, Color{0, 0, 0, 255});
-                taa.history_w = w;
-                taa.history_h = h;
-                taa.history_valid = false;
+                c.semantics.push_back(read_semantic(PassSemantic::HistoryColor, ContractDomain::Software, "history_in"));
+                c.semantics.push_back(write_semantic(PassSemantic::HistoryColor, ContractDomain::Software, "history_out"));
             }
-
-            const float blend = 0.12f;
-            const float keep = 1.0f - blend;
-            if (!taa.history_valid)
+            return c;
+        }
+        PassIODesc describe_io() const override
+        {
+            PassIODesc io{};
+            io.read(make_rt_resource_ref(rt_hdr_, PassResourceType::ColorHDR, "hdr", PassResourceDomain::Software));
+            io.read(make_rt_resource_ref(rt_motion_, PassResourceType::Motion, "motion", PassResourceDomain::Software));
+            io.read_write(make_rt_resource_ref(rt_ldr_, PassResourceType::ColorLDR, "ldr", PassResourceDomain::Software));
+            if (has_stage(PostStage::TAA))
             {
-                for (size_t i = 0; i < count; ++i)
-                {
-                    taa.history[i] = ldr->color.data[i];
-                }
-                taa.history_valid = true;
-                return PassExecutionResult::executed_no_outputs();
+                io.read(make_named_resource_ref("technique.history_color", PassResourceType::Temp, PassResourceDomain::Software));
+                io.write(make_named_resource_ref("technique.history_color", PassResourceType::Temp, PassResourceDomain::Software));
+            }
+            if (rt_tmp_.valid())
+            {
+                io.write(make_rt_resource_ref(rt_tmp_, PassResourceType::Temp, "post_tmp", PassResourceDomain::Software));
             }
+            else
+            {
+                io.write(make_named_resource_ref("post_stack.auto_tmp", PassResourceType::Temp, PassResourceDomain::Software));
+            }
+            return io;
+        }
 
-            for (size_t i = 0; i < count; ++i)
+        void reset_history(Context& ctx, RTRegistry& rtr) override
+        {
+            (void)rtr;
+            if (has_stage(PostStage::TAA)) ctx.temporal_aa.reset();
+        }
+
+        PassExecutionRequest build_execution_request(
+            const Context& ctx,
+            const Scene& scene,
+            const FrameParams& fp,
+            RTRegistry& rtr) const override
+        {
+            PassExecutionRequest req = IRenderPass::build_execution_request(ctx, scene, fp, rtr);
+            if (!req.valid) return req;
+            RTHandle tmp = rt_tmp_;
+            // Хэсгүүдийн хоорондох buffer зөвхөн хөрш уншдаг stage байвал хэрэгтэй.
+            if (!tmp.valid() && (has_stage(PostStage::LightShafts) || has_stage(PostStage::MotionBlur)))
             {
-                const Color cur = ldr->color.data[i];
-                const Color prev = taa.history[i];
-
-                auto lerp_chan = [keep, blend](uint8_t a, uint8_t b) -> uint8_t {
-                    const float v = keep * static_cast<float>(a) + blend * static_cast<float>(b);
-                    const int iv = static_cast<int>(v + 0.5f);
-                    return static_cast<uint8_t>(std::clamp(iv, 0, 255));
-                };
-
-                Color out{};
-                out.r = lerp_chan(cur.r, prev.r);
-                out.g = lerp_chan(cur.g, prev.g);
-                out.b = lerp_chan(cur.b, prev.b);
-                out.a = cur.a;
-                ldr->color.data[i] = out;
-                taa.history[i] = out;
+                auto* ldr = static_cast<RT_ColorLDR*>(rtr.get(rt_ldr_));
+                if (ldr) tmp = rtr.ensure_transient_color_ldr("post_stack.auto_tmp", ldr->w, ldr->h);
             }
+            req.set_named_rt("post_stack.tmp", tmp);
+            return req;
+        }
+
+        PassExecutionResult execute_resolved(Context& ctx, const PassExecutionRequest& request) override
+        {
+            if (!request.valid) return PassExecutionResult::not_executed();
+            if (!request.inputs.frame || !request.inputs.registry) return PassExecutionResult::not_executed();
+            PassPostStack::Inputs in{};
+            in.scene = request.inputs.scene;
+            in.fp = request.inputs.frame;
+            in.rtr = request.inputs.registry;
+            in.rt_hdr = rt_hdr_;
+            in.rt_ldr = rt_ldr_;
+            in.rt_motion = rt_motion_;
+            in.rt_tmp = request.find_named_rt("post_stack.tmp");
+            in.stages = stages_.data();
+            in.stage_count = stages_.size();
+            if (!pass_.execute(ctx, in)) return PassExecutionResult::not_executed();
             return PassExecutionResult::executed_no_outputs();
         }
 
     private:
+        bool has_stage(PostStage s) const
+        {
+            return std::find(stages_.begin(), stages_.end(), s) != stages_.end();
+        }
+
+        RTHandle rt_hdr_{};
         RTHandle rt_ldr_{};
+        RTHandle rt_motion_{};
+        RTHandle rt_tmp_{};
+        std::vector<PostStage> stages_{};
+        PassPostStack pass_{};
     };
 
     inline PassFactoryRegistry make_standard_pass_factory_registry(
@@ -1565,6 +1663,14 @@ namespace shs
         register_standard(PassId::TAA, [=]() {
             return std::make_unique<PassTemporalAAAdapter>(rt_ldr);
         });
+        reg.register_factory("post_stack", [=]() {
+            return std::make_unique<PassPostStackAdapter>(
+                rt_hdr,
+                rt_ldr,
+                rt_motion,
+                RTHandle{},
+                std::vector<PostStage>{PostStage::Tonemap, PostStage::LightShafts, PostStage::MotionBlur});
+        });
         return reg;
     }
 }
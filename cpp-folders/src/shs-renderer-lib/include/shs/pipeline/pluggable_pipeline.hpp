@@ -20,7 +20,10 @@
 #include <chrono>
 #include <sstream>
 #include <optional>
+#include <atomic>
 
+#include "shs/job/task_graph.hpp"
+#include "shs/pipeline/frame_budget_governor.hpp"
 #include "shs/pipeline/frame_graph.hpp"
 #include "shs/pipeline/pass_id.hpp"
 #include "shs/pipeline/pass_registry.hpp"
@@ -52,6 +55,8 @@ namespace shs
         std::vector<IRenderPass*> order{};
         std::vector<PipelineExecutionPass> passes{};
         std::vector<PipelineExecutionBackendGroup> backend_groups{};
+        // pass_dependencies[j] нь passes[j]-ээс өмнө дуусах ёстой passes-ийн индексүүд.
+        std::vector<std::vector<size_t>> pass_dependencies{};
         FrameGraphReport report{};
         bool valid = true;
     };
@@ -65,7 +70,7 @@ namespace shs
             const FrameParams& fp,
             RTRegistry& rtr,
             const PipelineExecutionPlan& plan,
-            VulkanLikeRuntime& vk_like_runtime) const
+            VulkanLikeRuntime& vk_like_runtime)
         {
             reset_debug_stats(ctx);
 
@@ -89,8 +94,33 @@ namespace shs
 
             std::array<uint64_t, 4> queue_timeline_sem{0, 0, 0, 0};
             std::array<uint64_t, 4> queue_timeline_val{0, 0, 0, 0};
-            RuntimeCapabilities runtime_caps = initial_runtime_capabilities(fp);
+            RuntimeCapabilities runtime_caps{};
+            init_runtime_capabilities(fp, runtime_caps);
             LightCullingRuntimePayload light_culling_payload{};
+
+            const bool use_pass_graph =
+                fp.hybrid.parallel_pass_graph &&
+                !emulate_vk &&
+                ctx.job_system &&
+                ctx.job_system->worker_count() > 1 &&
+                plan.backend_groups.size() == 1 &&
+                plan.pass_dependencies.size() == plan.passes.size();
+            // Transient-уудын aliasing нь pass-уудыг дарааллаар нь ажиллуулах үед л аюулгүй.
+            rtr.begin_transient_frame(!use_pass_graph && !emulate_vk);
+            if (use_pass_graph)
+            {
+                IRenderBackend* run_backend = plan.backend_groups.front().backend;
+                if (!run_backend)
+                {
+                    finish_transient_frame(ctx, rtr);
+                    return;
+                }
+                run_backend->begin_frame(ctx, backend_frame);
+                execute_pass_graph(ctx, scene, fp, rtr, plan, runtime_caps, light_culling_payload);
+                run_backend->end_frame(ctx, backend_frame);
+                finish_transient_frame(ctx, rtr);
+                return;
+            }
             if (emulate_vk)
             {
                 for (size_t qi = 0; qi < queue_timeline_sem.size(); ++qi)
@@ -102,6 +132,7 @@ namespace shs
             }
 
             IRenderBackend* current_backend = nullptr;
+            uint32_t transient_pass = 0u;
             for (const PipelineExecutionBackendGroup& group : plan.backend_groups)
             {
                 IRenderBackend* run_backend = group.backend;
@@ -121,18 +152,8 @@ namespace shs
                 {
                     IRenderPass* p = planned.pass;
                     if (!p) continue;
-                    const char* id = p->id();
-                    auto run_pass = [&ctx, &scene, &fp, &rtr, p, id, &runtime_caps, &light_culling_payload]() {
-                        PassExecutionRequest request = p->build_execution_request(ctx, scene, fp, rtr);
-                        if (!request.valid) return;
-                        request.depth_prepass_ready = runtime_caps.depth_prepass_ready;
-                        request.light_culling_ready = runtime_caps.light_culling_ready;
-                        request.inputs.light_culling = &light_culling_payload;
-                        const auto t0 = std::chrono::steady_clock::now();
-                        const PassExecutionResult result = p->execute_resolved(ctx, request);
-                        const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
-                        record_pass_timing(ctx, id, ms);
-                        update_runtime_capabilities(result, runtime_caps);
+                    auto run_pass = [&ctx, &scene, &fp, &rtr, p, &runtime_caps, &light_culling_payload]() {
+                        run_planned_pass(ctx, scene, fp, rtr, p, runtime_caps, light_culling_payload);
                     };
 
                     if (emulate_vk)
@@ -159,6 +180,7 @@ namespace shs
                     }
                     else
                     {
+                        rtr.set_transient_pass(transient_pass++);
                         run_pass();
                     }
                 }
@@ -174,15 +196,124 @@ namespace shs
                 ctx.debug.vk_like_stalls = vks.stalled_submissions;
             }
             if (current_backend) current_backend->end_frame(ctx, backend_frame);
+            finish_transient_frame(ctx, rtr);
         }
 
     private:
+        // Pass graph горимд хэд хэдэн pass зэрэг уншиж/бичих тул atomic.
         struct RuntimeCapabilities
         {
-            bool depth_prepass_ready = false;
-            bool light_culling_ready = false;
+            std::atomic<bool> depth_prepass_ready{false};
+            std::atomic<bool> light_culling_ready{false};
         };
 
+        struct PassGraphFrame
+        {
+            Context* ctx = nullptr;
+            const Scene* scene = nullptr;
+            const FrameParams* fp = nullptr;
+            RTRegistry* rtr = nullptr;
+            const PipelineExecutionPlan* plan = nullptr;
+            RuntimeCapabilities* caps = nullptr;
+            LightCullingRuntimePayload* light_culling = nullptr;
+        };
+
+        static void run_planned_pass(
+            Context& ctx,
+            const Scene& scene,
+            const FrameParams& fp,
+            RTRegistry& rtr,
+            IRenderPass* p,
+            RuntimeCapabilities& runtime_caps,
+            LightCullingRuntimePayload& light_culling_payload)
+        {
+            PassExecutionRequest request = p->build_execution_request(ctx, scene, fp, rtr);
+            run_resolved_pass(ctx, p, request, runtime_caps, light_culling_payload);
+        }
+
+        // Урьдчилан resolve хийсэн request-ийг гүйцэтгэнэ. Runtime capability-ууд (өмнөх pass-уудын
+        // гаргасан depth/light grid) энд, яг гүйцэтгэхийн өмнө уншигдана.
+        static void run_resolved_pass(
+            Context& ctx,
+            IRenderPass* p,
+            PassExecutionRequest& request,
+            RuntimeCapabilities& runtime_caps,
+            LightCullingRuntimePayload& light_culling_payload)
+        {
+            if (!request.valid) return;
+            request.depth_prepass_ready = runtime_caps.depth_prepass_ready.load(std::memory_order_acquire);
+            request.light_culling_ready = runtime_caps.light_culling_ready.load(std::memory_order_acquire);
+            request.inputs.light_culling = &light_culling_payload;
+            const auto t0 = std::chrono::steady_clock::now();
+            const PassExecutionResult result = p->execute_resolved(ctx, request);
+            const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            record_pass_timing(ctx, p->id(), ms);
+            update_runtime_capabilities(result, runtime_caps);
+        }
+
+        // Plan-ийн pass жагсаалт эсвэл dependency өөрчлөгдсөн үед л TaskGraph-ийг дахин байгуулна.
+        // Бусад frame-д node бүр pass_graph_frame_-ээр тухайн frame-ийн аргументыг авна.
+        void execute_pass_graph(
+            Context& ctx,
+            const Scene& scene,
+            const FrameParams& fp,
+            RTRegistry& rtr,
+            const PipelineExecutionPlan& plan,
+            RuntimeCapabilities& runtime_caps,
+            LightCullingRuntimePayload& light_culling_payload)
+        {
+            bool same_shape = pass_graph_passes_.size() == plan.passes.size() && pass_graph_deps_ == plan.pass_dependencies;
+            for (size_t i = 0; same_shape && i < plan.passes.size(); ++i)
+            {
+                same_shape = pass_graph_passes_[i] == plan.passes[i].pass;
+            }
+            if (!same_shape || !pass_graph_.compiled())
+            {
+                pass_graph_.clear();
+                pass_graph_passes_.clear();
+                for (size_t i = 0; i < plan.passes.size(); ++i)
+                {
+                    pass_graph_passes_.push_back(plan.passes[i].pass);
+                    (void)pass_graph_.add_node([this, i]() {
+                        const PassGraphFrame& f = pass_graph_frame_;
+                        IRenderPass* p = f.plan->passes[i].pass;
+                        if (!p) return;
+                        run_resolved_pass(*f.ctx, p, pass_graph_requests_[i], *f.caps, *f.light_culling);
+                    }, plan.passes[i].label);
+                }
+                for (size_t j = 0; j < plan.pass_dependencies.size(); ++j)
+                {
+                    for (size_t i : plan.pass_dependencies[j])
+                    {
+                        pass_graph_.add_edge((TaskGraph::NodeId)i, (TaskGraph::NodeId)j);
+                    }
+                }
+                pass_graph_deps_ = plan.pass_dependencies;
+                (void)pass_graph_.compile();
+            }
+
+            // build_execution_request нь RTRegistry-д transient бүртгэж (ensure_transient_*) map-ийг
+            // өөрчилдөг бөгөөд registry lock-гүй. Тиймээс бүх request-ийг энд serial resolve хийж,
+            // graph дотор pass-ууд registry-г зөвхөн уншина.
+            pass_graph_requests_.resize(plan.passes.size());
+            for (size_t i = 0; i < plan.passes.size(); ++i)
+            {
+                IRenderPass* p = plan.passes[i].pass;
+                pass_graph_requests_[i] = p ? p->build_execution_request(ctx, scene, fp, rtr) : PassExecutionRequest{};
+            }
+
+            pass_graph_frame_ = PassGraphFrame{&ctx, &scene, &fp, &rtr, &plan, &runtime_caps, &light_culling_payload};
+            if (!pass_graph_.run(ctx.job_system, JobPriority::FrameCritical))
+            {
+                // Dependency cycle: plan-ий (FrameGraph-ийн topo) дарааллаар serial ажиллуулна.
+                for (size_t i = 0; i < plan.passes.size(); ++i)
+                {
+                    if (plan.passes[i].pass) run_resolved_pass(ctx, plan.passes[i].pass, pass_graph_requests_[i], runtime_caps, light_culling_payload);
+                }
+            }
+            pass_graph_frame_ = PassGraphFrame{};
+        }
+
         static bool technique_uses_light_culling(const FrameParams& fp)
         {
             return
@@ -192,12 +323,10 @@ namespace shs
                 fp.technique.mode == TechniqueMode::ClusteredForward;
         }
 
-        static RuntimeCapabilities initial_runtime_capabilities(const FrameParams& fp)
+        static void init_runtime_capabilities(const FrameParams& fp, RuntimeCapabilities& caps)
         {
-            RuntimeCapabilities out{};
-            out.depth_prepass_ready = !fp.technique.depth_prepass;
-            out.light_culling_ready = !technique_uses_light_culling(fp);
-            return out;
+            caps.depth_prepass_ready.store(!fp.technique.depth_prepass, std::memory_order_relaxed);
+            caps.light_culling_ready.store(!technique_uses_light_culling(fp), std::memory_order_relaxed);
         }
 
         static void update_runtime_capabilities(const PassExecutionResult& result, RuntimeCapabilities& caps)
@@ -205,11 +334,11 @@ namespace shs
             if (!result.executed) return;
             if (result.produced_depth)
             {
-                caps.depth_prepass_ready = true;
+                caps.depth_prepass_ready.store(true, std::memory_order_release);
             }
             if (result.produced_light_grid && result.produced_light_index_list)
             {
-                caps.light_culling_ready = true;
+                caps.light_culling_ready.store(true, std::memory_order_release);
             }
         }
 
@@ -225,6 +354,16 @@ namespace shs
             ctx.debug.vk_like_stalls = 0;
         }
 
+        static void finish_transient_frame(Context& ctx, RTRegistry& rtr)
+        {
+            rtr.end_transient_frame();
+            const RTRegistry::TransientMemoryStats& ts = rtr.transient_memory_stats();
+            ctx.debug.transient_count = ts.transients;
+            ctx.debug.transient_slots = ts.slots;
+            ctx.debug.transient_bytes_dedicated = (uint64_t)ts.bytes_dedicated;
+            ctx.debug.transient_bytes_aliased = (uint64_t)ts.bytes_aliased;
+        }
+
         static void record_pass_timing(Context& ctx, const char* id, float ms)
         {
             const PassId pid = parse_pass_id(id ? id : "");
@@ -234,6 +373,12 @@ namespace shs
             else if (id && std::string_view(id) == "light_shafts") ctx.debug.ms_shafts = ms;
             else if (pid == PassId::MotionBlur) ctx.debug.ms_motion_blur = ms;
         }
+
+        TaskGraph pass_graph_{};
+        std::vector<IRenderPass*> pass_graph_passes_{};
+        std::vector<std::vector<size_t>> pass_graph_deps_{};
+        std::vector<PassExecutionRequest> pass_graph_requests_{};
+        PassGraphFrame pass_graph_frame_{};
     };
 
     class PipelineExecutionPlanner
@@ -346,6 +491,8 @@ namespace shs
                 planned_backend = run_backend;
             }
 
+            out.pass_dependencies = build_pass_dependencies(frame_graph, out.passes);
+
             for (const PipelineExecutionPass& p : out.passes)
             {
                 if (out.backend_groups.empty() || out.backend_groups.back().backend != p.backend)
@@ -363,6 +510,69 @@ namespace shs
         }
 
     private:
+        // FrameGraph-ийн ирмэгүүдийн transitive closure-оор planned pass-уудын dependency-г гаргана.
+        // Алгассан pass-аар дамжсан хамаарал ч хадгалагдана. IO зарлаагүй pass, өөр backend,
+        // эсвэл хүчингүй граф үед аюулгүй талдаа serial дараалалд холбоно.
+        static std::vector<std::vector<size_t>> build_pass_dependencies(
+            const FrameGraph& frame_graph,
+            const std::vector<PipelineExecutionPass>& passes)
+        {
+            const auto& nodes = frame_graph.nodes();
+            const auto& edges = frame_graph.edges();
+            const size_t m = nodes.size();
+            const bool graph_ok = frame_graph.report().valid && edges.size() == m;
+
+            std::vector<std::vector<char>> reach(m, std::vector<char>(m, 0));
+            if (graph_ok)
+            {
+                std::vector<size_t> stack{};
+                for (size_t s = 0; s < m; ++s)
+                {
+                    stack.assign(1, s);
+                    while (!stack.empty())
+                    {
+                        const size_t v = stack.back();
+                        stack.pop_back();
+                        for (size_t to : edges[v])
+                        {
+                            if (reach[s][to]) continue;
+                            reach[s][to] = 1;
+                            stack.push_back(to);
+                        }
+                    }
+                }
+            }
+
+            auto node_of = [&nodes](const IRenderPass* p) -> size_t {
+                for (size_t i = 0; i < nodes.size(); ++i)
+                {
+                    if (nodes[i].pass == p) return i;
+                }
+                return nodes.size();
+            };
+
+            std::vector<size_t> node_index(passes.size(), m);
+            for (size_t i = 0; i < passes.size(); ++i) node_index[i] = node_of(passes[i].pass);
+
+            std::vector<std::vector<size_t>> deps(passes.size());
+            for (size_t j = 0; j < passes.size(); ++j)
+            {
+                const size_t nj = node_index[j];
+                for (size_t i = 0; i < j; ++i)
+                {
+                    const size_t ni = node_index[i];
+                    const bool serialize =
+                        !graph_ok ||
+                        ni >= m || nj >= m ||
+                        passes[i].backend != passes[j].backend ||
+                        nodes[ni].io.resources.empty() ||
+                        nodes[nj].io.resources.empty();
+                    if (serialize || reach[ni][nj] || reach[nj][ni]) deps[j].push_back(i);
+                }
+            }
+            return deps;
+        }
+
         static bool resource_type_matches(PassResourceType expected, RTKind actual)
         {
             switch (expected)
@@ -705,6 +915,9 @@ namespace shs
         }
     };
 
+    // Backend (Vulkan дээр swapchain) болон pass-уудад гаралтын (fp.w/fp.h) хэмжээ өөрчлөгдөхөд л
+    // on_resize дамжуулна. Dynamic resolution-ий дотоод хэмжээ энд орохгүй: governor дэлгэцийн RT-уудыг
+    // жижиг RT руу rebind хийдэг тул pass-ууд дотоод buffer-аа RT-ийн extent-ээр тохируулна.
     class PipelineResizeCoordinator
     {
     public:
@@ -979,16 +1192,42 @@ namespace shs
 
         void execute(Context& ctx, const Scene& scene, const FrameParams& fp, RTRegistry& rtr)
         {
-            const FrameParams& fp_eval = fp;
+            const auto t0 = std::chrono::steady_clock::now();
+            // fp.budget идэвхтэй үед governor-ийн resolution/чанарын knob-той хуулбар.
+            const FrameParams& fp_eval = frame_budget_.begin_frame(rtr, fp);
 
             const PipelineExecutionPlan plan = build_execution_plan(ctx, fp_eval, rtr);
             execution_report_ = plan.report;
-            if (!execution_report_.valid && strict_graph_validation_) return;
-            resize_coordinator_.dispatch_if_needed(ctx, rtr, passes_, fp_eval.w, fp_eval.h);
-            runtime_executor_.execute(ctx, scene, fp_eval, rtr, plan, vk_like_runtime_);
+            if (execution_report_.valid || !strict_graph_validation_)
+            {
+                apply_hdr_format(rtr, fp_eval.raster.hdr_format);
+                resize_coordinator_.dispatch_if_needed(ctx, rtr, passes_, fp.w, fp.h);
+                runtime_executor_.execute(ctx, scene, fp_eval, rtr, plan, vk_like_runtime_);
+            }
+            frame_budget_.end_frame(ctx, rtr, fp, t0);
         }
 
+        FrameBudgetGovernor& frame_budget() { return frame_budget_; }
+        const FrameBudgetGovernor& frame_budget() const { return frame_budget_; }
+
     private:
+        // fp.raster.hdr_format-ийг pass-уудын бичдэг software HDR target бүрт хэрэглэнэ (governor-ийн
+        // бууруулсан target rebind хийгдсэн бол түүнд). Формат ижил үед set_format юу ч хийхгүй.
+        void apply_hdr_format(RTRegistry& rtr, HdrFormat format)
+        {
+            for (const auto& node : frame_graph_.nodes())
+            {
+                for (const auto& res : node.io.resources)
+                {
+                    if (res.type != PassResourceType::ColorHDR || res.domain != PassResourceDomain::Software) continue;
+                    if (!pass_access_has_write(res.access) || res.key == 0 || pass_resource_key_is_named(res.key)) continue;
+                    const RTHandle h{pass_rt_id_from_key(res.key)};
+                    if (!h.valid() || !rtr.has(h) || rtr.kind(h) != RTKind::ColorHDR) continue;
+                    if (auto* hdr = static_cast<RT_ColorHDR*>(rtr.get(h))) hdr->set_format(format);
+                }
+            }
+        }
+
         void rebuild_graph_if_needed()
         {
             if (!graph_dirty_) return;
@@ -1032,5 +1271,6 @@ namespace shs
         PipelineResizeCoordinator resize_coordinator_{};
         PipelineRuntimeExecutor runtime_executor_{};
         VulkanLikeRuntime vk_like_runtime_{};
+        FrameBudgetGovernor frame_budget_{};
     };
 }
@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 
+#include "shs/gfx/transient_alias.hpp"
 #include "shs/pipeline/pass_contract.hpp"
 #include "shs/pipeline/pass_contract_registry.hpp"
 #include "shs/pipeline/pass_id.hpp"
@@ -335,43 +336,26 @@ namespace shs
         out.alias_classes.reserve(lifetimes_by_alias_class.size());
         for (auto& entry : lifetimes_by_alias_class)
         {
-            std::vector<std::size_t>& indices = entry.second;
-            std::sort(indices.begin(), indices.end(), [&](std::size_t a, std::size_t b) {
-                const auto& la = out.lifetimes[a];
-                const auto& lb = out.lifetimes[b];
-                if (la.first_pass_index != lb.first_pass_index)
-                {
-                    return la.first_pass_index < lb.first_pass_index;
-                }
-                return la.last_pass_index < lb.last_pass_index;
-            });
-
-            std::vector<uint32_t> slot_last_pass{};
+            const std::vector<std::size_t>& indices = entry.second;
+            std::vector<AliasInterval> intervals{};
+            intervals.reserve(indices.size());
             for (const std::size_t lifetime_index : indices)
             {
-                auto& lifetime = out.lifetimes[lifetime_index];
-                uint32_t chosen_slot = UINT32_MAX;
-                for (uint32_t slot = 0u; slot < slot_last_pass.size(); ++slot)
-                {
-                    if (lifetime.first_pass_index > slot_last_pass[slot])
-                    {
-                        chosen_slot = slot;
-                        slot_last_pass[slot] = lifetime.last_pass_index;
-                        break;
-                    }
-                }
-                if (chosen_slot == UINT32_MAX)
-                {
-                    chosen_slot = static_cast<uint32_t>(slot_last_pass.size());
-                    slot_last_pass.push_back(lifetime.last_pass_index);
-                }
-                lifetime.alias_slot = chosen_slot;
+                const auto& lifetime = out.lifetimes[lifetime_index];
+                intervals.push_back(AliasInterval{lifetime.first_pass_index, lifetime.last_pass_index, 0u});
+            }
+
+            // Same interval-graph packing as the software RTRegistry transients (transient_alias.hpp).
+            const AliasSlotPlan slots = assign_alias_slots(intervals);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                out.lifetimes[indices[i]].alias_slot = slots.slot_of[i];
             }
 
             RenderPathAliasClassSummary summary{};
             summary.alias_class = entry.first;
             summary.resource_count = static_cast<uint32_t>(indices.size());
-            summary.slot_count = static_cast<uint32_t>(slot_last_pass.size());
+            summary.slot_count = slots.slot_count();
             out.alias_classes.push_back(std::move(summary));
         }
 
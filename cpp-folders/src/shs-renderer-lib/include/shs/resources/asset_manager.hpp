@@ -10,8 +10,11 @@
 */
 
 
+#include <mutex>
 #include <string>
+#include <utility>
 
+#include "shs/job/task.hpp"
 #include "shs/resources/loaders/resource_import.hpp"
 #include "shs/resources/resource_registry.hpp"
 
@@ -25,15 +28,44 @@ namespace shs
 
         MeshAssetHandle load_mesh(const std::string& path, const std::string& key = {})
         {
+            std::lock_guard<std::mutex> lock(registry_mtx_);
             return import_mesh_assimp(registry_, path, key);
         }
 
-        TextureAssetHandle load_texture(const std::string& path, const std::string& key = {}, bool flip_y = true)
+        TextureAssetHandle load_texture(const std::string& path, const std::string& key = {}, bool flip_y = true, const TextureMipOptions& mip_opt = {})
         {
-            return import_texture_sdl(registry_, path, key, flip_y);
+            std::lock_guard<std::mutex> lock(registry_mtx_);
+            return import_texture_sdl(registry_, path, key, flip_y, mip_opt);
+        }
+
+        // Файл уншилт/decode-ийг job system-ийн worker дээр хийж, зөвхөн registry-д
+        // бүртгэх хэсгийг mutex-ээр цувруулна. Олон asset-ийг зэрэг ачаалаад
+        // sync_wait эсвэл co_await-аар хүлээнэ. Ачаалал дуусах хүртэл registry-г бүү унш.
+        // Decode нь Background lane-д явж frame-ийн raster chunk-уудыг хойшлуулахгүй.
+        Task<MeshAssetHandle> load_mesh_async(IJobSystem* js, std::string path, std::string key = {}, MeshLoadOptions opt = {})
+        {
+            MeshData mesh = co_await run_async(js, [&path, &opt]() { return load_mesh_assimp_first(path, opt); }, JobPriority::Background);
+            if (mesh.empty()) co_return 0;
+            std::lock_guard<std::mutex> lock(registry_mtx_);
+            co_return registry_.add_mesh(std::move(mesh), key.empty() ? path : key);
+        }
+
+        Task<TextureAssetHandle> load_texture_async(IJobSystem* js, std::string path, std::string key = {}, bool flip_y = true, TextureMipOptions mip_opt = {})
+        {
+            // Mip chain болон блок шахалтыг decode-той хамт worker дээр хийнэ.
+            Texture2DData tex = co_await run_async(js, [&path, flip_y, &mip_opt]() {
+                Texture2DData t = load_texture2d_sdl_image(path, flip_y);
+                generate_texture_mips(t, mip_opt);
+                compress_texture_blocks(t, mip_opt.compression);
+                return t;
+            }, JobPriority::Background);
+            if (!tex.valid()) co_return 0;
+            std::lock_guard<std::mutex> lock(registry_mtx_);
+            co_return registry_.add_texture(std::move(tex), key.empty() ? path : key);
         }
 
     private:
         ResourceRegistry registry_{};
+        std::mutex registry_mtx_{};
     };
 }
@@ -15,6 +15,8 @@
 #include "shs/resources/loaders/mesh_loader_assimp.hpp"
 #include "shs/resources/loaders/texture_loader_sdl.hpp"
 #include "shs/resources/resource_registry.hpp"
+#include "shs/resources/texture_bc.hpp"
+#include "shs/resources/texture_mips.hpp"
 
 namespace shs
 {
@@ -34,11 +36,14 @@ namespace shs
         ResourceRegistry& reg,
         const std::string& path,
         const std::string& key = {},
-        bool flip_y = true
+        bool flip_y = true,
+        const TextureMipOptions& mip_opt = {}
     )
     {
         Texture2DData tex = load_texture2d_sdl_image(path, flip_y);
         if (!tex.valid()) return 0;
+        generate_texture_mips(tex, mip_opt);
+        compress_texture_blocks(tex, mip_opt.compression);
         return reg.add_texture(std::move(tex), key.empty() ? path : key);
     }
 }
@@ -10,6 +10,9 @@
 */
 
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -20,12 +23,83 @@ namespace shs
 {
     using TextureAssetHandle = uint32_t;
 
+    // Урьдчилан шугаман (linear) болгосон RGBA texel, 16 bit unorm. Sampler sRGB decode хийхгүй.
+    struct LinearTexel16
+    {
+        uint16_t r = 0;
+        uint16_t g = 0;
+        uint16_t b = 0;
+        uint16_t a = 0;
+    };
+
+    // 4x4 блок шахалт (texture_bc.hpp). BC1: блок 8 byte (RGB, 1 bit alpha), BC3: 16 byte
+    // (BC1 өнгө + 8 түвшний alpha). RGBA8-аас 8x / 4x бага.
+    enum class TextureBlockFormat : uint8_t
+    {
+        None = 0,
+        BC1,
+        BC3,
+    };
+
+    inline size_t texture_block_bytes(TextureBlockFormat f)
+    {
+        return f == TextureBlockFormat::BC1 ? 8u : (f == TextureBlockFormat::BC3 ? 16u : 0u);
+    }
+
+    struct Texture2DMip
+    {
+        int w = 0;
+        int h = 0;
+        std::vector<Color> texels{};
+        std::vector<LinearTexel16> linear{};
+        std::vector<uint8_t> blocks{};
+    };
+
+    // Нэг mip level-ийн уншихад зориулсан харагдац. blocks != nullptr бол шахсан блокоос,
+    // үгүй бол linear != nullptr үед түүнийг уншина. linear_tiled үед linear нь
+    // PixelLayoutTiled4x4 дараалалтай (texels үргэлж мөр дараалсан).
+    struct Texture2DLevelView
+    {
+        int w = 0;
+        int h = 0;
+        const Color* texels = nullptr;
+        const LinearTexel16* linear = nullptr;
+        bool linear_tiled = false;
+        const uint8_t* blocks = nullptr;
+        TextureBlockFormat block_format = TextureBlockFormat::None;
+        // Decode cache-ийн түлхүүрт орно: санах ой дахин ашиглагдсан ч хуучин блок уншихгүй.
+        uint32_t block_owner = 0;
+    };
+
+    // 8 bit sRGB -> linear (pow 2.2) хүснэгт. Texel бүрд pow дуудахгүй.
+    inline const std::array<float, 256>& srgb8_to_linear_table()
+    {
+        static const std::array<float, 256> table = []
+        {
+            std::array<float, 256> t{};
+            for (int i = 0; i < 256; ++i) t[(size_t)i] = std::pow((float)i / 255.0f, 2.2f);
+            return t;
+        }();
+        return table;
+    }
+
     struct Texture2DData
     {
         std::string source_path{};
         int w = 0;
         int h = 0;
         std::vector<Color> texels{};
+        // Level 1..N (level 0 нь texels). generate_texture_mips()-ээр бөглөгдөнө.
+        std::vector<Texture2DMip> mips{};
+        // Хоосон биш бол level 0-ийн шугаман хуулбар (TextureMipOptions::linear_storage).
+        std::vector<LinearTexel16> linear{};
+        // true бол бүх level-ийн linear хуулбар 4x4 блок дараалалтай (TextureMipOptions::tiled_linear).
+        bool linear_tiled = false;
+        // None биш бол texels/linear хоосон бөгөөд level бүр зөвхөн blocks-оор хадгалагдана
+        // (compress_texture_blocks). Уншихдаа level()/sampler-ийг ашигла, at() хүчингүй.
+        TextureBlockFormat block_format = TextureBlockFormat::None;
+        std::vector<uint8_t> blocks{};
+        uint32_t block_owner = 0;
 
         Texture2DData() = default;
         Texture2DData(int W, int H, Color clear = {0, 0, 0, 255})
@@ -34,7 +108,9 @@ namespace shs
 
         bool valid() const
         {
-            return w > 0 && h > 0 && texels.size() == (size_t)w * (size_t)h;
+            if (w <= 0 || h <= 0) return false;
+            if (block_format != TextureBlockFormat::None) return !blocks.empty();
+            return texels.size() == (size_t)w * (size_t)h;
         }
 
         Color& at(int x, int y)
@@ -46,6 +122,25 @@ namespace shs
         {
             return texels[(size_t)y * (size_t)w + (size_t)x];
         }
+
+        int level_count() const
+        {
+            return 1 + (int)mips.size();
+        }
+
+        Texture2DLevelView level(int l) const
+        {
+            if (l <= 0 || mips.empty())
+            {
+                return Texture2DLevelView{
+                    w, h, texels.data(), linear.empty() ? nullptr : linear.data(), linear_tiled,
+                    blocks.empty() ? nullptr : blocks.data(), block_format, block_owner};
+            }
+            const Texture2DMip& m = mips[(size_t)std::min(l, (int)mips.size()) - 1];
+            return Texture2DLevelView{
+                m.w, m.h, m.texels.data(), m.linear.empty() ? nullptr : m.linear.data(), linear_tiled,
+                m.blocks.empty() ? nullptr : m.blocks.data(), block_format, block_owner};
+        }
     };
 }
 
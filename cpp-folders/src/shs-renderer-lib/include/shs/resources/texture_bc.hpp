@@ -0,0 +1,391 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: texture_bc.hpp
+    МОДУЛЬ: resources
+    ЗОРИЛГО: BC1/BC3 (4x4 блок) texture шахалт. Import үед level бүрийг encode хийж RGBA8
+            texel-ийг чөлөөлнө; sampler нь блокыг thread (worker) бүрийн жижиг decode
+            cache-ээр дамжуулан шугаман өнгө болгож уншина.
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "shs/resources/texture.hpp"
+
+namespace shs
+{
+    namespace detail
+    {
+        inline uint16_t pack_rgb565(int r, int g, int b)
+        {
+            const int r5 = (r * 31 + 127) / 255;
+            const int g6 = (g * 63 + 127) / 255;
+            const int b5 = (b * 31 + 127) / 255;
+            return (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+        }
+
+        inline Color unpack_rgb565(uint16_t c)
+        {
+            const int r5 = (c >> 11) & 31;
+            const int g6 = (c >> 5) & 63;
+            const int b5 = c & 31;
+            return Color{(uint8_t)((r5 << 3) | (r5 >> 2)), (uint8_t)((g6 << 2) | (g6 >> 4)), (uint8_t)((b5 << 3) | (b5 >> 2)), 255};
+        }
+
+        inline uint16_t load_u16le(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+        inline void store_u16le(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+        // BC1 өнгөний палитр. c0 <= c1 үед 3 өнгө + тунгалаг хар; BC3-ийн өнгөний блок
+        // (force_four) үргэлж 4 өнгөтэй.
+        inline void bc1_palette(uint16_t c0, uint16_t c1, bool force_four, std::array<Color, 4>& pal)
+        {
+            const Color a = unpack_rgb565(c0);
+            const Color b = unpack_rgb565(c1);
+            pal[0] = a;
+            pal[1] = b;
+            if (force_four || c0 > c1)
+            {
+                pal[2] = Color{(uint8_t)((2 * a.r + b.r) / 3), (uint8_t)((2 * a.g + b.g) / 3), (uint8_t)((2 * a.b + b.b) / 3), 255};
+                pal[3] = Color{(uint8_t)((a.r + 2 * b.r) / 3), (uint8_t)((a.g + 2 * b.g) / 3), (uint8_t)((a.b + 2 * b.b) / 3), 255};
+            }
+            else
+            {
+                pal[2] = Color{(uint8_t)((a.r + b.r) / 2), (uint8_t)((a.g + b.g) / 2), (uint8_t)((a.b + b.b) / 2), 255};
+                pal[3] = Color{0, 0, 0, 0};
+            }
+        }
+
+        // c0/c1-ийн 4 өнгөний палитраар texel бүрд хамгийн ойр index-ийг сонгоод нийт
+        // квадрат алдааг буцаана.
+        inline int bc1_fit_indices(const std::array<Color, 16>& px, uint16_t c0, uint16_t c1, uint32_t& indices)
+        {
+            std::array<Color, 4> pal{};
+            bc1_palette(c0, c1, true, pal);
+            indices = 0u;
+            int total = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                const Color& c = px[(size_t)i];
+                int best = 0;
+                int best_d = 1 << 30;
+                for (int k = 0; k < 4; ++k)
+                {
+                    const int dr = (int)c.r - (int)pal[(size_t)k].r;
+                    const int dg = (int)c.g - (int)pal[(size_t)k].g;
+                    const int db = (int)c.b - (int)pal[(size_t)k].b;
+                    const int d = dr * dr + dg * dg + db * db;
+                    if (d < best_d) { best_d = d; best = k; }
+                }
+                indices |= (uint32_t)best << (2 * i);
+                total += best_d;
+            }
+            return total;
+        }
+
+        // Өнгөний гол тэнхлэг (covariance-ийн power iteration)-ийн хоёр туйлыг endpoint болгож,
+        // texel бүрд хамгийн ойр палитрын index-ийг сонгоно. Үргэлж 4 өнгөний горим (c0 > c1).
+        inline void encode_bc1_color(const std::array<Color, 16>& px, uint8_t* out)
+        {
+            glm::vec3 mean(0.0f);
+            for (const Color& c : px) mean += glm::vec3(c.r, c.g, c.b);
+            mean *= 1.0f / 16.0f;
+            float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+            for (const Color& c : px)
+            {
+                const glm::vec3 d = glm::vec3(c.r, c.g, c.b) - mean;
+                cov[0] += d.x * d.x; cov[1] += d.x * d.y; cov[2] += d.x * d.z;
+                cov[3] += d.y * d.y; cov[4] += d.y * d.z; cov[5] += d.z * d.z;
+            }
+            // Хамгийн их дисперстэй сувгийн covariance баганаас эхэлнэ: (1,1,1) эхлэл нь
+            // улаан/цэнхэр зэрэг эсрэг хамааралтай блок дээр тэг вектор болдог.
+            glm::vec3 axis(cov[0], cov[1], cov[2]);
+            if (cov[3] > cov[0] && cov[3] >= cov[5]) axis = glm::vec3(cov[1], cov[3], cov[4]);
+            else if (cov[5] > cov[0] && cov[5] > cov[3]) axis = glm::vec3(cov[2], cov[4], cov[5]);
+            for (int it = 0; it < 4; ++it)
+            {
+                const glm::vec3 n(
+                    cov[0] * axis.x + cov[1] * axis.y + cov[2] * axis.z,
+                    cov[1] * axis.x + cov[3] * axis.y + cov[4] * axis.z,
+                    cov[2] * axis.x + cov[4] * axis.y + cov[5] * axis.z);
+                const float m = std::max({std::abs(n.x), std::abs(n.y), std::abs(n.z)});
+                if (!(m > 1e-6f)) break;
+                axis = n / m;
+            }
+
+            int imin = 0;
+            int imax = 0;
+            float pmin = 0.0f;
+            float pmax = 0.0f;
+            for (int i = 0; i < 16; ++i)
+            {
+                const float p = glm::dot(glm::vec3(px[(size_t)i].r, px[(size_t)i].g, px[(size_t)i].b), axis);
+                if (i == 0 || p < pmin) { pmin = p; imin = i; }
+                if (i == 0 || p > pmax) { pmax = p; imax = i; }
+            }
+            const Color& hi = px[(size_t)imax];
+            const Color& lo = px[(size_t)imin];
+            uint16_t c0 = pack_rgb565(hi.r, hi.g, hi.b);
+            uint16_t c1 = pack_rgb565(lo.r, lo.g, lo.b);
+            uint32_t indices = 0u;
+            int err = bc1_fit_indices(px, c0, c1, indices);
+
+            // Index-ийг тогтоож endpoint-уудыг least squares-аар дахин тооцно (2x2 систем).
+            // Туйлын texel-ийг endpoint болгосноос дундаж алдаа мэдэгдэхүйц буурна.
+            for (int it = 0; it < 2 && err > 0; ++it)
+            {
+                static constexpr float k_w0[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+                float aa = 0.0f;
+                float ab = 0.0f;
+                float bb = 0.0f;
+                glm::vec3 ax(0.0f);
+                glm::vec3 bx(0.0f);
+                for (int i = 0; i < 16; ++i)
+                {
+                    const float a = k_w0[(indices >> (2 * i)) & 3u];
+                    const float b = 1.0f - a;
+                    const glm::vec3 x(px[(size_t)i].r, px[(size_t)i].g, px[(size_t)i].b);
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    ax += a * x;
+                    bx += b * x;
+                }
+                const float det = aa * bb - ab * ab;
+                if (std::abs(det) < 1e-6f) break;
+                const glm::vec3 e0 = glm::clamp((ax * bb - bx * ab) / det, glm::vec3(0.0f), glm::vec3(255.0f));
+                const glm::vec3 e1 = glm::clamp((bx * aa - ax * ab) / det, glm::vec3(0.0f), glm::vec3(255.0f));
+                const uint16_t r0 = pack_rgb565((int)(e0.r + 0.5f), (int)(e0.g + 0.5f), (int)(e0.b + 0.5f));
+                const uint16_t r1 = pack_rgb565((int)(e1.r + 0.5f), (int)(e1.g + 0.5f), (int)(e1.b + 0.5f));
+                uint32_t r_indices = 0u;
+                const int r_err = bc1_fit_indices(px, r0, r1, r_indices);
+                if (r_err >= err) break;
+                c0 = r0;
+                c1 = r1;
+                indices = r_indices;
+                err = r_err;
+            }
+
+            // 4 өнгөний горим c0 > c1-ийг шаарддаг: солиход index-ийн 0<->1, 2<->3 солигдоно.
+            if (c0 < c1)
+            {
+                std::swap(c0, c1);
+                indices ^= 0x55555555u;
+            }
+            else if (c0 == c1)
+            {
+                indices = 0u;
+            }
+            store_u16le(out + 0, c0);
+            store_u16le(out + 2, c1);
+            for (int i = 0; i < 4; ++i) out[4 + i] = (uint8_t)(indices >> (8 * i));
+        }
+
+        // 8 түвшний alpha (a0 > a1 горим): min/max-ийг endpoint болгоно.
+        inline void encode_bc3_alpha(const std::array<Color, 16>& px, uint8_t* out)
+        {
+            int amin = 255;
+            int amax = 0;
+            for (const Color& c : px)
+            {
+                amin = std::min(amin, (int)c.a);
+                amax = std::max(amax, (int)c.a);
+            }
+            uint64_t bits = 0u;
+            if (amax != amin)
+            {
+                int pal[8] = {amax, amin, 0, 0, 0, 0, 0, 0};
+                for (int k = 1; k < 7; ++k) pal[k + 1] = ((7 - k) * amax + k * amin) / 7;
+                for (int i = 0; i < 16; ++i)
+                {
+                    int best = 0;
+                    int best_d = 1 << 30;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        const int d = std::abs((int)px[(size_t)i].a - pal[k]);
+                        if (d < best_d) { best_d = d; best = k; }
+                    }
+                    bits |= (uint64_t)best << (3 * i);
+                }
+            }
+            out[0] = (uint8_t)amax;
+            out[1] = (uint8_t)amin;
+            for (int i = 0; i < 6; ++i) out[2 + i] = (uint8_t)(bits >> (8 * i));
+        }
+
+        inline void decode_bc1_color(const uint8_t* blk, bool force_four, std::array<Color, 16>& out)
+        {
+            std::array<Color, 4> pal{};
+            bc1_palette(load_u16le(blk), load_u16le(blk + 2), force_four, pal);
+            const uint32_t indices = (uint32_t)blk[4] | ((uint32_t)blk[5] << 8) | ((uint32_t)blk[6] << 16) | ((uint32_t)blk[7] << 24);
+            for (int i = 0; i < 16; ++i) out[(size_t)i] = pal[(indices >> (2 * i)) & 3u];
+        }
+
+        inline void decode_bc3_alpha(const uint8_t* blk, std::array<Color, 16>& out)
+        {
+            const int a0 = blk[0];
+            const int a1 = blk[1];
+            int pal[8] = {a0, a1, 0, 0, 0, 0, 0, 0};
+            if (a0 > a1)
+            {
+                for (int k = 1; k < 7; ++k) pal[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+            }
+            else
+            {
+                for (int k = 1; k < 5; ++k) pal[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+                pal[6] = 0;
+                pal[7] = 255;
+            }
+            uint64_t bits = 0u;
+            for (int i = 0; i < 6; ++i) bits |= (uint64_t)blk[2 + i] << (8 * i);
+            for (int i = 0; i < 16; ++i) out[(size_t)i].a = (uint8_t)pal[(bits >> (3 * i)) & 7u];
+        }
+
+        // Захын (4-т хуваагдахгүй) level-д блокын гаднах texel-ийг clamp хийж дүүргэнэ.
+        inline void encode_texture_level_blocks(const Color* texels, int w, int h, TextureBlockFormat fmt, std::vector<uint8_t>& out)
+        {
+            const int bx_count = (w + 3) / 4;
+            const int by_count = (h + 3) / 4;
+            const size_t bytes = texture_block_bytes(fmt);
+            out.assign((size_t)bx_count * (size_t)by_count * bytes, 0u);
+            std::array<Color, 16> px{};
+            for (int by = 0; by < by_count; ++by)
+            {
+                for (int bx = 0; bx < bx_count; ++bx)
+                {
+                    for (int i = 0; i < 16; ++i)
+                    {
+                        const int x = std::min(bx * 4 + (i & 3), w - 1);
+                        const int y = std::min(by * 4 + (i >> 2), h - 1);
+                        px[(size_t)i] = texels[(size_t)y * (size_t)w + (size_t)x];
+                    }
+                    uint8_t* blk = out.data() + ((size_t)by * (size_t)bx_count + (size_t)bx) * bytes;
+                    if (fmt == TextureBlockFormat::BC3)
+                    {
+                        encode_bc3_alpha(px, blk);
+                        encode_bc1_color(px, blk + 8);
+                    }
+                    else
+                    {
+                        encode_bc1_color(px, blk);
+                    }
+                }
+            }
+        }
+
+        inline uint32_t next_texture_block_owner()
+        {
+            static std::atomic<uint32_t> counter{0u};
+            uint32_t id = counter.fetch_add(1u, std::memory_order_relaxed) + 1u;
+            if (id == 0u) id = counter.fetch_add(1u, std::memory_order_relaxed) + 1u;
+            return id;
+        }
+    }
+
+    // Нэг блокыг sRGB8 RGBA texel болгоно (мөрөөр, 4x4).
+    inline void decode_texture_block(const uint8_t* blk, TextureBlockFormat fmt, std::array<Color, 16>& out)
+    {
+        if (fmt == TextureBlockFormat::BC3)
+        {
+            detail::decode_bc1_color(blk + 8, true, out);
+            detail::decode_bc3_alpha(blk, out);
+            return;
+        }
+        detail::decode_bc1_color(blk, false, out);
+    }
+
+    // Level бүрийг (mip chain-ийг оролцуулан) fmt-ээр шахаж texels/linear-ийг чөлөөлнө.
+    // generate_texture_mips-ийн дараа дуудна. Шахсан texture-ийг дахин шахахгүй.
+    inline void compress_texture_blocks(Texture2DData& tex, TextureBlockFormat fmt)
+    {
+        if (fmt == TextureBlockFormat::None || tex.block_format != TextureBlockFormat::None) return;
+        if (!tex.valid()) return;
+
+        detail::encode_texture_level_blocks(tex.texels.data(), tex.w, tex.h, fmt, tex.blocks);
+        for (Texture2DMip& m : tex.mips)
+        {
+            detail::encode_texture_level_blocks(m.texels.data(), m.w, m.h, fmt, m.blocks);
+            std::vector<Color>{}.swap(m.texels);
+            std::vector<LinearTexel16>{}.swap(m.linear);
+        }
+        std::vector<Color>{}.swap(tex.texels);
+        std::vector<LinearTexel16>{}.swap(tex.linear);
+        tex.linear_tiled = false;
+        tex.block_format = fmt;
+        tex.block_owner = detail::next_texture_block_owner();
+    }
+
+    // Texel өгөгдлийн (бүх level) байт хэмжээ. Санах ойн төсөв/харьцуулалтад.
+    inline size_t texture_storage_bytes(const Texture2DData& tex)
+    {
+        size_t bytes = tex.texels.size() * sizeof(Color) + tex.linear.size() * sizeof(LinearTexel16) + tex.blocks.size();
+        for (const Texture2DMip& m : tex.mips)
+        {
+            bytes += m.texels.size() * sizeof(Color) + m.linear.size() * sizeof(LinearTexel16) + m.blocks.size();
+        }
+        return bytes;
+    }
+
+    // Worker бүрийн decode cache: direct-mapped, блокийн заагч + owner-оор түлхүүрлэнэ.
+    // Bilinear-ийн 4 tap ихэвчлэн нэг блокт унах тул блок бүрийг нэг л удаа decode хийж,
+    // шугаман өнгөөр (sRGB LUT-ийг урьдчилан хэрэглэсэн) хадгална.
+    struct TextureBlockCache
+    {
+        static constexpr int k_entries_log2 = 7;
+        static constexpr size_t k_entries = (size_t)1 << k_entries_log2;
+
+        struct Entry
+        {
+            const uint8_t* block = nullptr;
+            uint32_t owner = 0;
+            std::array<glm::vec3, 16> rgb{};
+        };
+
+        std::array<Entry, k_entries> entries{};
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    inline TextureBlockCache& thread_texture_block_cache()
+    {
+        thread_local TextureBlockCache cache{};
+        return cache;
+    }
+
+    // (bx, by) блокын шугаман RGB 16 texel (мөрөөр). lv.blocks != nullptr байх ёстой.
+    inline const std::array<glm::vec3, 16>& texture_block_linear_rgb(const Texture2DLevelView& lv, int bx, int by)
+    {
+        const size_t bytes = texture_block_bytes(lv.block_format);
+        const size_t index = (size_t)by * (size_t)((lv.w + 3) / 4) + (size_t)bx;
+        const uint8_t* blk = lv.blocks + index * bytes;
+
+        TextureBlockCache& cache = thread_texture_block_cache();
+        // Fibonacci hash: зэргэлдээ мөрийн блокууд нэг slot-д давхцахгүй.
+        const uint64_t key = (uint64_t)(uintptr_t)blk ^ ((uint64_t)lv.block_owner << 40);
+        TextureBlockCache::Entry& e = cache.entries[(size_t)((key * 0x9E3779B97F4A7C15ull) >> (64 - TextureBlockCache::k_entries_log2))];
+        if (e.block == blk && e.owner == lv.block_owner)
+        {
+            ++cache.hits;
+            return e.rgb;
+        }
+        ++cache.misses;
+
+        std::array<Color, 16> px{};
+        decode_texture_block(blk, lv.block_format, px);
+        const std::array<float, 256>& lut = srgb8_to_linear_table();
+        for (size_t i = 0; i < 16; ++i) e.rgb[i] = glm::vec3(lut[px[i].r], lut[px[i].g], lut[px[i].b]);
+        e.block = blk;
+        e.owner = lv.block_owner;
+        return e.rgb;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: texture_mips.hpp
+    МОДУЛЬ: resources
+    ЗОРИЛГО: Texture2DData-ийн mip chain-ийг import үед нэг удаа үүсгэнэ. 2x2 box filter-ийг
+            шугаман (linear) орон зайд хийж, level бүрийг sRGB8 (мөн сонголтоор linear RGBA16)
+            хэлбэрээр хадгална. Trilinear sampler нь эдгээрийг уншина.
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "shs/gfx/pixel_layout.hpp"
+#include "shs/resources/texture.hpp"
+
+namespace shs
+{
+    struct TextureMipOptions
+    {
+        bool generate_mips = true;
+        // true үед level бүрийн шугаман RGBA16 хуулбарыг хадгална: sampler sRGB decode хийхгүй
+        // боловч texel бүр 8 byte болно.
+        bool linear_storage = false;
+        // linear_storage-тэй хамт: linear хуулбарыг 4x4 блок (PixelLayoutTiled4x4) дараалалд
+        // хадгална. Bilinear-ийн босоо хөрш texel нэг блокт орж cache line цөөн уншина.
+        bool tiled_linear = false;
+        // Import-ийн төгсгөлд level бүрийг шахна (compress_texture_blocks). None биш үед
+        // linear_storage/tiled_linear хэрэглэгдэхгүй.
+        TextureBlockFormat compression = TextureBlockFormat::None;
+    };
+
+    namespace detail
+    {
+        inline uint8_t linear_to_srgb8(float v)
+        {
+            const float s = std::pow(std::clamp(v, 0.0f, 1.0f), 1.0f / 2.2f);
+            return (uint8_t)std::clamp((int)(s * 255.0f + 0.5f), 0, 255);
+        }
+
+        inline uint16_t linear_to_unorm16(float v)
+        {
+            return (uint16_t)std::clamp((int)(v * 65535.0f + 0.5f), 0, 65535);
+        }
+
+        inline Color encode_srgb8(const glm::vec4& c)
+        {
+            return Color{
+                linear_to_srgb8(c.r),
+                linear_to_srgb8(c.g),
+                linear_to_srgb8(c.b),
+                (uint8_t)std::clamp((int)(c.a * 255.0f + 0.5f), 0, 255)};
+        }
+
+        inline LinearTexel16 encode_linear16(const glm::vec4& c)
+        {
+            return LinearTexel16{linear_to_unorm16(c.r), linear_to_unorm16(c.g), linear_to_unorm16(c.b), linear_to_unorm16(c.a)};
+        }
+
+        template<typename Layout>
+        inline void store_linear16(std::vector<LinearTexel16>& out, const std::vector<glm::vec4>& src, int w, int h)
+        {
+            out.assign(Layout::storage_size(w, h), LinearTexel16{});
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    out[Layout::index(x, y, w)] = encode_linear16(src[(size_t)y * (size_t)w + (size_t)x]);
+                }
+            }
+        }
+
+        inline void store_linear16(std::vector<LinearTexel16>& out, const std::vector<glm::vec4>& src, int w, int h, bool tiled)
+        {
+            if (tiled) store_linear16<PixelLayoutTiled4x4>(out, src, w, h);
+            else store_linear16<PixelLayoutLinear>(out, src, w, h);
+        }
+    }
+
+    // tex.texels-ээс 1x1 хүртэлх mip chain (болон сонголтоор linear хуулбар)-ыг дахин үүсгэнэ.
+    // Level бүр өмнөхийнхөө 2x2 texel-ийн box дундаж. Сондгой хэмжээтэй level-ийн сүүлийн мөр/баганыг
+    // хаяхгүйн тулд хамгийн сүүлийн гаралтын багана/мөр 3 texel (2x..2x+2)-ийг дундажилна.
+    inline void generate_texture_mips(Texture2DData& tex, const TextureMipOptions& opt = {})
+    {
+        // Шахсан texture-ийн texels чөлөөлөгдсөн тул chain-ийг дахин үүсгэх эх байхгүй.
+        if (tex.block_format != TextureBlockFormat::None) return;
+        tex.mips.clear();
+        tex.linear.clear();
+        tex.linear_tiled = false;
+        if (!tex.valid()) return;
+
+        // Өмнөх level-ийг float-оор барьж, sRGB8 дахин квантчлалын алдаа level-ээр хуримтлагдахгүй.
+        const std::array<float, 256>& lut = srgb8_to_linear_table();
+        std::vector<glm::vec4> prev((size_t)tex.w * (size_t)tex.h);
+        for (size_t i = 0; i < prev.size(); ++i)
+        {
+            const Color& c = tex.texels[i];
+            prev[i] = glm::vec4(lut[c.r], lut[c.g], lut[c.b], (float)c.a / 255.0f);
+        }
+        if (opt.linear_storage)
+        {
+            tex.linear_tiled = opt.tiled_linear;
+            detail::store_linear16(tex.linear, prev, tex.w, tex.h, opt.tiled_linear);
+        }
+        if (!opt.generate_mips) return;
+
+        int pw = tex.w;
+        int ph = tex.h;
+        std::vector<glm::vec4> cur{};
+        while (pw > 1 || ph > 1)
+        {
+            const int w = std::max(1, pw / 2);
+            const int h = std::max(1, ph / 2);
+            cur.assign((size_t)w * (size_t)h, glm::vec4(0.0f));
+            for (int y = 0; y < h; ++y)
+            {
+                const int y0 = std::min(2 * y, ph - 1);
+                const int y1 = (y == h - 1) ? ph - 1 : 2 * y + 1;
+                for (int x = 0; x < w; ++x)
+                {
+                    const int x0 = std::min(2 * x, pw - 1);
+                    const int x1 = (x == w - 1) ? pw - 1 : 2 * x + 1;
+                    glm::vec4 sum(0.0f);
+                    for (int sy = y0; sy <= y1; ++sy)
+                    {
+                        for (int sx = x0; sx <= x1; ++sx) sum += prev[(size_t)sy * (size_t)pw + (size_t)sx];
+                    }
+                    cur[(size_t)y * (size_t)w + (size_t)x] = sum / (float)((x1 - x0 + 1) * (y1 - y0 + 1));
+                }
+            }
+
+            Texture2DMip m{};
+            m.w = w;
+            m.h = h;
+            m.texels.resize(cur.size());
+            for (size_t i = 0; i < cur.size(); ++i) m.texels[i] = detail::encode_srgb8(cur[i]);
+            if (opt.linear_storage) detail::store_linear16(m.linear, cur, w, h, opt.tiled_linear);
+            tex.mips.push_back(std::move(m));
+
+            prev.swap(cur);
+            pw = w;
+            ph = h;
+        }
+    }
+}
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "shs/job/job_arena.hpp"
 #include "shs/job/job_system.hpp"
 #include "shs/job/wait_group.hpp"
 #include "shs/rhi/command/command_desc.hpp"
@@ -246,18 +247,25 @@ namespace shs
         {
             if (sub.allow_parallel_tasks && cfg_.allow_parallel_tasks && js_ && sub.tasks.size() > 1)
             {
+                // Task-ууд submission дууссаны дараа л устах тул std::function-ийг хуулахгүй,
+                // заагчаар нь arena бичлэгт барьж нэг batch-аар илгээнэ.
+                JobArenaScope arena_scope{thread_job_arena()};
+                JobRecord* records = arena_scope.allocate(sub.tasks.size());
+                size_t record_count = 0;
+
                 WaitGroup wg{};
                 for (const auto& t : sub.tasks)
                 {
                     if (!t.fn) continue;
-                    wg.add(1);
-                    js_->enqueue([fn = t.fn, &wg]() {
-                        fn();
+                    records[record_count++].bind([fn = &t.fn, &wg]() {
+                        (*fn)();
                         wg.done();
                     });
                     stats_.tasks_parallel++;
                 }
-                wg.wait();
+                wg.add((int)record_count);
+                js_->enqueue_batch(records, record_count);
+                wg.wait_help(js_, JobPriority::Normal);
             }
             else
             {
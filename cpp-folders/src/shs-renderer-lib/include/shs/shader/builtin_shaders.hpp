@@ -11,6 +11,7 @@
 
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 #include <glm/glm.hpp>
@@ -18,42 +19,104 @@
 
 #include "shs/frame/frame_params.hpp"
 #include "shs/lighting/shadow_sample.hpp"
+#include "shs/resources/texture_bc.hpp"
 #include "shs/shader/program.hpp"
 
 namespace shs
 {
     inline glm::vec3 srgb_to_linear_rgb(const Color& c)
     {
-        const float r = std::pow((float)c.r / 255.0f, 2.2f);
-        const float g = std::pow((float)c.g / 255.0f, 2.2f);
-        const float b = std::pow((float)c.b / 255.0f, 2.2f);
-        return glm::vec3(r, g, b);
+        const std::array<float, 256>& lut = srgb8_to_linear_table();
+        return glm::vec3(lut[c.r], lut[c.g], lut[c.b]);
     }
 
-    inline glm::vec3 sample_texture2d_bilinear_repeat_linear(const Texture2DData* tex, const glm::vec2& uv)
+    inline glm::vec3 texel_linear_rgb(const Texture2DLevelView& lv, int x, int y)
+    {
+        if (lv.blocks)
+        {
+            return texture_block_linear_rgb(lv, x >> 2, y >> 2)[(size_t)(((y & 3) << 2) | (x & 3))];
+        }
+        if (lv.linear)
+        {
+            const size_t i = lv.linear_tiled ? PixelLayoutTiled4x4::index(x, y, lv.w) : PixelLayoutLinear::index(x, y, lv.w);
+            const LinearTexel16& t = lv.linear[i];
+            return glm::vec3((float)t.r, (float)t.g, (float)t.b) * (1.0f / 65535.0f);
+        }
+        return srgb_to_linear_rgb(lv.texels[PixelLayoutLinear::index(x, y, lv.w)]);
+    }
+
+    inline glm::vec3 sample_texture_level_bilinear_repeat_linear(const Texture2DLevelView& lv, const glm::vec2& uv)
     {
-        if (!tex || !tex->valid()) return glm::vec3(1.0f);
         const float u = uv.x - std::floor(uv.x);
         const float v = uv.y - std::floor(uv.y);
 
-        const float fx = u * (float)(tex->w - 1);
-        const float fy = v * (float)(tex->h - 1);
-        const int x0 = (int)std::floor(fx);
-        const int y0 = (int)std::floor(fy);
-        const int x1 = std::min(x0 + 1, tex->w - 1);
-        const int y1 = std::min(y0 + 1, tex->h - 1);
+        const float fx = u * (float)(lv.w - 1);
+        const float fy = v * (float)(lv.h - 1);
+        const int x0 = std::min((int)fx, lv.w - 1);
+        const int y0 = std::min((int)fy, lv.h - 1);
+        const int x1 = std::min(x0 + 1, lv.w - 1);
+        const int y1 = std::min(y0 + 1, lv.h - 1);
         const float tx = fx - (float)x0;
         const float ty = fy - (float)y0;
 
-        const glm::vec3 c00 = srgb_to_linear_rgb(tex->at(x0, y0));
-        const glm::vec3 c10 = srgb_to_linear_rgb(tex->at(x1, y0));
-        const glm::vec3 c01 = srgb_to_linear_rgb(tex->at(x0, y1));
-        const glm::vec3 c11 = srgb_to_linear_rgb(tex->at(x1, y1));
+        glm::vec3 c00, c10, c01, c11;
+        if (lv.blocks && (x0 >> 2) == (x1 >> 2) && (y0 >> 2) == (y1 >> 2))
+        {
+            // 4 tap нэг блокт (ихэнх тохиолдол): cache-ээс нэг удаа авна.
+            const std::array<glm::vec3, 16>& b = texture_block_linear_rgb(lv, x0 >> 2, y0 >> 2);
+            c00 = b[(size_t)(((y0 & 3) << 2) | (x0 & 3))];
+            c10 = b[(size_t)(((y0 & 3) << 2) | (x1 & 3))];
+            c01 = b[(size_t)(((y1 & 3) << 2) | (x0 & 3))];
+            c11 = b[(size_t)(((y1 & 3) << 2) | (x1 & 3))];
+        }
+        else
+        {
+            c00 = texel_linear_rgb(lv, x0, y0);
+            c10 = texel_linear_rgb(lv, x1, y0);
+            c01 = texel_linear_rgb(lv, x0, y1);
+            c11 = texel_linear_rgb(lv, x1, y1);
+        }
         const glm::vec3 cx0 = glm::mix(c00, c10, tx);
         const glm::vec3 cx1 = glm::mix(c01, c11, tx);
         return glm::mix(cx0, cx1, ty);
     }
 
+    inline glm::vec3 sample_texture2d_bilinear_repeat_linear(const Texture2DData* tex, const glm::vec2& uv)
+    {
+        if (!tex || !tex->valid()) return glm::vec3(1.0f);
+        return sample_texture_level_bilinear_repeat_linear(tex->level(0), uv);
+    }
+
+    // Дэлгэцийн uv уламжлалаас mip LOD (level 0-ийн texel-ээр хэмжсэн footprint-ийн log2).
+    inline float texture2d_lod(const Texture2DData& tex, const glm::vec2& duv_dx, const glm::vec2& duv_dy)
+    {
+        const glm::vec2 size((float)tex.w, (float)tex.h);
+        const glm::vec2 dx = duv_dx * size;
+        const glm::vec2 dy = duv_dy * size;
+        const float rho2 = std::max(glm::dot(dx, dx), glm::dot(dy, dy));
+        if (!(rho2 > 1.0f)) return 0.0f;
+        return std::min(0.5f * std::log2(rho2), (float)(tex.level_count() - 1));
+    }
+
+    // Mip chain-тай texture-ийг хоёр хөрш level-ийн bilinear-ийг холих (trilinear) аргаар уншина.
+    // Mip-гүй texture дээр sample_texture2d_bilinear_repeat_linear-тай ижил.
+    inline glm::vec3 sample_texture2d_trilinear_repeat_linear(
+        const Texture2DData* tex,
+        const glm::vec2& uv,
+        const glm::vec2& duv_dx,
+        const glm::vec2& duv_dy)
+    {
+        if (!tex || !tex->valid()) return glm::vec3(1.0f);
+        if (tex->mips.empty()) return sample_texture_level_bilinear_repeat_linear(tex->level(0), uv);
+        const float lod = texture2d_lod(*tex, duv_dx, duv_dy);
+        const int l0 = (int)lod;
+        const float f = lod - (float)l0;
+        const glm::vec3 c0 = sample_texture_level_bilinear_repeat_linear(tex->level(l0), uv);
+        if (f <= 1.0f / 256.0f || l0 + 1 >= tex->level_count()) return c0;
+        const glm::vec3 c1 = sample_texture_level_bilinear_repeat_linear(tex->level(l0 + 1), uv);
+        return glm::mix(c0, c1, f);
+    }
+
     inline glm::vec3 eval_fake_ibl(const glm::vec3& N, const glm::vec3& V, const glm::vec3& base_color, float metallic, float roughness, float ao)
     {
         // LUT/PMREM-гүй нөхцөлд орчны гэрлийг ойролцоолсон хөнгөн IBL.
@@ -84,6 +147,233 @@ namespace shs
         return (diffuse_ibl + spec_ibl) * std::clamp(ao, 0.0f, 1.0f);
     }
 
+    // Texture/shadow fetch нь gather тул идэвхтэй lane бүрд scalar функцийг дуудна.
+    inline simd::Vec3Lanes sample_texture2d_trilinear_repeat_linear_lanes(
+        const Texture2DData* tex,
+        const simd::Vec2Lanes& uv,
+        const simd::Vec2Lanes& duv_dx,
+        const simd::Vec2Lanes& duv_dy,
+        const simd::mask& active)
+    {
+        if (!tex || !tex->valid()) return simd::Vec3Lanes(glm::vec3(1.0f));
+        simd::LaneArray u{}, v{}, dux{}, dvx{}, duy{}, dvy{}, r{}, g{}, b{};
+        simd::store(u.data(), uv.x);
+        simd::store(v.data(), uv.y);
+        simd::store(dux.data(), duv_dx.x);
+        simd::store(dvx.data(), duv_dx.y);
+        simd::store(duy.data(), duv_dy.x);
+        simd::store(dvy.data(), duv_dy.y);
+        const uint32_t bits = simd::mask_bits(active);
+        for (int i = 0; i < simd::k_lanes; ++i)
+        {
+            if ((bits & (1u << i)) == 0u) continue;
+            const size_t k = (size_t)i;
+            const glm::vec3 c = sample_texture2d_trilinear_repeat_linear(
+                tex, glm::vec2(u[k], v[k]), glm::vec2(dux[k], dvx[k]), glm::vec2(duy[k], dvy[k]));
+            r[(size_t)i] = c.r;
+            g[(size_t)i] = c.g;
+            b[(size_t)i] = c.b;
+        }
+        return simd::Vec3Lanes(simd::load(r.data()), simd::load(g.data()), simd::load(b.data()));
+    }
+
+    inline simd::f32 shadow_visibility_lanes(
+        const ShaderUniforms& u,
+        const simd::Vec3Lanes& world_pos,
+        const simd::f32& NdotL,
+        const simd::mask& active)
+    {
+        if (!u.shadow_map) return simd::f32(1.0f);
+        const uint32_t bits = simd::mask_bits(active & (NdotL > simd::f32(0.0f)));
+        if (bits == 0u) return simd::f32(1.0f);
+
+        ShadowParams sp{};
+        sp.light_viewproj = u.light_viewproj;
+        sp.bias_const = u.shadow_bias_const;
+        sp.bias_slope = u.shadow_bias_slope;
+        sp.pcf_radius = std::max(0, u.shadow_pcf_radius);
+        sp.pcf_step = std::max(1.0f, u.shadow_pcf_step);
+        const float strength = std::clamp(u.shadow_strength, 0.0f, 1.0f);
+
+        simd::LaneArray px{}, py{}, pz{}, ndl{}, vis{};
+        simd::store(px.data(), world_pos.x);
+        simd::store(py.data(), world_pos.y);
+        simd::store(pz.data(), world_pos.z);
+        simd::store(ndl.data(), NdotL);
+        for (int i = 0; i < simd::k_lanes; ++i)
+        {
+            const size_t li = (size_t)i;
+            vis[li] = 1.0f;
+            if ((bits & (1u << i)) == 0u) continue;
+            const float s = shadow_visibility_dir(*u.shadow_map, sp, glm::vec3(px[li], py[li], pz[li]), ndl[li]);
+            vis[li] = glm::mix(1.0f, s, strength);
+        }
+        return simd::load(vis.data());
+    }
+
+    inline simd::Vec3Lanes eval_fake_ibl_lanes(
+        const simd::Vec3Lanes& N,
+        const simd::Vec3Lanes& V,
+        const simd::Vec3Lanes& base_color,
+        float metallic,
+        float roughness,
+        float ao)
+    {
+        using simd::f32;
+        const simd::Vec3Lanes n = simd::normalize(N);
+        const simd::Vec3Lanes v = simd::normalize(V);
+        // reflect(-v, n) = 2 * dot(n, v) * n - v
+        const f32 ndv = simd::dot(n, v);
+        const f32 r_y = f32(2.0f) * ndv * n.y - v.y;
+
+        const simd::Vec3Lanes sky_zenith(glm::vec3(0.32f, 0.46f, 0.72f));
+        const simd::Vec3Lanes sky_horizon(glm::vec3(0.62f, 0.66f, 0.72f));
+        const simd::Vec3Lanes ground_tint(glm::vec3(0.16f, 0.15f, 0.14f));
+
+        const f32 up_n = simd::clamp(n.y * f32(0.5f) + f32(0.5f), 0.0f, 1.0f);
+        const f32 up_r = simd::clamp(r_y * f32(0.5f) + f32(0.5f), 0.0f, 1.0f);
+        const simd::Vec3Lanes env_n = simd::mix(ground_tint, simd::mix(sky_horizon, sky_zenith, up_n), up_n);
+        const simd::Vec3Lanes env_r = simd::mix(ground_tint, simd::mix(sky_horizon, sky_zenith, up_r), up_r);
+
+        const float m = std::clamp(metallic, 0.0f, 1.0f);
+        const float rgh = std::clamp(roughness, 0.0f, 1.0f);
+        const simd::Vec3Lanes F0 = simd::mix(simd::Vec3Lanes(glm::vec3(0.04f)), simd::max(base_color, simd::Vec3Lanes(glm::vec3(0.0f))), f32(m));
+        const f32 one_m_ndv = f32(1.0f) - simd::max(f32(0.0f), ndv);
+        const f32 ndv2 = one_m_ndv * one_m_ndv;
+        const f32 fres = ndv2 * ndv2 * one_m_ndv;
+        const simd::Vec3Lanes one(glm::vec3(1.0f));
+        const simd::Vec3Lanes F = F0 + (one - F0) * fres;
+
+        const simd::Vec3Lanes kd = (one - F) * f32(1.0f - m);
+        const simd::Vec3Lanes diffuse_ibl = kd * base_color * env_n * f32(0.12f);
+        const float spec_strength = 0.02f + (1.0f - rgh) * 0.18f;
+        const simd::Vec3Lanes spec_ibl = env_r * F * f32(spec_strength);
+        return (diffuse_ibl + spec_ibl) * f32(std::clamp(ao, 0.0f, 1.0f));
+    }
+
+    // BlinnPhongProgramT<Features>-ийн fs-тэй ижил тооцоо (simd lane-ээр).
+    template<uint32_t Features>
+    inline void shade_blinn_phong_lanes_t(const FragmentLanesIn& fin, const ShaderUniforms& u, FragmentLanesOut& out)
+    {
+        using simd::f32;
+        simd::Vec3Lanes albedo_tex(glm::vec3(1.0f));
+        if constexpr ((Features & ShaderFeatureTextured) != 0u)
+        {
+            albedo_tex = sample_texture2d_trilinear_repeat_linear_lanes(u.base_color_tex, fin.uv, fin.duv_dx, fin.duv_dy, fin.active);
+        }
+        const simd::Vec3Lanes albedo = simd::max(simd::Vec3Lanes(u.base_color) * albedo_tex, simd::Vec3Lanes(glm::vec3(0.0f)));
+        const simd::Vec3Lanes N = simd::normalize(fin.normal_ws);
+        const simd::Vec3Lanes L(glm::normalize(-u.light_dir_ws));
+        const simd::Vec3Lanes V = simd::normalize(simd::Vec3Lanes(u.camera_pos) - fin.world_pos);
+        const simd::Vec3Lanes H = simd::normalize(L + V);
+
+        const f32 NdotL = simd::max(f32(0.0f), simd::dot(N, L));
+        const f32 NdotH = simd::max(f32(0.0f), simd::dot(N, H));
+        const float rough = std::clamp(u.roughness, 0.0f, 1.0f);
+        const float metal = std::clamp(u.metallic, 0.0f, 1.0f);
+        const float spec_pow = std::max(4.0f, 8.0f + (1.0f - rough) * 120.0f);
+        const float spec_norm = (spec_pow + 2.0f) / (2.0f * glm::pi<float>());
+        const float spec_f0 = 0.04f + 0.96f * metal;
+        const f32 spec = simd::pow(NdotH, f32(spec_pow)) * f32(spec_norm * spec_f0) * NdotL;
+        const simd::Vec3Lanes diffuse = albedo * (f32(1.0f - metal) * NdotL * f32(1.0f / glm::pi<float>()));
+        f32 shadow_vis(1.0f);
+        if constexpr ((Features & ShaderFeatureShadowed) != 0u)
+        {
+            shadow_vis = shadow_visibility_lanes(u, fin.world_pos, NdotL, fin.active);
+        }
+        const simd::Vec3Lanes radiance(u.light_color * u.light_intensity);
+        const simd::Vec3Lanes direct = (diffuse + simd::Vec3Lanes(spec, spec, spec)) * radiance * shadow_vis;
+        const simd::Vec3Lanes ibl = eval_fake_ibl_lanes(N, V, albedo, u.metallic, u.roughness, u.ao);
+
+        out.color = direct + ibl;
+        out.alpha = f32(1.0f);
+    }
+
+    // PbrMetallicRoughnessProgramT<Features>-ийн fs-тэй ижил тооцоо (simd lane-ээр).
+    template<uint32_t Features>
+    inline void shade_pbr_mr_lanes_t(const FragmentLanesIn& fin, const ShaderUniforms& u, FragmentLanesOut& out)
+    {
+        using simd::f32;
+        simd::Vec3Lanes albedo_tex(glm::vec3(1.0f));
+        if constexpr ((Features & ShaderFeatureTextured) != 0u)
+        {
+            albedo_tex = sample_texture2d_trilinear_repeat_linear_lanes(u.base_color_tex, fin.uv, fin.duv_dx, fin.duv_dy, fin.active);
+        }
+        const simd::Vec3Lanes N = simd::normalize(fin.normal_ws);
+        const simd::Vec3Lanes V = simd::normalize(simd::Vec3Lanes(u.camera_pos) - fin.world_pos);
+        const simd::Vec3Lanes L(glm::normalize(-u.light_dir_ws));
+        const simd::Vec3Lanes H = simd::normalize(V + L);
+
+        const f32 zero(0.0f);
+        const f32 NdotL = simd::max(zero, simd::dot(N, L));
+        const f32 NdotV = simd::max(zero, simd::dot(N, V));
+        const f32 NdotH = simd::max(zero, simd::dot(N, H));
+        const f32 VdotH = simd::max(zero, simd::dot(V, H));
+        const float rough = std::clamp(u.roughness, 0.04f, 1.0f);
+        const float metal = std::clamp(u.metallic, 0.0f, 1.0f);
+        const simd::Vec3Lanes albedo = simd::max(simd::Vec3Lanes(u.base_color) * albedo_tex, simd::Vec3Lanes(glm::vec3(0.0f)));
+        const simd::Vec3Lanes F0 = simd::mix(simd::Vec3Lanes(glm::vec3(0.04f)), albedo, f32(metal));
+
+        const float a = rough * rough;
+        const float a2 = a * a;
+        const f32 denomD = (NdotH * NdotH) * f32(a2 - 1.0f) + f32(1.0f);
+        const f32 D = f32(a2) / (f32(glm::pi<float>()) * denomD * denomD + f32(1e-7f));
+
+        const float k = ((a + 1.0f) * (a + 1.0f)) * 0.125f;
+        const auto smith_ggx_g1 = [k](const f32& ndotx) {
+            return ndotx / (ndotx * f32(1.0f - k) + f32(k + 1e-7f));
+        };
+        const f32 G = smith_ggx_g1(NdotV) * smith_ggx_g1(NdotL);
+
+        const f32 one_m_vdh = f32(1.0f) - VdotH;
+        const f32 vdh2 = one_m_vdh * one_m_vdh;
+        const f32 fres = vdh2 * vdh2 * one_m_vdh;
+        const simd::Vec3Lanes one(glm::vec3(1.0f));
+        const simd::Vec3Lanes F = F0 + (one - F0) * fres;
+        const simd::Vec3Lanes spec = F * ((D * G) / simd::max(f32(4.0f) * NdotL * NdotV, f32(1e-6f)));
+
+        const simd::Vec3Lanes kd = (one - F) * f32(1.0f - metal);
+        const simd::Vec3Lanes diff = kd * albedo * f32(1.0f / glm::pi<float>());
+        const simd::Vec3Lanes radiance(u.light_color * u.light_intensity);
+        f32 shadow_vis(1.0f);
+        if constexpr ((Features & ShaderFeatureShadowed) != 0u)
+        {
+            shadow_vis = shadow_visibility_lanes(u, fin.world_pos, NdotL, fin.active);
+        }
+        const simd::mask lit = (NdotL > zero) & (NdotV > zero);
+        const simd::Vec3Lanes direct = simd::select(lit, (diff + spec) * radiance * (NdotL * shadow_vis), simd::Vec3Lanes(glm::vec3(0.0f)));
+        const simd::Vec3Lanes ibl = eval_fake_ibl_lanes(N, V, albedo, metal, rough, u.ao);
+
+        out.color = direct + ibl;
+        out.alpha = f32(1.0f);
+    }
+
+    inline void shade_blinn_phong_lanes(const FragmentLanesIn& fin, const ShaderUniforms& u, FragmentLanesOut& out)
+    {
+        shade_blinn_phong_lanes_t<ShaderFeaturesAll>(fin, u, out);
+    }
+
+    inline void shade_pbr_mr_lanes(const FragmentLanesIn& fin, const ShaderUniforms& u, FragmentLanesOut& out)
+    {
+        shade_pbr_mr_lanes_t<ShaderFeaturesAll>(fin, u, out);
+    }
+
+    // Built-in program-уудын VS: fs нь зөвхөн world/normal/uv-г уншдаг тул semantic varying
+    // бичихгүй (vertex cache болон fragment бүрийн varying interpolation хоосон үлдэнэ).
+    inline VertexOut make_surface_vertex_out(const ShaderVertex& vin, const ShaderUniforms& u)
+    {
+        VertexOut o{};
+        const glm::vec4 wp4 = u.model * glm::vec4(vin.position, 1.0f);
+        o.world_pos = glm::vec3(wp4);
+        o.clip = u.viewproj * wp4;
+        glm::mat3 nrm_m = glm::mat3(u.model);
+        const float det = glm::determinant(nrm_m);
+        if (std::abs(det) > 1e-8f) nrm_m = glm::transpose(glm::inverse(nrm_m));
+        o.normal_ws = glm::normalize(nrm_m * vin.normal);
+        o.uv = vin.uv;
+        return o;
+    }
+
     inline VertexOut make_default_vertex_out(const ShaderVertex& vin, const ShaderUniforms& u)
     {
         VertexOut o{};
@@ -102,15 +392,29 @@ namespace shs
         return o;
     }
 
-    inline ShaderProgram make_blinn_phong_program()
+    // StaticShaderProgram-ууд. Rasterizer-т шууд дамжуулбал vs/fs inline болно;
+    // make_*_program() нь тэдгээрийг ShaderProgram adapter-т ороосон хувилбар.
+    // Features-ийн bit унтраалттай үед тухайн салааг огт оруулахгүй тул сонгогч
+    // (shader_features_for_draw) тухайн draw-д хэрэггүй гэдгийг баталсан байх ёстой.
+    template<uint32_t Features = ShaderFeaturesAll>
+    struct BlinnPhongProgramT
     {
-        ShaderProgram p{};
-        p.vs = [](const ShaderVertex& vin, const ShaderUniforms& u) -> VertexOut {
-            return make_default_vertex_out(vin, u);
-        };
-        p.fs = [](const FragmentIn& fin, const ShaderUniforms& u) -> FragmentOut {
+        static constexpr FragmentLanesShaderFn fs_lanes = &shade_blinn_phong_lanes_t<Features>;
+        static constexpr bool motion_vectors = (Features & ShaderFeatureMotion) != 0u;
+
+        static VertexOut vs(const ShaderVertex& vin, const ShaderUniforms& u)
+        {
+            return make_surface_vertex_out(vin, u);
+        }
+
+        static FragmentOut fs(const FragmentIn& fin, const ShaderUniforms& u)
+        {
             FragmentOut o{};
-            const glm::vec3 albedo_tex = sample_texture2d_bilinear_repeat_linear(u.base_color_tex, fin.uv);
+            glm::vec3 albedo_tex(1.0f);
+            if constexpr ((Features & ShaderFeatureTextured) != 0u)
+            {
+                albedo_tex = sample_texture2d_trilinear_repeat_linear(u.base_color_tex, fin.uv, fin.duv_dx, fin.duv_dy);
+            }
             const glm::vec3 albedo = glm::max(u.base_color * albedo_tex, glm::vec3(0.0f));
             const glm::vec3 N = glm::normalize(fin.normal_ws);
             const glm::vec3 L = glm::normalize(-u.light_dir_ws);
@@ -129,7 +433,7 @@ namespace shs
             const glm::vec3 kd = glm::vec3(1.0f - metal);
             const glm::vec3 diffuse = kd * albedo * (NdotL / glm::pi<float>());
             float shadow_vis = 1.0f;
-            if (u.shadow_map && NdotL > 0.0f)
+            if (((Features & ShaderFeatureShadowed) != 0u) && u.shadow_map && NdotL > 0.0f)
             {
                 // Гэрэл объектын ар талд байвал shadow sampling хийх шаардлагагүй.
                 ShadowParams sp{};
@@ -147,19 +451,28 @@ namespace shs
 
             o.color = ColorF{c.r, c.g, c.b, 1.0f};
             return o;
-        };
-        return p;
-    }
+        }
+    };
 
-    inline ShaderProgram make_pbr_mr_program()
+    template<uint32_t Features = ShaderFeaturesAll>
+    struct PbrMetallicRoughnessProgramT
     {
-        ShaderProgram p{};
-        p.vs = [](const ShaderVertex& vin, const ShaderUniforms& u) -> VertexOut {
-            return make_default_vertex_out(vin, u);
-        };
-        p.fs = [](const FragmentIn& fin, const ShaderUniforms& u) -> FragmentOut {
+        static constexpr FragmentLanesShaderFn fs_lanes = &shade_pbr_mr_lanes_t<Features>;
+        static constexpr bool motion_vectors = (Features & ShaderFeatureMotion) != 0u;
+
+        static VertexOut vs(const ShaderVertex& vin, const ShaderUniforms& u)
+        {
+            return make_surface_vertex_out(vin, u);
+        }
+
+        static FragmentOut fs(const FragmentIn& fin, const ShaderUniforms& u)
+        {
             FragmentOut o{};
-            const glm::vec3 albedo_tex = sample_texture2d_bilinear_repeat_linear(u.base_color_tex, fin.uv);
+            glm::vec3 albedo_tex(1.0f);
+            if constexpr ((Features & ShaderFeatureTextured) != 0u)
+            {
+                albedo_tex = sample_texture2d_trilinear_repeat_linear(u.base_color_tex, fin.uv, fin.duv_dx, fin.duv_dy);
+            }
             const glm::vec3 N = glm::normalize(fin.normal_ws);
             const glm::vec3 V = glm::normalize(u.camera_pos - fin.world_pos);
             const glm::vec3 L = glm::normalize(-u.light_dir_ws);
@@ -192,7 +505,7 @@ namespace shs
             const glm::vec3 diff = kd * albedo * (1.0f / glm::pi<float>());
             const glm::vec3 radiance = u.light_color * u.light_intensity;
             float shadow_vis = 1.0f;
-            if (u.shadow_map && NdotL > 0.0f)
+            if (((Features & ShaderFeatureShadowed) != 0u) && u.shadow_map && NdotL > 0.0f)
             {
                 // Direct lighting үүсэхгүй нөхцөлд shadow fetch хийлгүй skip.
                 ShadowParams sp{};
@@ -209,20 +522,24 @@ namespace shs
             const glm::vec3 c = direct + ibl;
             o.color = ColorF{c.r, c.g, c.b, 1.0f};
             return o;
-        };
-        return p;
-    }
+        }
+    };
 
-    inline ShaderProgram make_lit_shader_program()
-    {
-        return make_pbr_mr_program();
-    }
+    using BlinnPhongProgram = BlinnPhongProgramT<>;
+    using PbrMetallicRoughnessProgram = PbrMetallicRoughnessProgramT<>;
 
-    inline ShaderProgram make_debug_view_shader_program(DebugViewMode mode)
+    // Lit program-ийн vs-ийг ашиглаж albedo/normal/depth-ийг шууд харуулна. SIMD хувилбаргүй.
+    struct DebugViewProgram
     {
-        ShaderProgram p = make_lit_shader_program();
+        DebugViewMode mode = DebugViewMode::Final;
+
+        static VertexOut vs(const ShaderVertex& vin, const ShaderUniforms& u)
+        {
+            return make_surface_vertex_out(vin, u);
+        }
 
-        p.fs = [mode](const FragmentIn& fin, const ShaderUniforms& u) -> FragmentOut {
+        FragmentOut fs(const FragmentIn& fin, const ShaderUniforms& u) const
+        {
             FragmentOut o{};
             if (mode == DebugViewMode::Albedo)
             {
@@ -239,8 +556,26 @@ namespace shs
             const float d = std::clamp(fin.depth01, 0.0f, 1.0f);
             o.color = ColorF{d, d, d, 1.0f};
             return o;
-        };
+        }
+    };
+
+    inline ShaderProgram make_blinn_phong_program()
+    {
+        return make_shader_program(BlinnPhongProgram{});
+    }
 
-        return p;
+    inline ShaderProgram make_pbr_mr_program()
+    {
+        return make_shader_program(PbrMetallicRoughnessProgram{});
+    }
+
+    inline ShaderProgram make_lit_shader_program()
+    {
+        return make_pbr_mr_program();
+    }
+
+    inline ShaderProgram make_debug_view_shader_program(DebugViewMode mode)
+    {
+        return make_shader_program(DebugViewProgram{mode});
     }
 }
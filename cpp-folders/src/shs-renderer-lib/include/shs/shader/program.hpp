@@ -10,7 +10,9 @@
 */
 
 
+#include <concepts>
 #include <functional>
+#include <utility>
 
 #include "shs/shader/types.hpp"
 
@@ -18,16 +20,79 @@ namespace shs
 {
     using VertexShaderFn = std::function<VertexOut(const ShaderVertex&, const ShaderUniforms&)>;
     using FragmentShaderFn = std::function<FragmentOut(const FragmentIn&, const ShaderUniforms&)>;
+    // Олон пикселийг зэрэг shade хийх хувилбар. Varying-ийг биш зөвхөн world/normal/uv/depth
+    // атрибутыг авна. out.discard-ийг false-аар эхлүүлсэн байна.
+    using FragmentLanesShaderFn = void (*)(const FragmentLanesIn&, const ShaderUniforms&, FragmentLanesOut&);
 
     struct ShaderProgram
     {
         VertexShaderFn vs{};
         FragmentShaderFn fs{};
+        // Заавал биш. Байвал rasterizer (RasterizerConfig::simd_fragments үед) fs-ийн оронд
+        // үүнийг дуудна; fs-тэй ижил үр дүн гаргах ёстой.
+        FragmentLanesShaderFn fs_lanes = nullptr;
 
         bool valid() const
         {
             return (bool)vs && (bool)fs;
         }
     };
+
+    // Built-in program-уудын permutation-ийн feature bit. Bit унтраалттай kernel-ээс тухайн
+    // салаа (texture fetch, shadow lookup, motion vector) compile-time-д хасагдана.
+    enum : uint32_t
+    {
+        ShaderFeatureTextured = 1u << 0,
+        ShaderFeatureShadowed = 1u << 1,
+        ShaderFeatureMotion = 1u << 2,
+        ShaderFeatureDebugView = 1u << 3,
+        ShaderFeaturesAll = ShaderFeatureTextured | ShaderFeatureShadowed | ShaderFeatureMotion | ShaderFeatureDebugView
+    };
+
+    // Compile-time shader program-ийн интерфэйс. vs/fs нь static эсвэл const гишүүн функц
+    // байж болно; rasterize_mesh болон TiledRasterizer::submit нь program-ийн төрлөөр
+    // instantiate хийгдэх тул shader-ийн бие пикселийн давталт дотор inline болно.
+    // fs_lanes (FragmentLanesShaderFn) болон valid() нь заавал биш.
+    // ShaderProgram өөрөө энэ concept-ийг хангах type-erased adapter хэвээр.
+    template<typename P>
+    concept StaticShaderProgram = requires(const P& p, const ShaderVertex& v, const FragmentIn& f, const ShaderUniforms& u)
+    {
+        { p.vs(v, u) } -> std::convertible_to<VertexOut>;
+        { p.fs(f, u) } -> std::convertible_to<FragmentOut>;
+    };
+
+    template<StaticShaderProgram P>
+    inline bool program_valid(const P& p)
+    {
+        if constexpr (requires { { p.valid() } -> std::convertible_to<bool>; }) return p.valid();
+        else return true;
+    }
+
+    template<StaticShaderProgram P>
+    inline FragmentLanesShaderFn program_fs_lanes(const P& p)
+    {
+        if constexpr (requires { { p.fs_lanes } -> std::convertible_to<FragmentLanesShaderFn>; }) return p.fs_lanes;
+        else return nullptr;
+    }
+
+    // Program нь `static constexpr bool motion_vectors = false` зарласан бол rasterizer
+    // motion vector-ийн тооцоог fragment давталтаас compile-time-д хасна.
+    template<typename P>
+    inline constexpr bool program_may_write_motion = []
+    {
+        if constexpr (requires { { P::motion_vectors } -> std::convertible_to<bool>; }) return (bool)P::motion_vectors;
+        else return true;
+    }();
+
+    // Static program-ийг ShaderProgram болгож хадгална (ажиллах үед program солих, хуучин API).
+    template<StaticShaderProgram P>
+    inline ShaderProgram make_shader_program(P program)
+    {
+        ShaderProgram out{};
+        out.fs_lanes = program_fs_lanes(program);
+        out.vs = [program](const ShaderVertex& v, const ShaderUniforms& u) -> VertexOut { return program.vs(v, u); };
+        out.fs = [program = std::move(program)](const FragmentIn& f, const ShaderUniforms& u) -> FragmentOut { return program.fs(f, u); };
+        return out;
+    }
 }
 
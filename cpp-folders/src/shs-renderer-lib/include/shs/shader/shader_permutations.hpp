@@ -0,0 +1,140 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: shader_permutations.hpp
+    МОДУЛЬ: shader
+    ЗОРИЛГО: Built-in PBR/Blinn-Phong program-уудын feature bit-ээр (textured, shadowed,
+            motion, debug view) түлхүүрлэсэн permutation-ууд. Хослол бүр тусдаа template
+            instantiation (kernel) бөгөөд static санах ойд нэг л удаа үүснэ. Pass draw бүрт
+            shader_features_for_draw()-аар түлхүүр гаргаж with_shader_permutation()-аар
+            тохирох kernel-ийг төрлөөр нь авна (rasterizer-т vs/fs inline болно).
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "shs/frame/frame_params.hpp"
+#include "shs/shader/builtin_shaders.hpp"
+
+namespace shs
+{
+    struct ShaderPermutationKey
+    {
+        ShadingModel model = ShadingModel::PBRMetalRough;
+        uint32_t features = 0u;
+        // features-д ShaderFeatureDebugView байвал л хэрэглэгдэнэ.
+        DebugViewMode debug_view = DebugViewMode::Final;
+    };
+
+    // Lit kernel-ийн feature хослол (textured/shadowed/motion).
+    inline constexpr uint32_t k_shader_lit_feature_mask = ShaderFeatureTextured | ShaderFeatureShadowed | ShaderFeatureMotion;
+    inline constexpr uint32_t k_shader_lit_permutations = k_shader_lit_feature_mask + 1u;
+    inline constexpr uint32_t k_shader_debug_view_modes = 4u;
+    // 2 shading model x 8 lit хослол + debug view горим бүр.
+    inline constexpr uint32_t k_shader_permutation_count = 2u * k_shader_lit_permutations + k_shader_debug_view_modes;
+
+    template<uint32_t Features>
+    inline constexpr PbrMetallicRoughnessProgramT<Features> k_pbr_mr_kernel{};
+    template<uint32_t Features>
+    inline constexpr BlinnPhongProgramT<Features> k_blinn_phong_kernel{};
+    inline constexpr std::array<DebugViewProgram, k_shader_debug_view_modes> k_debug_view_kernels{{
+        DebugViewProgram{DebugViewMode::Final},
+        DebugViewProgram{DebugViewMode::Albedo},
+        DebugViewProgram{DebugViewMode::Normal},
+        DebugViewProgram{DebugViewMode::Depth},
+    }};
+
+    // Draw-ийн uniform болон pass-ийн төлөвөөс хэрэгтэй feature-уудыг сонгоно. Bit-гүй
+    // салааг kernel огт оруулаагүй тул энд нөхцөлийг ShaderUniforms-той яг тааруулна.
+    inline uint32_t shader_features_for_draw(const ShaderUniforms& u, bool has_motion_target, DebugViewMode debug_view)
+    {
+        uint32_t f = 0u;
+        if (u.base_color_tex && u.base_color_tex->valid()) f |= ShaderFeatureTextured;
+        if (u.shadow_map) f |= ShaderFeatureShadowed;
+        if (has_motion_target && u.enable_motion_vectors) f |= ShaderFeatureMotion;
+        if (debug_view != DebugViewMode::Final) f |= ShaderFeatureDebugView;
+        return f;
+    }
+
+    inline bool shader_permutation_is_debug_view(const ShaderPermutationKey& key)
+    {
+        return (key.features & ShaderFeatureDebugView) != 0u && key.debug_view != DebugViewMode::Final;
+    }
+
+    inline uint32_t shader_permutation_index(const ShaderPermutationKey& key)
+    {
+        if (shader_permutation_is_debug_view(key))
+        {
+            return 2u * k_shader_lit_permutations + std::min<uint32_t>((uint32_t)key.debug_view, k_shader_debug_view_modes - 1u);
+        }
+        const uint32_t model = (key.model == ShadingModel::BlinnPhong) ? 1u : 0u;
+        return model * k_shader_lit_permutations + (key.features & k_shader_lit_feature_mask);
+    }
+
+    namespace detail
+    {
+        template<uint32_t Features, typename Fn>
+        inline void dispatch_lit_kernel(ShadingModel model, Fn& fn)
+        {
+            if (model == ShadingModel::BlinnPhong) fn(k_blinn_phong_kernel<Features>);
+            else fn(k_pbr_mr_kernel<Features>);
+        }
+
+        template<typename Fn, uint32_t... Features>
+        inline void dispatch_lit_features(
+            uint32_t features,
+            ShadingModel model,
+            Fn& fn,
+            std::integer_sequence<uint32_t, Features...>)
+        {
+            (void)((features == Features ? (dispatch_lit_kernel<Features>(model, fn), true) : false) || ...);
+        }
+    }
+
+    // fn(const Program&)-ийг key-д тохирох kernel-ээр дуудна. Kernel-ууд static санах ойд
+    // байх тул TiledRasterizer::submit-д flush хүртэл заагчаар хадгалахад аюулгүй.
+    template<typename Fn>
+    inline void with_shader_permutation(const ShaderPermutationKey& key, Fn&& fn)
+    {
+        if (shader_permutation_is_debug_view(key))
+        {
+            fn(k_debug_view_kernels[shader_permutation_index(key) - 2u * k_shader_lit_permutations]);
+            return;
+        }
+        detail::dispatch_lit_features(
+            key.features & k_shader_lit_feature_mask,
+            key.model,
+            fn,
+            std::make_integer_sequence<uint32_t, k_shader_lit_permutations>{});
+    }
+
+    // Type-erased (ShaderProgram) хэрэглэгчдэд зориулсан permutation-ийн cache. Анх дуудахад
+    // бүх хослолыг нэг удаа байгуулна.
+    inline const ShaderProgram& shader_permutation_program(const ShaderPermutationKey& key)
+    {
+        static const std::array<ShaderProgram, k_shader_permutation_count> table = []
+        {
+            std::array<ShaderProgram, k_shader_permutation_count> t{};
+            for (uint32_t m = 0; m < 2u; ++m)
+            {
+                for (uint32_t f = 0; f < k_shader_lit_permutations; ++f)
+                {
+                    const ShaderPermutationKey k{m == 1u ? ShadingModel::BlinnPhong : ShadingModel::PBRMetalRough, f, DebugViewMode::Final};
+                    with_shader_permutation(k, [&](const auto& p) { t[shader_permutation_index(k)] = make_shader_program(p); });
+                }
+            }
+            for (uint32_t d = 1; d < k_shader_debug_view_modes; ++d)
+            {
+                const ShaderPermutationKey k{ShadingModel::PBRMetalRough, ShaderFeatureDebugView, (DebugViewMode)d};
+                t[shader_permutation_index(k)] = make_shader_program(k_debug_view_kernels[d]);
+            }
+            return t;
+        }();
+        return table[shader_permutation_index(key)];
+    }
+}
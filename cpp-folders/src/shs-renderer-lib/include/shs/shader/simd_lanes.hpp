@@ -0,0 +1,244 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: simd_lanes.hpp
+    МОДУЛЬ: shader
+    ЗОРИЛГО: Fragment-ийг олон пикселээр зэрэг (lane) тооцох SIMD төрлүүд.
+            SHS_HAS_XSIMD үед xsimd::batch<float>-ийг (архитектурын өргөн: SSE 4, AVX 8) шууд
+            ашиглана. xsimd байхгүй үед ижил интерфэйстэй 8 lane-тэй массив төрөл ашиглаж,
+            компилятор auto-vectorize хийнэ. Shader код зөвхөн энд тодорхойлсон
+            үйлдлүүдийг хэрэглэх тул хоёр хувилбар дээр өөрчлөлтгүй хөрвөнө.
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#if defined(SHS_HAS_XSIMD) && SHS_HAS_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+
+namespace shs::simd
+{
+#if defined(SHS_HAS_XSIMD) && SHS_HAS_XSIMD
+    using f32 = xsimd::batch<float>;
+    using mask = xsimd::batch_bool<float>;
+    inline constexpr int k_lanes = (int)f32::size;
+
+    inline f32 load(const float* p) { return f32::load_unaligned(p); }
+    inline void store(float* p, const f32& v) { v.store_unaligned(p); }
+    inline f32 select(const mask& m, const f32& a, const f32& b) { return xsimd::select(m, a, b); }
+    inline bool any(const mask& m) { return xsimd::any(m); }
+    inline f32 min(const f32& a, const f32& b) { return xsimd::min(a, b); }
+    inline f32 max(const f32& a, const f32& b) { return xsimd::max(a, b); }
+    inline f32 abs(const f32& a) { return xsimd::abs(a); }
+    inline f32 sqrt(const f32& a) { return xsimd::sqrt(a); }
+    inline f32 pow(const f32& a, const f32& b) { return xsimd::pow(a, b); }
+#else
+    inline constexpr int k_lanes = 8;
+
+    struct mask
+    {
+        std::array<int32_t, k_lanes> v{};
+
+        friend mask operator&(const mask& a, const mask& b)
+        {
+            mask r{};
+            for (int i = 0; i < k_lanes; ++i) r.v[i] = a.v[i] & b.v[i];
+            return r;
+        }
+        friend mask operator|(const mask& a, const mask& b)
+        {
+            mask r{};
+            for (int i = 0; i < k_lanes; ++i) r.v[i] = a.v[i] | b.v[i];
+            return r;
+        }
+    };
+
+    struct f32
+    {
+        std::array<float, k_lanes> v{};
+
+        f32() = default;
+        f32(float s) { v.fill(s); }
+
+        f32& operator+=(const f32& o) { for (int i = 0; i < k_lanes; ++i) v[i] += o.v[i]; return *this; }
+        f32& operator-=(const f32& o) { for (int i = 0; i < k_lanes; ++i) v[i] -= o.v[i]; return *this; }
+        f32& operator*=(const f32& o) { for (int i = 0; i < k_lanes; ++i) v[i] *= o.v[i]; return *this; }
+        f32& operator/=(const f32& o) { for (int i = 0; i < k_lanes; ++i) v[i] /= o.v[i]; return *this; }
+
+        friend f32 operator+(f32 a, const f32& b) { return a += b; }
+        friend f32 operator-(f32 a, const f32& b) { return a -= b; }
+        friend f32 operator*(f32 a, const f32& b) { return a *= b; }
+        friend f32 operator/(f32 a, const f32& b) { return a /= b; }
+        friend f32 operator-(const f32& a)
+        {
+            f32 r{};
+            for (int i = 0; i < k_lanes; ++i) r.v[i] = -a.v[i];
+            return r;
+        }
+
+#define SHS_SIMD_LANES_CMP(op)                                              \
+        friend mask operator op(const f32& a, const f32& b)                 \
+        {                                                                   \
+            mask r{};                                                       \
+            for (int i = 0; i < k_lanes; ++i) r.v[i] = (a.v[i] op b.v[i]) ? -1 : 0; \
+            return r;                                                       \
+        }
+        SHS_SIMD_LANES_CMP(<)
+        SHS_SIMD_LANES_CMP(<=)
+        SHS_SIMD_LANES_CMP(>)
+        SHS_SIMD_LANES_CMP(>=)
+#undef SHS_SIMD_LANES_CMP
+    };
+
+    inline f32 load(const float* p)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = p[i];
+        return r;
+    }
+    inline void store(float* p, const f32& a)
+    {
+        for (int i = 0; i < k_lanes; ++i) p[i] = a.v[i];
+    }
+    // mask lane нь 0 эсвэл -1 тул битээр холино: ternary нь lane бүрт branch болж vectorize хийгдэхгүй.
+    inline f32 select(const mask& m, const f32& a, const f32& b)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i)
+        {
+            const uint32_t mi = (uint32_t)m.v[i];
+            r.v[i] = std::bit_cast<float>((std::bit_cast<uint32_t>(a.v[i]) & mi) | (std::bit_cast<uint32_t>(b.v[i]) & ~mi));
+        }
+        return r;
+    }
+    inline bool any(const mask& m)
+    {
+        int32_t acc = 0;
+        for (int i = 0; i < k_lanes; ++i) acc |= m.v[i];
+        return acc != 0;
+    }
+    inline f32 min(const f32& a, const f32& b)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = std::min(a.v[i], b.v[i]);
+        return r;
+    }
+    inline f32 max(const f32& a, const f32& b)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = std::max(a.v[i], b.v[i]);
+        return r;
+    }
+    inline f32 abs(const f32& a)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = std::abs(a.v[i]);
+        return r;
+    }
+    inline f32 sqrt(const f32& a)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = std::sqrt(a.v[i]);
+        return r;
+    }
+    inline f32 pow(const f32& a, const f32& b)
+    {
+        f32 r{};
+        for (int i = 0; i < k_lanes; ++i) r.v[i] = std::pow(a.v[i], b.v[i]);
+        return r;
+    }
+#endif
+
+    using LaneArray = std::array<float, (size_t)k_lanes>;
+
+    inline f32 clamp(const f32& a, float lo, float hi)
+    {
+        return min(max(a, f32(lo)), f32(hi));
+    }
+
+    inline f32 lane_index()
+    {
+        LaneArray a{};
+        for (int i = 0; i < k_lanes; ++i) a[(size_t)i] = (float)i;
+        return load(a.data());
+    }
+
+    // bit i = lane i. k_lanes <= 32 гэж үзнэ.
+    inline mask mask_from_bits(uint32_t bits)
+    {
+        LaneArray a{};
+        for (int i = 0; i < k_lanes; ++i) a[(size_t)i] = ((bits >> i) & 1u) ? 1.0f : 0.0f;
+        return load(a.data()) > f32(0.5f);
+    }
+
+    inline uint32_t mask_bits(const mask& m)
+    {
+        LaneArray a{};
+        store(a.data(), select(m, f32(1.0f), f32(0.0f)));
+        uint32_t bits = 0u;
+        for (int i = 0; i < k_lanes; ++i)
+        {
+            if (a[(size_t)i] != 0.0f) bits |= (1u << i);
+        }
+        return bits;
+    }
+
+    struct Vec2Lanes
+    {
+        f32 x{};
+        f32 y{};
+    };
+
+    struct Vec3Lanes
+    {
+        f32 x{};
+        f32 y{};
+        f32 z{};
+
+        Vec3Lanes() = default;
+        Vec3Lanes(const f32& ax, const f32& ay, const f32& az) : x(ax), y(ay), z(az) {}
+        Vec3Lanes(const glm::vec3& s) : x(s.x), y(s.y), z(s.z) {}
+
+        friend Vec3Lanes operator+(const Vec3Lanes& a, const Vec3Lanes& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+        friend Vec3Lanes operator-(const Vec3Lanes& a, const Vec3Lanes& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+        friend Vec3Lanes operator*(const Vec3Lanes& a, const Vec3Lanes& b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+        friend Vec3Lanes operator*(const Vec3Lanes& a, const f32& s) { return {a.x * s, a.y * s, a.z * s}; }
+        friend Vec3Lanes operator*(const f32& s, const Vec3Lanes& a) { return {a.x * s, a.y * s, a.z * s}; }
+    };
+
+    inline f32 dot(const Vec3Lanes& a, const Vec3Lanes& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    // glm::normalize-той ижил, харин тэг урттай lane NaN болохгүй.
+    inline Vec3Lanes normalize(const Vec3Lanes& a)
+    {
+        const f32 inv_len = f32(1.0f) / sqrt(max(dot(a, a), f32(1e-30f)));
+        return a * inv_len;
+    }
+
+    inline Vec3Lanes mix(const Vec3Lanes& a, const Vec3Lanes& b, const f32& t)
+    {
+        return a + (b - a) * t;
+    }
+
+    inline Vec3Lanes max(const Vec3Lanes& a, const Vec3Lanes& b)
+    {
+        return {max(a.x, b.x), max(a.y, b.y), max(a.z, b.z)};
+    }
+
+    inline Vec3Lanes select(const mask& m, const Vec3Lanes& a, const Vec3Lanes& b)
+    {
+        return {select(m, a.x, b.x), select(m, a.y, b.y), select(m, a.z, b.z)};
+    }
+}
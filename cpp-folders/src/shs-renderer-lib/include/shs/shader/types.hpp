@@ -18,6 +18,7 @@
 #include "shs/gfx/rt_shadow.hpp"
 #include "shs/gfx/rt_types.hpp"
 #include "shs/resources/texture.hpp"
+#include "shs/shader/simd_lanes.hpp"
 
 namespace shs
 {
@@ -73,6 +74,9 @@ namespace shs
         glm::vec3 world_pos{0.0f};
         glm::vec3 normal_ws{0.0f, 1.0f, 0.0f};
         glm::vec2 uv{0.0f};
+        // uv-ийн дэлгэцийн x/y-ээрх уламжлал (texture LOD сонгоход).
+        glm::vec2 duv_dx{0.0f};
+        glm::vec2 duv_dy{0.0f};
         float depth01 = 1.0f;
         int px = 0;
         int py = 0;
@@ -84,6 +88,28 @@ namespace shs
         bool discard = false;
     };
 
+    // simd::k_lanes пикселийн нэг мөрийн хэсэг (x = px + lane, y = py).
+    // Идэвхгүй lane-ийн утга тодорхойгүй тул shader зөвхөн active lane-ийг гаргана гэж үзнэ.
+    struct FragmentLanesIn
+    {
+        simd::Vec3Lanes world_pos{};
+        simd::Vec3Lanes normal_ws{};
+        simd::Vec2Lanes uv{};
+        simd::Vec2Lanes duv_dx{};
+        simd::Vec2Lanes duv_dy{};
+        simd::f32 depth01{};
+        simd::mask active{};
+        int px = 0;
+        int py = 0;
+    };
+
+    struct FragmentLanesOut
+    {
+        simd::Vec3Lanes color{};
+        simd::f32 alpha{};
+        simd::mask discard{};
+    };
+
     struct ShaderUniforms
     {
         std::array<glm::vec4, SHS_MAX_UNIFORM_VECS> vec4s{};
@@ -113,6 +139,9 @@ namespace shs
         float shadow_strength = 1.0f;
 
         bool enable_motion_vectors = false;
+        // true: объект энэ кадрт хөдлөөгүй (prev_model == model) тул motion-д зөвхөн
+        // камерын viewproj -> prev_viewproj шилжилтийг хэрэглэнэ.
+        bool motion_static = false;
     };
 
     inline void set_varying(VertexOut& out, VaryingSemantic semantic, const glm::vec4& v)
@@ -31,28 +31,32 @@ namespace shs
 
         const int w = out_hdr.w;
         const int h = out_hdr.h;
-        parallel_for_1d(jobs, 0, h, 8, [&](int yb, int ye)
+        // Формат давталтын гадна нэг удаа сонгогдоно (RT_ColorHDR::visit).
+        out_hdr.visit([&](auto& buf)
         {
-            for (int y = yb; y < ye; ++y)
+            parallel_for_1d(jobs, 0, h, 8, [&](int yb, int ye)
             {
-                const float ndc_y = (2.0f * ((float)y + 0.5f) / (float)h) - 1.0f;
-                for (int x = 0; x < w; ++x)
+                for (int y = yb; y < ye; ++y)
                 {
-                    const float ndc_x = (2.0f * ((float)x + 0.5f) / (float)w) - 1.0f;
-                    const glm::vec4 clip = glm::vec4(ndc_x, ndc_y, 1.0f, 1.0f);
-                    glm::vec4 world = inv_vp * clip;
-                    if (std::abs(world.w) < 1e-8f)
+                    const float ndc_y = (2.0f * ((float)y + 0.5f) / (float)h) - 1.0f;
+                    for (int x = 0; x < w; ++x)
                     {
-                        out_hdr.color.at(x, y) = ColorF{0.0f, 0.0f, 0.0f, 1.0f};
-                        continue;
+                        const float ndc_x = (2.0f * ((float)x + 0.5f) / (float)w) - 1.0f;
+                        const glm::vec4 clip = glm::vec4(ndc_x, ndc_y, 1.0f, 1.0f);
+                        glm::vec4 world = inv_vp * clip;
+                        if (std::abs(world.w) < 1e-8f)
+                        {
+                            hdr_store(buf, x, y, ColorF{0.0f, 0.0f, 0.0f, 1.0f});
+                            continue;
+                        }
+                        world /= world.w;
+
+                        const glm::vec3 dir_ws = glm::normalize(glm::vec3(world) - cam_pos);
+                        const glm::vec3 c = sky.sample(dir_ws);
+                        hdr_store(buf, x, y, ColorF{c.r, c.g, c.b, 1.0f});
                     }
-                    world /= world.w;
-
-                    const glm::vec3 dir_ws = glm::normalize(glm::vec3(world) - cam_pos);
-                    const glm::vec3 c = sky.sample(dir_ws);
-                    out_hdr.color.at(x, y) = ColorF{c.r, c.g, c.b, 1.0f};
                 }
-            }
+            });
         });
     }
 }
@@ -0,0 +1,426 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: edge_raster.hpp
+    МОДУЛЬ: render
+    ЗОРИЛГО: Гурвалжны хагас хавтгайн (half-space) raster-ийн нийтлэг цөм.
+            Оройнуудыг fixed-point sub-pixel нарийвчлалд буулгаж, ирмэгийн функцийг
+            пикселээс пиксел рүү зөвхөн нэмэх үйлдлээр алхуулна. Top-left fill rule-ээр
+            хөрш гурвалжнуудын нийтлэг ирмэг дээрх пиксел яг нэг удаа зурагдана.
+            SIMD fragment замд зориулж block-ийн мөр бүрийг coverage bitmask-тай span болгож гаргана.
+            8x8 block бүрийг булангаар нь шалгаж бүрэн гадна (trivial reject) block-ийг
+            алгасаж, бүрэн дотор (trivial accept) block-д пиксел бүрийн шалгалтыг хийхгүй.
+*/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace shs
+{
+    // 1/256 пикселийн sub-pixel нарийвчлал.
+    inline constexpr int k_raster_subpixel_bits = 8;
+    inline constexpr int64_t k_raster_subpixel_one = int64_t{1} << k_raster_subpixel_bits;
+    inline constexpr int k_raster_block_size = 8;
+    // Fixed-point замын координатын хязгаар (пиксел). Ирмэгийн утга int64-д багтана.
+    // Үүнээс хэтэрсэн (clip хийгээгүй shadow/culling) гурвалжин double fallback-аар явна.
+    inline constexpr float k_raster_fixed_guard_band = 16384.0f;
+
+    struct RasterBlockStats
+    {
+        uint64_t blocks_rejected = 0;
+        uint64_t blocks_accepted = 0;
+        uint64_t blocks_partial = 0;
+    };
+
+    // Нэг мөрийн дараалсан <= k_raster_block_size пиксел. Пиксел k (x + k) бүрхэгдсэн бол
+    // coverage-ийн bit k асна. Barycentric нь x дээрх утга + k * алхам.
+    struct RasterSpan
+    {
+        int x = 0;
+        int y = 0;
+        int count = 0;
+        uint32_t coverage = 0u;
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+        float db1 = 0.0f;
+        float db2 = 0.0f;
+    };
+
+    // Гурвалжны ирмэгийн setup. Ирмэг i нь орой i-гийн эсрэг талынх бөгөөд
+    // E_i(p) / area нь орой i-гийн barycentric жин болно.
+    struct RasterEdgeSetup
+    {
+        std::array<int64_t, 3> a{};
+        std::array<int64_t, 3> b{};
+        std::array<int64_t, 3> c{};
+        // Пиксел дотор байх нөхцөл: E_i >= min_e[i] (top-left ирмэг дээр 0, бусад дээр 1).
+        std::array<int64_t, 3> min_e{};
+        std::array<double, 3> fa{};
+        std::array<double, 3> fb{};
+        std::array<double, 3> fc{};
+        float inv_area = 0.0f;
+        bool fixed_point = true;
+        bool valid = false;
+    };
+
+    namespace detail
+    {
+        // Чиглэл эсрэгээр эргэхэд (a, b) тэмдгээ солих тул нийтлэг ирмэгийн хоёр
+        // гурвалжны яг нэг нь л энэ нөхцөлийг хангана.
+        template<typename T>
+        inline bool is_top_left_edge(T a, T b)
+        {
+            return a > T{0} || (a == T{0} && b < T{0});
+        }
+    }
+
+    // s0..s2: пикселийн координат (пикселийн төв нь x + 0.5). Дэлгэцэн дээр талбайгүй
+    // гурвалжинд valid = false.
+    inline bool setup_raster_edges(const glm::vec2& s0, const glm::vec2& s1, const glm::vec2& s2, RasterEdgeSetup& out)
+    {
+        out = RasterEdgeSetup{};
+        const glm::vec2 v[3] = {s0, s1, s2};
+        bool in_band = true;
+        for (const glm::vec2& p : v)
+        {
+            if (!std::isfinite(p.x) || !std::isfinite(p.y)) return false;
+            if (std::abs(p.x) > k_raster_fixed_guard_band || std::abs(p.y) > k_raster_fixed_guard_band) in_band = false;
+        }
+
+        if (in_band)
+        {
+            int64_t x[3]{};
+            int64_t y[3]{};
+            for (int i = 0; i < 3; ++i)
+            {
+                x[i] = (int64_t)std::llround((double)v[i].x * (double)k_raster_subpixel_one);
+                y[i] = (int64_t)std::llround((double)v[i].y * (double)k_raster_subpixel_one);
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                const int ia = (i + 1) % 3;
+                const int ib = (i + 2) % 3;
+                out.a[i] = y[ia] - y[ib];
+                out.b[i] = x[ib] - x[ia];
+                out.c[i] = -(out.a[i] * x[ia] + out.b[i] * y[ia]);
+            }
+            int64_t area = out.a[0] * x[0] + out.b[0] * y[0] + out.c[0];
+            if (area == 0) return false;
+            if (area < 0)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    out.a[i] = -out.a[i];
+                    out.b[i] = -out.b[i];
+                    out.c[i] = -out.c[i];
+                }
+                area = -area;
+            }
+            for (int i = 0; i < 3; ++i)
+            {
+                out.min_e[i] = detail::is_top_left_edge(out.a[i], out.b[i]) ? 0 : 1;
+            }
+            out.inv_area = (float)(1.0 / (double)area);
+            out.fixed_point = true;
+            out.valid = true;
+            return true;
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            const glm::vec2& pa = v[(i + 1) % 3];
+            const glm::vec2& pb = v[(i + 2) % 3];
+            out.fa[i] = (double)pa.y - (double)pb.y;
+            out.fb[i] = (double)pb.x - (double)pa.x;
+            out.fc[i] = -(out.fa[i] * (double)pa.x + out.fb[i] * (double)pa.y);
+        }
+        double area = out.fa[0] * (double)s0.x + out.fb[0] * (double)s0.y + out.fc[0];
+        if (!(std::abs(area) > 1e-12)) return false;
+        if (area < 0.0)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                out.fa[i] = -out.fa[i];
+                out.fb[i] = -out.fb[i];
+                out.fc[i] = -out.fc[i];
+            }
+            area = -area;
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            out.min_e[i] = detail::is_top_left_edge(out.fa[i], out.fb[i]) ? 0 : 1;
+        }
+        out.inv_area = (float)(1.0 / area);
+        out.fixed_point = false;
+        out.valid = true;
+        return true;
+    }
+
+    // Нэг пикселээр x (step_y: y) чиглэлд шилжихэд s0..s2-ийн barycentric жингийн өөрчлөлт.
+    inline glm::vec2 raster_edge_bary_step(const RasterEdgeSetup& e, int i)
+    {
+        if (e.fixed_point)
+        {
+            const float s = (float)k_raster_subpixel_one * e.inv_area;
+            return glm::vec2{(float)e.a[(size_t)i] * s, (float)e.b[(size_t)i] * s};
+        }
+        return glm::vec2{(float)e.fa[(size_t)i] * e.inv_area, (float)e.fb[(size_t)i] * e.inv_area};
+    }
+
+    // [minx, maxx] x [miny, maxy] мужид гурвалжны бүрхсэн пиксел бүрд fn(x, y, bc)-г дуудна.
+    // bc.x/y/z нь s0/s1/s2-ийн barycentric жин. Мөр бүрд x өсөх дарааллаар явна.
+    template<typename Fn>
+    inline void rasterize_edges(
+        const RasterEdgeSetup& e,
+        int minx,
+        int maxx,
+        int miny,
+        int maxy,
+        Fn&& fn,
+        RasterBlockStats* stats = nullptr)
+    {
+        if (!e.valid || minx > maxx || miny > maxy) return;
+
+        if (!e.fixed_point)
+        {
+            for (int y = miny; y <= maxy; ++y)
+            {
+                const double py = (double)y + 0.5;
+                for (int x = minx; x <= maxx; ++x)
+                {
+                    const double px = (double)x + 0.5;
+                    const double e0 = e.fa[0] * px + e.fb[0] * py + e.fc[0];
+                    const double e1 = e.fa[1] * px + e.fb[1] * py + e.fc[1];
+                    const double e2 = e.fa[2] * px + e.fb[2] * py + e.fc[2];
+                    if (e0 < 0.0 || (e0 == 0.0 && e.min_e[0] != 0)) continue;
+                    if (e1 < 0.0 || (e1 == 0.0 && e.min_e[1] != 0)) continue;
+                    if (e2 < 0.0 || (e2 == 0.0 && e.min_e[2] != 0)) continue;
+                    const float b1 = (float)e1 * e.inv_area;
+                    const float b2 = (float)e2 * e.inv_area;
+                    fn(x, y, glm::vec3(1.0f - b1 - b2, b1, b2));
+                }
+            }
+            return;
+        }
+
+        constexpr int B = k_raster_block_size;
+        constexpr int64_t one = k_raster_subpixel_one;
+        constexpr int64_t half = one / 2;
+        const int64_t step_x[3] = {e.a[0] * one, e.a[1] * one, e.a[2] * one};
+        const int64_t step_y[3] = {e.b[0] * one, e.b[1] * one, e.b[2] * one};
+        const float inv_area = e.inv_area;
+
+        for (int by = miny & ~(B - 1); by <= maxy; by += B)
+        {
+            const int y0 = std::max(by, miny);
+            const int y1 = std::min(by + B - 1, maxy);
+            for (int bx = minx & ~(B - 1); bx <= maxx; bx += B)
+            {
+                const int x0 = std::max(bx, minx);
+                const int x1 = std::min(bx + B - 1, maxx);
+                const int64_t px0 = (int64_t)x0 * one + half;
+                const int64_t py0 = (int64_t)y0 * one + half;
+
+                // Ирмэг шугаман тул block доторх хамгийн их/бага утга нь булан дээр байна.
+                int64_t origin[3]{};
+                bool reject = false;
+                bool accept = true;
+                for (int i = 0; i < 3; ++i)
+                {
+                    const int64_t e00 = e.a[i] * px0 + e.b[i] * py0 + e.c[i];
+                    const int64_t dx = step_x[i] * (x1 - x0);
+                    const int64_t dy = step_y[i] * (y1 - y0);
+                    const int64_t emax = e00 + std::max<int64_t>(dx, 0) + std::max<int64_t>(dy, 0);
+                    const int64_t emin = e00 + std::min<int64_t>(dx, 0) + std::min<int64_t>(dy, 0);
+                    if (emax < e.min_e[i])
+                    {
+                        reject = true;
+                        break;
+                    }
+                    if (emin < e.min_e[i]) accept = false;
+                    origin[i] = e00;
+                }
+                if (reject)
+                {
+                    if (stats) stats->blocks_rejected++;
+                    continue;
+                }
+                if (stats)
+                {
+                    if (accept) stats->blocks_accepted++;
+                    else stats->blocks_partial++;
+                }
+
+                for (int y = y0; y <= y1; ++y)
+                {
+                    int64_t e0 = origin[0];
+                    int64_t e1 = origin[1];
+                    int64_t e2 = origin[2];
+                    for (int x = x0; x <= x1; ++x)
+                    {
+                        if (accept || (e0 >= e.min_e[0] && e1 >= e.min_e[1] && e2 >= e.min_e[2]))
+                        {
+                            const float b1 = (float)e1 * inv_area;
+                            const float b2 = (float)e2 * inv_area;
+                            fn(x, y, glm::vec3(1.0f - b1 - b2, b1, b2));
+                        }
+                        e0 += step_x[0];
+                        e1 += step_x[1];
+                        e2 += step_x[2];
+                    }
+                    origin[0] += step_y[0];
+                    origin[1] += step_y[1];
+                    origin[2] += step_y[2];
+                }
+            }
+        }
+    }
+
+    // rasterize_edges-тэй ижил пикселүүдийг span-аар гаргана: coverage != 0 мөрийн хэсэг бүрд
+    // fn(const RasterSpan&). Block-ийн trivial accept/reject нь хэвээр ажиллана.
+    template<typename Fn>
+    inline void rasterize_edge_spans(
+        const RasterEdgeSetup& e,
+        int minx,
+        int maxx,
+        int miny,
+        int maxy,
+        Fn&& fn,
+        RasterBlockStats* stats = nullptr)
+    {
+        if (!e.valid || minx > maxx || miny > maxy) return;
+        constexpr int B = k_raster_block_size;
+        static_assert(B <= 32, "span coverage mask is 32 bits");
+
+        if (!e.fixed_point)
+        {
+            const float db1 = (float)e.fa[1] * e.inv_area;
+            const float db2 = (float)e.fa[2] * e.inv_area;
+            for (int y = miny; y <= maxy; ++y)
+            {
+                const double py = (double)y + 0.5;
+                for (int sx = minx; sx <= maxx; sx += B)
+                {
+                    RasterSpan span{};
+                    span.x = sx;
+                    span.y = y;
+                    span.count = std::min(B, maxx - sx + 1);
+                    for (int k = 0; k < span.count; ++k)
+                    {
+                        const double px = (double)(sx + k) + 0.5;
+                        const double e0 = e.fa[0] * px + e.fb[0] * py + e.fc[0];
+                        const double e1 = e.fa[1] * px + e.fb[1] * py + e.fc[1];
+                        const double e2 = e.fa[2] * px + e.fb[2] * py + e.fc[2];
+                        if (e0 < 0.0 || (e0 == 0.0 && e.min_e[0] != 0)) continue;
+                        if (e1 < 0.0 || (e1 == 0.0 && e.min_e[1] != 0)) continue;
+                        if (e2 < 0.0 || (e2 == 0.0 && e.min_e[2] != 0)) continue;
+                        span.coverage |= (1u << k);
+                    }
+                    if (span.coverage == 0u) continue;
+                    const double px0 = (double)sx + 0.5;
+                    span.b1 = (float)(e.fa[1] * px0 + e.fb[1] * py + e.fc[1]) * e.inv_area;
+                    span.b2 = (float)(e.fa[2] * px0 + e.fb[2] * py + e.fc[2]) * e.inv_area;
+                    span.db1 = db1;
+                    span.db2 = db2;
+                    fn(span);
+                }
+            }
+            return;
+        }
+
+        constexpr int64_t one = k_raster_subpixel_one;
+        constexpr int64_t half = one / 2;
+        const int64_t step_x[3] = {e.a[0] * one, e.a[1] * one, e.a[2] * one};
+        const int64_t step_y[3] = {e.b[0] * one, e.b[1] * one, e.b[2] * one};
+        const float inv_area = e.inv_area;
+        const float db1 = (float)step_x[1] * inv_area;
+        const float db2 = (float)step_x[2] * inv_area;
+
+        for (int by = miny & ~(B - 1); by <= maxy; by += B)
+        {
+            const int y0 = std::max(by, miny);
+            const int y1 = std::min(by + B - 1, maxy);
+            for (int bx = minx & ~(B - 1); bx <= maxx; bx += B)
+            {
+                const int x0 = std::max(bx, minx);
+                const int x1 = std::min(bx + B - 1, maxx);
+                const int64_t px0 = (int64_t)x0 * one + half;
+                const int64_t py0 = (int64_t)y0 * one + half;
+
+                int64_t origin[3]{};
+                bool reject = false;
+                bool accept = true;
+                for (int i = 0; i < 3; ++i)
+                {
+                    const int64_t e00 = e.a[i] * px0 + e.b[i] * py0 + e.c[i];
+                    const int64_t dx = step_x[i] * (x1 - x0);
+                    const int64_t dy = step_y[i] * (y1 - y0);
+                    const int64_t emax = e00 + std::max<int64_t>(dx, 0) + std::max<int64_t>(dy, 0);
+                    const int64_t emin = e00 + std::min<int64_t>(dx, 0) + std::min<int64_t>(dy, 0);
+                    if (emax < e.min_e[i])
+                    {
+                        reject = true;
+                        break;
+                    }
+                    if (emin < e.min_e[i]) accept = false;
+                    origin[i] = e00;
+                }
+                if (reject)
+                {
+                    if (stats) stats->blocks_rejected++;
+                    continue;
+                }
+                if (stats)
+                {
+                    if (accept) stats->blocks_accepted++;
+                    else stats->blocks_partial++;
+                }
+
+                const int count = x1 - x0 + 1;
+                const uint32_t full = (count >= 32) ? ~0u : ((1u << count) - 1u);
+                for (int y = y0; y <= y1; ++y)
+                {
+                    RasterSpan span{};
+                    span.x = x0;
+                    span.y = y;
+                    span.count = count;
+                    if (accept)
+                    {
+                        span.coverage = full;
+                    }
+                    else
+                    {
+                        int64_t e0 = origin[0];
+                        int64_t e1 = origin[1];
+                        int64_t e2 = origin[2];
+                        for (int k = 0; k < count; ++k)
+                        {
+                            if (e0 >= e.min_e[0] && e1 >= e.min_e[1] && e2 >= e.min_e[2]) span.coverage |= (1u << k);
+                            e0 += step_x[0];
+                            e1 += step_x[1];
+                            e2 += step_x[2];
+                        }
+                    }
+                    if (span.coverage != 0u)
+                    {
+                        span.b1 = (float)origin[1] * inv_area;
+                        span.b2 = (float)origin[2] * inv_area;
+                        span.db1 = db1;
+                        span.db2 = db2;
+                        fn(span);
+                    }
+                    origin[0] += step_y[0];
+                    origin[1] += step_y[1];
+                    origin[2] += step_y[2];
+                }
+            }
+        }
+    }
+}
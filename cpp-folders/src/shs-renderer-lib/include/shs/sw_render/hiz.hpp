@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: hiz.hpp
+    МОДУЛЬ: render
+    ЗОРИЛГО: Software rasterizer-ийн hierarchical-Z. Depth buffer-ийн 8x8 block бүрийн
+            min/max гүнийг хадгалж, гурвалжны хамгийн ойрын гүн block-ийн хамгийн алсын
+            гүнээс цааш байвал тухайн block-ийг пиксел бүрийн ажилгүйгээр алгасна.
+            Raster depth бичих үед block-ийг "dirty" болгож, дараагийн асуултад 64 пикселийг
+            дахин уншиж нарийн утгыг сэргээнэ (max зөвхөн багасах тул dirty үед ч хуучин утга
+            консерватив хэвээр).
+*/
+
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "shs/gfx/rt_types.hpp"
+#include "shs/sw_render/edge_raster.hpp"
+
+namespace shs
+{
+    // Block-ийн хэмжээ нь edge raster-ийн block-той ижил тул tile/мөрийн хуваалт 8-д
+    // зэрэгцсэн үед нэг block-ийг зөвхөн нэг thread өөрчилнө.
+    inline constexpr int k_hiz_block_size = k_raster_block_size;
+    static_assert(FastClearTiles::k_tile == k_hiz_block_size, "fast-clear tile must match the Hi-Z block");
+
+    class RasterHiZ
+    {
+    public:
+        // depth-ийн бүх block-ийг дахин тооцно. Pass эхлэхэд (clear эсвэл prepass-ийн дараа)
+        // дуудаж, rasterizer-аас гадуур бичигдсэн depth-тэй зөрөхгүй болгоно.
+        void rebuild(const PixelBuffer2D<float>& depth)
+        {
+            w_ = depth.w;
+            h_ = depth.h;
+            bw_ = (w_ + k_hiz_block_size - 1) / k_hiz_block_size;
+            bh_ = (h_ + k_hiz_block_size - 1) / k_hiz_block_size;
+            const size_t n = (size_t)bw_ * (size_t)bh_;
+            zmin_.assign(n, 0.0f);
+            zmax_.assign(n, 1.0f);
+            dirty_.assign(n, 0u);
+            for (int by = 0; by < bh_; ++by)
+            {
+                for (int bx = 0; bx < bw_; ++bx)
+                {
+                    // clear_fast()-ийн pending block: санах ой уншилгүй clear утгаа авна.
+                    if (depth.fast_clear.tile_pending(bx, by))
+                    {
+                        const size_t i = index(bx, by);
+                        zmin_[i] = depth.fast_clear_value;
+                        zmax_[i] = depth.fast_clear_value;
+                        continue;
+                    }
+                    refresh(bx, by, depth);
+                }
+            }
+        }
+
+        bool matches(const PixelBuffer2D<float>& depth) const
+        {
+            return w_ == depth.w && h_ == depth.h && w_ > 0 && h_ > 0;
+        }
+
+        int blocks_x() const { return bw_; }
+        int blocks_y() const { return bh_; }
+
+        float block_max(int bx, int by, const PixelBuffer2D<float>& depth)
+        {
+            const size_t i = index(bx, by);
+            if (dirty_[i]) refresh(bx, by, depth);
+            return zmax_[i];
+        }
+
+        float block_min(int bx, int by, const PixelBuffer2D<float>& depth)
+        {
+            const size_t i = index(bx, by);
+            if (dirty_[i]) refresh(bx, by, depth);
+            return zmin_[i];
+        }
+
+        void mark_dirty(int bx, int by)
+        {
+            dirty_[index(bx, by)] = 1u;
+        }
+
+    private:
+        size_t index(int bx, int by) const
+        {
+            return (size_t)by * (size_t)bw_ + (size_t)bx;
+        }
+
+        void refresh(int bx, int by, const PixelBuffer2D<float>& depth)
+        {
+            const int x0 = bx * k_hiz_block_size;
+            const int y0 = by * k_hiz_block_size;
+            const int x1 = std::min(w_, x0 + k_hiz_block_size);
+            const int y1 = std::min(h_, y0 + k_hiz_block_size);
+            float lo = std::numeric_limits<float>::max();
+            float hi = std::numeric_limits<float>::lowest();
+            for (int y = y0; y < y1; ++y)
+            {
+                const float* row = &depth.at(x0, y);
+                for (int x = 0; x < x1 - x0; ++x)
+                {
+                    lo = std::min(lo, row[x]);
+                    hi = std::max(hi, row[x]);
+                }
+            }
+            const size_t i = index(bx, by);
+            zmin_[i] = lo;
+            zmax_[i] = hi;
+            dirty_[i] = 0u;
+        }
+
+        int w_ = 0;
+        int h_ = 0;
+        int bw_ = 0;
+        int bh_ = 0;
+        std::vector<float> zmin_{};
+        std::vector<float> zmax_{};
+        std::vector<uint8_t> dirty_{};
+    };
+}
@@ -12,14 +12,21 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include "shs/gfx/rt_shadow.hpp"
 #include "shs/job/parallel_for.hpp"
 #include "shs/resources/mesh.hpp"
 #include "shs/shader/program.hpp"
+#include "shs/sw_render/edge_raster.hpp"
+#include "shs/sw_render/hiz.hpp"
 
 namespace shs
 {
@@ -37,12 +44,20 @@ namespace shs
         IJobSystem* job_system = nullptr;
         int parallel_min_rows = 8;
         int parallel_min_pixels = 128 * 128;
+        // true үед program.fs_lanes байвал fragment-уудыг simd::k_lanes пикселээр зэрэг
+        // (coverage/depth/interpolation/shading) тооцно. false (default) үед пиксел тус бүрийн fs.
+        bool simd_fragments = false;
+        // true үед RasterizerTarget::hiz-ийн 8x8 block-ийн max depth-ээс цааш байгаа
+        // гурвалжин/block-ийг пиксел бүрийн ажилгүйгээр алгасна.
+        bool hierarchical_z = false;
     };
 
     struct RasterizerTarget
     {
         RT_ColorHDR* hdr = nullptr;
         RT_ColorDepthMotion* depth_motion = nullptr;
+        // depth_motion->depth-ийн hierarchical-Z. Эзэмшигч нь pass эхлэхэд rebuild() хийнэ.
+        RasterHiZ* hiz = nullptr;
     };
 
     struct RasterizerStats
@@ -50,6 +65,35 @@ namespace shs
         uint64_t tri_input = 0;
         uint64_t tri_after_clip = 0;
         uint64_t tri_raster = 0;
+        // Vertex shader-ийн дуудлагын тоо (post-transform cache-ийн дараа).
+        uint64_t vs_invocations = 0;
+        // Hi-Z-ээр бүхэлдээ алгасагдсан гурвалжин (tile горимд гурвалжин x tile) ба 8x8 block.
+        uint64_t hiz_tris_rejected = 0;
+        uint64_t hiz_blocks_rejected = 0;
+        // Depth test давсан fragment ба fragment shader-ийн дуудлага (lane бүрийг нэг гэж тоолно).
+        // Forward горимд хоёр нь тэнцүү; visibility-buffer горимд fs_invocations нь харагдах
+        // пикселийн тоо болж, fragments_passed / fs_invocations нь shading overdraw-г илэрхийлнэ.
+        uint64_t fragments_passed = 0;
+        uint64_t fs_invocations = 0;
+    };
+
+    // Draw-ийн post-transform vertex cache (SoA). Орой бүрийн VS нэг л удаа ажиллаж,
+    // гурвалжин угсрах шат индексээр эндээс уншина. Varying нь slot бүрээр тусдаа
+    // массивтай бөгөөд зөвхөн slot_mask-д орсон slot-д санах ой хуваарилагдана.
+    // Draw бүр count/slot_mask-ийг дахин тохируулж, vector-уудын capacity хадгалагдана: pass
+    // (эсвэл дуудагч) нэгийг эзэмшиж draw бүрд дамжуулбал steady state-д heap allocation гарахгүй.
+    struct RasterVertexCache
+    {
+        std::vector<glm::vec4> clip{};
+        std::vector<glm::vec3> world_pos{};
+        std::vector<glm::vec3> normal_ws{};
+        std::vector<glm::vec2> uv{};
+        std::vector<uint32_t> varying_mask{};
+        std::array<std::vector<glm::vec4>, SHS_MAX_VARYINGS> varyings{};
+        // Motion бичих draw-д л бөглөгдөнө (x, y, w).
+        std::vector<glm::vec3> prev_clip{};
+        uint32_t slot_mask = 0u;
+        size_t count = 0;
     };
 
     namespace detail
@@ -64,6 +108,8 @@ namespace shs
             glm::vec3 world_pos{0.0f};
             glm::vec3 normal_ws{0.0f, 1.0f, 0.0f};
             glm::vec2 uv{0.0f};
+            // Өмнөх кадрын clip байрлал (x, y, w). Motion бичихгүй draw-д 0 хэвээр.
+            glm::vec3 prev_clip{0.0f};
         };
 
         inline RasterVertex lerp_rv(const RasterVertex& a, const RasterVertex& b, float t)
@@ -75,92 +121,113 @@ namespace shs
             o.world_pos = glm::mix(a.world_pos, b.world_pos, t);
             o.normal_ws = glm::normalize(glm::mix(a.normal_ws, b.normal_ws, t));
             o.uv = glm::mix(a.uv, b.uv, t);
+            o.prev_clip = glm::mix(a.prev_clip, b.prev_clip, t);
             return o;
         }
 
-        inline float plane_dist_left(const RasterVertex& v)
-        {
-            return v.clip.x + v.clip.w;
-        }
+        // Clip-ийн дараа fan-аар гурвалжлах олон өнцөгтийн дээд хэмжээ: гурвалжин + clip
+        // хийх хавтгай бүрд нэг орой (near/far + guard-band-ийн 4).
+        inline constexpr uint32_t k_clip_polygon_max_vertices = 3u + 6u;
 
-        inline float plane_dist_right(const RasterVertex& v)
+        // Heap-гүй, тогтмол багтаамжтай clip олон өнцөгт (setup-ийн stack дээр амьдарна).
+        struct ClipPolygon
         {
-            return v.clip.w - v.clip.x;
-        }
-
-        inline float plane_dist_bottom(const RasterVertex& v)
-        {
-            return v.clip.y + v.clip.w;
-        }
+            std::array<RasterVertex, k_clip_polygon_max_vertices> v{};
+            uint32_t count = 0;
+        };
 
-        inline float plane_dist_top(const RasterVertex& v)
+        // Оройн clip outcode. Frustum-ын bit-үүд trivial reject-д, near/far болон guard-band-ийн
+        // bit-үүд clip хийх хавтгайг сонгоход хэрэглэгдэнэ.
+        enum : uint32_t
         {
-            return v.clip.w - v.clip.y;
-        }
+            ClipOutLeft = 1u << 0,
+            ClipOutRight = 1u << 1,
+            ClipOutBottom = 1u << 2,
+            ClipOutTop = 1u << 3,
+            ClipOutNear = 1u << 4,
+            ClipOutFar = 1u << 5,
+            ClipOutGuardLeft = 1u << 6,
+            ClipOutGuardRight = 1u << 7,
+            ClipOutGuardBottom = 1u << 8,
+            ClipOutGuardTop = 1u << 9,
+            ClipOutFrustum = ClipOutLeft | ClipOutRight | ClipOutBottom | ClipOutTop | ClipOutNear | ClipOutFar,
+            ClipOutClipPlanes = ClipOutNear | ClipOutFar | ClipOutGuardLeft | ClipOutGuardRight | ClipOutGuardBottom | ClipOutGuardTop
+        };
 
-        inline float plane_dist_near(const RasterVertex& v)
+        // Guard-band-ийн NDC хагас өргөн (|x| <= g.x * w). x/y-г scissor (bbox clamp) хариуцах
+        // тул зөвхөн дэлгэцийн координат fixed-point edge setup-ийн хязгаараас хэтрэх үед clip хийнэ.
+        inline glm::vec2 clip_guard_band_ndc(int W, int H)
         {
-            return v.clip.z + v.clip.w;
+            const float band = 0.5f * k_raster_fixed_guard_band;
+            return glm::vec2{
+                std::max(1.0f, 2.0f * band / (float)std::max(1, W - 1) - 1.0f),
+                std::max(1.0f, 2.0f * band / (float)std::max(1, H - 1) - 1.0f)
+            };
         }
 
-        inline float plane_dist_far(const RasterVertex& v)
+        inline uint32_t clip_outcode(const glm::vec4& c, const glm::vec2& guard)
         {
-            return v.clip.w - v.clip.z;
+            uint32_t code = 0u;
+            if (c.x < -c.w) code |= ClipOutLeft;
+            if (c.x > c.w) code |= ClipOutRight;
+            if (c.y < -c.w) code |= ClipOutBottom;
+            if (c.y > c.w) code |= ClipOutTop;
+            if (c.z < -c.w) code |= ClipOutNear;
+            if (c.z > c.w) code |= ClipOutFar;
+            if (c.x < -guard.x * c.w) code |= ClipOutGuardLeft;
+            if (c.x > guard.x * c.w) code |= ClipOutGuardRight;
+            if (c.y < -guard.y * c.w) code |= ClipOutGuardBottom;
+            if (c.y > guard.y * c.w) code |= ClipOutGuardTop;
+            // NaN/inf координаттай оройг clip-ээр дамжуулж хаялгана (бүх харьцуулалт false).
+            if (!std::isfinite(c.w)) code |= ClipOutClipPlanes;
+            return code;
         }
 
         template <typename PlaneDistFn>
-        inline std::vector<RasterVertex> clip_polygon_plane(const std::vector<RasterVertex>& in_poly, PlaneDistFn plane_dist_fn)
+        inline void clip_polygon_plane(const ClipPolygon& in_poly, ClipPolygon& out, PlaneDistFn plane_dist_fn)
         {
-            std::vector<RasterVertex> out{};
-            if (in_poly.empty()) return out;
+            out.count = 0;
+            if (in_poly.count == 0) return;
 
-            out.reserve(in_poly.size() + 2);
-            for (size_t i = 0; i < in_poly.size(); ++i)
+            float da = plane_dist_fn(in_poly.v[0]);
+            for (uint32_t i = 0; i < in_poly.count; ++i)
             {
-                const RasterVertex& cur = in_poly[i];
-                const RasterVertex& nxt = in_poly[(i + 1) % in_poly.size()];
-                const float da = plane_dist_fn(cur);
+                const RasterVertex& cur = in_poly.v[i];
+                const RasterVertex& nxt = in_poly.v[(i + 1) % in_poly.count];
                 const float db = plane_dist_fn(nxt);
                 const bool cur_in = da >= 0.0f;
                 const bool nxt_in = db >= 0.0f;
 
-                if (cur_in && nxt_in)
-                {
-                    out.push_back(nxt);
-                }
-                else if (cur_in && !nxt_in)
+                // Хавтгай бүр олон өнцөгтийг хамгийн ихдээ нэг оройгоор л нэмэгдүүлэх тул
+                // багтаамж хэтрэхгүй; зөвхөн NaN-тай оройн үед хамгаална.
+                if (cur_in != nxt_in && out.count < k_clip_polygon_max_vertices)
                 {
                     const float denom = da - db;
-                    if (std::abs(denom) > 1e-8f)
-                    {
-                        const float t = da / denom;
-                        out.push_back(lerp_rv(cur, nxt, t));
-                    }
-                }
-                else if (!cur_in && nxt_in)
-                {
-                    const float denom = da - db;
-                    if (std::abs(denom) > 1e-8f)
-                    {
-                        const float t = da / denom;
-                        out.push_back(lerp_rv(cur, nxt, t));
-                    }
-                    out.push_back(nxt);
+                    if (std::abs(denom) > 1e-8f) out.v[out.count++] = lerp_rv(cur, nxt, da / denom);
                 }
+                if (nxt_in && out.count < k_clip_polygon_max_vertices) out.v[out.count++] = nxt;
+                da = db;
             }
-            return out;
         }
 
-        inline std::vector<RasterVertex> clip_polygon_frustum(const std::vector<RasterVertex>& in_poly)
+        // planes (ClipOut* bit-үүд)-д заасан хавтгайнуудаар poly-г clip хийнэ. scratch-тай
+        // ээлжилж ажиллах тул үр дүн аль нэгэнд нь үлдэх ба түүнийг буцаана.
+        inline const ClipPolygon& clip_polygon_guard_band(ClipPolygon& poly, ClipPolygon& scratch, uint32_t planes, const glm::vec2& guard)
         {
-            std::vector<RasterVertex> poly = in_poly;
-            poly = clip_polygon_plane(poly, plane_dist_left);
-            poly = clip_polygon_plane(poly, plane_dist_right);
-            poly = clip_polygon_plane(poly, plane_dist_bottom);
-            poly = clip_polygon_plane(poly, plane_dist_top);
-            poly = clip_polygon_plane(poly, plane_dist_near);
-            poly = clip_polygon_plane(poly, plane_dist_far);
-            return poly;
+            ClipPolygon* src = &poly;
+            ClipPolygon* dst = &scratch;
+            auto clip = [&](uint32_t bit, auto plane_dist_fn) {
+                if ((planes & bit) == 0u || src->count < 3) return;
+                clip_polygon_plane(*src, *dst, plane_dist_fn);
+                std::swap(src, dst);
+            };
+            clip(ClipOutNear, [](const RasterVertex& v) { return v.clip.z + v.clip.w; });
+            clip(ClipOutFar, [](const RasterVertex& v) { return v.clip.w - v.clip.z; });
+            clip(ClipOutGuardLeft, [&](const RasterVertex& v) { return v.clip.x + guard.x * v.clip.w; });
+            clip(ClipOutGuardRight, [&](const RasterVertex& v) { return guard.x * v.clip.w - v.clip.x; });
+            clip(ClipOutGuardBottom, [&](const RasterVertex& v) { return v.clip.y + guard.y * v.clip.w; });
+            clip(ClipOutGuardTop, [&](const RasterVertex& v) { return guard.y * v.clip.w - v.clip.y; });
+            return *src;
         }
     }
 
@@ -178,266 +245,1014 @@ namespace shs
         return glm::vec3(u, v, w);
     }
 
-    inline RasterizerStats rasterize_mesh(
-        const MeshData& mesh,
-        const ShaderProgram& program,
-        const ShaderUniforms& uniforms,
-        RasterizerTarget target,
-        const RasterizerConfig& config = {}
-    )
+    namespace detail
     {
-        RasterizerStats stats{};
-        if (!target.hdr || !program.valid()) return stats;
-        if (mesh.positions.empty()) return stats;
-        const int W = target.hdr->w;
-        const int H = target.hdr->h;
-        if (W <= 0 || H <= 0) return stats;
+        // Clip/cull хийгдсэний дараах, raster шатанд бэлэн screen-space гурвалжин.
+        // Атрибутууд 1/w-ээр үржигдсэн (perspective-correct interpolation-д бэлэн).
+        // Идэвхтэй varying-ууд тусдаа буферт слот бүрд v0, v1, v2 дарааллаар шахагдана.
+        struct RasterTriangle
+        {
+            glm::vec2 s0{0.0f};
+            glm::vec2 s1{0.0f};
+            glm::vec2 s2{0.0f};
+            float invw0 = 0.0f;
+            float invw1 = 0.0f;
+            float invw2 = 0.0f;
+            float zw0 = 0.0f;
+            float zw1 = 0.0f;
+            float zw2 = 0.0f;
+            glm::vec3 wpw0{0.0f};
+            glm::vec3 wpw1{0.0f};
+            glm::vec3 wpw2{0.0f};
+            glm::vec3 npw0{0.0f};
+            glm::vec3 npw1{0.0f};
+            glm::vec3 npw2{0.0f};
+            glm::vec2 uvw0{0.0f};
+            glm::vec2 uvw1{0.0f};
+            glm::vec2 uvw2{0.0f};
+            // prev_clip * invw: пиксел бүрд perspective-correct интерполяц хийж motion гаргана.
+            glm::vec3 pcw0{0.0f};
+            glm::vec3 pcw1{0.0f};
+            glm::vec3 pcw2{0.0f};
+            // uv*invw ба invw-ийн пикселээрх өөрчлөлт (дэлгэцэн дээр шугаман). Пиксел бүрд
+            // duv/dx = (duvw_dx - uv * dinvw_dx) / invw болж texture LOD-д хэрэглэгдэнэ.
+            glm::vec2 duvw_dx{0.0f};
+            glm::vec2 duvw_dy{0.0f};
+            float dinvw_dx = 0.0f;
+            float dinvw_dy = 0.0f;
+            uint32_t varying_mask = 0u;
+            RasterEdgeSetup edges{};
+            int minx = 0;
+            int maxx = -1;
+            int miny = 0;
+            int maxy = -1;
+        };
+
+        // Motion vector-ийн пикселээр хэмжсэн дээд урт.
+        inline constexpr float k_raster_max_motion_px = 96.0f;
+
+        // Пикселийн төвийг (x + 0.5) NDC рүү буулгах алхам: ndc = (x + 0.5) * scale - 1.
+        // setup-ийн s = (ndc * 0.5 + 0.5) * (W - 1) буулгалтын урвуу.
+        inline glm::vec2 motion_ndc_scale(int W, int H)
+        {
+            return glm::vec2{2.0f / (float)std::max(1, W - 1), 2.0f / (float)std::max(1, H - 1)};
+        }
 
-        auto read_v = [&](uint32_t idx) -> ShaderVertex {
+        // Нэг гурвалжны шахсан varying-ийн дээд тоо.
+        inline constexpr uint32_t k_packed_varyings_max = SHS_MAX_VARYINGS * 3u;
+
+        // Draw бүрд нэг удаа тооцогдох fragment шатны төлөв. Program нь shade_* функцүүдэд
+        // төрлөөрөө (template) тусад нь дамжина.
+        struct RasterDrawState
+        {
+            const ShaderUniforms* uniforms = nullptr;
+            // nullptr биш бол SIMD fragment зам (shade_triangle_rect_lanes) ашиглагдана.
+            FragmentLanesShaderFn fs_lanes = nullptr;
+            // nullptr биш бол block бүрийг Hi-Z-ээр шалгана.
+            RasterHiZ* hiz = nullptr;
+            bool write_motion = false;
+            // Одоогийн world байрлалаас өмнөх кадрын clip рүү. Орой бүрд нэг удаа хэрэглэгдэнэ.
+            glm::mat4 prev_clip_from_world{1.0f};
+        };
+
+        template<StaticShaderProgram Program>
+        inline RasterDrawState make_raster_draw_state(
+            const Program& program,
+            const ShaderUniforms& uniforms,
+            const RasterizerTarget& target,
+            const RasterizerConfig& config)
+        {
+            RasterDrawState ds{};
+            ds.uniforms = &uniforms;
+            ds.fs_lanes = config.simd_fragments ? program_fs_lanes(program) : nullptr;
+            if (config.hierarchical_z && target.hiz && target.depth_motion && target.hiz->matches(target.depth_motion->depth))
+            {
+                ds.hiz = target.hiz;
+            }
+            ds.write_motion = program_may_write_motion<Program> && (target.depth_motion != nullptr) && uniforms.enable_motion_vectors;
+            if (ds.write_motion)
+            {
+                // Static объектод зөвхөн камерын шилжилт үлдэх тул model-ийн inverse хэрэггүй.
+                ds.prev_clip_from_world = uniforms.prev_viewproj;
+                if (!uniforms.motion_static)
+                {
+                    const float det_model = glm::determinant(uniforms.model);
+                    if (std::abs(det_model) > 1e-10f)
+                    {
+                        ds.prev_clip_from_world = uniforms.prev_viewproj * uniforms.prev_model * glm::inverse(uniforms.model);
+                    }
+                }
+            }
+            return ds;
+        }
+
+        // Visibility-buffer горимын пикселийн шүүлт. ids нь W x H, 0 = хоосон пиксел.
+        struct RasterVisibility
+        {
+            PixelBuffer2D<uint32_t>* ids = nullptr;
+            uint32_t id = 0;
+            // false: depth test + depth/id бичилт л хийнэ (fs, motion ажиллахгүй).
+            // true: ids == id пикселүүдийг depth test-гүйгээр яг нэг удаа shade хийнэ.
+            bool resolve = false;
+        };
+
+        inline size_t mesh_triangle_count(const MeshData& mesh)
+        {
+            return mesh.indices.empty() ? (mesh.positions.size() / 3) : (mesh.indices.size() / 3);
+        }
+
+        inline ShaderVertex read_shader_vertex(const MeshData& mesh, size_t idx)
+        {
             ShaderVertex v{};
-            v.position = mesh.positions[(size_t)idx];
-            if (idx < mesh.normals.size()) v.normal = mesh.normals[(size_t)idx];
-            if (idx < mesh.uvs.size()) v.uv = mesh.uvs[(size_t)idx];
+            v.position = mesh.positions[idx];
+            if (idx < mesh.normals.size()) v.normal = mesh.normals[idx];
+            if (idx < mesh.uvs.size()) v.uv = mesh.uvs[idx];
             return v;
-        };
+        }
+
+        // Нэг job-д оногдох хамгийн бага оройн тоо.
+        inline constexpr int k_vertex_shade_grain = 1024;
 
-        const bool indexed = !mesh.indices.empty();
-        const size_t tri_count = indexed ? (mesh.indices.size() / 3) : (mesh.positions.size() / 3);
-        for (size_t ti = 0; ti < tri_count; ++ti)
+        inline void store_cached_vertex(RasterVertexCache& cache, size_t i, const VertexOut& o, const glm::mat4* prev_clip_from_world)
         {
-            stats.tri_input++;
-            uint32_t i0 = 0, i1 = 0, i2 = 0;
-            if (indexed)
+            cache.clip[i] = o.clip;
+            cache.world_pos[i] = o.world_pos;
+            cache.normal_ws[i] = o.normal_ws;
+            cache.uv[i] = o.uv;
+            const uint32_t mask = o.varying_mask & cache.slot_mask;
+            cache.varying_mask[i] = mask;
+            for (uint32_t s = 0; s < SHS_MAX_VARYINGS; ++s)
             {
-                i0 = mesh.indices[ti * 3 + 0];
-                i1 = mesh.indices[ti * 3 + 1];
-                i2 = mesh.indices[ti * 3 + 2];
+                if ((mask & varying_bit(s)) != 0u) cache.varyings[s][i] = o.varyings[s];
             }
-            else
+            if (prev_clip_from_world)
             {
-                i0 = (uint32_t)(ti * 3 + 0);
-                i1 = (uint32_t)(ti * 3 + 1);
-                i2 = (uint32_t)(ti * 3 + 2);
+                // Fragment шат WorldPos varying-ийг world_pos-оос илүүд үздэгтэй адил.
+                const uint32_t wp_bit = varying_bit((uint32_t)VaryingSemantic::WorldPos);
+                const glm::vec3 wp = ((o.varying_mask & wp_bit) != 0u) ? glm::vec3(o.varyings[(uint32_t)VaryingSemantic::WorldPos]) : o.world_pos;
+                const glm::vec4 pc = *prev_clip_from_world * glm::vec4(wp, 1.0f);
+                cache.prev_clip[i] = glm::vec3(pc.x, pc.y, pc.w);
             }
-            if (i0 >= mesh.positions.size() || i1 >= mesh.positions.size() || i2 >= mesh.positions.size()) continue;
+        }
 
-            const VertexOut v0 = program.vs(read_v(i0), uniforms);
-            const VertexOut v1 = program.vs(read_v(i1), uniforms);
-            const VertexOut v2 = program.vs(read_v(i2), uniforms);
+        // mesh-ийн бүх оройг нэг удаа VS-ээр дамжуулж cache-д бичнэ. VS-ийн дуудлагын тоог буцаана.
+        // Varying slot-уудыг эхний оройгоор тааварлаж, өөр slot бичсэн орой гарвал slot-ийг нэмээд
+        // бүгдийг дахин shade хийнэ (VS бүх оройд ижил varying бичдэг ердийн тохиолдолд нэг л удаа).
+        // prev_clip_from_world өгөгдвөл (RasterDrawState::write_motion) оройн өмнөх clip-ийг мөн бичнэ.
+        template<StaticShaderProgram Program>
+        inline uint64_t shade_mesh_vertices(
+            const MeshData& mesh,
+            const Program& program,
+            const ShaderUniforms& uniforms,
+            RasterVertexCache& cache,
+            const glm::mat4* prev_clip_from_world,
+            IJobSystem* js,
+            JobPriority priority = JobPriority::FrameCritical)
+        {
+            const size_t n = mesh.positions.size();
+            cache.count = n;
+            cache.slot_mask = 0u;
+            if (n == 0) return 0;
+            cache.clip.resize(n);
+            cache.world_pos.resize(n);
+            cache.normal_ws.resize(n);
+            cache.uv.resize(n);
+            cache.varying_mask.resize(n);
+            if (prev_clip_from_world) cache.prev_clip.resize(n);
+            else cache.prev_clip.clear();
 
-            const detail::RasterVertex rv0{v0.clip, v0.varyings, v0.varying_mask, v0.world_pos, v0.normal_ws, v0.uv};
-            const detail::RasterVertex rv1{v1.clip, v1.varyings, v1.varying_mask, v1.world_pos, v1.normal_ws, v1.uv};
-            const detail::RasterVertex rv2{v2.clip, v2.varyings, v2.varying_mask, v2.world_pos, v2.normal_ws, v2.uv};
+            const VertexOut probe = program.vs(read_shader_vertex(mesh, 0), uniforms);
+            uint64_t invocations = 1;
+            uint32_t slots = probe.varying_mask;
+            int first = 1;
+            while (true)
+            {
+                cache.slot_mask = slots;
+                for (uint32_t s = 0; s < SHS_MAX_VARYINGS; ++s)
+                {
+                    if ((slots & varying_bit(s)) != 0u) cache.varyings[s].resize(n);
+                    else cache.varyings[s].clear();
+                }
+                if (first == 1) store_cached_vertex(cache, 0, probe, prev_clip_from_world);
 
-            const auto fully_inside_clip = [](const detail::RasterVertex& rv) -> bool
+                std::atomic<uint32_t> seen{slots};
+                parallel_for_1d(js, first, (int)n, k_vertex_shade_grain, priority, [&](int b, int e) {
+                    uint32_t local = 0u;
+                    for (int i = b; i < e; ++i)
+                    {
+                        const VertexOut o = program.vs(read_shader_vertex(mesh, (size_t)i), uniforms);
+                        local |= o.varying_mask;
+                        store_cached_vertex(cache, (size_t)i, o, prev_clip_from_world);
+                    }
+                    seen.fetch_or(local, std::memory_order_relaxed);
+                });
+                invocations += (uint64_t)(n - (size_t)first);
+
+                const uint32_t all = seen.load(std::memory_order_relaxed);
+                if ((all & ~slots) == 0u) break;
+                slots |= all;
+                first = 0;
+            }
+            return invocations;
+        }
+
+        inline RasterVertex cached_raster_vertex(const RasterVertexCache& cache, uint32_t idx)
+        {
+            const size_t i = (size_t)idx;
+            RasterVertex rv{};
+            rv.clip = cache.clip[i];
+            rv.varying_mask = cache.varying_mask[i];
+            for (uint32_t s = 0; s < SHS_MAX_VARYINGS; ++s)
             {
-                const glm::vec4 c = rv.clip;
-                if (!(c.w > 0.0f)) return false;
-                return
-                    (c.x >= -c.w && c.x <= c.w) &&
-                    (c.y >= -c.w && c.y <= c.w) &&
-                    (c.z >= -c.w && c.z <= c.w);
-            };
+                if ((rv.varying_mask & varying_bit(s)) != 0u) rv.varyings[s] = cache.varyings[s][i];
+            }
+            rv.world_pos = cache.world_pos[i];
+            rv.normal_ws = cache.normal_ws[i];
+            rv.uv = cache.uv[i];
+            if (!cache.prev_clip.empty()) rv.prev_clip = cache.prev_clip[i];
+            return rv;
+        }
+
+        // [tri_begin, tri_end) мужийн гурвалжнуудыг vertex cache -> clip -> cull -> bbox шатаар
+        // дамжуулж, raster хийх гурвалжин бүрийг emit(tri, packed_varyings, packed_count)-аар гаргана.
+        template<typename Emit>
+        inline void setup_mesh_triangles(
+            const MeshData& mesh,
+            const RasterVertexCache& vertices,
+            int W,
+            int H,
+            const RasterizerConfig& config,
+            size_t tri_begin,
+            size_t tri_end,
+            RasterizerStats& stats,
+            Emit&& emit)
+        {
+            const bool indexed = !mesh.indices.empty();
+            const glm::vec2 guard = clip_guard_band_ndc(W, H);
+            std::array<glm::vec4, k_packed_varyings_max> packed{};
+            ClipPolygon poly{};
+            ClipPolygon scratch{};
+            for (size_t ti = tri_begin; ti < tri_end; ++ti)
+            {
+                stats.tri_input++;
+                uint32_t i0 = 0, i1 = 0, i2 = 0;
+                if (indexed)
+                {
+                    i0 = mesh.indices[ti * 3 + 0];
+                    i1 = mesh.indices[ti * 3 + 1];
+                    i2 = mesh.indices[ti * 3 + 2];
+                }
+                else
+                {
+                    i0 = (uint32_t)(ti * 3 + 0);
+                    i1 = (uint32_t)(ti * 3 + 1);
+                    i2 = (uint32_t)(ti * 3 + 2);
+                }
+                if (i0 >= vertices.count || i1 >= vertices.count || i2 >= vertices.count) continue;
+
+                // Бүх орой frustum-ын нэг хавтгайн гадна бол оройг хуулахаас өмнө хаяна.
+                const uint32_t oc0 = clip_outcode(vertices.clip[i0], guard);
+                const uint32_t oc1 = clip_outcode(vertices.clip[i1], guard);
+                const uint32_t oc2 = clip_outcode(vertices.clip[i2], guard);
+                if ((oc0 & oc1 & oc2 & ClipOutFrustum) != 0u) continue;
+
+                poly.v[0] = cached_raster_vertex(vertices, i0);
+                poly.v[1] = cached_raster_vertex(vertices, i1);
+                poly.v[2] = cached_raster_vertex(vertices, i2);
+                poly.count = 3;
+                // Дэлгэцийн хажуугаар гарсан гурвалжинг scissor тайрна; clip нь зөвхөн near/far
+                // эсвэл guard-band давсан (ховор) үед, зөвхөн зөрчигдсөн хавтгайгаар хийгдэнэ.
+                const uint32_t planes = (oc0 | oc1 | oc2) & ClipOutClipPlanes;
+                const ClipPolygon& clipped = (planes != 0u) ? clip_polygon_guard_band(poly, scratch, planes, guard) : poly;
+                if (clipped.count < 3) continue;
+
+                // Клип хийсний дараах олон өнцөгтийг fan аргаар гурвалжилна.
+                for (uint32_t k = 1; k + 1 < clipped.count; ++k)
+                {
+                    stats.tri_after_clip++;
+                    const RasterVertex& rv0 = clipped.v[0];
+                    const RasterVertex& rv1 = clipped.v[k];
+                    const RasterVertex& rv2 = clipped.v[k + 1];
+
+                    const glm::vec3 n0 = glm::vec3(rv0.clip) / rv0.clip.w;
+                    const glm::vec3 n1 = glm::vec3(rv1.clip) / rv1.clip.w;
+                    const glm::vec3 n2 = glm::vec3(rv2.clip) / rv2.clip.w;
+                    if (!std::isfinite(n0.x) || !std::isfinite(n0.y) || !std::isfinite(n0.z)) continue;
+                    if (!std::isfinite(n1.x) || !std::isfinite(n1.y) || !std::isfinite(n1.z)) continue;
+                    if (!std::isfinite(n2.x) || !std::isfinite(n2.y) || !std::isfinite(n2.z)) continue;
+
+                    RasterTriangle t{};
+                    t.s0 = glm::vec2{(n0.x * 0.5f + 0.5f) * (float)(W - 1), (n0.y * 0.5f + 0.5f) * (float)(H - 1)};
+                    t.s1 = glm::vec2{(n1.x * 0.5f + 0.5f) * (float)(W - 1), (n1.y * 0.5f + 0.5f) * (float)(H - 1)};
+                    t.s2 = glm::vec2{(n2.x * 0.5f + 0.5f) * (float)(W - 1), (n2.y * 0.5f + 0.5f) * (float)(H - 1)};
+
+                    const glm::vec2 e0 = t.s1 - t.s0;
+                    const glm::vec2 e1 = t.s2 - t.s0;
+                    const float signed_area2 = e0.x * e1.y - e0.y * e1.x;
+                    if (std::abs(signed_area2) < 1e-10f) continue;
+                    const bool tri_ccw = signed_area2 > 0.0f;
+                    const bool is_front = (tri_ccw == config.front_face_ccw);
+                    if (config.cull_mode == RasterizerCullMode::Back && !is_front) continue;
+                    if (config.cull_mode == RasterizerCullMode::Front && is_front) continue;
 
-            std::vector<detail::RasterVertex> poly = {
-                rv0, rv1, rv2
+                    t.minx = std::max(0, (int)std::floor(std::min({t.s0.x, t.s1.x, t.s2.x})));
+                    t.maxx = std::min(W - 1, (int)std::ceil(std::max({t.s0.x, t.s1.x, t.s2.x})));
+                    t.miny = std::max(0, (int)std::floor(std::min({t.s0.y, t.s1.y, t.s2.y})));
+                    t.maxy = std::min(H - 1, (int)std::ceil(std::max({t.s0.y, t.s1.y, t.s2.y})));
+                    if (t.minx > t.maxx || t.miny > t.maxy) continue;
+                    if (!setup_raster_edges(t.s0, t.s1, t.s2, t.edges)) continue;
+                    stats.tri_raster++;
+
+                    t.invw0 = 1.0f / rv0.clip.w;
+                    t.invw1 = 1.0f / rv1.clip.w;
+                    t.invw2 = 1.0f / rv2.clip.w;
+                    t.zw0 = rv0.clip.z * t.invw0;
+                    t.zw1 = rv1.clip.z * t.invw1;
+                    t.zw2 = rv2.clip.z * t.invw2;
+                    t.varying_mask = rv0.varying_mask | rv1.varying_mask | rv2.varying_mask;
+                    t.wpw0 = rv0.world_pos * t.invw0;
+                    t.wpw1 = rv1.world_pos * t.invw1;
+                    t.wpw2 = rv2.world_pos * t.invw2;
+                    t.npw0 = rv0.normal_ws * t.invw0;
+                    t.npw1 = rv1.normal_ws * t.invw1;
+                    t.npw2 = rv2.normal_ws * t.invw2;
+                    t.uvw0 = rv0.uv * t.invw0;
+                    t.uvw1 = rv1.uv * t.invw1;
+                    t.uvw2 = rv2.uv * t.invw2;
+                    t.pcw0 = rv0.prev_clip * t.invw0;
+                    t.pcw1 = rv1.prev_clip * t.invw1;
+                    t.pcw2 = rv2.prev_clip * t.invw2;
+                    {
+                        // Fragment шаттай адил UV0 varying байвал түүнийг uv гэж үзнэ.
+                        const uint32_t uv_slot = (uint32_t)VaryingSemantic::UV0;
+                        const bool uv_varying = (t.varying_mask & varying_bit(uv_slot)) != 0u;
+                        const glm::vec2 uvw[3] = {
+                            (uv_varying ? glm::vec2(rv0.varyings[uv_slot]) : rv0.uv) * t.invw0,
+                            (uv_varying ? glm::vec2(rv1.varyings[uv_slot]) : rv1.uv) * t.invw1,
+                            (uv_varying ? glm::vec2(rv2.varyings[uv_slot]) : rv2.uv) * t.invw2};
+                        const float invw[3] = {t.invw0, t.invw1, t.invw2};
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            const glm::vec2 g = raster_edge_bary_step(t.edges, i);
+                            t.duvw_dx += uvw[i] * g.x;
+                            t.duvw_dy += uvw[i] * g.y;
+                            t.dinvw_dx += invw[i] * g.x;
+                            t.dinvw_dy += invw[i] * g.y;
+                        }
+                    }
+
+                    uint32_t packed_count = 0;
+                    for (uint32_t i = 0; i < SHS_MAX_VARYINGS; ++i)
+                    {
+                        if ((t.varying_mask & varying_bit(i)) == 0u) continue;
+                        packed[packed_count++] = rv0.varyings[i] * t.invw0;
+                        packed[packed_count++] = rv1.varyings[i] * t.invw1;
+                        packed[packed_count++] = rv2.varyings[i] * t.invw2;
+                    }
+                    emit(t, packed.data(), packed_count);
+                }
+            }
+        }
+
+        // shade_triangle_rect-ийн SIMD хувилбар: span бүрийг simd::k_lanes пикселээр нь
+        // coverage mask, depth test, perspective-correct interpolation, motion, ds.fs_lanes
+        // дамжуулна. Scalar замтай ижил дүрэм (depth-ийг fs-ээс өмнө бичих гэх мэт) баримтална.
+        // Depth бичсэн эсэхийг буцаана.
+        inline bool shade_triangle_rect_lanes(
+            const RasterTriangle& t,
+            const glm::vec4* varw,
+            const RasterDrawState& ds,
+            const RasterizerTarget& target,
+            int W,
+            int H,
+            int minx,
+            int maxx,
+            int miny,
+            int maxy,
+            RasterizerStats* stats,
+            const RasterVisibility* vis)
+        {
+            using simd::f32;
+            constexpr int L = simd::k_lanes;
+            const ShaderUniforms& uniforms = *ds.uniforms;
+            const uint32_t varying_mask = t.varying_mask;
+
+            // Semantic varying байвал fs замтай адил түүнийг, үгүй бол world/normal/uv-г авна.
+            auto packed_slot = [&](VaryingSemantic sem) -> const glm::vec4* {
+                const uint32_t slot = (uint32_t)sem;
+                if ((varying_mask & varying_bit(slot)) == 0u) return nullptr;
+                uint32_t packed_index = 0;
+                for (uint32_t i = 0; i < slot; ++i)
+                {
+                    if ((varying_mask & varying_bit(i)) != 0u) packed_index += 3;
+                }
+                return varw + packed_index;
             };
-            // Ихэнх кадарт харагдаж буй трианглууд clip volume дотор байдаг тул clip-ийг алгасна.
-            if (!(fully_inside_clip(rv0) && fully_inside_clip(rv1) && fully_inside_clip(rv2)))
+            glm::vec3 wp[3] = {t.wpw0, t.wpw1, t.wpw2};
+            glm::vec3 np[3] = {t.npw0, t.npw1, t.npw2};
+            glm::vec2 uvp[3] = {t.uvw0, t.uvw1, t.uvw2};
+            if (const glm::vec4* v = packed_slot(VaryingSemantic::WorldPos))
             {
-                poly = detail::clip_polygon_frustum(poly);
+                for (int i = 0; i < 3; ++i) wp[i] = glm::vec3(v[i]);
+            }
+            if (const glm::vec4* v = packed_slot(VaryingSemantic::NormalWS))
+            {
+                for (int i = 0; i < 3; ++i) np[i] = glm::vec3(v[i]);
+            }
+            if (const glm::vec4* v = packed_slot(VaryingSemantic::UV0))
+            {
+                for (int i = 0; i < 3; ++i) uvp[i] = glm::vec2(v[i]);
             }
-            if (poly.size() < 3) continue;
 
-            // Клип хийсний дараах олон өнцөгтийг fan аргаар гурвалжилна.
-            for (size_t k = 1; k + 1 < poly.size(); ++k)
+            const bool has_depth = target.depth_motion != nullptr;
+            const float zn = has_depth ? target.depth_motion->zn : 0.0f;
+            const float zf = has_depth ? target.depth_motion->zf : 1.0f;
+            const bool linear_depth = has_depth && zf > zn + 1e-6f;
+            const float inv_zrange = linear_depth ? 1.0f / (zf - zn) : 0.0f;
+            const glm::vec2 ndc_scale = motion_ndc_scale(W, H);
+            const glm::vec2 vel_scale{0.5f * (float)W, 0.5f * (float)H};
+            const f32 lane = simd::lane_index();
+
+            const bool write_ids = vis && !vis->resolve;
+            const bool resolve = vis && vis->resolve;
+            simd::LaneArray tmp0{}, tmp1{}, tmp2{}, tmp3{};
+            bool wrote_depth = false;
+            uint64_t passed = 0;
+            uint64_t invoked = 0;
+            rasterize_edge_spans(t.edges, minx, maxx, miny, maxy, [&](const RasterSpan& span)
             {
-                stats.tri_after_clip++;
-                const detail::RasterVertex rv0 = poly[0];
-                const detail::RasterVertex rv1 = poly[k];
-                const detail::RasterVertex rv2 = poly[k + 1];
-
-                const glm::vec3 n0 = glm::vec3(rv0.clip) / rv0.clip.w;
-                const glm::vec3 n1 = glm::vec3(rv1.clip) / rv1.clip.w;
-                const glm::vec3 n2 = glm::vec3(rv2.clip) / rv2.clip.w;
-                if (!std::isfinite(n0.x) || !std::isfinite(n0.y) || !std::isfinite(n0.z)) continue;
-                if (!std::isfinite(n1.x) || !std::isfinite(n1.y) || !std::isfinite(n1.z)) continue;
-                if (!std::isfinite(n2.x) || !std::isfinite(n2.y) || !std::isfinite(n2.z)) continue;
-
-                const glm::vec2 s0{(n0.x * 0.5f + 0.5f) * (float)(W - 1), (n0.y * 0.5f + 0.5f) * (float)(H - 1)};
-                const glm::vec2 s1{(n1.x * 0.5f + 0.5f) * (float)(W - 1), (n1.y * 0.5f + 0.5f) * (float)(H - 1)};
-                const glm::vec2 s2{(n2.x * 0.5f + 0.5f) * (float)(W - 1), (n2.y * 0.5f + 0.5f) * (float)(H - 1)};
-
-                const glm::vec2 e0 = s1 - s0;
-                const glm::vec2 e1 = s2 - s0;
-                const float signed_area2 = e0.x * e1.y - e0.y * e1.x;
-                if (std::abs(signed_area2) < 1e-10f) continue;
-                const bool tri_ccw = signed_area2 > 0.0f;
-                const bool is_front = (tri_ccw == config.front_face_ccw);
-                if (config.cull_mode == RasterizerCullMode::Back && !is_front) continue;
-                if (config.cull_mode == RasterizerCullMode::Front && is_front) continue;
-
-                const float minx_f = std::min({s0.x, s1.x, s2.x});
-                const float maxx_f = std::max({s0.x, s1.x, s2.x});
-                const float miny_f = std::min({s0.y, s1.y, s2.y});
-                const float maxy_f = std::max({s0.y, s1.y, s2.y});
-
-                const int minx = std::max(0, (int)std::floor(minx_f));
-                const int maxx = std::min(W - 1, (int)std::ceil(maxx_f));
-                const int miny = std::max(0, (int)std::floor(miny_f));
-                const int maxy = std::min(H - 1, (int)std::ceil(maxy_f));
-                if (minx > maxx || miny > maxy) continue;
-                stats.tri_raster++;
+                for (int k0 = 0; k0 < span.count; k0 += L)
+                {
+                    const int n = std::min(L, span.count - k0);
+                    uint32_t bits = (span.coverage >> k0) & ((n >= 32) ? ~0u : ((1u << n) - 1u));
+                    if (bits == 0u) continue;
+                    const int x = span.x + k0;
+                    const int y = span.y;
+                    const float curr_ndc_y = ((float)y + 0.5f) * ndc_scale.y - 1.0f;
+                    if (resolve)
+                    {
+                        const uint32_t* irow = &vis->ids->at(x, y);
+                        for (int i = 0; i < n; ++i)
+                        {
+                            if (irow[i] != vis->id) bits &= ~(1u << i);
+                        }
+                        if (bits == 0u) continue;
+                    }
+
+                    const f32 b1 = f32(span.b1 + (float)k0 * span.db1) + lane * f32(span.db1);
+                    const f32 b2 = f32(span.b2 + (float)k0 * span.db2) + lane * f32(span.db2);
+                    const f32 b0 = f32(1.0f) - b1 - b2;
+
+                    // 1/w interpolation: perspective-correct varying/position/uv тооцоо.
+                    f32 denom = b0 * f32(t.invw0) + b1 * f32(t.invw1) + b2 * f32(t.invw2);
+                    simd::mask m = simd::mask_from_bits(bits) & (denom > f32(1e-10f));
+                    bits = simd::mask_bits(m);
+                    if (bits == 0u) continue;
+                    denom = simd::select(m, denom, f32(1.0f));
+                    const f32 inv_denom = f32(1.0f) / denom;
+
+                    const f32 z_ndc = (b0 * f32(t.zw0) + b1 * f32(t.zw1) + b2 * f32(t.zw2)) * inv_denom;
+                    f32 z01 = simd::clamp(z_ndc * f32(0.5f) + f32(0.5f), 0.0f, 1.0f);
+                    if (has_depth && linear_depth)
+                    {
+                        z01 = simd::clamp((inv_denom - f32(zn)) * f32(inv_zrange), 0.0f, 1.0f);
+                    }
+                    if (has_depth && !resolve)
+                    {
+                        float* zrow = &target.depth_motion->depth.at(x, y);
+                        tmp0.fill(0.0f);
+                        std::copy(zrow, zrow + n, tmp0.begin());
+                        m = m & (z01 < simd::load(tmp0.data()));
+                        bits = simd::mask_bits(m);
+                        if (bits == 0u) continue;
+                        simd::store(tmp0.data(), z01);
+                        for (int i = 0; i < n; ++i)
+                        {
+                            if ((bits & (1u << i)) != 0u) zrow[i] = tmp0[(size_t)i];
+                        }
+                        wrote_depth = true;
+                    }
+                    if (write_ids)
+                    {
+                        uint32_t* irow = &vis->ids->at(x, y);
+                        for (int i = 0; i < n; ++i)
+                        {
+                            if ((bits & (1u << i)) != 0u) irow[i] = vis->id;
+                        }
+                        passed += (uint64_t)std::popcount(bits);
+                        continue;
+                    }
+                    passed += (uint64_t)std::popcount(bits);
+                    invoked += (uint64_t)std::popcount(bits);
+
+                    FragmentLanesIn fin{};
+                    fin.world_pos = (simd::Vec3Lanes(wp[0]) * b0 + simd::Vec3Lanes(wp[1]) * b1 + simd::Vec3Lanes(wp[2]) * b2) * inv_denom;
+                    fin.normal_ws = simd::normalize(simd::Vec3Lanes(np[0]) * b0 + simd::Vec3Lanes(np[1]) * b1 + simd::Vec3Lanes(np[2]) * b2);
+                    fin.uv.x = (f32(uvp[0].x) * b0 + f32(uvp[1].x) * b1 + f32(uvp[2].x) * b2) * inv_denom;
+                    fin.uv.y = (f32(uvp[0].y) * b0 + f32(uvp[1].y) * b1 + f32(uvp[2].y) * b2) * inv_denom;
+                    fin.duv_dx.x = (f32(t.duvw_dx.x) - fin.uv.x * f32(t.dinvw_dx)) * inv_denom;
+                    fin.duv_dx.y = (f32(t.duvw_dx.y) - fin.uv.y * f32(t.dinvw_dx)) * inv_denom;
+                    fin.duv_dy.x = (f32(t.duvw_dy.x) - fin.uv.x * f32(t.dinvw_dy)) * inv_denom;
+                    fin.duv_dy.y = (f32(t.duvw_dy.y) - fin.uv.y * f32(t.dinvw_dy)) * inv_denom;
+                    fin.depth01 = z01;
+                    fin.active = m;
+                    fin.px = x;
+                    fin.py = y;
+
+                    if (ds.write_motion)
+                    {
+                        const f32 pcx = (b0 * f32(t.pcw0.x) + b1 * f32(t.pcw1.x) + b2 * f32(t.pcw2.x)) * inv_denom;
+                        const f32 pcy = (b0 * f32(t.pcw0.y) + b1 * f32(t.pcw1.y) + b2 * f32(t.pcw2.y)) * inv_denom;
+                        const f32 pcw = (b0 * f32(t.pcw0.z) + b1 * f32(t.pcw1.z) + b2 * f32(t.pcw2.z)) * inv_denom;
+                        const simd::mask valid = simd::abs(pcw) > f32(1e-8f);
+                        const f32 inv_pw = f32(1.0f) / simd::select(valid, pcw, f32(1.0f));
+                        const f32 curr_x = (f32((float)x + 0.5f) + lane) * f32(ndc_scale.x) - f32(1.0f);
+                        f32 vx = (curr_x - pcx * inv_pw) * f32(vel_scale.x);
+                        f32 vy = (f32(curr_ndc_y) - pcy * inv_pw) * f32(vel_scale.y);
+                        const f32 len2 = vx * vx + vy * vy;
+                        const simd::mask over = len2 > f32(k_raster_max_motion_px * k_raster_max_motion_px);
+                        if (simd::mask_bits(over) != 0u)
+                        {
+                            const f32 scale = simd::select(over, f32(k_raster_max_motion_px) / simd::sqrt(simd::max(len2, f32(1e-12f))), f32(1.0f));
+                            vx = vx * scale;
+                            vy = vy * scale;
+                        }
+                        vx = simd::select(valid, vx, f32(0.0f));
+                        vy = simd::select(valid, vy, f32(0.0f));
+                        simd::store(tmp0.data(), vx);
+                        simd::store(tmp1.data(), vy);
+                        Motion2f* mrow = &target.depth_motion->motion.at(x, y);
+                        for (int i = 0; i < n; ++i)
+                        {
+                            if ((bits & (1u << i)) != 0u) mrow[i] = Motion2f{tmp0[(size_t)i], tmp1[(size_t)i]};
+                        }
+                    }
+
+                    FragmentLanesOut fout{};
+                    fout.alpha = f32(1.0f);
+                    fout.discard = simd::mask_from_bits(0u);
+                    ds.fs_lanes(fin, uniforms, fout);
+                    bits &= ~simd::mask_bits(fout.discard);
+                    if (bits == 0u) continue;
+
+                    simd::store(tmp0.data(), fout.color.x);
+                    simd::store(tmp1.data(), fout.color.y);
+                    simd::store(tmp2.data(), fout.color.z);
+                    simd::store(tmp3.data(), fout.alpha);
+                    target.hdr->visit([&](auto& buf)
+                    {
+                        using P = typename std::remove_reference_t<decltype(buf)>::pixel_type;
+                        P* crow = &buf.at(x, y);
+                        for (int i = 0; i < n; ++i)
+                        {
+                            const size_t li = (size_t)i;
+                            if ((bits & (1u << i)) != 0u) crow[i] = HdrPixelCodec<P>::encode(ColorF{tmp0[li], tmp1[li], tmp2[li], tmp3[li]});
+                        }
+                    });
+                }
+            });
+            if (stats)
+            {
+                // Resolve үед depth test нь id шалгалт руу шилжсэн тул давсан fragment-ыг raster шат тоолно.
+                if (!resolve) stats->fragments_passed += passed;
+                stats->fs_invocations += invoked;
+            }
+            return wrote_depth;
+        }
+
+        // [minx, maxx] x [miny, maxy] (гурвалжны bbox-той огтлолцсон) мужийг пиксел бүрээр shade хийнэ.
+        // vis өгөгдвөл visibility-buffer горимын аль нэг шатыг гүйцэтгэнэ (RasterVisibility).
+        // Depth бичсэн эсэхийг буцаана.
+        template<StaticShaderProgram Program>
+        inline bool shade_triangle_pixels(
+            const Program& program,
+            const RasterTriangle& t,
+            const glm::vec4* varw,
+            const RasterDrawState& ds,
+            const RasterizerTarget& target,
+            int W,
+            int H,
+            int minx,
+            int maxx,
+            int miny,
+            int maxy,
+            RasterizerStats* stats = nullptr,
+            const RasterVisibility* vis = nullptr)
+        {
+            if (ds.fs_lanes)
+            {
+                return shade_triangle_rect_lanes(t, varw, ds, target, W, H, minx, maxx, miny, maxy, stats, vis);
+            }
+
+            const ShaderUniforms& uniforms = *ds.uniforms;
+            const uint32_t varying_mask = t.varying_mask;
+            const bool write_ids = vis && !vis->resolve;
+            const bool resolve = vis && vis->resolve;
+            bool wrote_depth = false;
+            uint64_t passed = 0;
+            uint64_t invoked = 0;
+            const glm::vec2 ndc_scale = motion_ndc_scale(W, H);
+            const glm::vec2 vel_scale{0.5f * (float)W, 0.5f * (float)H};
+
+            rasterize_edges(t.edges, minx, maxx, miny, maxy, [&](int x, int y, const glm::vec3& bc)
+            {
+                if (resolve && vis->ids->at(x, y) != vis->id) return;
+                // 1/w interpolation: perspective-correct varying/position/uv тооцоо.
+                const float denom = bc.x * t.invw0 + bc.y * t.invw1 + bc.z * t.invw2;
+                if (denom <= 1e-10f) return;
+                const float inv_denom = 1.0f / denom;
 
-                const float invw0 = 1.0f / rv0.clip.w;
-                const float invw1 = 1.0f / rv1.clip.w;
-                const float invw2 = 1.0f / rv2.clip.w;
-                const bool write_motion = (target.depth_motion != nullptr) && uniforms.enable_motion_vectors;
-                glm::mat4 curr_to_prev_model{1.0f};
-                if (write_motion)
+                const float z_clip = bc.x * t.zw0 + bc.y * t.zw1 + bc.z * t.zw2;
+                const float z_ndc = z_clip * inv_denom;
+                float z01 = glm::clamp(z_ndc * 0.5f + 0.5f, 0.0f, 1.0f);
+                if (target.depth_motion)
                 {
-                    const float det_model = glm::determinant(uniforms.model);
-                    if (std::abs(det_model) > 1e-10f)
+                    // Perspective projection үед clip.w-аас view-space z сэргээж depth-ийг тогтвортой болгоно.
+                    const float view_z = 1.0f / denom;
+                    const float zn = target.depth_motion->zn;
+                    const float zf = target.depth_motion->zf;
+                    if (zf > zn + 1e-6f)
                     {
-                        curr_to_prev_model = uniforms.prev_model * glm::inverse(uniforms.model);
+                        z01 = glm::clamp((view_z - zn) / (zf - zn), 0.0f, 1.0f);
                     }
-                    else
+                    if (!resolve)
                     {
-                        curr_to_prev_model = glm::mat4(1.0f);
+                        float& zbuf = target.depth_motion->depth.at(x, y);
+                        if (z01 >= zbuf) return;
+                        zbuf = z01;
+                        wrote_depth = true;
                     }
                 }
-                const uint32_t varying_mask = rv0.varying_mask | rv1.varying_mask | rv2.varying_mask;
-                const glm::vec3 wpw0 = rv0.world_pos * invw0;
-                const glm::vec3 wpw1 = rv1.world_pos * invw1;
-                const glm::vec3 wpw2 = rv2.world_pos * invw2;
-                const glm::vec3 npw0 = rv0.normal_ws * invw0;
-                const glm::vec3 npw1 = rv1.normal_ws * invw1;
-                const glm::vec3 npw2 = rv2.normal_ws * invw2;
-                const glm::vec2 uvw0 = rv0.uv * invw0;
-                const glm::vec2 uvw1 = rv1.uv * invw1;
-                const glm::vec2 uvw2 = rv2.uv * invw2;
-                std::array<glm::vec4, SHS_MAX_VARYINGS> varw0{};
-                std::array<glm::vec4, SHS_MAX_VARYINGS> varw1{};
-                std::array<glm::vec4, SHS_MAX_VARYINGS> varw2{};
+                if (!resolve) ++passed;
+                if (write_ids)
+                {
+                    vis->ids->at(x, y) = vis->id;
+                    return;
+                }
+                ++invoked;
+
+                FragmentIn fin{};
+                fin.varying_mask = varying_mask;
+                uint32_t packed_index = 0;
                 for (uint32_t i = 0; i < SHS_MAX_VARYINGS; ++i)
                 {
                     if ((varying_mask & varying_bit(i)) == 0u) continue;
-                    varw0[i] = rv0.varyings[i] * invw0;
-                    varw1[i] = rv1.varyings[i] * invw1;
-                    varw2[i] = rv2.varyings[i] * invw2;
+                    const glm::vec4* v = varw + packed_index;
+                    fin.varyings[i] = (bc.x * v[0] + bc.y * v[1] + bc.z * v[2]) * inv_denom;
+                    packed_index += 3;
                 }
 
-                auto raster_rows = [&](int yb, int ye)
+                fin.world_pos = (bc.x * t.wpw0 + bc.y * t.wpw1 + bc.z * t.wpw2) * inv_denom;
+                fin.normal_ws = glm::normalize((bc.x * t.npw0 + bc.y * t.npw1 + bc.z * t.npw2) * inv_denom);
+                fin.uv = (bc.x * t.uvw0 + bc.y * t.uvw1 + bc.z * t.uvw2) * inv_denom;
+                // Shader өөрийн semantic varying гаргасан бол түүнд давуу эрх өгнө.
+                if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::WorldPos)) != 0u)
+                {
+                    fin.world_pos = glm::vec3(get_varying(fin, VaryingSemantic::WorldPos));
+                }
+                if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::NormalWS)) != 0u)
+                {
+                    fin.normal_ws = glm::normalize(glm::vec3(get_varying(fin, VaryingSemantic::NormalWS)));
+                }
+                if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::UV0)) != 0u)
                 {
-                    for (int y = yb; y < ye; ++y)
+                    const glm::vec4 uv0 = get_varying(fin, VaryingSemantic::UV0);
+                    fin.uv = glm::vec2(uv0.x, uv0.y);
+                }
+                fin.duv_dx = (t.duvw_dx - fin.uv * t.dinvw_dx) * inv_denom;
+                fin.duv_dy = (t.duvw_dy - fin.uv * t.dinvw_dy) * inv_denom;
+                if (program_may_write_motion<Program> && ds.write_motion)
+                {
+                    // Өмнөх clip нь оройн perspective-correct varying; одоогийн NDC нь пикселийн төв.
+                    const glm::vec3 pc = (bc.x * t.pcw0 + bc.y * t.pcw1 + bc.z * t.pcw2) * inv_denom;
+                    Motion2f mv{};
+                    if (std::abs(pc.z) > 1e-8f)
                     {
-                        for (int x = minx; x <= maxx; ++x)
+                        const float inv_pw = 1.0f / pc.z;
+                        glm::vec2 vel{
+                            (((float)x + 0.5f) * ndc_scale.x - 1.0f - pc.x * inv_pw) * vel_scale.x,
+                            (((float)y + 0.5f) * ndc_scale.y - 1.0f - pc.y * inv_pw) * vel_scale.y};
+                        const float len2 = glm::dot(vel, vel);
+                        if (len2 > k_raster_max_motion_px * k_raster_max_motion_px)
                         {
-                            const glm::vec2 p{(float)x + 0.5f, (float)y + 0.5f};
-                            const glm::vec3 bc = barycentric_2d(p, s0, s1, s2);
-                            if (bc.x < 0.0f || bc.y < 0.0f || bc.z < 0.0f) continue;
-
-                            // 1/w interpolation: perspective-correct varying/position/uv тооцоо.
-                            const float denom = bc.x * invw0 + bc.y * invw1 + bc.z * invw2;
-                            if (denom <= 1e-10f) continue;
-                            const float inv_denom = 1.0f / denom;
-
-                            const float z_clip = bc.x * (rv0.clip.z * invw0) + bc.y * (rv1.clip.z * invw1) + bc.z * (rv2.clip.z * invw2);
-                            const float z_ndc = z_clip * inv_denom;
-                            float z01 = glm::clamp(z_ndc * 0.5f + 0.5f, 0.0f, 1.0f);
-                            if (target.depth_motion)
-                            {
-                                // Perspective projection үед clip.w-аас view-space z сэргээж depth-ийг тогтвортой болгоно.
-                                const float view_z = 1.0f / denom;
-                                const float zn = target.depth_motion->zn;
-                                const float zf = target.depth_motion->zf;
-                                if (zf > zn + 1e-6f)
-                                {
-                                    z01 = glm::clamp((view_z - zn) / (zf - zn), 0.0f, 1.0f);
-                                }
-                                float& zbuf = target.depth_motion->depth.at(x, y);
-                                if (z01 >= zbuf) continue;
-                                zbuf = z01;
-                            }
-
-                            FragmentIn fin{};
-                            fin.varying_mask = varying_mask;
-                            for (uint32_t i = 0; i < SHS_MAX_VARYINGS; ++i)
-                            {
-                                if ((varying_mask & varying_bit(i)) == 0u) continue;
-                                fin.varyings[i] = (bc.x * varw0[i] + bc.y * varw1[i] + bc.z * varw2[i]) * inv_denom;
-                            }
-
-                            fin.world_pos = (bc.x * wpw0 + bc.y * wpw1 + bc.z * wpw2) * inv_denom;
-                            fin.normal_ws = glm::normalize((bc.x * npw0 + bc.y * npw1 + bc.z * npw2) * inv_denom);
-                            fin.uv = (bc.x * uvw0 + bc.y * uvw1 + bc.z * uvw2) * inv_denom;
-                            // Shader өөрийн semantic varying гаргасан бол түүнд давуу эрх өгнө.
-                            if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::WorldPos)) != 0u)
-                            {
-                                fin.world_pos = glm::vec3(get_varying(fin, VaryingSemantic::WorldPos));
-                            }
-                            if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::NormalWS)) != 0u)
-                            {
-                                fin.normal_ws = glm::normalize(glm::vec3(get_varying(fin, VaryingSemantic::NormalWS)));
-                            }
-                            if ((fin.varying_mask & varying_bit((uint32_t)VaryingSemantic::UV0)) != 0u)
-                            {
-                                const glm::vec4 uv0 = get_varying(fin, VaryingSemantic::UV0);
-                                fin.uv = glm::vec2(uv0.x, uv0.y);
-                            }
-                            if (write_motion)
-                            {
-                                const glm::vec4 curr_world = glm::vec4(fin.world_pos, 1.0f);
-                                const glm::vec4 prev_world = curr_to_prev_model * curr_world;
-                                const glm::vec4 curr_clip = uniforms.viewproj * curr_world;
-                                const glm::vec4 prev_clip = uniforms.prev_viewproj * prev_world;
-                                if (std::abs(curr_clip.w) > 1e-8f && std::abs(prev_clip.w) > 1e-8f)
-                                {
-                                    const glm::vec2 curr_ndc = glm::vec2(curr_clip) / curr_clip.w;
-                                    const glm::vec2 prev_ndc = glm::vec2(prev_clip) / prev_clip.w;
-                                    glm::vec2 vel = (curr_ndc - prev_ndc) * 0.5f * glm::vec2((float)W, (float)H);
-                                    const float len = glm::length(vel);
-                                    const float max_vel = 96.0f;
-                                    if (len > max_vel && len > 1e-6f)
-                                    {
-                                        vel *= (max_vel / len);
-                                    }
-                                    target.depth_motion->motion.at(x, y) = Motion2f{vel.x, vel.y};
-                                }
-                                else
-                                {
-                                    target.depth_motion->motion.at(x, y) = Motion2f{};
-                                }
-                            }
-                            fin.depth01 = z01;
-                            fin.px = x;
-                            fin.py = y;
-
-                            const FragmentOut fout = program.fs(fin, uniforms);
-                            if (fout.discard) continue;
-
-                            target.hdr->color.at(x, y) = fout.color;
+                            vel *= k_raster_max_motion_px / std::sqrt(len2);
                         }
+                        mv = Motion2f{vel.x, vel.y};
                     }
+                    target.depth_motion->motion.at(x, y) = mv;
+                }
+                fin.depth01 = z01;
+                fin.px = x;
+                fin.py = y;
+
+                const FragmentOut fout = program.fs(fin, uniforms);
+                if (fout.discard) return;
+
+                target.hdr->store(x, y, fout.color);
+            });
+            if (stats)
+            {
+                stats->fragments_passed += passed;
+                stats->fs_invocations += invoked;
+            }
+            return wrote_depth;
+        }
+
+        // Гурвалжны хамгийн ойрын depth01. 1/w болон z/w нь дэлгэц дээр шугаман тул
+        // пикселийн утга оройн утгуудын хооронд байна.
+        inline float triangle_min_depth01(const RasterTriangle& t, const RT_ColorDepthMotion& dm)
+        {
+            if (dm.zf > dm.zn + 1e-6f)
+            {
+                const float wmin = std::min({1.0f / t.invw0, 1.0f / t.invw1, 1.0f / t.invw2});
+                return glm::clamp((wmin - dm.zn) / (dm.zf - dm.zn), 0.0f, 1.0f);
+            }
+            const float zmin = std::min({t.zw0, t.zw1, t.zw2});
+            return glm::clamp(zmin * 0.5f + 0.5f, 0.0f, 1.0f);
+        }
+
+        // Hi-Z харьцуулалтын хүлцэл: пикселийн depth-ийн float алдаанаас болж буруу reject хийхгүй.
+        inline constexpr float k_hiz_reject_epsilon = 1e-5f;
+
+        // Гурвалжны bbox-ийг [x0, x1] x [y0, y1] тэгш өнцөгттэй огтлолцуулж raster + shade хийнэ.
+        // Tile-тай rasterizer тухайн tile-ийн хүрээг, шууд горим мөрийн chunk-ийг дамжуулна.
+        // Hi-Z идэвхтэй үед хүрээ нь 8-д зэрэгцсэн байх ёстой (block-ийг нэг thread эзэмшинэ).
+        template<StaticShaderProgram Program>
+        inline void shade_triangle_rect(
+            const Program& program,
+            const RasterTriangle& t,
+            const glm::vec4* varw,
+            const RasterDrawState& ds,
+            const RasterizerTarget& target,
+            int W,
+            int H,
+            int x0,
+            int x1,
+            int y0,
+            int y1,
+            RasterizerStats* stats = nullptr,
+            const RasterVisibility* vis = nullptr)
+        {
+            const int minx = std::max(t.minx, x0);
+            const int maxx = std::min(t.maxx, x1);
+            const int miny = std::max(t.miny, y0);
+            const int maxy = std::min(t.maxy, y1);
+            if (minx > maxx || miny > maxy) return;
+            // Resolve шатанд depth эцсийн утгатай тул Hi-Z шалгалт юу ч хасахгүй.
+            if (!ds.hiz || (vis && vis->resolve))
+            {
+                (void)shade_triangle_pixels(program, t, varw, ds, target, W, H, minx, maxx, miny, maxy, stats, vis);
+                return;
+            }
+
+            RasterHiZ& hiz = *ds.hiz;
+            const PixelBuffer2D<float>& depth = target.depth_motion->depth;
+            const float tri_zmin = triangle_min_depth01(t, *target.depth_motion) - k_hiz_reject_epsilon;
+            constexpr int B = k_hiz_block_size;
+            uint64_t rejected = 0;
+            bool any_visible = false;
+            for (int by = miny / B; by <= maxy / B; ++by)
+            {
+                for (int bx = minx / B; bx <= maxx / B; ++bx)
+                {
+                    // z01 < zbuf шалгалт тул block-ийн хамгийн алс пикселээс ч цааш бол бүгд унана.
+                    if (tri_zmin >= hiz.block_max(bx, by, depth))
+                    {
+                        ++rejected;
+                        continue;
+                    }
+                    any_visible = true;
+                    const bool wrote = shade_triangle_pixels(
+                        program, t, varw, ds, target, W, H,
+                        std::max(minx, bx * B), std::min(maxx, bx * B + B - 1),
+                        std::max(miny, by * B), std::min(maxy, by * B + B - 1),
+                        stats, vis);
+                    if (wrote) hiz.mark_dirty(bx, by);
+                }
+            }
+            if (stats)
+            {
+                stats->hiz_blocks_rejected += rejected;
+                if (!any_visible) stats->hiz_tris_rejected++;
+            }
+        }
+    }
+
+    namespace detail
+    {
+        // Shadow map зэрэг зөвхөн гүн бичих raster-ийн screen-space гурвалжин (NDC z).
+        struct DepthTriangle
+        {
+            glm::vec2 s0{0.0f};
+            glm::vec2 s1{0.0f};
+            glm::vec2 s2{0.0f};
+            float z0 = 0.0f;
+            float z1 = 0.0f;
+            float z2 = 0.0f;
+            RasterEdgeSetup edges{};
+            int minx = 0;
+            int maxx = -1;
+            int miny = 0;
+            int maxy = -1;
+        };
+
+        // Depth-only setup: clip хийхгүй, cull хийхгүй, зөвхөн бүх орой NDC-ийн нэг талд
+        // гарсан гурвалжинг trivial reject хийнэ.
+        template<typename Emit>
+        inline void setup_depth_triangles(
+            const MeshData& mesh,
+            const glm::mat4& model,
+            const glm::mat4& viewproj,
+            int W,
+            int H,
+            size_t tri_begin,
+            size_t tri_end,
+            RasterizerStats& stats,
+            Emit&& emit)
+        {
+            const bool indexed = !mesh.indices.empty();
+            for (size_t ti = tri_begin; ti < tri_end; ++ti)
+            {
+                stats.tri_input++;
+                const uint32_t i0 = indexed ? mesh.indices[ti * 3 + 0] : (uint32_t)(ti * 3 + 0);
+                const uint32_t i1 = indexed ? mesh.indices[ti * 3 + 1] : (uint32_t)(ti * 3 + 1);
+                const uint32_t i2 = indexed ? mesh.indices[ti * 3 + 2] : (uint32_t)(ti * 3 + 2);
+                if (i0 >= mesh.positions.size() || i1 >= mesh.positions.size() || i2 >= mesh.positions.size()) continue;
+
+                const glm::vec3 p0 = glm::vec3(model * glm::vec4(mesh.positions[i0], 1.0f));
+                const glm::vec3 p1 = glm::vec3(model * glm::vec4(mesh.positions[i1], 1.0f));
+                const glm::vec3 p2 = glm::vec3(model * glm::vec4(mesh.positions[i2], 1.0f));
+                const glm::vec4 c0 = viewproj * glm::vec4(p0, 1.0f);
+                const glm::vec4 c1 = viewproj * glm::vec4(p1, 1.0f);
+                const glm::vec4 c2 = viewproj * glm::vec4(p2, 1.0f);
+                if (std::abs(c0.w) < 1e-8f || std::abs(c1.w) < 1e-8f || std::abs(c2.w) < 1e-8f) continue;
+
+                const glm::vec3 n0 = glm::vec3(c0) / c0.w;
+                const glm::vec3 n1 = glm::vec3(c1) / c1.w;
+                const glm::vec3 n2 = glm::vec3(c2) / c2.w;
+
+                // Бүх орой нэг талаараа NDC-гээс гарсан бол early reject.
+                if ((n0.x < -1.0f && n1.x < -1.0f && n2.x < -1.0f) || (n0.x > 1.0f && n1.x > 1.0f && n2.x > 1.0f)) continue;
+                if ((n0.y < -1.0f && n1.y < -1.0f && n2.y < -1.0f) || (n0.y > 1.0f && n1.y > 1.0f && n2.y > 1.0f)) continue;
+                if ((n0.z < -1.0f && n1.z < -1.0f && n2.z < -1.0f) || (n0.z > 1.0f && n1.z > 1.0f && n2.z > 1.0f)) continue;
+                stats.tri_after_clip++;
+
+                DepthTriangle t{};
+                t.s0 = glm::vec2{(n0.x * 0.5f + 0.5f) * (float)(W - 1), (n0.y * 0.5f + 0.5f) * (float)(H - 1)};
+                t.s1 = glm::vec2{(n1.x * 0.5f + 0.5f) * (float)(W - 1), (n1.y * 0.5f + 0.5f) * (float)(H - 1)};
+                t.s2 = glm::vec2{(n2.x * 0.5f + 0.5f) * (float)(W - 1), (n2.y * 0.5f + 0.5f) * (float)(H - 1)};
+                t.z0 = n0.z;
+                t.z1 = n1.z;
+                t.z2 = n2.z;
+
+                t.minx = std::max(0, (int)std::floor(std::min({t.s0.x, t.s1.x, t.s2.x})));
+                t.maxx = std::min(W - 1, (int)std::ceil(std::max({t.s0.x, t.s1.x, t.s2.x})));
+                t.miny = std::max(0, (int)std::floor(std::min({t.s0.y, t.s1.y, t.s2.y})));
+                t.maxy = std::min(H - 1, (int)std::ceil(std::max({t.s0.y, t.s1.y, t.s2.y})));
+                if (t.minx > t.maxx || t.miny > t.maxy) continue;
+                if (!setup_raster_edges(t.s0, t.s1, t.s2, t.edges)) continue;
+                stats.tri_raster++;
+                emit(t);
+            }
+        }
+
+        // clear_fast()-аар тэмдэглэсэн target-ийн [x0, x1] x [y0, y1]-д давхцах tile-уудыг анх
+        // хүрэхээс өмнө бөглөнө. Дуудагч нь tile/band-ийг 8-д зэрэгцүүлсэн байх ёстой.
+        inline void resolve_target_fast_clear(const RasterizerTarget& target, int x0, int x1, int y0, int y1)
+        {
+            if (target.hdr) target.hdr->resolve_fast_clear_rect(x0, x1, y0, y1);
+            if (target.depth_motion)
+            {
+                target.depth_motion->depth.resolve_fast_clear_rect(x0, x1, y0, y1);
+                target.depth_motion->motion.resolve_fast_clear_rect(x0, x1, y0, y1);
+            }
+        }
+
+        // Хамгийн ойрын z01-ийг үлдээнэ (shadow map-ийн depth test).
+        inline void shade_depth_triangle_rect(
+            const DepthTriangle& t,
+            RT_ShadowDepth& depth,
+            int x0,
+            int x1,
+            int y0,
+            int y1)
+        {
+            const int minx = std::max(t.minx, x0);
+            const int maxx = std::min(t.maxx, x1);
+            const int miny = std::max(t.miny, y0);
+            const int maxy = std::min(t.maxy, y1);
+            rasterize_edges(t.edges, minx, maxx, miny, maxy, [&](int x, int y, const glm::vec3& bc)
+            {
+                const float z_ndc = bc.x * t.z0 + bc.y * t.z1 + bc.z * t.z2;
+                const float z01 = std::clamp(z_ndc * 0.5f + 0.5f, 0.0f, 1.0f);
+                float& zbuf = depth.at(x, y);
+                if (z01 < zbuf) zbuf = z01;
+            });
+        }
+    }
+
+    // Program-ийн төрлөөр instantiate хийгдэнэ: static program (BlinnPhongProgram г.м.) дамжуулбал
+    // vs/fs шууд inline болж, ShaderProgram дамжуулбал std::function-ээр дуудна.
+    // vertices нь дуудагчийн эзэмшдэг cache: frame бүр олон draw хийдэг pass-ууд өөрийн гишүүнийг
+    // дамжуулж, draw бүрийн cache хуваарилалтаас зайлсхийнэ.
+    template<StaticShaderProgram Program>
+    inline RasterizerStats rasterize_mesh(
+        const MeshData& mesh,
+        const Program& program,
+        const ShaderUniforms& uniforms,
+        RasterizerTarget target,
+        const RasterizerConfig& config,
+        RasterVertexCache& vertices
+    )
+    {
+        RasterizerStats stats{};
+        if (!target.hdr || !program_valid(program)) return stats;
+        if (mesh.positions.empty()) return stats;
+        const int W = target.hdr->w;
+        const int H = target.hdr->h;
+        if (W <= 0 || H <= 0) return stats;
+
+        const detail::RasterDrawState ds = detail::make_raster_draw_state(program, uniforms, target, config);
+        stats.vs_invocations = detail::shade_mesh_vertices(
+            mesh, program, uniforms, vertices, ds.write_motion ? &ds.prev_clip_from_world : nullptr, config.job_system);
+        detail::setup_mesh_triangles(
+            mesh, vertices, W, H, config, 0, detail::mesh_triangle_count(mesh), stats,
+            [&](const detail::RasterTriangle& t, const glm::vec4* varw, uint32_t) {
+                // Мөрүүдийг 8 мөрийн band-аар хуваана: Hi-Z block бүрийг нэг л job өөрчилнө.
+                constexpr int B = k_hiz_block_size;
+                std::atomic<uint64_t> blocks_rejected{0};
+                std::atomic<uint64_t> bands_visible{0};
+                std::atomic<uint64_t> fragments_passed{0};
+                std::atomic<uint64_t> fs_invocations{0};
+                auto raster_bands = [&](int bb, int be)
+                {
+                    RasterizerStats local{};
+                    detail::resolve_target_fast_clear(target, t.minx, t.maxx, bb * B, be * B - 1);
+                    detail::shade_triangle_rect(program, t, varw, ds, target, W, H, t.minx, t.maxx, bb * B, be * B - 1, &local);
+                    blocks_rejected.fetch_add(local.hiz_blocks_rejected, std::memory_order_relaxed);
+                    fragments_passed.fetch_add(local.fragments_passed, std::memory_order_relaxed);
+                    fs_invocations.fetch_add(local.fs_invocations, std::memory_order_relaxed);
+                    if (local.hiz_tris_rejected == 0) bands_visible.fetch_add(1, std::memory_order_relaxed);
                 };
 
-                const int bbox_rows = maxy - miny + 1;
-                const int bbox_pixels = (maxx - minx + 1) * bbox_rows;
+                const int bbox_rows = t.maxy - t.miny + 1;
+                const int bbox_pixels = (t.maxx - t.minx + 1) * bbox_rows;
                 // Том bbox дээр л parallel замыг асааж scheduling overhead-оос зайлсхийж байна.
                 const bool use_parallel =
                     config.job_system &&
                     bbox_rows >= std::max(1, config.parallel_min_rows) &&
                     bbox_pixels >= std::max(1, config.parallel_min_pixels);
+                const int band_begin = t.miny / B;
+                const int band_end = t.maxy / B + 1;
                 if (use_parallel)
                 {
-                    parallel_for_1d(config.job_system, miny, maxy + 1, std::max(1, config.parallel_min_rows), raster_rows);
+                    const int band_grain = std::max(1, (config.parallel_min_rows + B - 1) / B);
+                    parallel_for_1d(config.job_system, band_begin, band_end, band_grain, raster_bands);
                 }
                 else
                 {
-                    raster_rows(miny, maxy + 1);
+                    raster_bands(band_begin, band_end);
                 }
-            }
-        }
+                stats.fragments_passed += fragments_passed.load(std::memory_order_relaxed);
+                stats.fs_invocations += fs_invocations.load(std::memory_order_relaxed);
+                if (ds.hiz)
+                {
+                    stats.hiz_blocks_rejected += blocks_rejected.load(std::memory_order_relaxed);
+                    if (bands_visible.load(std::memory_order_relaxed) == 0) stats.hiz_tris_rejected++;
+                }
+            });
+        return stats;
+    }
+
+    // Нэг удаагийн draw: cache-ийг дуудлага бүрд шинээр үүсгэнэ (demo/test; hot path-д хэрэглэхгүй).
+    template<StaticShaderProgram Program>
+    inline RasterizerStats rasterize_mesh(
+        const MeshData& mesh,
+        const Program& program,
+        const ShaderUniforms& uniforms,
+        RasterizerTarget target,
+        const RasterizerConfig& config = {}
+    )
+    {
+        RasterVertexCache vertices{};
+        return rasterize_mesh(mesh, program, uniforms, target, config, vertices);
+    }
+
+    // Зөвхөн гүн бичих (shadow map) raster. model/viewproj-оор шууд хувиргана, culling хийхгүй.
+    inline RasterizerStats rasterize_mesh_depth(
+        const MeshData& mesh,
+        const glm::mat4& model,
+        const glm::mat4& viewproj,
+        RT_ShadowDepth& target)
+    {
+        RasterizerStats stats{};
+        if (mesh.positions.empty() || target.w <= 0 || target.h <= 0) return stats;
+        detail::setup_depth_triangles(
+            mesh, model, viewproj, target.w, target.h, 0, detail::mesh_triangle_count(mesh), stats,
+            [&](const detail::DepthTriangle& t) {
+                target.resolve_fast_clear_rect(t.minx, t.maxx, t.miny, t.maxy);
+                detail::shade_depth_triangle_rect(t, target, t.minx, t.maxx, t.miny, t.maxy);
+            });
         return stats;
     }
 }
@@ -0,0 +1,591 @@
+#pragma once
+
+/*
+    SHS РЕНДЕРЕР САН
+
+    ФАЙЛ: tiled_rasterizer.hpp
+    МОДУЛЬ: render
+    ЗОРИЛГО: Sort-middle tile-binned software rasterizer. Pass-ийн бүх draw-ийг submit хийгээд
+            flush() дээр:
+              1) front-end job-ууд (draw, гурвалжны муж) тус бүрд VS/clip/cull/setup хийж
+                 гурвалжнуудыг tile_size x tile_size bin-д хуваарилна,
+              2) back-end job-ууд tile-уудыг зэрэг raster/shade хийнэ.
+            Tile бүрийг нэг л thread эзэмших тул depth/color бичилтэд sync хэрэггүй,
+            tile доторх гурвалжны дараалал submit дарааллыг хадгална (rasterize_mesh-тэй ижил үр дүн).
+            visibility_buffer горимд 2-р шат зөвхөн depth + гурвалжны id бичиж, 3-р шат
+            (resolve) tile бүрт харагдах гурвалжнуудыг л дахин raster хийн пиксел бүрийг
+            яг нэг удаа shade хийнэ.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "shs/frame/frame_params.hpp"
+#include "shs/gfx/rt_fast_clear_resolve.hpp"
+#include "shs/gfx/rt_shadow.hpp"
+#include "shs/job/parallel_for.hpp"
+#include "shs/sw_render/rasterizer.hpp"
+
+namespace shs
+{
+    struct TiledRasterizerConfig
+    {
+        IJobSystem* job_system = nullptr;
+        // k_hiz_block_size-ийн (8) үржвэр болгон дээш бөөрөнхийлнө.
+        int tile_size = 64;
+        // Нэг front-end job-ийн боловсруулах эх гурвалжны тоо.
+        int front_end_tris_per_job = 512;
+        JobPriority priority = JobPriority::FrameCritical;
+        // Visibility-buffer (deferred shading) горим. depth_motion target шаардана; discard
+        // хийдэг fragment program-ууд дээр id шат discard-ийг мэдэхгүй тул буруу үр дүн гарна.
+        bool visibility_buffer = false;
+    };
+
+    inline TiledRasterizerConfig make_tiled_rasterizer_config(const SoftwareRasterParams& params, IJobSystem* js)
+    {
+        TiledRasterizerConfig cfg{};
+        cfg.job_system = js;
+        cfg.tile_size = params.tile_size;
+        cfg.front_end_tris_per_job = params.front_end_tris_per_job;
+        cfg.visibility_buffer = params.visibility_buffer;
+        return cfg;
+    }
+
+    struct TiledRasterizerStats
+    {
+        RasterizerStats raster{};
+        uint32_t draws = 0;
+        uint32_t front_end_jobs = 0;
+        uint32_t tiles = 0;
+        uint32_t tiles_touched = 0;
+        uint64_t bin_entries = 0;
+    };
+
+    class TiledRasterizer
+    {
+    public:
+        // Өнгө + (сонголтоор) depth/motion бичих горим. Дараагийн flush хүртэл submit хүлээн авна.
+        void begin(RasterizerTarget target, const TiledRasterizerConfig& cfg = {})
+        {
+            reset_frame(cfg);
+            depth_only_ = false;
+            target_ = target;
+            shadow_ = nullptr;
+            if (target_.hdr)
+            {
+                set_extent(target_.hdr->w, target_.hdr->h);
+            }
+        }
+
+        // PassShadowMap-ийн depth-only горим: clip/cull хийхгүй, хамгийн ойрын z01-ийг үлдээнэ.
+        void begin_depth_only(RT_ShadowDepth* depth, const TiledRasterizerConfig& cfg = {})
+        {
+            reset_frame(cfg);
+            depth_only_ = true;
+            target_ = RasterizerTarget{};
+            shadow_ = depth;
+            if (shadow_)
+            {
+                set_extent(shadow_->w, shadow_->h);
+            }
+        }
+
+        // mesh болон program нь flush() дуустал амьд байх ёстой. uniforms хуулагдана.
+        // Program-ийн төрөл бүрд vertex/fragment шатыг instantiate хийх тул draw-уудын
+        // program өөр өөр төрөлтэй байж болно (draw тутамд нэг indirect дуудлага).
+        template<StaticShaderProgram Program>
+        void submit(
+            const MeshData& mesh,
+            const Program& program,
+            const ShaderUniforms& uniforms,
+            const RasterizerConfig& config = {})
+        {
+            if (depth_only_ || !target_.hdr || !program_valid(program) || mesh.positions.empty()) return;
+            DrawRecord& d = next_draw();
+            d.mesh = &mesh;
+            d.program = &program;
+            d.ops = &k_program_ops<Program>;
+            d.uniforms = uniforms;
+            d.config = config;
+            add_draw_chunks(detail::mesh_triangle_count(mesh));
+        }
+
+        void submit_depth(const MeshData& mesh, const glm::mat4& model, const glm::mat4& viewproj)
+        {
+            if (!depth_only_ || !shadow_ || mesh.positions.empty()) return;
+            DrawRecord& d = next_draw();
+            d.mesh = &mesh;
+            d.program = nullptr;
+            d.ops = nullptr;
+            d.model = model;
+            d.viewproj = viewproj;
+            add_draw_chunks(detail::mesh_triangle_count(mesh));
+        }
+
+        RasterizerStats flush()
+        {
+            stats_ = TiledRasterizerStats{};
+            stats_.draws = (uint32_t)draw_count_;
+            stats_.front_end_jobs = (uint32_t)chunk_count_;
+            stats_.tiles = (uint32_t)(tiles_x_ * tiles_y_);
+            if (draw_count_ == 0 || W_ <= 0 || H_ <= 0)
+            {
+                draw_count_ = 0;
+                chunk_count_ = 0;
+                return stats_.raster;
+            }
+
+            run_front_end();
+            build_bins();
+            reset_tile_counters();
+            visibility_ = cfg_.visibility_buffer && !depth_only_ && target_.depth_motion != nullptr;
+            if (visibility_)
+            {
+                begin_visibility();
+                run_tiles([&](uint32_t tile, int, RasterizerStats& local) { raster_tile(tile, local); });
+                run_tiles([&](uint32_t tile, int lane, RasterizerStats& local) {
+                    resolve_tile(tile, resolve_scratch_[(size_t)lane], local);
+                });
+                // visibility()-г уншигчид хоосон tile-ийг 0 гэж харна.
+                resolve_fast_clear(vis_ids_, cfg_.job_system);
+            }
+            else
+            {
+                run_tiles([&](uint32_t tile, int, RasterizerStats& local) { raster_tile(tile, local); });
+            }
+
+            for (size_t c = 0; c < chunk_count_; ++c)
+            {
+                const RasterizerStats& cs = chunks_[c].stats;
+                stats_.raster.tri_input += cs.tri_input;
+                stats_.raster.tri_after_clip += cs.tri_after_clip;
+                stats_.raster.tri_raster += cs.tri_raster;
+            }
+            for (size_t i = 0; i < draw_count_; ++i) stats_.raster.vs_invocations += draws_[i].vs_invocations;
+            stats_.raster.hiz_tris_rejected = hiz_tris_rejected_.load(std::memory_order_relaxed);
+            stats_.raster.hiz_blocks_rejected = hiz_blocks_rejected_.load(std::memory_order_relaxed);
+            stats_.raster.fragments_passed = fragments_passed_.load(std::memory_order_relaxed);
+            stats_.raster.fs_invocations = fs_invocations_.load(std::memory_order_relaxed);
+            vis_chunk_count_ = visibility_ ? chunk_count_ : 0;
+            draw_count_ = 0;
+            chunk_count_ = 0;
+            return stats_.raster;
+        }
+
+        const TiledRasterizerStats& last_stats() const { return stats_; }
+
+        // Сүүлийн visibility-buffer flush-ийн id buffer. Пиксел бүрд кадрын хэмжээний
+        // raster гурвалжны индекс + 1 (0 = хоосон) хадгална.
+        const PixelBuffer2D<uint32_t>& visibility() const { return vis_ids_; }
+
+        // visibility()-ийн id-г submit дарааллын draw индекс болгоно. Хоосон/хуучирсан id-д -1.
+        int visibility_draw(uint32_t id) const
+        {
+            if (id == 0u || vis_chunk_count_ == 0) return -1;
+            const uint32_t tri = id - 1u;
+            const auto end = chunk_tri_base_.begin() + (std::ptrdiff_t)vis_chunk_count_;
+            const auto it = std::upper_bound(chunk_tri_base_.begin(), end, tri);
+            if (it == chunk_tri_base_.begin()) return -1;
+            const size_t c = (size_t)(it - chunk_tri_base_.begin()) - 1u;
+            if (tri - chunk_tri_base_[c] >= chunks_[c].tris.size()) return -1;
+            return (int)chunks_[c].draw;
+        }
+
+    private:
+        // Draw-ийн program-ийн төрлийг нуусан шатны функцүүд. Тус бүр нь тухайн төрлийн
+        // template instantiation-ийг дуудна.
+        struct ProgramOps
+        {
+            detail::RasterDrawState (*make_state)(
+                const void* program, const ShaderUniforms&, const RasterizerTarget&, const RasterizerConfig&);
+            uint64_t (*shade_vertices)(
+                const void* program, const MeshData&, const ShaderUniforms&, RasterVertexCache&, const glm::mat4*, IJobSystem*, JobPriority);
+            void (*shade_rect)(
+                const void* program, const detail::RasterTriangle&, const glm::vec4*, const detail::RasterDrawState&,
+                const RasterizerTarget&, int W, int H, int x0, int x1, int y0, int y1,
+                RasterizerStats*, const detail::RasterVisibility*);
+        };
+
+        template<typename Program>
+        static constexpr ProgramOps k_program_ops{
+            [](const void* p, const ShaderUniforms& u, const RasterizerTarget& target, const RasterizerConfig& config) {
+                return detail::make_raster_draw_state(*static_cast<const Program*>(p), u, target, config);
+            },
+            [](const void* p, const MeshData& mesh, const ShaderUniforms& u, RasterVertexCache& cache,
+               const glm::mat4* prev_clip_from_world, IJobSystem* js, JobPriority priority) {
+                return detail::shade_mesh_vertices(mesh, *static_cast<const Program*>(p), u, cache, prev_clip_from_world, js, priority);
+            },
+            [](const void* p, const detail::RasterTriangle& t, const glm::vec4* varw, const detail::RasterDrawState& ds,
+               const RasterizerTarget& target, int W, int H, int x0, int x1, int y0, int y1,
+               RasterizerStats* stats, const detail::RasterVisibility* vis) {
+                detail::shade_triangle_rect(*static_cast<const Program*>(p), t, varw, ds, target, W, H, x0, x1, y0, y1, stats, vis);
+            },
+        };
+
+        struct DrawRecord
+        {
+            const MeshData* mesh = nullptr;
+            const void* program = nullptr;
+            const ProgramOps* ops = nullptr;
+            ShaderUniforms uniforms{};
+            RasterizerConfig config{};
+            detail::RasterDrawState state{};
+            // Post-transform vertex cache. Frame хооронд буфер нь дахин ашиглагдана.
+            RasterVertexCache vertices{};
+            uint64_t vs_invocations = 0;
+            glm::mat4 model{1.0f};
+            glm::mat4 viewproj{1.0f};
+        };
+
+        // Нэг front-end job-ийн гаралт. Буферууд frame хооронд дахин ашиглагдана.
+        struct Chunk
+        {
+            uint32_t draw = 0;
+            size_t tri_begin = 0;
+            size_t tri_end = 0;
+            std::vector<detail::RasterTriangle> tris{};
+            std::vector<detail::DepthTriangle> depth_tris{};
+            std::vector<uint32_t> varying_offsets{};
+            std::vector<glm::vec4> varyings{};
+            // (tile, chunk доторх гурвалжны индекс) хос.
+            std::vector<uint32_t> bin_tiles{};
+            std::vector<uint32_t> bin_tris{};
+            RasterizerStats stats{};
+        };
+
+        struct TileRef
+        {
+            uint32_t chunk = 0;
+            uint32_t tri = 0;
+        };
+
+        void reset_frame(const TiledRasterizerConfig& cfg)
+        {
+            cfg_ = cfg;
+            cfg_.tile_size = std::max(k_hiz_block_size, (cfg_.tile_size + k_hiz_block_size - 1) / k_hiz_block_size * k_hiz_block_size);
+            cfg_.front_end_tris_per_job = std::max(1, cfg_.front_end_tris_per_job);
+            draw_count_ = 0;
+            chunk_count_ = 0;
+            W_ = 0;
+            H_ = 0;
+            tiles_x_ = 0;
+            tiles_y_ = 0;
+        }
+
+        void set_extent(int w, int h)
+        {
+            W_ = w;
+            H_ = h;
+            if (W_ <= 0 || H_ <= 0) return;
+            tiles_x_ = (W_ + cfg_.tile_size - 1) / cfg_.tile_size;
+            tiles_y_ = (H_ + cfg_.tile_size - 1) / cfg_.tile_size;
+        }
+
+        DrawRecord& next_draw()
+        {
+            if (draw_count_ == draws_.size()) draws_.emplace_back();
+            return draws_[draw_count_++];
+        }
+
+        void add_draw_chunks(size_t tri_count)
+        {
+            const uint32_t draw = (uint32_t)(draw_count_ - 1);
+            const size_t step = (size_t)cfg_.front_end_tris_per_job;
+            for (size_t b = 0; b < tri_count; b += step)
+            {
+                if (chunk_count_ == chunks_.size()) chunks_.emplace_back();
+                Chunk& c = chunks_[chunk_count_++];
+                c.draw = draw;
+                c.tri_begin = b;
+                c.tri_end = std::min(tri_count, b + step);
+            }
+        }
+
+        template<typename Tri>
+        void bin_triangle(Chunk& c, const Tri& t, uint32_t tri_index)
+        {
+            const int ts = cfg_.tile_size;
+            const int tx0 = t.minx / ts;
+            const int tx1 = t.maxx / ts;
+            const int ty0 = t.miny / ts;
+            const int ty1 = t.maxy / ts;
+            for (int ty = ty0; ty <= ty1; ++ty)
+            {
+                for (int tx = tx0; tx <= tx1; ++tx)
+                {
+                    c.bin_tiles.push_back((uint32_t)(ty * tiles_x_ + tx));
+                    c.bin_tris.push_back(tri_index);
+                }
+            }
+        }
+
+        void run_front_end_chunk(Chunk& c)
+        {
+            c.tris.clear();
+            c.depth_tris.clear();
+            c.varying_offsets.clear();
+            c.varyings.clear();
+            c.bin_tiles.clear();
+            c.bin_tris.clear();
+            c.stats = RasterizerStats{};
+
+            const DrawRecord& d = draws_[c.draw];
+            if (depth_only_)
+            {
+                detail::setup_depth_triangles(
+                    *d.mesh, d.model, d.viewproj, W_, H_, c.tri_begin, c.tri_end, c.stats,
+                    [&](const detail::DepthTriangle& t) {
+                        bin_triangle(c, t, (uint32_t)c.depth_tris.size());
+                        c.depth_tris.push_back(t);
+                    });
+                return;
+            }
+
+            detail::setup_mesh_triangles(
+                *d.mesh, d.vertices, W_, H_, d.config, c.tri_begin, c.tri_end, c.stats,
+                [&](const detail::RasterTriangle& t, const glm::vec4* varw, uint32_t varw_count) {
+                    bin_triangle(c, t, (uint32_t)c.tris.size());
+                    c.tris.push_back(t);
+                    c.varying_offsets.push_back((uint32_t)c.varyings.size());
+                    c.varyings.insert(c.varyings.end(), varw, varw + varw_count);
+                });
+        }
+
+        void run_front_end()
+        {
+            if (!depth_only_)
+            {
+                // Vertex шат: draw бүрийн оройг нэг удаа shade хийнэ. Том mesh дотроо дахин хуваагдана.
+                parallel_for_1d(cfg_.job_system, 0, (int)draw_count_, 1, cfg_.priority, [&](int b, int e) {
+                    for (int i = b; i < e; ++i)
+                    {
+                        DrawRecord& d = draws_[(size_t)i];
+                        d.state = d.ops->make_state(d.program, d.uniforms, target_, d.config);
+                        d.vs_invocations = d.ops->shade_vertices(
+                            d.program, *d.mesh, d.uniforms, d.vertices,
+                            d.state.write_motion ? &d.state.prev_clip_from_world : nullptr, cfg_.job_system, cfg_.priority);
+                    }
+                });
+            }
+            parallel_for_1d(cfg_.job_system, 0, (int)chunk_count_, 1, cfg_.priority, [&](int b, int e) {
+                for (int i = b; i < e; ++i) run_front_end_chunk(chunks_[(size_t)i]);
+            });
+        }
+
+        // Chunk-уудын bin хосуудыг tile бүрийн CSR жагсаалт болгоно. Chunk-ийн дарааллаар
+        // тоолох тул tile доторх гурвалжны дараалал submit дарааллыг хадгална.
+        void build_bins()
+        {
+            const size_t tile_count = (size_t)(tiles_x_ * tiles_y_);
+            tile_offsets_.assign(tile_count + 1, 0u);
+            size_t total = 0;
+            for (size_t c = 0; c < chunk_count_; ++c)
+            {
+                for (uint32_t tile : chunks_[c].bin_tiles) tile_offsets_[tile + 1]++;
+                total += chunks_[c].bin_tiles.size();
+            }
+            for (size_t i = 0; i < tile_count; ++i) tile_offsets_[i + 1] += tile_offsets_[i];
+            tile_refs_.resize(total);
+            tile_cursor_.assign(tile_offsets_.begin(), tile_offsets_.end() - 1);
+            for (size_t c = 0; c < chunk_count_; ++c)
+            {
+                const Chunk& ch = chunks_[c];
+                for (size_t k = 0; k < ch.bin_tiles.size(); ++k)
+                {
+                    tile_refs_[tile_cursor_[ch.bin_tiles[k]]++] = TileRef{(uint32_t)c, ch.bin_tris[k]};
+                }
+            }
+
+            // Хоосон tile-уудыг алгасч, back-end job-ууд зөвхөн ажилтай tile-ийг авна.
+            active_tiles_.clear();
+            for (size_t i = 0; i < tile_count; ++i)
+            {
+                if (tile_offsets_[i + 1] != tile_offsets_[i]) active_tiles_.push_back((uint32_t)i);
+            }
+            stats_.bin_entries = total;
+            stats_.tiles_touched = (uint32_t)active_tiles_.size();
+        }
+
+        void raster_tile(uint32_t tile, RasterizerStats& stats)
+        {
+            const int ts = cfg_.tile_size;
+            const int x0 = (int)(tile % (uint32_t)tiles_x_) * ts;
+            const int y0 = (int)(tile / (uint32_t)tiles_x_) * ts;
+            const int x1 = std::min(W_, x0 + ts) - 1;
+            const int y1 = std::min(H_, y0 + ts) - 1;
+            // Tile нь 8-д зэрэгцсэн тул fast-clear tile-ууд энэ job-д л хамаарна.
+            if (depth_only_) shadow_->resolve_fast_clear_rect(x0, x1, y0, y1);
+            else detail::resolve_target_fast_clear(target_, x0, x1, y0, y1);
+            if (visibility_) vis_ids_.resolve_fast_clear_rect(x0, x1, y0, y1);
+            for (uint32_t k = tile_offsets_[tile]; k < tile_offsets_[tile + 1]; ++k)
+            {
+                const TileRef ref = tile_refs_[k];
+                const Chunk& c = chunks_[ref.chunk];
+                if (depth_only_)
+                {
+                    detail::shade_depth_triangle_rect(c.depth_tris[ref.tri], *shadow_, x0, x1, y0, y1);
+                    continue;
+                }
+                detail::RasterVisibility vis{};
+                if (visibility_) vis = detail::RasterVisibility{&vis_ids_, chunk_tri_base_[ref.chunk] + ref.tri + 1u, false};
+                const DrawRecord& d = draws_[c.draw];
+                d.ops->shade_rect(
+                    d.program,
+                    c.tris[ref.tri],
+                    c.varyings.data() + c.varying_offsets[ref.tri],
+                    d.state,
+                    target_,
+                    W_,
+                    H_,
+                    x0,
+                    x1,
+                    y0,
+                    y1,
+                    &stats,
+                    visibility_ ? &vis : nullptr);
+            }
+        }
+
+        // Chunk бүрийн гурвалжны кадрын хэмжээний эхлэл индекс ба id buffer-ийг бэлтгэнэ.
+        // Tile доторх bin жагсаалт (chunk, tri) дарааллаар эрэмбэлэгдсэн тул id нь өсөх дараалалтай.
+        void begin_visibility()
+        {
+            chunk_tri_base_.resize(chunk_count_);
+            uint32_t base = 0;
+            for (size_t c = 0; c < chunk_count_; ++c)
+            {
+                chunk_tri_base_[c] = base;
+                base += (uint32_t)chunks_[c].tris.size();
+            }
+            if (vis_ids_.w != W_ || vis_ids_.h != H_) vis_ids_.resize(W_, H_, 0u);
+            // Идэвхтэй tile-ууд raster_tile-д, бусад нь flush-ийн төгсгөлд бөглөгдөнө.
+            vis_ids_.clear_fast(0u);
+            if (resolve_scratch_.size() < (size_t)tile_lanes()) resolve_scratch_.resize((size_t)tile_lanes());
+        }
+
+        // Tile-д үлдсэн id-уудыг цуглуулж, bin-ийн зөвхөн тэдгээр гурвалжныг id шүүлттэйгээр
+        // дахин raster хийнэ. Далд гурвалжин fragment shader огт ажиллуулахгүй.
+        void resolve_tile(uint32_t tile, std::vector<uint32_t>& present, RasterizerStats& stats)
+        {
+            const int ts = cfg_.tile_size;
+            const int x0 = (int)(tile % (uint32_t)tiles_x_) * ts;
+            const int y0 = (int)(tile / (uint32_t)tiles_x_) * ts;
+            const int x1 = std::min(W_, x0 + ts) - 1;
+            const int y1 = std::min(H_, y0 + ts) - 1;
+            present.clear();
+            for (int y = y0; y <= y1; ++y)
+            {
+                const uint32_t* row = &vis_ids_.at(x0, y);
+                for (int x = 0; x <= x1 - x0; ++x)
+                {
+                    if (row[x] != 0u && (present.empty() || present.back() != row[x])) present.push_back(row[x]);
+                }
+            }
+            if (present.empty()) return;
+            std::sort(present.begin(), present.end());
+            present.erase(std::unique(present.begin(), present.end()), present.end());
+
+            size_t p = 0;
+            for (uint32_t k = tile_offsets_[tile]; k < tile_offsets_[tile + 1] && p < present.size(); ++k)
+            {
+                const TileRef ref = tile_refs_[k];
+                const uint32_t id = chunk_tri_base_[ref.chunk] + ref.tri + 1u;
+                while (p < present.size() && present[p] < id) ++p;
+                if (p == present.size() || present[p] != id) continue;
+                const Chunk& c = chunks_[ref.chunk];
+                const detail::RasterVisibility vis{&vis_ids_, id, true};
+                const DrawRecord& d = draws_[c.draw];
+                d.ops->shade_rect(
+                    d.program,
+                    c.tris[ref.tri],
+                    c.varyings.data() + c.varying_offsets[ref.tri],
+                    d.state,
+                    target_,
+                    W_,
+                    H_,
+                    x0,
+                    x1,
+                    y0,
+                    y1,
+                    &stats,
+                    &vis);
+            }
+        }
+
+        int tile_lanes() const
+        {
+            const int active = (int)active_tiles_.size();
+            return cfg_.job_system
+                ? std::max(1, std::min(active, (int)std::max<size_t>(1, cfg_.job_system->worker_count())))
+                : 1;
+        }
+
+        void reset_tile_counters()
+        {
+            hiz_tris_rejected_.store(0, std::memory_order_relaxed);
+            hiz_blocks_rejected_.store(0, std::memory_order_relaxed);
+            fragments_passed_.store(0, std::memory_order_relaxed);
+            fs_invocations_.store(0, std::memory_order_relaxed);
+        }
+
+        // fn(tile, lane, local_stats). Tile-ийн ачаалал жигд биш тул worker бүр дараагийн
+        // tile-ийг atomic cursor-оос татна. lane нь [0, tile_lanes()) дахь worker-ийн scratch индекс.
+        template<typename TileFn>
+        void run_tiles(TileFn&& fn)
+        {
+            const int active = (int)active_tiles_.size();
+            if (active == 0) return;
+            const int lanes = tile_lanes();
+            next_tile_.store(0, std::memory_order_relaxed);
+            parallel_for_1d(cfg_.job_system, 0, lanes, 1, cfg_.priority, [&](int lane, int) {
+                RasterizerStats local{};
+                while (true)
+                {
+                    const int i = next_tile_.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= active) break;
+                    fn(active_tiles_[(size_t)i], lane, local);
+                }
+                hiz_tris_rejected_.fetch_add(local.hiz_tris_rejected, std::memory_order_relaxed);
+                hiz_blocks_rejected_.fetch_add(local.hiz_blocks_rejected, std::memory_order_relaxed);
+                fragments_passed_.fetch_add(local.fragments_passed, std::memory_order_relaxed);
+                fs_invocations_.fetch_add(local.fs_invocations, std::memory_order_relaxed);
+            });
+        }
+
+        TiledRasterizerConfig cfg_{};
+        TiledRasterizerStats stats_{};
+        bool depth_only_ = false;
+        RasterizerTarget target_{};
+        RT_ShadowDepth* shadow_ = nullptr;
+        int W_ = 0;
+        int H_ = 0;
+        int tiles_x_ = 0;
+        int tiles_y_ = 0;
+
+        std::vector<DrawRecord> draws_{};
+        size_t draw_count_ = 0;
+        std::vector<Chunk> chunks_{};
+        size_t chunk_count_ = 0;
+        std::vector<uint32_t> tile_offsets_{};
+        std::vector<uint32_t> tile_cursor_{};
+        std::vector<TileRef> tile_refs_{};
+        std::vector<uint32_t> active_tiles_{};
+        std::atomic<int> next_tile_{0};
+        std::atomic<uint64_t> hiz_tris_rejected_{0};
+        std::atomic<uint64_t> hiz_blocks_rejected_{0};
+        std::atomic<uint64_t> fragments_passed_{0};
+        std::atomic<uint64_t> fs_invocations_{0};
+
+        bool visibility_ = false;
+        size_t vis_chunk_count_ = 0;
+        PixelBuffer2D<uint32_t> vis_ids_{};
+        std::vector<uint32_t> chunk_tri_base_{};
+        std::vector<std::vector<uint32_t>> resolve_scratch_{};
+    };
+}
@@ -0,0 +1,617 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "shs/core/context.hpp"
+#include "shs/job/job_arena.hpp"
+#include "shs/job/job_record.hpp"
+#include "shs/job/parallel_for.hpp"
+#include "shs/job/task.hpp"
+#include "shs/job/task_graph.hpp"
+#include "shs/job/thread_pool_job_system.hpp"
+#include "shs/job/work_stealing_deque.hpp"
+#include "shs/job/work_stealing_job_system.hpp"
+#include "shs/passes/pass_light_shafts.hpp"
+
+// Steady-state frame-д heap allocation гарахгүйг шалгах глобал тоолуур.
+static std::atomic<long long> g_heap_allocs{0};
+
+void* operator new(std::size_t n)
+{
+    g_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    bool test_deque_owner_lifo_thief_fifo()
+    {
+        shs::WorkStealingDeque<int> dq{16};
+        for (int i = 0; i < 100; ++i) dq.push(i);
+
+        int v = -1;
+        if (!dq.steal(v) || v != 0) return false;
+        if (!dq.pop(v) || v != 99) return false;
+        if (dq.size_approx() != 98) return false;
+        while (dq.pop(v)) {}
+        if (dq.steal(v)) return false;
+        return true;
+    }
+
+    bool test_work_stealing_runs_every_job()
+    {
+        shs::WorkStealingJobSystem js{4};
+        std::atomic<int> sum{0};
+        for (int i = 0; i < 20000; ++i)
+        {
+            js.enqueue([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); });
+        }
+        js.wait_idle();
+        return sum.load() == 20000;
+    }
+
+    bool test_work_stealing_nested_submit()
+    {
+        // Worker дотроос enqueue хийсэн ажил өөрийн deque-д орж, бусад нь хулгайлах ёстой.
+        shs::WorkStealingJobSystem js{4};
+        std::atomic<int> leaves{0};
+        for (int i = 0; i < 64; ++i)
+        {
+            js.enqueue([&js, &leaves]() {
+                if (!js.on_worker_thread()) return;
+                for (int k = 0; k < 256; ++k)
+                {
+                    js.enqueue([&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        js.wait_idle();
+        return leaves.load() == 64 * 256;
+    }
+
+    bool test_job_record_inline_and_boxed()
+    {
+        int hits = 0;
+        shs::JobRecord small{};
+        small.bind([&hits]() { ++hits; });
+        small.execute();
+        if (small.bound() || hits != 1) return false;
+
+        // Inline буферт багтахгүй callable нь box хийгдэж, execute-ийн дараа чөлөөлөгдөнө.
+        std::array<int, 32> big{};
+        big[31] = 5;
+        shs::JobRecord boxed{};
+        boxed.bind([big, &hits]() { hits += big[31]; });
+        boxed.execute();
+        return !boxed.bound() && hits == 6;
+    }
+
+    bool test_job_arena_reuses_chunks()
+    {
+        shs::JobArena arena{8};
+        for (int frame = 0; frame < 4; ++frame)
+        {
+            arena.reset();
+            shs::JobArenaScope outer{arena};
+            (void)outer.allocate(6);
+            {
+                shs::JobArenaScope inner{arena};
+                (void)inner.allocate(5);
+            }
+            (void)outer.allocate(2);
+        }
+        return arena.chunk_count() == 2;
+    }
+
+    bool test_steady_state_frames_do_not_allocate(shs::IJobSystem& js, const char* name)
+    {
+        std::vector<float> buf(1920 * 64, 0.0f);
+        auto frame = [&js, &buf]() {
+            // Frame доторх raster/post pass-уудыг дууриана.
+            for (int pass = 0; pass < 12; ++pass)
+            {
+                shs::parallel_for_1d(&js, 0, (int)buf.size(), 256, [&buf, pass](int b, int e) {
+                    for (int i = b; i < e; ++i) buf[(size_t)i] += (float)pass;
+                });
+            }
+        };
+
+        for (int i = 0; i < 4; ++i) frame();
+        const long long before = g_heap_allocs.load();
+        for (int i = 0; i < 32; ++i) frame();
+        const long long allocs = g_heap_allocs.load() - before;
+        if (allocs != 0)
+        {
+            std::fprintf(stderr, "[job-tests] steady-state frames on %s allocated %lld times\n", name, allocs);
+            return false;
+        }
+        return true;
+    }
+
+    bool test_light_shafts_frames_do_not_allocate(shs::IJobSystem& js, const char* name)
+    {
+        // Нар дэлгэцийн голд проекцлогдох scene: luma → march → resolve бүх үе шат ажиллана.
+        shs::Scene scene{};
+        scene.cam.pos = glm::vec3(0.0f);
+        scene.cam.viewproj = glm::mat4(1.0f);
+        scene.sun.dir_ws = glm::vec3(-0.002f, -0.003f, -0.001f);
+        shs::FrameParams fp{};
+        fp.pass.light_shafts.enable = true;
+        fp.pass.light_shafts.steps = 8;
+
+        shs::RT_ColorLDR a{160, 90};
+        shs::RT_ColorLDR b{160, 90};
+        shs::RTRegistry rtr{};
+        const shs::RTHandle h_a = rtr.reg<shs::RTHandle>(&a);
+        const shs::RTHandle h_b = rtr.reg<shs::RTHandle>(&b);
+        shs::Context ctx{};
+        ctx.job_system = &js;
+        shs::PassLightShafts shafts{};
+        const shs::PassLightShafts::Inputs in_place{&scene, &fp, &rtr, h_a, h_a, shs::RTHandle{}, shs::RTHandle{}};
+        const shs::PassLightShafts::Inputs to_b{&scene, &fp, &rtr, h_a, h_b, shs::RTHandle{}, shs::RTHandle{}};
+
+        auto frame = [&]() {
+            shafts.execute(ctx, in_place);
+            shafts.execute(ctx, to_b);
+        };
+        for (int i = 0; i < 4; ++i) frame();
+        long long before = g_heap_allocs.load();
+        for (int i = 0; i < 16; ++i) frame();
+        const long long sync_allocs = g_heap_allocs.load() - before;
+
+        // Coroutine зам: chunk бичлэгүүд pass-ийн arena-аас тул дуудлага бүрд зөвхөн
+        // execute_async болон sync_wait-ийн хоёр frame (үе шатын тооноос үл хамаарна).
+        auto async_frame = [&]() {
+            shs::sync_wait(&js, shafts.execute_async(ctx, in_place), shs::JobPriority::FrameCritical);
+        };
+        for (int i = 0; i < 4; ++i) async_frame();
+        before = g_heap_allocs.load();
+        for (int i = 0; i < 16; ++i) async_frame();
+        const long long async_allocs = g_heap_allocs.load() - before;
+
+        if (sync_allocs != 0 || async_allocs > 2 * 16)
+        {
+            std::fprintf(stderr, "[job-tests] light shafts frames on %s allocated %lld (sync) / %lld (async) times\n",
+                name, sync_allocs, async_allocs);
+            return false;
+        }
+        return true;
+    }
+
+    bool test_nested_parallel_for_does_not_deadlock(shs::IJobSystem& js)
+    {
+        // Бүх worker outer chunk дотроо inner parallel_for дээр хүлээх үед help горим
+        // дараалалд байгаа inner chunk-уудыг өөрсдөө гүйцэтгэж урагшилна.
+        std::vector<std::atomic<int>> rows(64);
+        shs::parallel_for_1d(&js, 0, (int)rows.size(), 1, [&js, &rows](int rb, int re) {
+            for (int r = rb; r < re; ++r)
+            {
+                shs::parallel_for_1d(&js, 0, 4096, 64, [&rows, r](int b, int e) {
+                    rows[(size_t)r].fetch_add(e - b, std::memory_order_relaxed);
+                });
+            }
+        });
+        for (const auto& r : rows)
+        {
+            if (r.load() != 4096) return false;
+        }
+        return true;
+    }
+
+    bool test_wait_group_parks_until_done()
+    {
+        shs::WaitGroup wg{};
+        std::atomic<int> value{0};
+        wg.add(2);
+        std::thread a([&]() { value.fetch_add(1); wg.done(); });
+        std::thread b([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            value.fetch_add(1);
+            wg.done();
+        });
+        wg.wait();
+        const bool ok = value.load() == 2 && wg.is_done();
+        a.join();
+        b.join();
+        return ok;
+    }
+
+    bool test_task_graph_respects_dependencies(shs::IJobSystem& js)
+    {
+        // A -> (B, C) -> D diamond. B/C зэрэг явж болох ч D үргэлж хамгийн сүүлд.
+        std::atomic<int> seq{0};
+        std::array<std::atomic<int>, 4> at{};
+        shs::TaskGraph g{};
+        const auto a = g.add_node([&]() { at[0].store(seq.fetch_add(1)); }, "A");
+        const auto b = g.add_node([&]() { at[1].store(seq.fetch_add(1)); }, "B");
+        const auto c = g.add_node([&]() { at[2].store(seq.fetch_add(1)); }, "C");
+        const auto d = g.add_node([&]() { at[3].store(seq.fetch_add(1)); }, "D");
+        g.add_edge(a, b);
+        g.add_edge(a, c);
+        g.add_edge(b, d);
+        g.add_edge(c, d);
+        if (!g.compile()) return false;
+
+        for (int frame = 0; frame < 200; ++frame)
+        {
+            seq.store(0);
+            if (!g.run(&js)) return false;
+            if (seq.load() != 4) return false;
+            if (at[0].load() != 0 || at[3].load() != 3) return false;
+            if (g.last_stats().nodes_executed != 4) return false;
+        }
+        return true;
+    }
+
+    bool test_task_graph_rejects_cycle_and_reruns_without_alloc(shs::IJobSystem& js)
+    {
+        shs::TaskGraph cyclic{};
+        std::atomic<int> cyclic_runs{0};
+        const auto x = cyclic.add_node([&cyclic_runs]() { cyclic_runs.fetch_add(1); });
+        const auto y = cyclic.add_node([&cyclic_runs]() { cyclic_runs.fetch_add(1); });
+        const auto z = cyclic.add_node([&cyclic_runs]() { cyclic_runs.fetch_add(1); });
+        cyclic.add_edge(x, y);
+        cyclic.add_edge(y, x);
+        cyclic.add_edge(y, z);
+        if (cyclic.compile()) return false;
+        // Cycle-тэй граф dependency-гээ зөрчин index дарааллаар ажиллах ёсгүй.
+        if (cyclic.run(&js) || cyclic.run(nullptr) || cyclic_runs.load() != 0) return false;
+
+        // Cull -> Record(x8) -> Submit хэлбэрийн граф: compile хийсний дараа allocation-гүй.
+        std::atomic<int> work{0};
+        shs::TaskGraph g{};
+        const auto cull = g.add_node([&work]() { work.fetch_add(1); }, "cull");
+        const auto submit = g.add_node([&work]() { work.fetch_add(1); }, "submit");
+        for (int i = 0; i < 8; ++i)
+        {
+            const auto rec = g.add_node([&work]() { work.fetch_add(1); }, "record");
+            g.add_edge(cull, rec);
+            g.add_edge(rec, submit);
+        }
+        if (!g.compile()) return false;
+
+        for (int i = 0; i < 4; ++i) (void)g.run(&js);
+        const long long before = g_heap_allocs.load();
+        for (int i = 0; i < 64; ++i) (void)g.run(&js);
+        const long long allocs = g_heap_allocs.load() - before;
+        if (allocs != 0)
+        {
+            std::fprintf(stderr, "[job-tests] task graph re-run allocated %lld times\n", allocs);
+            return false;
+        }
+        return work.load() == 68 * 10;
+    }
+
+    shs::Task<int> coro_answer(shs::IJobSystem* js, int* steps)
+    {
+        co_await shs::schedule_on(js);
+        ++*steps;
+        const int a = co_await shs::run_async(js, []() { return 20; });
+        co_return a + 22;
+    }
+
+    shs::Task<long long> coro_two_step_pass(shs::IJobSystem* js, std::vector<int>& data)
+    {
+        // Олон алхамтай pass: эхний алхмын бүх chunk дуусахад л хоёр дахь нь эхэлнэ.
+        shs::JobArena records{};
+        co_await shs::parallel_for_1d_async(js, records, 0, (int)data.size(), 256, [&data](int b, int e) {
+            for (int i = b; i < e; ++i) data[(size_t)i] = i;
+        });
+        std::atomic<long long> sum{0};
+        co_await shs::parallel_for_1d_async(js, records, 0, (int)data.size(), 256, [&data, &sum](int b, int e) {
+            long long local = 0;
+            for (int i = b; i < e; ++i) local += data[(size_t)i];
+            sum.fetch_add(local, std::memory_order_relaxed);
+        });
+        co_return sum.load();
+    }
+
+    shs::Task<void> coro_throws()
+    {
+        throw std::runtime_error("boom");
+        co_return;
+    }
+
+    bool test_task_schedule_and_job_await(shs::IJobSystem& js)
+    {
+        // sync_wait-ийн дуудагч ч тусалдаг тул аль thread дээр үргэлжлэхийг шалгахгүй.
+        int steps = 0;
+        const int v = shs::sync_wait(&js, coro_answer(&js, &steps));
+        if (v != 42 || steps != 1) return false;
+        if (shs::sync_wait(nullptr, coro_answer(nullptr, &steps)) != 42 || steps != 2) return false;
+
+        std::vector<int> data(50000, 0);
+        const long long n = (long long)data.size();
+        if (shs::sync_wait(&js, coro_two_step_pass(&js, data)) != n * (n - 1) / 2) return false;
+
+        bool caught = false;
+        try
+        {
+            shs::sync_wait(&js, coro_throws());
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        return caught;
+    }
+
+    shs::Task<void> coro_gate_waiter(shs::IJobSystem* js, shs::WaitGroup& gate, std::atomic<int>& finished)
+    {
+        co_await shs::schedule_on(js);
+        co_await shs::wait_for(js, gate);
+        finished.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    bool test_task_wait_group_does_not_block_workers()
+    {
+        // 2 worker дээр 8 coroutine gate хүлээнэ. Blocking wait байсан бол gate-ийг
+        // нээх job-ууд worker олохгүй гацна; coroutine зогсоход worker чөлөөлөгдөнө.
+        shs::ThreadPoolJobSystem js{2};
+        std::array<shs::WaitGroup, 8> gates{};
+        std::atomic<int> finished{0};
+        for (auto& g : gates)
+        {
+            g.add(1);
+            shs::start_detached(coro_gate_waiter(&js, g, finished));
+        }
+        for (auto& g : gates)
+        {
+            js.enqueue([&g]() { g.done(); });
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (finished.load(std::memory_order_acquire) != (int)gates.size())
+        {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        js.wait_idle();
+        return true;
+    }
+
+    // Ганц worker-ийг gate ажлаар түгжээд дараалалд lane-уудыг дүүргэнэ.
+    template<typename Fill>
+    void with_blocked_worker(shs::IJobSystem& js, Fill&& fill)
+    {
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        js.enqueue([&]() {
+            started.store(true);
+            while (!release.load()) std::this_thread::yield();
+        });
+        while (!started.load()) std::this_thread::yield();
+        fill();
+        release.store(true);
+        js.wait_idle();
+    }
+
+    bool test_priority_lanes_prefer_frame_critical(shs::IJobSystem& js)
+    {
+        std::vector<int> order{};
+        order.reserve(16);
+        with_blocked_worker(js, [&]() {
+            for (int i = 0; i < 8; ++i) js.enqueue([&order]() { order.push_back(2); }, shs::JobPriority::Background);
+            for (int i = 0; i < 8; ++i) js.enqueue([&order]() { order.push_back(0); }, shs::JobPriority::FrameCritical);
+        });
+        if (order.size() != 16) return false;
+        // 8 дараалсан сонголтын дунд starvation tick хамгийн ихдээ нэг удаа тохионо.
+        int critical_first = 0;
+        for (size_t i = 0; i < 8; ++i) critical_first += order[i] == 0 ? 1 : 0;
+        return critical_first >= 7;
+    }
+
+    bool test_background_lane_is_not_starved(shs::IJobSystem& js)
+    {
+        // Frame-critical ажил өөрийгөө дахин илгээж тасралтгүй урсгал үүсгэнэ.
+        constexpr int k_background = 20;
+        constexpr int k_cap = 100000;
+        std::atomic<int> bg_done{0};
+        std::atomic<int> crit_runs{0};
+        std::function<void()> crit{};
+        crit = [&]() {
+            if (crit_runs.fetch_add(1) < k_cap && bg_done.load() < k_background)
+            {
+                js.enqueue(crit, shs::JobPriority::FrameCritical);
+            }
+        };
+        with_blocked_worker(js, [&]() {
+            for (int i = 0; i < k_background; ++i)
+            {
+                js.enqueue([&bg_done]() { bg_done.fetch_add(1); }, shs::JobPriority::Background);
+            }
+            js.enqueue(crit, shs::JobPriority::FrameCritical);
+        });
+        return bg_done.load() == k_background && crit_runs.load() < k_cap;
+    }
+
+    bool test_frame_critical_wait_skips_background(shs::IJobSystem& js)
+    {
+        // Worker хаагдсан үед дуудагч parallel_for-ийн chunk-уудыг өөрөө гүйцэтгэнэ. Дараалалд
+        // хүлээж буй Background ажлыг (starvation tick тохиосон ч) хэзээ ч авах ёсгүй.
+        std::atomic<bool> bg_ran{false};
+        bool bg_ran_during_wait = false;
+        int covered = 0;
+        with_blocked_worker(js, [&]() {
+            js.enqueue([&bg_ran]() { bg_ran.store(true); }, shs::JobPriority::Background);
+            for (int frame = 0; frame < 4 * (int)shs::k_job_priority_count * (int)shs::k_job_starvation_interval; ++frame)
+            {
+                std::atomic<int> sum{0};
+                shs::parallel_for_1d(&js, 0, 64, 4, [&sum](int b, int e) { sum.fetch_add(e - b); });
+                covered += sum.load() == 64 ? 1 : 0;
+            }
+            bg_ran_during_wait = bg_ran.load();
+        });
+        return !bg_ran_during_wait && bg_ran.load() && covered == 4 * (int)shs::k_job_priority_count * (int)shs::k_job_starvation_interval;
+    }
+
+    shs::Task<long long> coro_frame_critical_chain(shs::IJobSystem* js, shs::JobArena& records, std::vector<int>& data)
+    {
+        co_await shs::parallel_for_1d_async(js, records, 0, (int)data.size(), 64, [&data](int b, int e) {
+            for (int i = b; i < e; ++i) data[(size_t)i] = i;
+        }, shs::JobPriority::FrameCritical);
+        std::atomic<long long> sum{0};
+        co_await shs::parallel_for_1d_async(js, records, 0, (int)data.size(), 64, [&data, &sum](int b, int e) {
+            long long local = 0;
+            for (int i = b; i < e; ++i) local += data[(size_t)i];
+            sum.fetch_add(local, std::memory_order_relaxed);
+        }, shs::JobPriority::FrameCritical);
+        co_return sum.load();
+    }
+
+    bool test_frame_critical_continuation_skips_normal_lane(shs::IJobSystem& js)
+    {
+        // Ганц worker хаагдаж, Normal lane дүүрэн байхад FrameCritical sync_wait-ийн үе шат хоорондын
+        // continuation FrameCritical lane-д орж, хүлээгч өөрөө гүйцэтгэх ёстой. Normal lane-д
+        // орсон бол worker суллагдах (deadline) хүртэл гацна.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
+        js.enqueue([&]() {
+            started.store(true);
+            while (!release.load() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        });
+        while (!started.load()) std::this_thread::yield();
+
+        std::atomic<int> normal_ran{0};
+        for (int i = 0; i < 16; ++i) js.enqueue([&normal_ran]() { normal_ran.fetch_add(1); }, shs::JobPriority::Normal);
+
+        shs::JobArena records{};
+        std::vector<int> data(4096, 0);
+        const long long sum = shs::sync_wait(&js, coro_frame_critical_chain(&js, records, data), shs::JobPriority::FrameCritical);
+        const bool before_release = std::chrono::steady_clock::now() < deadline && normal_ran.load() == 0;
+
+        release.store(true);
+        js.wait_idle();
+        const long long n = (long long)data.size();
+        return before_release && sum == n * (n - 1) / 2 && normal_ran.load() == 16;
+    }
+
+    bool test_full_injection_queue_spills_to_overflow()
+    {
+        // Injection дараалал дүүрсэн үед ч job илгээгч thread дээр ажиллахгүй, overflow-оор дамжина.
+        shs::WorkStealingJobSystemConfig cfg{};
+        cfg.injection_capacity = 4;
+        shs::WorkStealingJobSystem js{1, cfg};
+        const std::thread::id producer = std::this_thread::get_id();
+        std::atomic<int> ran{0};
+        std::atomic<int> ran_inline{0};
+        std::array<shs::JobRecord, 32> batch{};
+        with_blocked_worker(js, [&]() {
+            for (int i = 0; i < 32; ++i)
+            {
+                js.enqueue([&, producer]() {
+                    ran.fetch_add(1);
+                    if (std::this_thread::get_id() == producer) ran_inline.fetch_add(1);
+                });
+            }
+            for (auto& r : batch)
+            {
+                r.bind([&, producer]() {
+                    ran.fetch_add(1);
+                    if (std::this_thread::get_id() == producer) ran_inline.fetch_add(1);
+                });
+            }
+            js.enqueue_batch(batch.data(), batch.size());
+            // Worker түгжээтэй тул хэн ч ажиллуулаагүй байх ёстой.
+            if (ran.load() != 0) ran_inline.fetch_add(1000);
+        });
+        return ran.load() == 64 && ran_inline.load() == 0 && js.overflow_count() >= 56;
+    }
+
+    bool test_parallel_for_covers_range(shs::IJobSystem& js)
+    {
+        std::vector<int> hits(100003, 0);
+        shs::parallel_for_1d(&js, 0, (int)hits.size(), 64, [&hits](int b, int e) {
+            for (int i = b; i < e; ++i) hits[(size_t)i] += 1;
+        });
+        for (int h : hits)
+        {
+            if (h != 1) return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    shs::ThreadPoolJobSystem pool{4};
+    shs::WorkStealingJobSystem stealing{4};
+
+    const bool ok_deque = test_deque_owner_lifo_thief_fifo();
+    const bool ok_all_jobs = test_work_stealing_runs_every_job();
+    const bool ok_nested = test_work_stealing_nested_submit();
+    const bool ok_pf_pool = test_parallel_for_covers_range(pool);
+    const bool ok_pf_stealing = test_parallel_for_covers_range(stealing);
+    const bool ok_nested_pool = test_nested_parallel_for_does_not_deadlock(pool);
+    const bool ok_nested_stealing = test_nested_parallel_for_does_not_deadlock(stealing);
+    const bool ok_wait_group = test_wait_group_parks_until_done();
+    const bool ok_record = test_job_record_inline_and_boxed();
+    const bool ok_arena = test_job_arena_reuses_chunks();
+    const bool ok_no_alloc = test_steady_state_frames_do_not_allocate(pool, "thread pool")
+        && test_steady_state_frames_do_not_allocate(stealing, "work-stealing")
+        && test_light_shafts_frames_do_not_allocate(pool, "thread pool")
+        && test_light_shafts_frames_do_not_allocate(stealing, "work-stealing");
+    const bool ok_graph_pool = test_task_graph_respects_dependencies(pool);
+    const bool ok_graph_stealing = test_task_graph_respects_dependencies(stealing);
+    const bool ok_graph_reuse = test_task_graph_rejects_cycle_and_reruns_without_alloc(stealing);
+    const bool ok_coro = test_task_schedule_and_job_await(stealing);
+    const bool ok_coro_wg = test_task_wait_group_does_not_block_workers();
+    const bool ok_overflow = test_full_injection_queue_spills_to_overflow();
+
+    shs::ThreadPoolJobSystem pool_single{1};
+    shs::WorkStealingJobSystem stealing_single{1};
+    const bool ok_prio_pool = test_priority_lanes_prefer_frame_critical(pool_single)
+        && test_background_lane_is_not_starved(pool_single)
+        && test_frame_critical_wait_skips_background(pool_single)
+        && test_frame_critical_continuation_skips_normal_lane(pool_single);
+    const bool ok_prio_stealing = test_priority_lanes_prefer_frame_critical(stealing_single)
+        && test_background_lane_is_not_starved(stealing_single)
+        && test_frame_critical_wait_skips_background(stealing_single)
+        && test_frame_critical_continuation_skips_normal_lane(stealing_single);
+
+    if (!ok_deque) std::fprintf(stderr, "[job-tests] chase-lev deque ordering failed\n");
+    if (!ok_all_jobs) std::fprintf(stderr, "[job-tests] work-stealing lost jobs\n");
+    if (!ok_nested) std::fprintf(stderr, "[job-tests] work-stealing nested submit failed\n");
+    if (!ok_pf_pool) std::fprintf(stderr, "[job-tests] parallel_for_1d on thread pool failed\n");
+    if (!ok_pf_stealing) std::fprintf(stderr, "[job-tests] parallel_for_1d on work-stealing failed\n");
+    if (!ok_nested_pool) std::fprintf(stderr, "[job-tests] nested parallel_for on thread pool failed\n");
+    if (!ok_nested_stealing) std::fprintf(stderr, "[job-tests] nested parallel_for on work-stealing failed\n");
+    if (!ok_wait_group) std::fprintf(stderr, "[job-tests] wait group park/wake failed\n");
+    if (!ok_record) std::fprintf(stderr, "[job-tests] job record inline/boxed binding failed\n");
+    if (!ok_arena) std::fprintf(stderr, "[job-tests] job arena chunk reuse failed\n");
+    if (!ok_no_alloc) std::fprintf(stderr, "[job-tests] steady-state frame allocation check failed\n");
+    if (!ok_graph_pool) std::fprintf(stderr, "[job-tests] task graph ordering on thread pool failed\n");
+    if (!ok_graph_stealing) std::fprintf(stderr, "[job-tests] task graph ordering on work-stealing failed\n");
+    if (!ok_graph_reuse) std::fprintf(stderr, "[job-tests] task graph cycle/reuse check failed\n");
+    if (!ok_coro) std::fprintf(stderr, "[job-tests] coroutine schedule/job await failed\n");
+    if (!ok_coro_wg) std::fprintf(stderr, "[job-tests] coroutine wait group await failed\n");
+    if (!ok_overflow) std::fprintf(stderr, "[job-tests] full injection queue ran jobs inline or lost them\n");
+    if (!ok_prio_pool) std::fprintf(stderr, "[job-tests] priority lanes on thread pool failed\n");
+    if (!ok_prio_stealing) std::fprintf(stderr, "[job-tests] priority lanes on work-stealing failed\n");
+
+    if (!(ok_deque && ok_all_jobs && ok_nested && ok_pf_pool && ok_pf_stealing
+        && ok_nested_pool && ok_nested_stealing && ok_wait_group && ok_record && ok_arena && ok_no_alloc
+        && ok_graph_pool && ok_graph_stealing && ok_graph_reuse && ok_coro && ok_coro_wg
+        && ok_overflow && ok_prio_pool && ok_prio_stealing)) return 1;
+    std::fprintf(stderr, "[job-tests] all tests passed\n");
+    return 0;
+}
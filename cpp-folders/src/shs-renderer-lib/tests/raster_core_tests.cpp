@@ -0,0 +1,2304 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "shs/core/context.hpp"
+#include "shs/gfx/pixel_layout_convert.hpp"
+#include "shs/gfx/rt_fast_clear_resolve.hpp"
+#include "shs/gfx/rt_registry.hpp"
+#include "shs/job/work_stealing_job_system.hpp"
+#include "shs/lighting/shadow_sample.hpp"
+#include "shs/passes/pass_light_shafts.hpp"
+#include "shs/passes/pass_motion_blur.hpp"
+#include "shs/passes/pass_post_stack.hpp"
+#include "shs/passes/pass_tonemap.hpp"
+#include "shs/passes/pass_upscale.hpp"
+#include "shs/pipeline/frame_budget_governor.hpp"
+#include "shs/pipeline/pluggable_pipeline.hpp"
+#include "shs/resources/texture_bc.hpp"
+#include "shs/resources/texture_mips.hpp"
+#include "shs/shader/builtin_shaders.hpp"
+#include "shs/shader/shader_permutations.hpp"
+#include "shs/shader/simd_lanes.hpp"
+#include "shs/sw_render/edge_raster.hpp"
+#include "shs/sw_render/rasterizer.hpp"
+#include "shs/sw_render/tiled_rasterizer.hpp"
+
+// CMake xsimd олсон үед (SHS_RENDERER_HAS_XSIMD) lane тестүүд xsimd::batch замыг ажиллуулах ёстой.
+#if defined(SHS_RENDERER_TESTS_EXPECT_XSIMD) && SHS_RENDERER_TESTS_EXPECT_XSIMD
+#if !(defined(SHS_HAS_XSIMD) && SHS_HAS_XSIMD)
+#error "xsimd build: SHS_HAS_XSIMD must reach shs_renderer_raster_tests"
+#endif
+static_assert(std::is_same_v<shs::simd::f32, xsimd::batch<float>>, "lane tests must exercise xsimd::batch<float>");
+#endif
+
+namespace
+{
+    constexpr int k_w = 157;
+    constexpr int k_h = 93;
+
+    struct RasterBlockStatsGuard
+    {
+        shs::RasterBlockStats stats{};
+        bool bad_bc = false;
+    };
+
+    bool approx_eq(float a, float b, float eps = 1e-5f)
+    {
+        return std::abs(a - b) <= eps;
+    }
+
+    // Давхцсан, near plane огтолсон, дэлгэцээс гарсан гурвалжнуудтай тогтмол seed-тэй mesh.
+    shs::MeshData make_soup(uint32_t seed, int tri_count)
+    {
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / (float)(1u << 24);
+        };
+        shs::MeshData m{};
+        for (int t = 0; t < tri_count; ++t)
+        {
+            const glm::vec3 c{next() * 8.0f - 4.0f, next() * 6.0f - 3.0f, next() * 10.0f - 7.0f};
+            for (int k = 0; k < 3; ++k)
+            {
+                m.positions.push_back(c + glm::vec3(next() * 3.0f - 1.5f, next() * 3.0f - 1.5f, next() * 2.0f - 1.0f));
+                m.normals.push_back(glm::normalize(glm::vec3(next() - 0.5f, 1.0f, next() - 0.5f)));
+                m.uvs.push_back(glm::vec2(next(), next()));
+                m.indices.push_back((uint32_t)m.indices.size());
+            }
+        }
+        return m;
+    }
+
+    shs::ShaderProgram make_test_program()
+    {
+        shs::ShaderProgram p{};
+        p.vs = [](const shs::ShaderVertex& v, const shs::ShaderUniforms& u) {
+            shs::VertexOut o{};
+            const glm::vec4 wp = u.model * glm::vec4(v.position, 1.0f);
+            o.clip = u.viewproj * wp;
+            o.world_pos = glm::vec3(wp);
+            o.normal_ws = v.normal;
+            o.uv = v.uv;
+            shs::set_varying(o, shs::VaryingSemantic::Color0, glm::vec4(glm::fract(v.position * 0.37f), 1.0f));
+            return o;
+        };
+        p.fs = [](const shs::FragmentIn& in, const shs::ShaderUniforms& u) {
+            shs::FragmentOut o{};
+            const glm::vec4 c = shs::get_varying(in, shs::VaryingSemantic::Color0);
+            o.color = shs::ColorF{c.x * u.base_color.x, c.y + in.uv.x * 0.1f, c.z + in.depth01, 1.0f};
+            o.discard = (in.px + in.py) % 17 == 0;
+            return o;
+        };
+        return p;
+    }
+
+    // make_test_program-тай ижил shader-ийг StaticShaderProgram хэлбэрээр.
+    struct TestStaticProgram
+    {
+        float color_scale = 1.0f;
+
+        static shs::VertexOut vs(const shs::ShaderVertex& v, const shs::ShaderUniforms& u)
+        {
+            shs::VertexOut o{};
+            const glm::vec4 wp = u.model * glm::vec4(v.position, 1.0f);
+            o.clip = u.viewproj * wp;
+            o.world_pos = glm::vec3(wp);
+            o.normal_ws = v.normal;
+            o.uv = v.uv;
+            shs::set_varying(o, shs::VaryingSemantic::Color0, glm::vec4(glm::fract(v.position * 0.37f), 1.0f));
+            return o;
+        }
+
+        shs::FragmentOut fs(const shs::FragmentIn& in, const shs::ShaderUniforms& u) const
+        {
+            shs::FragmentOut o{};
+            const glm::vec4 c = shs::get_varying(in, shs::VaryingSemantic::Color0);
+            o.color = shs::ColorF{c.x * u.base_color.x * color_scale, c.y + in.uv.x * 0.1f, c.z + in.depth01, 1.0f};
+            o.discard = (in.px + in.py) % 17 == 0;
+            return o;
+        }
+    };
+    static_assert(shs::StaticShaderProgram<TestStaticProgram>);
+    static_assert(shs::StaticShaderProgram<shs::ShaderProgram>);
+    static_assert(shs::StaticShaderProgram<shs::PbrMetallicRoughnessProgram>);
+
+    // uv болон rasterizer-ийн гаргасан duv/dx-ийг өнгөнд бичнэ (scalar ба lane зам).
+    struct UvDerivativeProgram
+    {
+        static void shade_lanes(const shs::FragmentLanesIn& fin, const shs::ShaderUniforms&, shs::FragmentLanesOut& out)
+        {
+            out.color = shs::simd::Vec3Lanes(fin.uv.x, fin.uv.y, fin.duv_dx.x);
+            out.alpha = fin.duv_dy.y;
+        }
+        static constexpr shs::FragmentLanesShaderFn fs_lanes = &shade_lanes;
+
+        static shs::VertexOut vs(const shs::ShaderVertex& v, const shs::ShaderUniforms& u)
+        {
+            shs::VertexOut o{};
+            o.clip = u.viewproj * u.model * glm::vec4(v.position, 1.0f);
+            o.uv = v.uv;
+            return o;
+        }
+
+        static shs::FragmentOut fs(const shs::FragmentIn& fin, const shs::ShaderUniforms&)
+        {
+            shs::FragmentOut o{};
+            o.color = shs::ColorF{fin.uv.x, fin.uv.y, fin.duv_dx.x, fin.duv_dy.y};
+            return o;
+        }
+    };
+
+    struct TestDraw
+    {
+        shs::MeshData mesh{};
+        shs::ShaderUniforms uniforms{};
+    };
+
+    std::vector<TestDraw> make_draws()
+    {
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.5f, 4.0f), glm::vec3(0.0f, 0.0f, -2.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)k_w / (float)k_h, 0.5f, 40.0f);
+        std::vector<TestDraw> draws{};
+        for (int i = 0; i < 5; ++i)
+        {
+            TestDraw d{};
+            d.mesh = make_soup(17u + (uint32_t)i * 31u, 40 + i * 25);
+            d.uniforms.model = glm::translate(glm::mat4(1.0f), glm::vec3(0.3f * (float)i, 0.0f, -0.2f * (float)i));
+            d.uniforms.viewproj = proj * view;
+            d.uniforms.prev_model = glm::translate(d.uniforms.model, glm::vec3(0.05f, 0.0f, 0.0f));
+            d.uniforms.prev_viewproj = d.uniforms.viewproj;
+            d.uniforms.base_color = glm::vec3(0.5f + 0.1f * (float)i);
+            d.uniforms.enable_motion_vectors = true;
+            draws.push_back(std::move(d));
+        }
+        return draws;
+    }
+
+    // Нэг цэгийг тойрсон fan болон дэлгэцээс хэтэрсэн (fallback замын) гурвалжнууд
+    // пиксел бүрийг яг нэг удаа бүрхэх ёстой (top-left fill rule).
+    bool test_edge_raster_is_watertight()
+    {
+        std::vector<int> hits((size_t)k_w * (size_t)k_h, 0);
+        RasterBlockStatsGuard guard{};
+        auto draw = [&](const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+            shs::RasterEdgeSetup e{};
+            if (!shs::setup_raster_edges(a, b, c, e)) return;
+            shs::rasterize_edges(e, 0, k_w - 1, 0, k_h - 1, [&](int x, int y, const glm::vec3& bc) {
+                if (bc.x < -1e-4f || bc.y < -1e-4f || bc.z < -1e-4f) guard.bad_bc = true;
+                hits[(size_t)y * (size_t)k_w + (size_t)x]++;
+            }, &guard.stats);
+        };
+
+        const glm::vec2 center{61.37f, 40.5f};
+        const glm::vec2 ring[] = {
+            {-3.0f, -2.0f}, {40.25f, -2.0f}, {80.0f, -2.0f}, {(float)k_w + 2.0f, -2.0f},
+            {(float)k_w + 2.0f, 47.0f}, {(float)k_w + 2.0f, (float)k_h + 2.0f}, {100.5f, (float)k_h + 2.0f},
+            {12.0f, (float)k_h + 2.0f}, {-3.0f, (float)k_h + 2.0f}, {-3.0f, 30.0f}
+        };
+        const size_t n = sizeof(ring) / sizeof(ring[0]);
+        for (size_t i = 0; i < n; ++i)
+        {
+            // Ээлжлэн эргэлтийн чиглэлийг сольж хоёр winding-ийг хоёуланг нь шалгана.
+            if (i % 2 == 0) draw(center, ring[i], ring[(i + 1) % n]);
+            else draw(center, ring[(i + 1) % n], ring[i]);
+        }
+        for (int h : hits)
+        {
+            if (h != 1) return false;
+        }
+        if (guard.bad_bc || guard.stats.blocks_accepted == 0 || guard.stats.blocks_partial == 0) return false;
+
+        // Guard band-аас хэтэрсэн координаттай хоёр гурвалжин (double fallback зам).
+        std::fill(hits.begin(), hits.end(), 0);
+        const glm::vec2 big0{-1.0e6f, -1.0e6f};
+        const glm::vec2 big1{1.0e6f, -1.0e6f};
+        const glm::vec2 big2{1.0e6f, 1.0e6f};
+        const glm::vec2 big3{-1.0e6f, 1.0e6f};
+        draw(big0, big1, big2);
+        draw(big0, big2, big3);
+        for (int h : hits)
+        {
+            if (h != 1) return false;
+        }
+        return !guard.bad_bc;
+    }
+
+    bool test_tiled_matches_immediate(shs::IJobSystem& js)
+    {
+        const std::vector<TestDraw> draws = make_draws();
+        const shs::ShaderProgram prog = make_test_program();
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+
+        shs::RT_ColorHDR ref_hdr{k_w, k_h};
+        shs::RT_ColorDepthMotion ref_dm{k_w, k_h, 0.5f, 40.0f};
+        shs::RasterizerStats ref_stats{};
+        for (const TestDraw& d : draws)
+        {
+            const shs::RasterizerStats s = shs::rasterize_mesh(d.mesh, prog, d.uniforms, shs::RasterizerTarget{&ref_hdr, &ref_dm}, cfg);
+            ref_stats.tri_input += s.tri_input;
+            ref_stats.tri_after_clip += s.tri_after_clip;
+            ref_stats.tri_raster += s.tri_raster;
+        }
+        if (ref_stats.tri_raster == 0 || ref_stats.tri_after_clip == ref_stats.tri_input) return false;
+
+        shs::TiledRasterizer tiled{};
+        shs::RT_ColorHDR hdr{k_w, k_h};
+        shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+        shs::TiledRasterizerConfig tcfg{};
+        tcfg.job_system = &js;
+        tcfg.tile_size = 16;
+        tcfg.front_end_tris_per_job = 7;
+
+        // Хоёр удаа ажиллуулж дахин ашиглагдсан буфертэй үр дүн ижил эсэхийг шалгана.
+        for (int frame = 0; frame < 2; ++frame)
+        {
+            hdr.clear();
+            dm.clear_all();
+            tiled.begin(shs::RasterizerTarget{&hdr, &dm}, tcfg);
+            for (const TestDraw& d : draws) tiled.submit(d.mesh, prog, d.uniforms, cfg);
+            const shs::RasterizerStats s = tiled.flush();
+            if (s.tri_input != ref_stats.tri_input || s.tri_raster != ref_stats.tri_raster) return false;
+            if (tiled.last_stats().tiles_touched == 0) return false;
+
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = hdr.color.at(x, y);
+                    const shs::ColorF b = ref_hdr.color.at(x, y);
+                    if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+                    if (!approx_eq(dm.depth.at(x, y), ref_dm.depth.at(x, y))) return false;
+                    if (!approx_eq(dm.motion.at(x, y).x, ref_dm.motion.at(x, y).x, 1e-3f)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Static program-ийг шууд болон ShaderProgram adapter-аар дамжуулахад зураг ижил байх ёстой.
+    // Tile горимд хоёр төрлийн program-тэй draw-уудыг холиж submit хийнэ.
+    bool test_static_program_matches_adapter(shs::IJobSystem& js)
+    {
+        const std::vector<TestDraw> draws = make_draws();
+        const TestStaticProgram static_prog{};
+        const shs::ShaderProgram erased_prog = shs::make_shader_program(static_prog);
+        const shs::ShaderProgram lambda_prog = make_test_program();
+        if (!erased_prog.valid() || erased_prog.fs_lanes != nullptr) return false;
+        if (shs::make_pbr_mr_program().fs_lanes != shs::PbrMetallicRoughnessProgram::fs_lanes) return false;
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+
+        shs::RT_ColorHDR hdr[3] = {shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}};
+        shs::RT_ColorDepthMotion dm[3] = {
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f},
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f},
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}};
+        for (const TestDraw& d : draws)
+        {
+            (void)shs::rasterize_mesh(d.mesh, lambda_prog, d.uniforms, shs::RasterizerTarget{&hdr[0], &dm[0]}, cfg);
+            (void)shs::rasterize_mesh(d.mesh, static_prog, d.uniforms, shs::RasterizerTarget{&hdr[1], &dm[1]}, cfg);
+        }
+        shs::TiledRasterizer tiled{};
+        shs::TiledRasterizerConfig tcfg{};
+        tcfg.job_system = &js;
+        tcfg.tile_size = 16;
+        tiled.begin(shs::RasterizerTarget{&hdr[2], &dm[2]}, tcfg);
+        for (size_t i = 0; i < draws.size(); ++i)
+        {
+            if (i % 2 == 0) tiled.submit(draws[i].mesh, static_prog, draws[i].uniforms, cfg);
+            else tiled.submit(draws[i].mesh, erased_prog, draws[i].uniforms, cfg);
+        }
+        (void)tiled.flush();
+
+        for (int m = 1; m < 3; ++m)
+        {
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = hdr[0].color.at(x, y);
+                    const shs::ColorF b = hdr[m].color.at(x, y);
+                    if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+                    if (!approx_eq(dm[0].depth.at(x, y), dm[m].depth.at(x, y))) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Draw бүрт сонгосон permutation kernel нь бүх салаатай (ShaderFeaturesAll) program-тай
+    // ижил зураг гаргаж, texture/shadow/motion-гүй draw дээр тэр салааг огт ажиллуулахгүй.
+    bool test_shader_permutations_match_generic(shs::IJobSystem& js)
+    {
+        std::vector<TestDraw> draws = make_draws();
+        shs::Texture2DData tex{5, 9};
+        for (int y = 0; y < tex.h; ++y)
+        {
+            for (int x = 0; x < tex.w; ++x) tex.at(x, y) = shs::Color{(uint8_t)(x * 47), (uint8_t)(y * 23), 90, 255};
+        }
+        const glm::mat4 light_vp =
+            glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, 0.1f, 30.0f) *
+            glm::lookAt(glm::vec3(3.0f, 10.0f, 2.0f), glm::vec3(0.0f, 0.0f, -3.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+        shs::RT_ShadowDepth shadow{64, 64};
+        for (const TestDraw& d : draws) (void)shs::rasterize_mesh_depth(d.mesh, d.uniforms.model, light_vp, shadow);
+        for (size_t i = 0; i < draws.size(); ++i)
+        {
+            shs::ShaderUniforms& u = draws[i].uniforms;
+            u.light_dir_ws = glm::normalize(glm::vec3(-0.3f, -1.0f, 0.2f));
+            u.base_color_tex = (i % 2 == 0) ? &tex : nullptr;
+            u.shadow_map = (i % 3 != 1) ? &shadow : nullptr;
+            u.light_viewproj = light_vp;
+            u.enable_motion_vectors = (i != 2);
+        }
+
+        const shs::ShadingModel models[] = {shs::ShadingModel::PBRMetalRough, shs::ShadingModel::BlinnPhong};
+        for (const shs::ShadingModel model : models)
+        {
+            for (int simd = 0; simd < 2; ++simd)
+            {
+                shs::RasterizerConfig cfg{};
+                cfg.cull_mode = shs::RasterizerCullMode::None;
+                cfg.simd_fragments = (simd == 1);
+                cfg.job_system = &js;
+                shs::RT_ColorHDR hdr[2] = {shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}};
+                shs::RT_ColorDepthMotion dm[2] = {shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}, shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}};
+                uint32_t seen = 0u;
+                for (const TestDraw& d : draws)
+                {
+                    const shs::RasterizerTarget t0{&hdr[0], &dm[0]};
+                    const shs::RasterizerTarget t1{&hdr[1], &dm[1]};
+                    if (model == shs::ShadingModel::BlinnPhong) (void)shs::rasterize_mesh(d.mesh, shs::BlinnPhongProgram{}, d.uniforms, t0, cfg);
+                    else (void)shs::rasterize_mesh(d.mesh, shs::PbrMetallicRoughnessProgram{}, d.uniforms, t0, cfg);
+
+                    shs::ShaderPermutationKey key{};
+                    key.model = model;
+                    key.features = shs::shader_features_for_draw(d.uniforms, true, shs::DebugViewMode::Final);
+                    seen |= 1u << key.features;
+                    bool erased_ok = false;
+                    shs::with_shader_permutation(key, [&](const auto& prog) {
+                        erased_ok = shs::shader_permutation_program(key).fs_lanes == shs::program_fs_lanes(prog);
+                        (void)shs::rasterize_mesh(d.mesh, prog, d.uniforms, t1, cfg);
+                    });
+                    if (!erased_ok) return false;
+                }
+                // Textured/shadowed/motion-ийн хэд хэдэн өөр хослол сонгогдсон байх ёстой.
+                if (std::popcount(seen) < 4) return false;
+
+                for (int y = 0; y < k_h; ++y)
+                {
+                    for (int x = 0; x < k_w; ++x)
+                    {
+                        const shs::ColorF a = hdr[0].color.at(x, y);
+                        const shs::ColorF b = hdr[1].color.at(x, y);
+                        if (!approx_eq(a.r, b.r, 1e-4f) || !approx_eq(a.g, b.g, 1e-4f) || !approx_eq(a.b, b.b, 1e-4f)) return false;
+                        if (!approx_eq(dm[0].depth.at(x, y), dm[1].depth.at(x, y))) return false;
+                        if (!approx_eq(dm[0].motion.at(x, y).x, dm[1].motion.at(x, y).x, 1e-3f)) return false;
+                    }
+                }
+            }
+        }
+
+        // Debug view нь lit хослолоос үл хамааран нэг kernel-тэй.
+        const shs::ShaderPermutationKey dbg{shs::ShadingModel::BlinnPhong, shs::ShaderFeatureDebugView | shs::ShaderFeatureTextured, shs::DebugViewMode::Normal};
+        if (!shs::shader_permutation_program(dbg).valid() || shs::shader_permutation_program(dbg).fs_lanes != nullptr) return false;
+        return true;
+    }
+
+    // Near plane-ийг огтолж, guard-band-аас хэтэрсэн асар том шал: зөвхөн near/far/guard-band
+    // хавтгайгаар clip хийгдэж, пиксел бүрийн depth нь шалтай огтлолцох цацрагийн depth-тэй
+    // таарна. Дэлгэцээс гарсан ч guard-band дотор байгаа гурвалжин огт clip хийгдэхгүй.
+    bool test_guard_band_clipping()
+    {
+        const float near_z = 0.5f;
+        const float far_z = 40.0f;
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.4f, -4.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)k_w / (float)k_h, near_z, far_z);
+        const glm::mat4 vp = proj * view;
+        const glm::mat4 inv_vp = glm::inverse(vp);
+
+        shs::MeshData floor{};
+        const float e = 1.0e5f;
+        floor.positions = {{-e, 0.0f, -e}, {e, 0.0f, -e}, {e, 0.0f, e}, {-e, 0.0f, e}};
+        floor.normals.assign(4, glm::vec3(0.0f, 1.0f, 0.0f));
+        floor.uvs.assign(4, glm::vec2(0.0f));
+        floor.indices = {0, 1, 2, 0, 2, 3};
+
+        shs::ShaderUniforms u{};
+        u.model = glm::mat4(1.0f);
+        u.viewproj = vp;
+        u.prev_model = u.model;
+        u.prev_viewproj = vp;
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+        const shs::DebugViewProgram prog{shs::DebugViewMode::Depth};
+
+        shs::RT_ColorHDR hdr{k_w, k_h};
+        shs::RT_ColorDepthMotion dm{k_w, k_h, near_z, far_z};
+        const shs::RasterizerStats s = shs::rasterize_mesh(floor, prog, u, shs::RasterizerTarget{&hdr, &dm}, cfg);
+        if (s.tri_after_clip <= s.tri_input) return false;
+
+        int covered = 0;
+        for (int y = 0; y < k_h; ++y)
+        {
+            for (int x = 0; x < k_w; ++x)
+            {
+                const float nx = ((float)x + 0.5f) / (float)(k_w - 1) * 2.0f - 1.0f;
+                const float ny = ((float)y + 0.5f) / (float)(k_h - 1) * 2.0f - 1.0f;
+                glm::vec4 a = inv_vp * glm::vec4(nx, ny, -1.0f, 1.0f);
+                glm::vec4 b = inv_vp * glm::vec4(nx, ny, 1.0f, 1.0f);
+                a /= a.w;
+                b /= b.w;
+                float expect = 1.0f;
+                if (a.y > 0.0f && b.y < 0.0f)
+                {
+                    const glm::vec3 hit = glm::mix(glm::vec3(a), glm::vec3(b), a.y / (a.y - b.y));
+                    const glm::vec4 c = vp * glm::vec4(hit, 1.0f);
+                    // RT_ColorDepthMotion нь zn..zf-ийн шугаман view depth хадгална.
+                    if (c.z <= c.w) expect = (c.w - near_z) / (far_z - near_z);
+                }
+                const float got = dm.depth.at(x, y);
+                // Far plane-ийн хил дээрх пикселүүдийн coverage нь float-ын нарийвчлалаас хамаарна.
+                if (expect > 0.995f) continue;
+                if (!approx_eq(got, expect, 1e-3f)) return false;
+                covered++;
+            }
+        }
+        if (covered == 0) return false;
+
+        // Дэлгэцээс 3 дахин том боловч near/far болон guard-band дотор байгаа гурвалжин.
+        shs::MeshData big{};
+        big.positions = {{-12.0f, -8.0f, -5.0f}, {12.0f, -8.0f, -5.0f}, {0.0f, 14.0f, -5.0f}};
+        big.normals.assign(3, glm::vec3(0.0f, 0.0f, 1.0f));
+        big.uvs.assign(3, glm::vec2(0.0f));
+        big.indices = {0, 1, 2};
+        shs::RT_ColorDepthMotion dm_big{k_w, k_h, near_z, far_z};
+        const shs::RasterizerStats sb = shs::rasterize_mesh(big, prog, u, shs::RasterizerTarget{&hdr, &dm_big}, cfg);
+        return sb.tri_input == 1 && sb.tri_after_clip == 1 && sb.fragments_passed == (uint64_t)k_w * (uint64_t)k_h;
+    }
+
+    // Оройн өмнөх clip-ийн интерполяцаар гарсан motion нь пикселийн world байрлалыг өмнөх
+    // кадрын model/viewproj-оор шууд проекцлосонтой таарна. motion_static нь prev_model-ийг
+    // үл тоож зөвхөн камерын шилжилтийг хэрэглэнэ.
+    bool test_motion_vectors_match_reprojection(shs::IJobSystem& js)
+    {
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)k_w / (float)k_h, 0.5f, 40.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.3f, 1.0f), glm::vec3(0.0f, 0.0f, -4.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 prev_view = glm::lookAt(glm::vec3(0.15f, 0.25f, 1.1f), glm::vec3(0.1f, 0.0f, -4.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        shs::MeshData quad{};
+        quad.positions = {{-3.0f, -2.0f, 0.0f}, {3.0f, -2.0f, 0.0f}, {3.0f, 2.0f, 0.0f}, {-3.0f, 2.0f, 0.0f}};
+        quad.normals.assign(4, glm::vec3(0.0f, 0.0f, 1.0f));
+        quad.uvs.assign(4, glm::vec2(0.0f));
+        quad.indices = {0, 1, 2, 0, 2, 3};
+
+        shs::ShaderUniforms u{};
+        u.model = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -4.0f)), 0.6f, glm::vec3(0.0f, 1.0f, 0.0f));
+        u.viewproj = proj * view;
+        u.prev_model = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(-0.1f, 0.05f, -4.2f)), 0.55f, glm::vec3(0.0f, 1.0f, 0.0f));
+        u.prev_viewproj = proj * prev_view;
+        u.enable_motion_vectors = true;
+
+        const glm::mat4 inv_vp = glm::inverse(u.viewproj);
+        const glm::vec3 plane_p = glm::vec3(u.model * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        const glm::vec3 plane_n = glm::vec3(u.model * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f));
+        auto check = [&](const shs::RT_ColorDepthMotion& dm, const glm::mat4& curr_to_prev) -> bool {
+            int checked = 0;
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    if (dm.depth.at(x, y) >= 1.0f) continue;
+                    const float nx = ((float)x + 0.5f) / (float)(k_w - 1) * 2.0f - 1.0f;
+                    const float ny = ((float)y + 0.5f) / (float)(k_h - 1) * 2.0f - 1.0f;
+                    glm::vec4 a = inv_vp * glm::vec4(nx, ny, -1.0f, 1.0f);
+                    glm::vec4 b = inv_vp * glm::vec4(nx, ny, 1.0f, 1.0f);
+                    a /= a.w;
+                    b /= b.w;
+                    const glm::vec3 dir = glm::vec3(b) - glm::vec3(a);
+                    const float tt = glm::dot(plane_p - glm::vec3(a), plane_n) / glm::dot(dir, plane_n);
+                    const glm::vec3 wp = glm::vec3(a) + dir * tt;
+                    const glm::vec4 pc = u.prev_viewproj * curr_to_prev * glm::vec4(wp, 1.0f);
+                    glm::vec2 vel = (glm::vec2(nx, ny) - glm::vec2(pc) / pc.w) * 0.5f * glm::vec2((float)k_w, (float)k_h);
+                    if (glm::length(vel) > 96.0f) vel *= 96.0f / glm::length(vel);
+                    const shs::Motion2f got = dm.motion.at(x, y);
+                    if (!approx_eq(got.x, vel.x, 0.02f) || !approx_eq(got.y, vel.y, 0.02f)) return false;
+                    checked++;
+                }
+            }
+            return checked > k_w * k_h / 8;
+        };
+
+        for (int simd = 0; simd < 2; ++simd)
+        {
+            shs::RasterizerConfig cfg{};
+            cfg.cull_mode = shs::RasterizerCullMode::None;
+            cfg.simd_fragments = (simd == 1);
+            cfg.job_system = &js;
+            const shs::PbrMetallicRoughnessProgram prog{};
+
+            shs::RT_ColorHDR hdr{k_w, k_h};
+            shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+            (void)shs::rasterize_mesh(quad, prog, u, shs::RasterizerTarget{&hdr, &dm}, cfg);
+            if (!check(dm, u.prev_model * glm::inverse(u.model))) return false;
+
+            shs::ShaderUniforms us = u;
+            us.motion_static = true;
+            shs::RT_ColorDepthMotion dm_static{k_w, k_h, 0.5f, 40.0f};
+            (void)shs::rasterize_mesh(quad, prog, us, shs::RasterizerTarget{&hdr, &dm_static}, cfg);
+            if (!check(dm_static, glm::mat4(1.0f))) return false;
+        }
+        return true;
+    }
+
+    // Mip chain нь linear орон зайн box filter, trilinear sampler нь LOD-оор зөв level-ийг
+    // уншиж, rasterizer-ийн duv/dx нь хөрш пикселийн uv-ийн зөрүүтэй таарна.
+    bool test_texture_mips_trilinear(shs::IJobSystem& js)
+    {
+        shs::Texture2DData tex{64, 32};
+        for (int y = 0; y < tex.h; ++y)
+        {
+            for (int x = 0; x < tex.w; ++x)
+            {
+                tex.at(x, y) = ((x / 2 + y / 2) % 2 == 0) ? shs::Color{250, 40, 10, 255} : shs::Color{20, 200, 90, 255};
+            }
+        }
+        shs::Texture2DData lin = tex;
+        shs::generate_texture_mips(tex);
+        shs::TextureMipOptions lin_opt{};
+        lin_opt.linear_storage = true;
+        shs::generate_texture_mips(lin, lin_opt);
+        if (tex.level_count() != 7 || tex.level(6).w != 1 || tex.level(6).h != 1) return false;
+        if (tex.level(5).w != 2 || tex.level(5).h != 1) return false;
+
+        // 1x1 level нь base-ийн шугаман дундаж (sRGB8 квантчлалын нарийвчлалтай).
+        glm::vec3 avg(0.0f);
+        for (const shs::Color& c : tex.texels) avg += shs::srgb_to_linear_rgb(c);
+        avg /= (float)tex.texels.size();
+        const glm::vec3 top = shs::texel_linear_rgb(tex.level(6), 0, 0);
+        if (!approx_eq(top.r, avg.r, 0.01f) || !approx_eq(top.g, avg.g, 0.01f) || !approx_eq(top.b, avg.b, 0.01f)) return false;
+
+        // Сондгой хэмжээ: 3x3 -> 1x1 нь бүх 9 texel-ийн дундаж (баруун багана/доод мөр хаягдахгүй),
+        // 5x3 -> 2x1 -ийн сүүлийн texel нь 3x3 footprint-ийн дундаж.
+        shs::Texture2DData odd{5, 3};
+        for (int y = 0; y < odd.h; ++y)
+        {
+            for (int x = 0; x < odd.w; ++x)
+            {
+                odd.at(x, y) = (x >= 2 || y == 2) ? shs::Color{255, 255, 255, 255} : shs::Color{0, 0, 0, 255};
+            }
+        }
+        shs::TextureMipOptions odd_opt{};
+        odd_opt.linear_storage = true;
+        shs::Texture2DData odd3{3, 3};
+        for (int y = 0; y < 3; ++y)
+        {
+            for (int x = 0; x < 3; ++x) odd3.at(x, y) = odd.at(x, y);
+        }
+        shs::generate_texture_mips(odd3, odd_opt);
+        shs::generate_texture_mips(odd, odd_opt);
+        if (odd3.level_count() != 2 || odd3.level(1).w != 1 || odd3.level(1).h != 1) return false;
+        if (odd.level(1).w != 2 || odd.level(1).h != 1) return false;
+        // 3x3: 5 цагаан / 9. 5x3-ийн баруун 3x3 footprint: бүгд цагаан; зүүн 2x3: 2 цагаан / 6.
+        const float expect_3x3 = 5.0f / 9.0f;
+        const float expect_left = 2.0f / 6.0f;
+        if (!approx_eq(shs::texel_linear_rgb(odd3.level(1), 0, 0).g, expect_3x3, 0.01f)) return false;
+        if (!approx_eq(shs::texel_linear_rgb(odd.level(1), 0, 0).g, expect_left, 0.01f)) return false;
+        if (!approx_eq(shs::texel_linear_rgb(odd.level(1), 1, 0).g, 1.0f, 0.01f)) return false;
+
+        const glm::vec2 uvs[] = {{0.13f, 0.71f}, {0.5f, 0.5f}, {1.37f, -0.22f}, {0.999f, 0.001f}};
+        for (const glm::vec2& uv : uvs)
+        {
+            // Magnification: level 0 bilinear-тай ижил.
+            const glm::vec3 a = shs::sample_texture2d_trilinear_repeat_linear(&tex, uv, glm::vec2(0.001f, 0.0f), glm::vec2(0.0f, 0.001f));
+            const glm::vec3 b = shs::sample_texture2d_bilinear_repeat_linear(&tex, uv);
+            if (glm::length(a - b) > 1e-6f) return false;
+
+            // 4 texel footprint -> LOD 2.
+            const glm::vec3 c = shs::sample_texture2d_trilinear_repeat_linear(&tex, uv, glm::vec2(4.0f / 64.0f, 0.0f), glm::vec2(0.0f, 1.0f / 32.0f));
+            const glm::vec3 d = shs::sample_texture_level_bilinear_repeat_linear(tex.level(2), uv);
+            if (glm::length(c - d) > 1e-5f) return false;
+
+            // LOD 2.5 нь level 2 ба 3-ын дундаж.
+            const float s = std::sqrt(32.0f) / 64.0f;
+            const glm::vec3 e = shs::sample_texture2d_trilinear_repeat_linear(&tex, uv, glm::vec2(s, 0.0f), glm::vec2(0.0f, 0.0f));
+            const glm::vec3 f = 0.5f * (d + shs::sample_texture_level_bilinear_repeat_linear(tex.level(3), uv));
+            if (glm::length(e - f) > 1e-4f) return false;
+
+            // Шугаман хадгалалт нь sRGB decode-той ижил утга өгнө.
+            const glm::vec3 g = shs::sample_texture2d_trilinear_repeat_linear(&lin, uv, glm::vec2(s, 0.0f), glm::vec2(0.0f, 0.0f));
+            if (glm::length(e - g) > 0.01f) return false;
+        }
+
+        // Налуу quad дээр duv/dx, duv/dy нь хөрш пикселийн uv-ийн төвлөрсөн зөрүүтэй таарна.
+        shs::MeshData quad{};
+        quad.positions = {{-2.0f, -0.8f, 0.0f}, {2.0f, 0.8f, 0.0f}, {2.0f, 0.8f, -8.0f}, {-2.0f, -0.8f, -8.0f}};
+        quad.normals.assign(4, glm::vec3(0.0f, 1.0f, 0.0f));
+        quad.uvs = {{0.0f, 0.0f}, {3.0f, 0.0f}, {3.0f, 5.0f}, {0.0f, 5.0f}};
+        quad.indices = {0, 1, 2, 0, 2, 3};
+        shs::ShaderUniforms u{};
+        u.viewproj =
+            glm::perspective(glm::radians(60.0f), (float)k_w / (float)k_h, 0.5f, 40.0f) *
+            glm::lookAt(glm::vec3(1.5f, 4.0f, 2.0f), glm::vec3(0.0f, 0.0f, -4.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        for (int simd = 0; simd < 2; ++simd)
+        {
+            shs::RasterizerConfig cfg{};
+            cfg.cull_mode = shs::RasterizerCullMode::None;
+            cfg.simd_fragments = (simd == 1);
+            cfg.job_system = &js;
+            shs::RT_ColorHDR hdr{k_w, k_h};
+            shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+            (void)shs::rasterize_mesh(quad, UvDerivativeProgram{}, u, shs::RasterizerTarget{&hdr, &dm}, cfg);
+            int checked = 0;
+            for (int y = 1; y + 1 < k_h; ++y)
+            {
+                for (int x = 1; x + 1 < k_w; ++x)
+                {
+                    if (dm.depth.at(x, y) >= 1.0f || dm.depth.at(x - 1, y) >= 1.0f || dm.depth.at(x + 1, y) >= 1.0f) continue;
+                    if (dm.depth.at(x, y - 1) >= 1.0f || dm.depth.at(x, y + 1) >= 1.0f) continue;
+                    // Trapezoid дүрэм: uv(x+1) - uv(x) ~ (duv/dx(x) + duv/dx(x+1)) / 2.
+                    const shs::ColorF c = hdr.color.at(x, y);
+                    const float du = hdr.color.at(x + 1, y).r - c.r;
+                    const float dv = hdr.color.at(x, y + 1).g - c.g;
+                    const float dudx = 0.5f * (c.b + hdr.color.at(x + 1, y).b);
+                    const float dvdy = 0.5f * (c.a + hdr.color.at(x, y + 1).a);
+                    if (!approx_eq(du, dudx, 0.02f * std::abs(du) + 1e-4f)) return false;
+                    if (!approx_eq(dv, dvdy, 0.02f * std::abs(dv) + 1e-4f)) return false;
+                    checked++;
+                }
+            }
+            if (checked < k_w * k_h / 8) return false;
+        }
+        return true;
+    }
+
+    // Оройг хуваалцсан индекстэй grid ба түүний гурвалжин бүрийг тусад нь задалсан хувилбар.
+    // Задалсан хувилбарын гурвалжны дараалал урвуу тул эхний орой нь x > 0 талд байна.
+    void make_grid(shs::MeshData& indexed, shs::MeshData& expanded)
+    {
+        constexpr int nx = 24;
+        constexpr int ny = 16;
+        for (int y = 0; y <= ny; ++y)
+        {
+            for (int x = 0; x <= nx; ++x)
+            {
+                const float fx = -3.0f + 6.0f * (float)x / (float)nx;
+                const float fy = -2.0f + 4.0f * (float)y / (float)ny;
+                indexed.positions.push_back(glm::vec3(fx, fy, -3.0f + 0.3f * std::sin(fx * 1.7f + fy)));
+                indexed.normals.push_back(glm::normalize(glm::vec3(0.1f * fx, 1.0f, 0.2f)));
+                indexed.uvs.push_back(glm::vec2((float)x / (float)nx, (float)y / (float)ny));
+            }
+        }
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                const uint32_t i00 = (uint32_t)(y * (nx + 1) + x);
+                const uint32_t i10 = i00 + 1u;
+                const uint32_t i01 = i00 + (uint32_t)(nx + 1);
+                const uint32_t i11 = i01 + 1u;
+                indexed.indices.insert(indexed.indices.end(), {i00, i10, i11, i00, i11, i01});
+            }
+        }
+        for (size_t t = indexed.indices.size() / 3; t-- > 0;)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t i = indexed.indices[t * 3 + (size_t)k];
+                expanded.positions.push_back(indexed.positions[i]);
+                expanded.normals.push_back(indexed.normals[i]);
+                expanded.uvs.push_back(indexed.uvs[i]);
+            }
+        }
+    }
+
+    // Vertex cache нь орой бүрийн VS-ийг нэг удаа дуудаж, задалсан mesh-тэй ижил зураг гаргана.
+    // VS нь зарим оройд л Custom0 бичдэг тул эхний оройгоор тааварласан slot-ийг нэмэх замыг шалгана.
+    // Tiled layout нь зөвхөн хадгалалтын дараалал: index нь давхцахгүй, хөрвүүлэлт буцаж
+    // ижил болно, layout-оос үл хамаарах pass/sampler-ууд bit-exact ижил үр дүн өгнө.
+    bool test_tiled_layout_matches_linear(shs::IJobSystem& js)
+    {
+        constexpr int w = 45;
+        constexpr int h = 29;
+        {
+            using L = shs::PixelLayoutTiled4x4;
+            std::vector<uint8_t> seen(L::storage_size(w, h), 0u);
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    const size_t i = L::index(x, y, w);
+                    if (i >= seen.size() || seen[i]) return false;
+                    seen[i] = 1u;
+                }
+            }
+        }
+
+        uint32_t seed = 77u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / (float)(1u << 24);
+        };
+
+        shs::RT_ColorDepthMotion rt{w, h, 0.1f, 100.0f};
+        shs::RT_ColorHDR hdr{w, h};
+        shs::RT_ShadowDepth shadow{w, h};
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                rt.color.at(x, y) = shs::Color{(uint8_t)(next() * 255.0f), (uint8_t)(next() * 255.0f), (uint8_t)(next() * 255.0f), 255};
+                // Хоёр түвшний depth: depth reject салаа хоёулаа ажиллана.
+                rt.depth.at(x, y) = (x + y < 40) ? 0.25f : 0.75f + 0.01f * next();
+                rt.motion.at(x, y) = shs::Motion2f{(next() - 0.5f) * 30.0f, (next() - 0.5f) * 30.0f};
+                hdr.color.at(x, y) = shs::ColorF{next() * 4.0f, next() * 4.0f, next() * 4.0f, 1.0f};
+                shadow.at(x, y) = next();
+            }
+        }
+
+        shs::PixelBuffer2D<shs::Color, shs::PixelLayoutTiled8x8> color_t{};
+        shs::PixelBuffer2D<float, shs::PixelLayoutTiled8x8> depth_t{};
+        shs::PixelBuffer2D<shs::Motion2f, shs::PixelLayoutTiled8x8> motion_t{};
+        shs::PixelBuffer2D<shs::ColorF, shs::PixelLayoutTiled4x4> hdr_t{};
+        shs::PixelBuffer2D<float, shs::PixelLayoutTiled4x4> shadow_t{};
+        shs::convert_pixel_layout(rt.color, color_t, &js);
+        shs::convert_pixel_layout(rt.depth, depth_t, &js);
+        shs::convert_pixel_layout(rt.motion, motion_t, &js);
+        shs::convert_pixel_layout(hdr.color, hdr_t, &js);
+        shs::convert_pixel_layout(shadow, shadow_t, &js);
+
+        shs::PixelBuffer2D<shs::ColorF> hdr_back{};
+        shs::convert_pixel_layout(hdr_t, hdr_back, &js);
+        for (size_t i = 0; i < hdr.color.data.size(); ++i)
+        {
+            if (hdr_back.data[i].r != hdr.color.data[i].r || hdr_back.data[i].b != hdr.color.data[i].b) return false;
+        }
+
+        shs::PassMotionBlur::MotionBlurKernelParams kp{};
+        kp.samples = 9;
+        kp.velocity_scale = 1.3f;
+        kp.max_velocity_px = 12.0f;
+        kp.min_velocity_px = 1.0f;
+        kp.depth_reject = 0.1f;
+        shs::PixelBuffer2D<shs::Color> blur_l{w, h, shs::Color{}};
+        shs::PixelBuffer2D<shs::Color> blur_t{w, h, shs::Color{}};
+        shs::PassMotionBlur::blur(&js, rt.color, rt.depth, rt.motion, w, h, kp, [&](int x, int y, const shs::Color& c) { blur_l.at(x, y) = c; });
+        shs::PassMotionBlur::blur(&js, color_t, depth_t, motion_t, w, h, kp, [&](int x, int y, const shs::Color& c) { blur_t.at(x, y) = c; });
+        size_t blurred = 0;
+        for (size_t i = 0; i < blur_l.data.size(); ++i)
+        {
+            const shs::Color a = blur_l.data[i];
+            const shs::Color b = blur_t.data[i];
+            if (a.r != b.r || a.g != b.g || a.b != b.b) return false;
+            if (a.r != rt.color.data[i].r || a.g != rt.color.data[i].g) ++blurred;
+        }
+        if (blurred < blur_l.data.size() / 2) return false;
+
+        shs::PixelBuffer2D<shs::Color> ldr_l{w, h, shs::Color{}};
+        shs::PixelBuffer2D<shs::Color> ldr_t{w, h, shs::Color{}};
+        shs::PassTonemap::tonemap(&js, hdr.color, ldr_l, w, h, shs::PassTonemap::Curve{1.2f, 1.0f / 2.2f});
+        shs::PassTonemap::tonemap(&js, hdr_t, ldr_t, w, h, shs::PassTonemap::Curve{1.2f, 1.0f / 2.2f});
+        for (size_t i = 0; i < ldr_l.data.size(); ++i)
+        {
+            if (ldr_l.data[i].r != ldr_t.data[i].r || ldr_l.data[i].g != ldr_t.data[i].g || ldr_l.data[i].b != ldr_t.data[i].b) return false;
+        }
+
+        shs::ShadowParams sp{};
+        sp.light_viewproj = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f);
+        sp.pcf_radius = 2;
+        for (int i = 0; i < 256; ++i)
+        {
+            const glm::vec3 p(next() * 2.2f - 1.1f, next() * 2.2f - 1.1f, next() * 1.8f - 0.9f);
+            const float ndl = next();
+            if (shs::shadow_visibility_dir(shadow, sp, p, ndl) != shs::shadow_visibility_dir(shadow_t, sp, p, ndl)) return false;
+        }
+
+        shs::Texture2DData tex{37, 21};
+        for (shs::Color& c : tex.texels) c = shs::Color{(uint8_t)(next() * 255.0f), (uint8_t)(next() * 255.0f), (uint8_t)(next() * 255.0f), 255};
+        shs::Texture2DData tex_t = tex;
+        shs::TextureMipOptions opt{};
+        opt.linear_storage = true;
+        shs::generate_texture_mips(tex, opt);
+        opt.tiled_linear = true;
+        shs::generate_texture_mips(tex_t, opt);
+        if (!tex_t.linear_tiled || tex_t.linear.size() != shs::PixelLayoutTiled4x4::storage_size(tex.w, tex.h)) return false;
+        for (int i = 0; i < 128; ++i)
+        {
+            const glm::vec2 uv(next() * 3.0f - 1.0f, next() * 3.0f - 1.0f);
+            const glm::vec2 d(next() * 0.2f, 0.0f);
+            const glm::vec3 a = shs::sample_texture2d_trilinear_repeat_linear(&tex, uv, d, glm::vec2(0.0f, d.x));
+            const glm::vec3 b = shs::sample_texture2d_trilinear_repeat_linear(&tex_t, uv, d, glm::vec2(0.0f, d.x));
+            if (a != b) return false;
+        }
+        return true;
+    }
+
+    // BC1/BC3: санах ой 8x/4x багасна, decode алдаа бага, sampler шахаагүйтэй ойролцоо,
+    // worker-ийн decode cache нь bilinear tap-уудыг блок бүрд нэг decode-оор хангана.
+    bool test_texture_block_compression()
+    {
+        // 4-т хуваагдахгүй хэмжээ: захын блокууд clamp-аар дүүргэгдэнэ.
+        shs::Texture2DData tex{70, 45};
+        uint32_t seed = 5u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (int)((seed >> 8) & 7u);
+        };
+        for (int y = 0; y < tex.h; ++y)
+        {
+            for (int x = 0; x < tex.w; ++x)
+            {
+                // Бодит зурагтай адил блок доторх өнгө нэг тэнхлэг (гэрэлтэлт) дагуу + бага noise.
+                const int l = 20 + (x * 2 + y * 3) % 200;
+                tex.at(x, y) = shs::Color{(uint8_t)(l + next()), (uint8_t)(l * 3 / 4 + next()), (uint8_t)(l / 2 + 10), (uint8_t)(255 - x * 2)};
+            }
+        }
+        shs::generate_texture_mips(tex);
+        const size_t raw_bytes = shs::texture_storage_bytes(tex);
+
+        shs::Texture2DData bc1 = tex;
+        shs::Texture2DData bc3 = tex;
+        shs::compress_texture_blocks(bc1, shs::TextureBlockFormat::BC1);
+        shs::compress_texture_blocks(bc3, shs::TextureBlockFormat::BC3);
+        if (!bc1.valid() || !bc3.valid() || !bc1.texels.empty() || bc1.level_count() != tex.level_count()) return false;
+        if (bc1.block_owner == 0u || bc1.block_owner == bc3.block_owner) return false;
+        if ((double)raw_bytes / (double)shs::texture_storage_bytes(bc1) < 7.0) return false;
+        if ((double)raw_bytes / (double)shs::texture_storage_bytes(bc3) < 3.5) return false;
+
+        // Level 0-ийн decode алдаа (sRGB8 нэгжээр дундаж).
+        const shs::Texture2DLevelView l1 = bc1.level(0);
+        const shs::Texture2DLevelView l3 = bc3.level(0);
+        double err_rgb = 0.0;
+        double err_a = 0.0;
+        std::array<shs::Color, 16> b1{};
+        std::array<shs::Color, 16> b3{};
+        for (int by = 0; by < (tex.h + 3) / 4; ++by)
+        {
+            for (int bx = 0; bx < (tex.w + 3) / 4; ++bx)
+            {
+                const size_t bi = (size_t)by * (size_t)((tex.w + 3) / 4) + (size_t)bx;
+                shs::decode_texture_block(l1.blocks + bi * 8u, shs::TextureBlockFormat::BC1, b1);
+                shs::decode_texture_block(l3.blocks + bi * 16u, shs::TextureBlockFormat::BC3, b3);
+                for (int i = 0; i < 16; ++i)
+                {
+                    const int x = bx * 4 + (i & 3);
+                    const int y = by * 4 + (i >> 2);
+                    if (x >= tex.w || y >= tex.h) continue;
+                    const shs::Color o = tex.at(x, y);
+                    const shs::Color d = b1[(size_t)i];
+                    if (d.r != b3[(size_t)i].r || d.g != b3[(size_t)i].g || d.b != b3[(size_t)i].b) return false;
+                    err_rgb += std::abs((int)o.r - (int)d.r) + std::abs((int)o.g - (int)d.g) + std::abs((int)o.b - (int)d.b);
+                    err_a += std::abs((int)o.a - (int)b3[(size_t)i].a);
+                }
+            }
+        }
+        const double n = (double)tex.w * (double)tex.h;
+        if (err_rgb / (3.0 * n) > 4.0 || err_a / n > 2.0) return false;
+
+        // 565-д яг буудаг хоёр өнгөтэй (эсрэг хамааралтай суваг) блок алдаагүй буцна. Цэнхэр
+        // тэнхлэгийн дээд үзүүр 565 утгаараа бага тул endpoint солих салаа ажиллана.
+        {
+            shs::Texture2DData two{4, 4};
+            for (int i = 0; i < 16; ++i) two.texels[(size_t)i] = (i % 3 == 0) ? shs::Color{99, 0, 0, 255} : shs::Color{0, 0, 255, 255};
+            const std::vector<shs::Color> src = two.texels;
+            shs::compress_texture_blocks(two, shs::TextureBlockFormat::BC1);
+            std::array<shs::Color, 16> d{};
+            shs::decode_texture_block(two.blocks.data(), shs::TextureBlockFormat::BC1, d);
+            for (size_t i = 0; i < 16; ++i)
+            {
+                if (d[i].r != src[i].r || d[i].g != src[i].g || d[i].b != src[i].b || d[i].a != 255) return false;
+            }
+        }
+
+        shs::TextureBlockCache& cache = shs::thread_texture_block_cache();
+        const uint64_t hits0 = cache.hits;
+        const uint64_t misses0 = cache.misses;
+        // Блок доторх хурц ирмэг (гэрэлтэлтийн wrap) дээр BC1-ийн 4 түвшин алдаа өгөх тул
+        // дундаж болон хамгийн их алдааг тусад нь шалгана.
+        float sample_err = 0.0f;
+        float sample_err_max = 0.0f;
+        for (int i = 0; i < 400; ++i)
+        {
+            const glm::vec2 uv(0.0025f * (float)i, 0.3f + 0.0007f * (float)i);
+            const glm::vec2 d(0.004f + 0.0002f * (float)i, 0.0f);
+            const glm::vec3 a = shs::sample_texture2d_trilinear_repeat_linear(&tex, uv, d, glm::vec2(0.0f, d.x));
+            const glm::vec3 b = shs::sample_texture2d_trilinear_repeat_linear(&bc1, uv, d, glm::vec2(0.0f, d.x));
+            const float e = std::max({std::abs(a.r - b.r), std::abs(a.g - b.g), std::abs(a.b - b.b)});
+            sample_err += e;
+            sample_err_max = std::max(sample_err_max, e);
+        }
+        if (sample_err / 400.0f > 0.02f || sample_err_max > 0.12f) return false;
+        const uint64_t hits = cache.hits - hits0;
+        const uint64_t misses = cache.misses - misses0;
+        return misses > 0u && hits > 3u * misses;
+    }
+
+    bool test_vertex_cache_shades_each_vertex_once(shs::IJobSystem& js)
+    {
+        shs::MeshData indexed{};
+        shs::MeshData expanded{};
+        make_grid(indexed, expanded);
+
+        shs::ShaderProgram prog{};
+        prog.vs = [](const shs::ShaderVertex& v, const shs::ShaderUniforms& u) {
+            shs::VertexOut o{};
+            const glm::vec4 wp = u.model * glm::vec4(v.position, 1.0f);
+            o.clip = u.viewproj * wp;
+            o.world_pos = glm::vec3(wp);
+            o.normal_ws = v.normal;
+            o.uv = v.uv;
+            shs::set_varying(o, shs::VaryingSemantic::Color0, glm::vec4(v.uv, 0.25f, 1.0f));
+            if (v.position.x > 0.4f) shs::set_varying(o, shs::VaryingSemantic::Custom0, glm::vec4(0.0f, 0.0f, 0.5f, 0.0f));
+            return o;
+        };
+        prog.fs = [](const shs::FragmentIn& in, const shs::ShaderUniforms&) {
+            shs::FragmentOut o{};
+            const glm::vec4 c = shs::get_varying(in, shs::VaryingSemantic::Color0) + shs::get_varying(in, shs::VaryingSemantic::Custom0);
+            o.color = shs::ColorF{c.x, c.y, c.z, 1.0f};
+            return o;
+        };
+
+        const std::vector<TestDraw> draws = make_draws();
+        const shs::ShaderUniforms& u = draws[0].uniforms;
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+        cfg.job_system = &js;
+
+        shs::RT_ColorHDR hdr_indexed{k_w, k_h};
+        shs::RT_ColorDepthMotion dm_indexed{k_w, k_h, 0.5f, 40.0f};
+        const shs::RasterizerStats s_indexed = shs::rasterize_mesh(indexed, prog, u, shs::RasterizerTarget{&hdr_indexed, &dm_indexed}, cfg);
+
+        shs::RT_ColorHDR hdr_expanded{k_w, k_h};
+        shs::RT_ColorDepthMotion dm_expanded{k_w, k_h, 0.5f, 40.0f};
+        shs::TiledRasterizer tiled{};
+        shs::TiledRasterizerConfig tcfg{};
+        tcfg.job_system = &js;
+        tcfg.tile_size = 16;
+        tiled.begin(shs::RasterizerTarget{&hdr_expanded, &dm_expanded}, tcfg);
+        tiled.submit(expanded, prog, u, cfg);
+        const shs::RasterizerStats s_expanded = tiled.flush();
+
+        // Indexed grid-ийн эхний орой x < 0 тул slot нэмэгдэж бүх орой дахин shade хийгдэнэ.
+        const uint64_t grid_vertices = indexed.positions.size();
+        if (s_indexed.vs_invocations != grid_vertices * 2u) return false;
+        if (s_expanded.vs_invocations != expanded.positions.size()) return false;
+        if (s_indexed.tri_raster == 0 || s_indexed.tri_raster != s_expanded.tri_raster) return false;
+
+        bool saw_custom = false;
+        for (int y = 0; y < k_h; ++y)
+        {
+            for (int x = 0; x < k_w; ++x)
+            {
+                const shs::ColorF a = hdr_indexed.color.at(x, y);
+                const shs::ColorF b = hdr_expanded.color.at(x, y);
+                if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+                if (!approx_eq(dm_indexed.depth.at(x, y), dm_expanded.depth.at(x, y))) return false;
+                if (a.b > 0.3f) saw_custom = true;
+            }
+        }
+        if (!saw_custom) return false;
+
+        // Дуудагчийн cache: draw хооронд буфераа дахин ашиглаж (reallocation-гүй), ижил зураг өгнө.
+        shs::RasterVertexCache cache{};
+        for (int draw = 0; draw < 2; ++draw)
+        {
+            const glm::vec4* clip_before = cache.clip.data();
+            shs::RT_ColorHDR hdr{k_w, k_h};
+            shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+            const shs::RasterizerStats s = shs::rasterize_mesh(indexed, prog, u, shs::RasterizerTarget{&hdr, &dm}, cfg, cache);
+            if (s.vs_invocations != s_indexed.vs_invocations || s.tri_raster != s_indexed.tri_raster) return false;
+            if (draw == 1 && cache.clip.data() != clip_before) return false;
+            for (size_t i = 0; i < hdr.color.data.size(); ++i)
+            {
+                const shs::ColorF a = hdr_indexed.color.data[i];
+                const shs::ColorF b = hdr.color.data[i];
+                if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+            }
+        }
+        return true;
+    }
+
+    // Ойрын том occluder-ийн ард байгаа гурвалжнуудыг Hi-Z алгасах ёстой бөгөөд зураг Hi-Z-гүй
+    // үеийнхтэй яг ижил байна. Шууд болон tile горим хоёуланг шалгана.
+    bool test_hiz_rejects_hidden_triangles(shs::IJobSystem& js)
+    {
+        std::vector<TestDraw> draws = make_draws();
+        TestDraw occluder{};
+        occluder.uniforms = draws[0].uniforms;
+        occluder.uniforms.model = glm::mat4(1.0f);
+        occluder.uniforms.prev_model = occluder.uniforms.model;
+        const float z = 1.0f;
+        occluder.mesh.positions = {{-20.0f, -20.0f, z}, {20.0f, -20.0f, z}, {20.0f, 20.0f, z}, {-20.0f, 20.0f, z}};
+        occluder.mesh.normals.assign(4, glm::vec3(0.0f, 0.0f, 1.0f));
+        occluder.mesh.uvs = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+        occluder.mesh.indices = {0, 1, 2, 0, 2, 3};
+        draws.insert(draws.begin(), occluder);
+
+        const shs::ShaderProgram prog = make_test_program();
+        shs::RT_ColorHDR hdr[3] = {shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}};
+        shs::RT_ColorDepthMotion dm[3] = {
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f},
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f},
+            shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}};
+        shs::RasterHiZ hiz[3]{};
+        shs::RasterizerStats stats[3]{};
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            shs::RasterizerConfig cfg{};
+            cfg.cull_mode = shs::RasterizerCullMode::None;
+            cfg.hierarchical_z = (mode != 0);
+            cfg.job_system = &js;
+            cfg.parallel_min_rows = 8;
+            cfg.parallel_min_pixels = 64;
+            hiz[mode].rebuild(dm[mode].depth);
+            const shs::RasterizerTarget target{&hdr[mode], &dm[mode], &hiz[mode]};
+            if (mode == 2)
+            {
+                shs::TiledRasterizer tiled{};
+                shs::TiledRasterizerConfig tcfg{};
+                tcfg.job_system = &js;
+                tcfg.tile_size = 20;
+                tiled.begin(target, tcfg);
+                for (const TestDraw& d : draws) tiled.submit(d.mesh, prog, d.uniforms, cfg);
+                stats[mode] = tiled.flush();
+                continue;
+            }
+            for (const TestDraw& d : draws)
+            {
+                const shs::RasterizerStats s = shs::rasterize_mesh(d.mesh, prog, d.uniforms, target, cfg);
+                stats[mode].tri_raster += s.tri_raster;
+                stats[mode].hiz_tris_rejected += s.hiz_tris_rejected;
+                stats[mode].hiz_blocks_rejected += s.hiz_blocks_rejected;
+            }
+        }
+
+        if (stats[0].hiz_tris_rejected != 0 || stats[0].hiz_blocks_rejected != 0) return false;
+        for (int mode = 1; mode < 3; ++mode)
+        {
+            if (stats[mode].hiz_tris_rejected == 0 || stats[mode].hiz_blocks_rejected == 0) return false;
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = hdr[mode].color.at(x, y);
+                    const shs::ColorF b = hdr[0].color.at(x, y);
+                    if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+                    if (!approx_eq(dm[mode].depth.at(x, y), dm[0].depth.at(x, y))) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Built-in program-уудын SIMD lane зам scalar fs замтай ижил зураг гаргах ёстой.
+    // Depth-ийн тэнцүү дөхсөн давхцлын улмаас цөөн пиксел өөр гурвалжинд очиж болно.
+    bool test_simd_fragments_match_scalar(shs::IJobSystem& js)
+    {
+        std::vector<TestDraw> draws = make_draws();
+
+        shs::Texture2DData tex{13, 7};
+        for (int y = 0; y < tex.h; ++y)
+        {
+            for (int x = 0; x < tex.w; ++x)
+            {
+                tex.at(x, y) = shs::Color{(uint8_t)(x * 19), (uint8_t)(y * 37), (uint8_t)((x ^ y) * 11), 255};
+            }
+        }
+
+        const glm::mat4 light_vp =
+            glm::ortho(-8.0f, 8.0f, -8.0f, 8.0f, 0.1f, 30.0f) *
+            glm::lookAt(glm::vec3(3.0f, 10.0f, 2.0f), glm::vec3(0.0f, 0.0f, -3.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+        shs::RT_ShadowDepth shadow{64, 64};
+        for (const TestDraw& d : draws)
+        {
+            (void)shs::rasterize_mesh_depth(d.mesh, d.uniforms.model, light_vp, shadow);
+        }
+        for (size_t i = 0; i < draws.size(); ++i)
+        {
+            shs::ShaderUniforms& u = draws[i].uniforms;
+            u.camera_pos = glm::vec3(0.0f, 0.5f, 4.0f);
+            u.light_dir_ws = glm::normalize(glm::vec3(-0.3f, -1.0f, 0.2f));
+            u.light_intensity = 2.5f;
+            u.metallic = 0.2f * (float)i;
+            u.roughness = 0.15f + 0.2f * (float)i;
+            u.base_color_tex = (i % 2 == 0) ? &tex : nullptr;
+            u.shadow_map = &shadow;
+            u.light_viewproj = light_vp;
+            u.shadow_pcf_radius = (int)(i % 3);
+        }
+
+        const shs::ShaderProgram programs[] = {shs::make_pbr_mr_program(), shs::make_blinn_phong_program()};
+        for (const shs::ShaderProgram& prog : programs)
+        {
+            if (!prog.fs_lanes) return false;
+            shs::RT_ColorHDR hdr[2] = {shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}};
+            shs::RT_ColorDepthMotion dm[2] = {shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}, shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}};
+            for (int mode = 0; mode < 2; ++mode)
+            {
+                shs::RasterizerConfig cfg{};
+                cfg.cull_mode = shs::RasterizerCullMode::None;
+                cfg.simd_fragments = (mode == 1);
+                // SIMD замыг tile-binned rasterizer-аар ажиллуулж хоёр замыг хоёуланг нь шалгана.
+                if (mode == 1)
+                {
+                    shs::TiledRasterizer tiled{};
+                    shs::TiledRasterizerConfig tcfg{};
+                    tcfg.job_system = &js;
+                    tcfg.tile_size = 16;
+                    tiled.begin(shs::RasterizerTarget{&hdr[mode], &dm[mode]}, tcfg);
+                    for (const TestDraw& d : draws) tiled.submit(d.mesh, prog, d.uniforms, cfg);
+                    (void)tiled.flush();
+                }
+                else
+                {
+                    for (const TestDraw& d : draws)
+                    {
+                        (void)shs::rasterize_mesh(d.mesh, prog, d.uniforms, shs::RasterizerTarget{&hdr[mode], &dm[mode]}, cfg);
+                    }
+                }
+            }
+
+            int covered = 0;
+            int mismatched = 0;
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const float d0 = dm[0].depth.at(x, y);
+                    const float d1 = dm[1].depth.at(x, y);
+                    if ((d0 < 1.0f) != (d1 < 1.0f)) return false;
+                    if (d0 >= 1.0f) continue;
+                    ++covered;
+                    const shs::ColorF a = hdr[0].color.at(x, y);
+                    const shs::ColorF b = hdr[1].color.at(x, y);
+                    const float tol = 2e-3f * (1.0f + std::max({std::abs(a.r), std::abs(a.g), std::abs(a.b)}));
+                    const bool same =
+                        approx_eq(d0, d1, 1e-4f) &&
+                        approx_eq(a.r, b.r, tol) && approx_eq(a.g, b.g, tol) && approx_eq(a.b, b.b, tol) &&
+                        approx_eq(dm[0].motion.at(x, y).x, dm[1].motion.at(x, y).x, 1e-2f) &&
+                        approx_eq(dm[0].motion.at(x, y).y, dm[1].motion.at(x, y).y, 1e-2f);
+                    if (!same) ++mismatched;
+                }
+            }
+            if (covered < k_w * k_h / 4) return false;
+            if (mismatched * 1000 > covered) return false;
+        }
+        return true;
+    }
+
+    // Visibility-buffer горим forward tile горимтой ижил зураг гаргаж, харагдах пиксел
+    // бүрийг яг нэг удаа shade хийх ёстой.
+    bool test_visibility_buffer_matches_forward(shs::IJobSystem& js)
+    {
+        const std::vector<TestDraw> draws = make_draws();
+        const shs::ShaderProgram prog = shs::make_pbr_mr_program();
+        for (int simd = 0; simd < 2; ++simd)
+        {
+            shs::RasterizerConfig cfg{};
+            cfg.cull_mode = shs::RasterizerCullMode::None;
+            cfg.simd_fragments = (simd == 1);
+
+            shs::RT_ColorHDR hdr[2] = {shs::RT_ColorHDR{k_w, k_h}, shs::RT_ColorHDR{k_w, k_h}};
+            shs::RT_ColorDepthMotion dm[2] = {shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}, shs::RT_ColorDepthMotion{k_w, k_h, 0.5f, 40.0f}};
+            shs::RasterizerStats stats[2]{};
+            shs::TiledRasterizer tiled{};
+            for (int mode = 0; mode < 2; ++mode)
+            {
+                shs::TiledRasterizerConfig tcfg{};
+                tcfg.job_system = &js;
+                tcfg.tile_size = 16;
+                tcfg.front_end_tris_per_job = 7;
+                tcfg.visibility_buffer = (mode == 1);
+                tiled.begin(shs::RasterizerTarget{&hdr[mode], &dm[mode]}, tcfg);
+                for (const TestDraw& d : draws) tiled.submit(d.mesh, prog, d.uniforms, cfg);
+                stats[mode] = tiled.flush();
+            }
+
+            uint64_t covered = 0;
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = hdr[0].color.at(x, y);
+                    const shs::ColorF b = hdr[1].color.at(x, y);
+                    if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b)) return false;
+                    if (!approx_eq(dm[0].depth.at(x, y), dm[1].depth.at(x, y))) return false;
+                    if (!approx_eq(dm[0].motion.at(x, y).x, dm[1].motion.at(x, y).x, 1e-3f)) return false;
+                    if (!approx_eq(dm[0].motion.at(x, y).y, dm[1].motion.at(x, y).y, 1e-3f)) return false;
+                    const bool hit = dm[1].depth.at(x, y) < 1.0f;
+                    const int draw = tiled.visibility_draw(tiled.visibility().at(x, y));
+                    if (hit != (draw >= 0) || draw >= (int)draws.size()) return false;
+                    if (hit) ++covered;
+                }
+            }
+
+            // Forward нь depth test давсан fragment бүрийг shade хийнэ (soup дээр overdraw > 1).
+            if (stats[0].fs_invocations != stats[0].fragments_passed) return false;
+            if (stats[1].fragments_passed != stats[0].fragments_passed) return false;
+            if (stats[1].fs_invocations != covered) return false;
+            if (stats[0].fs_invocations <= covered) return false;
+        }
+        return true;
+    }
+
+    bool test_tiled_depth_only_matches_immediate(shs::IJobSystem& js)
+    {
+        const std::vector<TestDraw> draws = make_draws();
+        shs::RT_ShadowDepth ref{k_w, k_h};
+        for (const TestDraw& d : draws)
+        {
+            (void)shs::rasterize_mesh_depth(d.mesh, d.uniforms.model, d.uniforms.viewproj, ref);
+        }
+
+        shs::RT_ShadowDepth depth{k_w, k_h};
+        shs::TiledRasterizer tiled{};
+        shs::TiledRasterizerConfig tcfg{};
+        tcfg.job_system = &js;
+        tcfg.tile_size = 32;
+        tiled.begin_depth_only(&depth, tcfg);
+        for (const TestDraw& d : draws) tiled.submit_depth(d.mesh, d.uniforms.model, d.uniforms.viewproj);
+        (void)tiled.flush();
+
+        for (size_t i = 0; i < ref.depth.size(); ++i)
+        {
+            if (!approx_eq(ref.depth[i], depth.depth[i])) return false;
+        }
+        return true;
+    }
+
+    bool fast_clear_has_pending(const shs::FastClearTiles& fc)
+    {
+        if (!fc.active) return false;
+        for (uint8_t p : fc.pending)
+        {
+            if (p) return true;
+        }
+        return false;
+    }
+
+    // clear_fast() + raster-ийн анх хүрэх resolve + pass төгсгөлийн resolve_fast_clear() нь
+    // энгийн clear()-тэй бит-ижил зураг өгөх ёстой. Buffer-уудыг эхлээд хог утгаар дүүргэж,
+    // resolve алгассан tile байвал ил гарна.
+    bool test_fast_clear_matches_clear(shs::IJobSystem& js)
+    {
+        const std::vector<TestDraw> draws = make_draws();
+        const shs::ShaderProgram prog = make_test_program();
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+        cfg.hierarchical_z = true;
+        const shs::ColorF garbage_color{7.0f, -3.0f, 5.0f, 0.25f};
+        const shs::Motion2f garbage_motion{9.0f, -9.0f};
+
+        shs::RT_ColorHDR ref_hdr{k_w, k_h};
+        shs::RT_ColorDepthMotion ref_dm{k_w, k_h, 0.5f, 40.0f};
+        shs::RasterHiZ ref_hiz{};
+        ref_hiz.rebuild(ref_dm.depth);
+        for (const TestDraw& d : draws)
+        {
+            (void)shs::rasterize_mesh(d.mesh, prog, d.uniforms, shs::RasterizerTarget{&ref_hdr, &ref_dm, &ref_hiz}, cfg);
+        }
+
+        // 0: rasterize_mesh, 1: tiled forward, 2: tiled visibility buffer.
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            shs::RT_ColorHDR hdr{k_w, k_h, garbage_color};
+            shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+            dm.depth.clear(0.0f);
+            dm.motion.clear(garbage_motion);
+            hdr.color.clear_fast(shs::ColorF{0.0f, 0.0f, 0.0f, 1.0f});
+            dm.clear_all_fast();
+
+            // Pending block-ууд хог (0.0) уншилгүй clear утгаа авна.
+            shs::RasterHiZ hiz{};
+            hiz.rebuild(dm.depth);
+            for (int by = 0; by < hiz.blocks_y(); ++by)
+            {
+                for (int bx = 0; bx < hiz.blocks_x(); ++bx)
+                {
+                    if (hiz.block_max(bx, by, dm.depth) != 1.0f || hiz.block_min(bx, by, dm.depth) != 1.0f) return false;
+                }
+            }
+
+            if (mode == 0)
+            {
+                for (const TestDraw& d : draws)
+                {
+                    (void)shs::rasterize_mesh(d.mesh, prog, d.uniforms, shs::RasterizerTarget{&hdr, &dm, &hiz}, cfg);
+                }
+            }
+            else
+            {
+                shs::TiledRasterizer tiled{};
+                shs::TiledRasterizerConfig tcfg{};
+                tcfg.job_system = &js;
+                tcfg.tile_size = 16;
+                tcfg.front_end_tris_per_job = 7;
+                tcfg.visibility_buffer = (mode == 2);
+                tiled.begin(shs::RasterizerTarget{&hdr, &dm, &hiz}, tcfg);
+                for (const TestDraw& d : draws) tiled.submit(d.mesh, prog, d.uniforms, cfg);
+                (void)tiled.flush();
+                if (tcfg.visibility_buffer && tiled.visibility().fast_clear.active) return false;
+            }
+
+            shs::resolve_fast_clear(hdr.color, &js);
+            shs::resolve_fast_clear(dm.depth, &js);
+            shs::resolve_fast_clear(dm.motion, &js);
+
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = ref_hdr.color.at(x, y);
+                    const shs::ColorF b = hdr.color.at(x, y);
+                    if (!approx_eq(a.r, b.r) || !approx_eq(a.g, b.g) || !approx_eq(a.b, b.b) || !approx_eq(a.a, b.a)) return false;
+                    if (!approx_eq(ref_dm.depth.at(x, y), dm.depth.at(x, y))) return false;
+                    if (!approx_eq(ref_dm.motion.at(x, y).x, dm.motion.at(x, y).x, 1e-3f)) return false;
+                    if (!approx_eq(ref_dm.motion.at(x, y).y, dm.motion.at(x, y).y, 1e-3f)) return false;
+                }
+            }
+        }
+
+        // Хэсэгчлэн resolve хийсэн buffer: тэгш өнцөгттэй давхцсан tile л бөглөгдөж, үлдсэн нь
+        // pass-ийн төгсгөл хүртэл pending хэвээр.
+        {
+            shs::PixelBuffer2D<float> buf{k_w, k_h, 0.0f};
+            buf.clear_fast(1.0f);
+            buf.resolve_fast_clear_rect(20, 41, 9, 9);
+            if (buf.fast_clear.tile_pending(2, 1) || buf.fast_clear.tile_pending(5, 1)) return false;
+            if (!buf.fast_clear.tile_pending(1, 1) || !buf.fast_clear.tile_pending(6, 1) || !buf.fast_clear.tile_pending(2, 0)) return false;
+            if (buf.at(16, 8) != 1.0f || buf.at(47, 15) != 1.0f || buf.at(15, 8) != 0.0f || buf.at(48, 8) != 0.0f) return false;
+            if (!fast_clear_has_pending(buf.fast_clear)) return false;
+            shs::resolve_fast_clear(buf, &js);
+            if (buf.fast_clear.active) return false;
+            for (float v : buf.data)
+            {
+                if (v != 1.0f) return false;
+            }
+        }
+
+        // Depth-only (shadow map) зам.
+        shs::RT_ShadowDepth ref_shadow{k_w, k_h};
+        for (const TestDraw& d : draws)
+        {
+            (void)shs::rasterize_mesh_depth(d.mesh, d.uniforms.model, d.uniforms.viewproj, ref_shadow);
+        }
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            shs::RT_ShadowDepth shadow{k_w, k_h};
+            shadow.clear(0.0f);
+            shadow.clear_fast(1.0f);
+            if (mode == 0)
+            {
+                for (const TestDraw& d : draws)
+                {
+                    (void)shs::rasterize_mesh_depth(d.mesh, d.uniforms.model, d.uniforms.viewproj, shadow);
+                }
+            }
+            else
+            {
+                shs::TiledRasterizer tiled{};
+                shs::TiledRasterizerConfig tcfg{};
+                tcfg.job_system = &js;
+                tcfg.tile_size = 32;
+                tiled.begin_depth_only(&shadow, tcfg);
+                for (const TestDraw& d : draws) tiled.submit_depth(d.mesh, d.uniforms.model, d.uniforms.viewproj);
+                (void)tiled.flush();
+            }
+            shs::resolve_fast_clear(shadow, &js);
+            if (shadow.fast_clear.active) return false;
+            for (size_t i = 0; i < ref_shadow.depth.size(); ++i)
+            {
+                if (!approx_eq(ref_shadow.depth[i], shadow.depth[i])) return false;
+            }
+        }
+        return true;
+    }
+
+    // Half/R11G11B10 кодчилол болон нягт HDR target руу raster/sky/tonemap хийх зам.
+    bool test_hdr_formats(shs::IJobSystem& js)
+    {
+        // Бүх төгсгөлөг half утга float-оор дамжаад өөртөө буцна; дундын утга тэгш рүү дугуйрна.
+        for (uint32_t h = 0; h < 0x10000u; ++h)
+        {
+            if ((h & 0x7C00u) == 0x7C00u) continue;
+            const float f = shs::half_bits_to_float((uint16_t)h);
+            if (shs::float_to_half_bits(f) != (uint16_t)h) return false;
+            if (shs::encode_half4(f, f, f, f).g != (uint16_t)h) return false;
+            if ((h & 0x7FFFu) < 0x7BFFu)
+            {
+                const float mid = 0.5f * (f + shs::half_bits_to_float((uint16_t)(h + 1u)));
+                const uint16_t even = (h & 1u) ? (uint16_t)(h + 1u) : (uint16_t)h;
+                if (shs::float_to_half_bits(mid) != even) return false;
+            }
+        }
+        const shs::ColorHalf4 clamped = shs::encode_half4(1.0e6f, -1.0e6f, 0.0f, 1.0f);
+        if (clamped.r != 0x7BFFu || clamped.g != 0xFBFFu) return false;
+
+        uint32_t rng = 12345u;
+        for (int i = 0; i < 20000; ++i)
+        {
+            rng = rng * 1664525u + 1013904223u;
+            const float v = std::exp2(-10.0f + 25.0f * (float)(rng >> 8) * (1.0f / 16777216.0f));
+            const float in[3] = {v, v * 0.37f, v * 1.9f};
+            float out[3];
+            shs::decode_r11g11b10(shs::encode_r11g11b10(in), out);
+            // 6/5 битийн mantissa: хагас ulp-ийн харьцангуй алдаа.
+            const float tol[3] = {1.0f / 128.0f, 1.0f / 128.0f, 1.0f / 64.0f};
+            for (int c = 0; c < 3; ++c)
+            {
+                if (in[c] < 1.0e-4f) continue;
+                if (std::abs(out[c] - in[c]) > tol[c] * in[c] * 1.001f) return false;
+            }
+        }
+        const float odd[3] = {-2.0f, std::nanf(""), 1.0e9f};
+        float odd_out[3];
+        shs::decode_r11g11b10(shs::encode_r11g11b10(odd), odd_out);
+        if (odd_out[0] != 0.0f || odd_out[1] != 0.0f || odd_out[2] != 64512.0f) return false;
+
+        const std::vector<TestDraw> draws = make_draws();
+        const shs::ShaderProgram prog = make_test_program();
+        shs::RasterizerConfig cfg{};
+        cfg.cull_mode = shs::RasterizerCullMode::None;
+        const shs::HdrFormat formats[3] = {shs::HdrFormat::RGBA32F, shs::HdrFormat::RGBA16F, shs::HdrFormat::R11G11B10F};
+        shs::RT_ColorHDR hdr[3]{};
+        shs::RT_ColorLDR ldr[3]{};
+        for (int f = 0; f < 3; ++f)
+        {
+            hdr[f] = shs::RT_ColorHDR{k_w, k_h, shs::ColorF{0.2f, 0.3f, 0.4f, 1.0f}, formats[f]};
+            if (hdr[f].storage_bytes() != (size_t)k_w * (size_t)k_h * shs::hdr_format_bytes(formats[f])) return false;
+            if ((f == 0) != !hdr[f].color.data.empty() || (f == 1) != !hdr[f].color_half.data.empty()) return false;
+            if ((f == 2) != !hdr[f].color_packed.data.empty()) return false;
+
+            shs::RT_ColorDepthMotion dm{k_w, k_h, 0.5f, 40.0f};
+            hdr[f].clear_fast(shs::ColorF{0.2f, 0.3f, 0.4f, 1.0f});
+            shs::TiledRasterizer tiled{};
+            shs::TiledRasterizerConfig tcfg{};
+            tcfg.job_system = &js;
+            tcfg.tile_size = 16;
+            tiled.begin(shs::RasterizerTarget{&hdr[f], &dm}, tcfg);
+            for (size_t i = 0; i + 1 < draws.size(); ++i) tiled.submit(draws[i].mesh, prog, draws[i].uniforms, cfg);
+            (void)tiled.flush();
+            // Сүүлийн draw-ийг immediate (scalar fs) замаар.
+            cfg.simd_fragments = false;
+            (void)shs::rasterize_mesh(draws.back().mesh, prog, draws.back().uniforms, shs::RasterizerTarget{&hdr[f], &dm}, cfg);
+            cfg.simd_fragments = true;
+            shs::resolve_fast_clear(hdr[f], &js);
+
+            ldr[f] = shs::RT_ColorLDR{k_w, k_h};
+            hdr[f].visit([&](const auto& buf) { shs::PassTonemap::tonemap(&js, buf, ldr[f].color, k_w, k_h, shs::PassTonemap::Curve{1.0f, 1.0f / 2.2f}); });
+        }
+
+        for (int f = 1; f < 3; ++f)
+        {
+            const float rel = (f == 1) ? (1.0f / 1024.0f) : (1.0f / 64.0f);
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const shs::ColorF a = hdr[0].load(x, y);
+                    const shs::ColorF b = hdr[f].load(x, y);
+                    if (std::abs(a.r - b.r) > rel * std::abs(a.r) + 1e-4f) return false;
+                    if (std::abs(a.g - b.g) > rel * std::abs(a.g) + 1e-4f) return false;
+                    if (std::abs(a.b - b.b) > rel * std::abs(a.b) + 1e-4f) return false;
+                    const shs::Color la = ldr[0].color.at(x, y);
+                    const shs::Color lb = ldr[f].color.at(x, y);
+                    const int tol8 = (f == 1) ? 1 : 2;
+                    if (std::abs((int)la.r - (int)lb.r) > tol8 || std::abs((int)la.g - (int)lb.g) > tol8 || std::abs((int)la.b - (int)lb.b) > tol8) return false;
+                }
+            }
+        }
+
+        // Формат солиход өмнөх хадгалалт чөлөөлөгдөж store/load шинэ форматаар явна.
+        hdr[0].set_format(shs::HdrFormat::RGBA16F);
+        if (!hdr[0].color.data.empty() || hdr[0].color_half.data.size() != (size_t)k_w * (size_t)k_h) return false;
+        hdr[0].store(3, 4, shs::ColorF{1.5f, 2.0f, 0.25f, 1.0f});
+        const shs::ColorF back = hdr[0].load(3, 4);
+        return back.r == 1.5f && back.g == 2.0f && back.b == 0.25f && back.a == 1.0f;
+    }
+
+    bool test_transient_aliasing()
+    {
+        // Packer: [0,1] ба [2,3] нэг slot, [1,2] давхцах тул тусдаа. Сул slot-оос багтах хамгийн жижгийг сонгоно.
+        {
+            const shs::AliasSlotPlan p = shs::assign_alias_slots({{0u, 1u, 100u}, {2u, 3u, 60u}, {1u, 2u, 40u}});
+            if (p.slot_count() != 2u || p.slot_of[0] != p.slot_of[1] || p.slot_of[2] == p.slot_of[0]) return false;
+            if (p.bytes_dedicated != 200u || p.bytes_aliased != 140u) return false;
+            const shs::AliasSlotPlan fit = shs::assign_alias_slots({{0u, 0u, 10u}, {0u, 0u, 50u}, {1u, 1u, 40u}});
+            if (fit.slot_count() != 2u || fit.slot_of[2] != fit.slot_of[1] || fit.bytes_aliased != 60u) return false;
+        }
+
+        constexpr int k_w = 32;
+        constexpr int k_h = 16;
+        constexpr size_t k_bytes = (size_t)k_w * (size_t)k_h * sizeof(shs::Color);
+        shs::RTRegistry rtr{};
+        auto frame = [&](bool allow_aliasing, uint32_t pass_a, uint32_t pass_b, shs::RTHandle& a, shs::RTHandle& b)
+        {
+            rtr.begin_transient_frame(allow_aliasing);
+            rtr.set_transient_pass(pass_a);
+            a = rtr.ensure_transient_color_ldr("test.a", k_w, k_h);
+            rtr.set_transient_pass(pass_b);
+            b = rtr.ensure_transient_color_ldr("test.b", k_w, k_h);
+            rtr.ensure_transient_color_ldr("test.small", k_w / 2, k_h);
+            rtr.end_transient_frame();
+        };
+
+        // Дараалсан pass-ууд: дараагийн frame-ээс нэг backing хуваалцана.
+        shs::RTHandle a{};
+        shs::RTHandle b{};
+        frame(true, 0u, 1u, a, b);
+        const auto& st = rtr.transient_memory_stats();
+        if (st.transients != 3u || st.slots != 2u) return false;
+        if (st.bytes_dedicated != 2u * k_bytes + k_bytes / 2u || st.bytes_aliased != k_bytes + k_bytes / 2u) return false;
+        frame(true, 0u, 1u, a, b);
+        if (rtr.get(a) == nullptr || rtr.get(a) != rtr.get(b)) return false;
+        static_cast<shs::RT_ColorLDR*>(rtr.get(a))->color.at(5, 5) = shs::Color{1, 2, 3, 4};
+
+        // Нэг pass-д хоёулаа: дахин салж, агуулгаа хадгална.
+        frame(true, 2u, 2u, a, b);
+        if (rtr.get(a) == rtr.get(b) || st.slots != 3u || st.bytes_aliased != st.bytes_dedicated) return false;
+        if (static_cast<shs::RT_ColorLDR*>(rtr.get(b))->color.at(5, 5).b != 3) return false;
+
+        // Alias хийгдсэн байхад aliasing-гүй (зэрэг ажиллах) frame эхэлбэл шууд салгана.
+        frame(true, 0u, 1u, a, b);
+        frame(true, 0u, 1u, a, b);
+        if (rtr.get(a) != rtr.get(b)) return false;
+        rtr.begin_transient_frame(false);
+        if (rtr.get(a) == rtr.get(b) || st.slots != 3u || st.bytes_aliased != st.bytes_dedicated) return false;
+        rtr.end_transient_frame();
+
+        // Alias гишүүний хэмжээ өөрчлөгдвөл хуваалцсан backing-ийг хөндөхгүй.
+        frame(true, 0u, 1u, a, b);
+        frame(true, 0u, 1u, a, b);
+        rtr.begin_transient_frame(true);
+        const shs::RTHandle grown = rtr.ensure_transient_color_ldr("test.b", k_w * 2, k_h);
+        const auto* ra = static_cast<const shs::RT_ColorLDR*>(rtr.get(a));
+        const auto* rb = static_cast<const shs::RT_ColorLDR*>(rtr.get(grown));
+        if (grown.id != b.id || ra == rb || ra->w != k_w || rb->w != k_w * 2 || rb->color.w != k_w * 2) return false;
+        rtr.end_transient_frame();
+        return true;
+    }
+
+    bool test_post_stack_matches_passes(shs::IJobSystem& js)
+    {
+        // 64-өөр хуваагдахгүй хэмжээ: хагас tile, кадрын ирмэгийн halo clamp шалгагдана.
+        constexpr int k_w = 150;
+        constexpr int k_h = 90;
+        uint32_t seed = 91u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / (float)(1u << 24);
+        };
+
+        shs::RT_ColorHDR hdr{k_w, k_h};
+        shs::RT_ColorDepthMotion motion{k_w, k_h, 0.1f, 100.0f};
+        for (int y = 0; y < k_h; ++y)
+        {
+            for (int x = 0; x < k_w; ++x)
+            {
+                hdr.color.at(x, y) = shs::ColorF{next() * 3.0f, next() * 3.0f, next() * 3.0f, 1.0f};
+                motion.depth.at(x, y) = (x > 60 && y > 30) ? 0.3f : 0.8f + 0.05f * next();
+                motion.motion.at(x, y) = shs::Motion2f{(next() - 0.5f) * 40.0f, (next() - 0.5f) * 40.0f};
+            }
+        }
+
+        shs::Scene scene{};
+        scene.cam.pos = glm::vec3(0.0f);
+        scene.cam.viewproj = glm::mat4(1.0f);
+        // Нар (0.2, 0.3, 0.1) дээр: identity viewproj-оор дэлгэц дотор проекцлогдоно.
+        scene.sun.dir_ws = glm::vec3(-0.002f, -0.003f, -0.001f);
+
+        shs::FrameParams fp{};
+        fp.dt = 1.0f / 60.0f;
+        fp.pass.motion_blur.enable = true;
+        fp.pass.motion_blur.max_velocity_px = 12.0f;
+        fp.pass.light_shafts.steps = 12;
+        fp.pass.post_stack.tile_size = 32;
+
+        using S = shs::PostStage;
+        struct Case
+        {
+            std::vector<S> stages;
+            int max_fused_halo;
+            bool shafts;
+            uint32_t sweeps;
+        };
+        const Case cases[] = {
+            {{S::Tonemap, S::MotionBlur, S::TAA}, 16, true, 1u},
+            {{S::Tonemap, S::MotionBlur, S::TAA}, 0, true, 2u},
+            {{S::Tonemap, S::LightShafts, S::MotionBlur, S::TAA}, 16, true, 3u},
+            {{S::Tonemap, S::TAA, S::LightShafts}, 16, true, 2u},
+            {{S::Tonemap, S::LightShafts, S::TAA}, 16, false, 1u},
+            // Tonemap-гүй: LDR дээр шууд, урьдчилсан luma/copy дамжилттай.
+            {{S::LightShafts, S::MotionBlur}, 16, true, 3u},
+            {{S::MotionBlur, S::TAA}, 16, true, 2u},
+        };
+
+        for (const Case& c : cases)
+        {
+            fp.pass.post_stack.max_fused_halo = c.max_fused_halo;
+            fp.pass.light_shafts.enable = c.shafts;
+            const bool tonemap_first = c.stages.front() == S::Tonemap;
+
+            shs::RT_ColorLDR ldr_ref{k_w, k_h};
+            shs::RT_ColorLDR ldr_fused{k_w, k_h};
+            shs::RT_ColorLDR tmp{k_w, k_h};
+            shs::RTRegistry rtr{};
+            const shs::RTHandle h_hdr = rtr.reg<shs::RTHandle>(&hdr);
+            const shs::RTHandle h_ref = rtr.reg<shs::RTHandle>(&ldr_ref);
+            const shs::RTHandle h_fused = rtr.reg<shs::RTHandle>(&ldr_fused);
+            const shs::RTHandle h_motion = rtr.reg<shs::RTHandle>(&motion);
+            const shs::RTHandle h_tmp = rtr.reg<shs::RTHandle>(&tmp);
+
+            shs::Context ctx_ref{};
+            shs::Context ctx_fused{};
+            ctx_ref.job_system = &js;
+            ctx_fused.job_system = &js;
+            shs::PassTonemap tonemap{};
+            shs::PassLightShafts shafts{};
+            shs::PassMotionBlur blur{};
+            shs::PassTemporalAA taa{};
+            shs::PassPostStack stack{};
+
+            // Хоёр кадр: хоёр дахь нь TAA history-тэй холилдоно.
+            for (int frame = 0; frame < 2; ++frame)
+            {
+                fp.pass.tonemap.exposure = 1.0f + 0.5f * (float)frame;
+                fp.pass.tonemap.op = frame ? shs::TonemapOperator::ACESFit : shs::TonemapOperator::Reinhard;
+                if (!tonemap_first)
+                {
+                    shs::PassTonemap::GammaLut lut{};
+                    shs::PassTonemap::tonemap(&js, hdr.color, ldr_ref.color, k_w, k_h, shs::PassTonemap::make_curve(fp.pass.tonemap, lut));
+                    ldr_fused.color.data = ldr_ref.color.data;
+                }
+
+                for (const S s : c.stages)
+                {
+                    if (s == S::Tonemap)
+                    {
+                        tonemap.execute(ctx_ref, shs::PassTonemap::Inputs{&fp, &rtr, h_hdr, h_ref});
+                    }
+                    else if (s == S::LightShafts)
+                    {
+                        shafts.execute(ctx_ref, shs::PassLightShafts::Inputs{&scene, &fp, &rtr, h_ref, h_ref, h_motion, shs::RTHandle{}});
+                    }
+                    else if (s == S::MotionBlur)
+                    {
+                        blur.execute(ctx_ref, shs::PassMotionBlur::Inputs{&fp, &rtr, h_ref, h_ref, h_motion, shs::RTHandle{}});
+                    }
+                    else
+                    {
+                        taa.execute(ctx_ref, shs::PassTemporalAA::Inputs{&rtr, h_ref});
+                    }
+                }
+
+                shs::PassPostStack::Inputs in{};
+                in.scene = &scene;
+                in.fp = &fp;
+                in.rtr = &rtr;
+                in.rt_hdr = h_hdr;
+                in.rt_ldr = h_fused;
+                in.rt_motion = h_motion;
+                in.rt_tmp = h_tmp;
+                in.stages = c.stages.data();
+                in.stage_count = c.stages.size();
+                if (!stack.execute(ctx_fused, in)) return false;
+                if (stack.stats().sweeps != c.sweeps) return false;
+
+                for (size_t i = 0; i < ldr_ref.color.data.size(); ++i)
+                {
+                    const shs::Color a = ldr_ref.color.data[i];
+                    const shs::Color b = ldr_fused.color.data[i];
+                    if (a.r != b.r || a.g != b.g || a.b != b.b || a.a != b.a) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Coroutine болгосон light shafts: үе шатууд co_await-аар дарааллаж, parent Task дотроос хоёр
+    // дараалсан pass (in-place ба tmp-тэй) болон job system-гүй sync дуудлага нь scalar лавлагаатай тэнцүү.
+    bool test_light_shafts_coroutine_matches_reference(shs::IJobSystem& js)
+    {
+        constexpr int k_w = 97;
+        constexpr int k_h = 61;
+        uint32_t seed = 17u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (uint8_t)(seed >> 24);
+        };
+
+        shs::Scene scene{};
+        scene.cam.pos = glm::vec3(0.0f);
+        scene.cam.viewproj = glm::mat4(1.0f);
+        scene.sun.dir_ws = glm::vec3(-0.002f, -0.003f, -0.001f);
+        shs::FrameParams fp{};
+        fp.pass.light_shafts.enable = true;
+        fp.pass.light_shafts.steps = 16;
+
+        shs::RT_ColorLDR src{k_w, k_h};
+        shs::RT_ColorDepthMotion motion{k_w, k_h, 0.1f, 100.0f};
+        for (int y = 0; y < k_h; ++y)
+        {
+            for (int x = 0; x < k_w; ++x)
+            {
+                src.color.at(x, y) = shs::Color{next(), next(), next(), 255};
+                motion.depth.at(x, y) = (x > 40 && y > 20) ? 0.3f : 0.9f;
+            }
+        }
+
+        // Лавлагаа: нэг thread дээр shaft_pixel-ээр хоёр удаа.
+        glm::vec2 sun_uv{};
+        if (!shs::PassLightShafts::sun_screen_uv(scene, sun_uv)) return false;
+        const shs::PassLightShafts::ShaftsKernelParams kp = shs::PassLightShafts::kernel_params(fp, sun_uv);
+        std::vector<shs::Color> ref = src.color.data;
+        std::vector<float> luma((size_t)k_w * (size_t)k_h);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (size_t i = 0; i < ref.size(); ++i) luma[i] = shs::PassLightShafts::luma(ref[i]);
+            std::vector<shs::Color> next_ref(ref.size());
+            for (int y = 0; y < k_h; ++y)
+            {
+                for (int x = 0; x < k_w; ++x)
+                {
+                    const size_t i = (size_t)y * (size_t)k_w + (size_t)x;
+                    next_ref[i] = shs::PassLightShafts::shaft_pixel(ref[i], x, y, k_w, k_h, luma.data(), &motion.depth, kp);
+                }
+            }
+            ref.swap(next_ref);
+        }
+
+        auto same = [&ref](const shs::RT_ColorLDR& rt) {
+            for (size_t i = 0; i < ref.size(); ++i)
+            {
+                const shs::Color a = ref[i];
+                const shs::Color b = rt.color.data[i];
+                if (a.r != b.r || a.g != b.g || a.b != b.b || a.a != b.a) return false;
+            }
+            return true;
+        };
+
+        // js дээр coroutine ба sync хоёр зам, js-гүй sync зам.
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            shs::IJobSystem* sys = (mode < 2) ? &js : nullptr;
+            const bool use_async = (mode == 0);
+            shs::RT_ColorLDR a = src;
+            shs::RT_ColorLDR b{k_w, k_h};
+            shs::RT_ColorLDR tmp{k_w, k_h};
+            shs::RTRegistry rtr{};
+            const shs::RTHandle h_a = rtr.reg<shs::RTHandle>(&a);
+            const shs::RTHandle h_b = rtr.reg<shs::RTHandle>(&b);
+            const shs::RTHandle h_tmp = rtr.reg<shs::RTHandle>(&tmp);
+            const shs::RTHandle h_motion = rtr.reg<shs::RTHandle>(&motion);
+
+            shs::Context ctx{};
+            ctx.job_system = sys;
+            shs::PassLightShafts shafts{};
+            if (use_async)
+            {
+                // Frame timeline маягийн parent coroutine: in-place (tmp-гүй) дараа нь a → b tmp-ээр.
+                auto frame = [&]() -> shs::Task<void> {
+                    co_await shafts.execute_async(ctx, shs::PassLightShafts::Inputs{&scene, &fp, &rtr, h_a, h_a, h_motion, shs::RTHandle{}});
+                    co_await shafts.execute_async(ctx, shs::PassLightShafts::Inputs{&scene, &fp, &rtr, h_a, h_b, h_motion, h_tmp});
+                };
+                shs::sync_wait(sys, frame());
+            }
+            else
+            {
+                shafts.execute(ctx, shs::PassLightShafts::Inputs{&scene, &fp, &rtr, h_a, h_a, h_motion, shs::RTHandle{}});
+                shafts.execute(ctx, shs::PassLightShafts::Inputs{&scene, &fp, &rtr, h_a, h_b, h_motion, h_tmp});
+            }
+            if (!same(b)) return false;
+        }
+        return true;
+    }
+
+    // simd_lanes.hpp-ийн primitive бүр (xsimd эсвэл массив fallback) lane тус бүрийн scalar-тай тэнцүү.
+    bool test_simd_lane_primitives()
+    {
+        constexpr int L = shs::simd::k_lanes;
+        if (L < 1 || L > 32) return false;
+
+        shs::simd::LaneArray a{};
+        shs::simd::LaneArray b{};
+        for (int i = 0; i < L; ++i)
+        {
+            a[(size_t)i] = (float)(i - L / 2) * 0.75f;
+            b[(size_t)i] = 0.5f + (float)(i % 3);
+        }
+        const shs::simd::f32 va = shs::simd::load(a.data());
+        const shs::simd::f32 vb = shs::simd::load(b.data());
+
+        auto same = [L](const shs::simd::f32& v, auto&& ref) {
+            shs::simd::LaneArray out{};
+            shs::simd::store(out.data(), v);
+            for (int i = 0; i < L; ++i)
+            {
+                const float r = ref(i);
+                if (std::abs(out[(size_t)i] - r) > 1e-6f * std::max(1.0f, std::abs(r))) return false;
+            }
+            return true;
+        };
+
+        if (!same(va + vb * shs::simd::f32(2.0f) - vb / shs::simd::f32(4.0f), [&](int i) { return a[(size_t)i] + b[(size_t)i] * 2.0f - b[(size_t)i] / 4.0f; })) return false;
+        if (!same(-va, [&](int i) { return -a[(size_t)i]; })) return false;
+        if (!same(shs::simd::min(va, vb), [&](int i) { return std::min(a[(size_t)i], b[(size_t)i]); })) return false;
+        if (!same(shs::simd::max(va, vb), [&](int i) { return std::max(a[(size_t)i], b[(size_t)i]); })) return false;
+        if (!same(shs::simd::abs(va), [&](int i) { return std::abs(a[(size_t)i]); })) return false;
+        if (!same(shs::simd::sqrt(vb), [&](int i) { return std::sqrt(b[(size_t)i]); })) return false;
+        if (!same(shs::simd::pow(vb, shs::simd::f32(1.0f / 2.2f)), [&](int i) { return std::pow(b[(size_t)i], 1.0f / 2.2f); })) return false;
+        if (!same(shs::simd::clamp(va, -1.0f, 1.0f), [&](int i) { return std::clamp(a[(size_t)i], -1.0f, 1.0f); })) return false;
+        if (!same(shs::simd::lane_index(), [](int i) { return (float)i; })) return false;
+        if (!same(shs::simd::select(va < vb, va, vb), [&](int i) { return a[(size_t)i] < b[(size_t)i] ? a[(size_t)i] : b[(size_t)i]; })) return false;
+
+        // Mask bit <-> lane хөрвүүлэлт ба any.
+        const uint32_t all = (L == 32) ? 0xffffffffu : ((1u << L) - 1u);
+        const uint32_t patterns[] = {0u, 1u, 0x55555555u & all, 0xaaaaaaaau & all, all, 1u << (L - 1)};
+        for (const uint32_t bits : patterns)
+        {
+            const shs::simd::mask m = shs::simd::mask_from_bits(bits);
+            if (shs::simd::mask_bits(m) != bits) return false;
+            if (shs::simd::any(m) != (bits != 0u)) return false;
+        }
+        uint32_t lt_bits = 0u;
+        for (int i = 0; i < L; ++i) lt_bits |= (a[(size_t)i] < b[(size_t)i]) ? (1u << i) : 0u;
+        if (shs::simd::mask_bits(va < vb) != lt_bits) return false;
+        if (shs::simd::mask_bits((va < vb) & (va >= shs::simd::f32(0.0f))) != (lt_bits & shs::simd::mask_bits(va >= shs::simd::f32(0.0f)))) return false;
+        if (shs::simd::mask_bits((va > vb) | (va <= vb)) != all) return false;
+        return true;
+    }
+
+    // Lane-аар тооцсон tonemap: pow зам нь scalar лавлагаатай бит тэнцүү, 12 битийн gamma LUT нь
+    // ±1 LSB дотор. Өргөн нь lane-д хуваагдахгүй (сүүл), сөрөг/NaN/inf утга орно.
+    bool test_tonemap_lanes_match_reference(shs::IJobSystem& js)
+    {
+        constexpr int k_w = 53;
+        constexpr int k_h = 7;
+        uint32_t seed = 5u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return (float)(seed >> 8) / (float)(1u << 24);
+        };
+
+        shs::PixelBuffer2D<shs::ColorF> hdr{k_w, k_h, shs::ColorF{}};
+        for (shs::ColorF& c : hdr.data)
+        {
+            // Харанхуйг (gamma-ийн огцом хэсэг) их төлөөлүүлнэ.
+            const float t = next();
+            c = shs::ColorF{t * t * t * 8.0f, next() * 0.02f, next() * 100.0f, 1.0f};
+        }
+        hdr.at(0, 0) = shs::ColorF{-1.0f, std::nanf(""), std::numeric_limits<float>::infinity(), 1.0f};
+        hdr.at(1, 0) = shs::ColorF{0.0f, 1e-7f, 1e30f, 1.0f};
+
+        auto reference = [](float v, float exposure, float inv_gamma, shs::TonemapOperator op) -> int {
+            float x = v * exposure;
+            x = (x > 0.0f) ? x : 0.0f;
+            float y = (op == shs::TonemapOperator::ACESFit)
+                ? (x * (x * 2.51f + 0.03f)) / (x * (x * 2.43f + 0.59f) + 0.14f)
+                : x / (1.0f + x);
+            y = (y < 1.0f) ? y : 1.0f;
+            return std::min(255, (int)(std::pow(y, inv_gamma) * 255.0f + 0.5f));
+        };
+
+        const shs::TonemapOperator ops[] = {shs::TonemapOperator::Reinhard, shs::TonemapOperator::ACESFit};
+        const float gammas[] = {2.2f, 2.4f, 1.8f, 1.0f};
+        for (const shs::TonemapOperator op : ops)
+        {
+            for (const float gamma : gammas)
+            {
+                for (const bool use_lut : {false, true})
+                {
+                    shs::TonemapParams tp{};
+                    tp.exposure = 1.3f;
+                    tp.gamma = gamma;
+                    tp.op = op;
+                    tp.gamma_lut = use_lut;
+                    shs::PassTonemap::GammaLut lut{};
+                    const shs::PassTonemap::Curve curve = shs::PassTonemap::make_curve(tp, lut);
+                    if ((curve.lut != nullptr) != use_lut) return false;
+
+                    shs::PixelBuffer2D<shs::Color> ldr{k_w, k_h, shs::Color{1, 2, 3, 4}};
+                    shs::PassTonemap::tonemap(&js, hdr, ldr, k_w, k_h, curve);
+                    const int tol = use_lut ? 1 : 0;
+                    for (int y = 0; y < k_h; ++y)
+                    {
+                        for (int x = 0; x < k_w; ++x)
+                        {
+                            const shs::ColorF s = hdr.at(x, y);
+                            const shs::Color c = ldr.at(x, y);
+                            if (c.a != 255) return false;
+                            if (std::abs((int)c.r - reference(s.r, curve.exposure, curve.inv_gamma, op)) > tol) return false;
+                            if (std::abs((int)c.g - reference(s.g, curve.exposure, curve.inv_gamma, op)) > tol) return false;
+                            if (std::abs((int)c.b - reference(s.b, curve.exposure, curve.inv_gamma, op)) > tol) return false;
+                        }
+                    }
+                    // Хязгаарын утгууд LUT-аар ч яг таарна.
+                    const shs::Color edge = ldr.at(0, 0);
+                    if (edge.r != 0 || edge.g != 0 || edge.b != 255) return false;
+                }
+            }
+        }
+
+        // Span-ийн дурын [x0, x1) хэсэг бүтэн мөрийн харгалзах хэсэгтэй таарна.
+        shs::PassTonemap::GammaLut lut{};
+        const shs::PassTonemap::Curve curve = shs::PassTonemap::make_curve(shs::TonemapParams{}, lut);
+        std::vector<shs::Color> row((size_t)k_w);
+        std::vector<shs::Color> part((size_t)k_w);
+        shs::PassTonemap::tonemap_span(hdr, 0, k_w, 3, row.data(), curve);
+        shs::PassTonemap::tonemap_span(hdr, 5, 18, 3, part.data(), curve);
+        for (int i = 0; i < 13; ++i)
+        {
+            const shs::Color a = row[(size_t)(5 + i)];
+            const shs::Color b = part[(size_t)i];
+            if (a.r != b.r || a.g != b.g || a.b != b.b) return false;
+        }
+        return true;
+    }
+
+    // Frame budget governor: budget-ээс хэтэрвэл хамгийн их хэмнэлттэй knob-оос буулгана, hysteresis-ийн
+    // зурваст тогтвортой, хангалттай хурдан үед урвуу дарааллаар бүрэн сэргэнэ. Бууруулсан resolution-той
+    // кадрт handle-ууд жижиг RT руу заагдаж, төгсгөлд present LDR руу томруулаад сэргээгдэнэ.
+    bool test_frame_budget_governor(shs::IJobSystem& js)
+    {
+        shs::FrameParams fp{};
+        fp.w = 64;
+        fp.h = 48;
+        fp.pass.shadow.pcf_radius = 2;
+        fp.pass.light_shafts.steps = 48;
+        fp.pass.motion_blur.samples = 16;
+        fp.budget.enable = true;
+        fp.budget.target_ms = 10.0f;
+        fp.budget.settle_frames_down = 2;
+        fp.budget.settle_frames_up = 3;
+
+        shs::RenderDebugStats pass_ms{};
+        pass_ms.ms_shadow = 2.0f;
+        pass_ms.ms_pbr = 4.0f;
+        pass_ms.ms_shafts = 10.0f;
+
+        shs::FrameBudgetGovernor gov{};
+        gov.set_dynamic_resolution_targets(shs::RTHandle{1});
+        if (gov.update(fp, 20.0f, pass_ms)) return false;
+        if (!gov.update(fp, 20.0f, pass_ms)) return false;
+        // Light shafts нь хамгийн үнэтэй pass.
+        if (gov.level(shs::BudgetKnob::LightShafts) != 1 || gov.quality_level() != 1) return false;
+        shs::FrameParams out{};
+        gov.apply(fp, out);
+        if (out.pass.light_shafts.steps != 36 || out.w != fp.w || out.pass.shadow.pcf_radius != 2) return false;
+
+        // Удаан хэтэрвэл бүх knob доод хязгаартаа хүрч зогсоно.
+        for (int i = 0; i < 200; ++i) gov.update(fp, 40.0f, pass_ms);
+        gov.apply(fp, out);
+        if (out.w != 32 || out.h != 24) return false;
+        if (out.pass.light_shafts.steps != 12 || out.pass.shadow.pcf_radius != 0) return false;
+        // Motion blur-ийн хугацаа 0 тул хөндөгдөхгүй.
+        if (out.pass.motion_blur.samples != 16) return false;
+        const uint32_t bottom = gov.quality_level();
+        if (gov.update(fp, 40.0f, pass_ms) || gov.quality_level() != bottom) return false;
+
+        // Hysteresis-ийн зурвас (target * [0.8, 1.0]) дотор өөрчлөгдөхгүй.
+        for (int i = 0; i < 200; ++i)
+        {
+            if (gov.update(fp, 9.0f, pass_ms)) return false;
+        }
+
+        // Хурдан үед сүүлд буулгасан knob-оос эхэлж бүрэн сэргэнэ.
+        int frames = 0;
+        while (gov.quality_level() > 0 && frames < 1000)
+        {
+            gov.update(fp, 5.0f, pass_ms);
+            ++frames;
+        }
+        if (gov.quality_level() != 0 || gov.steps_up() != gov.steps_down()) return false;
+        gov.apply(fp, out);
+        if (out.w != fp.w || out.pass.light_shafts.steps != 48 || out.pass.shadow.pcf_radius != 2) return false;
+
+        // Budget унтраавал хуулбар нь fp-тэй ижил.
+        shs::FrameParams off = fp;
+        off.budget.enable = false;
+        gov.update(off, 40.0f, pass_ms);
+        gov.apply(off, out);
+        if (out.w != fp.w || out.pass.light_shafts.steps != 48) return false;
+
+        // Bilinear upscale: тогтмол өнгө хэвээр, ижил хэмжээ нь хуулбар.
+        shs::PixelBuffer2D<shs::Color> small{5, 3, shs::Color{10, 20, 30, 255}};
+        shs::PixelBuffer2D<shs::Color> big{13, 7, shs::Color{0, 0, 0, 0}};
+        shs::PassUpscale::bilinear(&js, small, big);
+        for (const shs::Color& c : big.data)
+        {
+            if (c.r != 10 || c.g != 20 || c.b != 30 || c.a != 255) return false;
+        }
+        small.at(4, 2) = shs::Color{200, 0, 0, 255};
+        shs::PassUpscale::bilinear(&js, small, big);
+        if (big.at(12, 6).r != 200 || big.at(0, 0).r != 10) return false;
+
+        // Pipeline-ийн begin/end: зөвхөн resolution-оос хэмнэлт гарах үед нэг шат буулгана.
+        shs::RT_ColorLDR ldr{64, 48, shs::Color{0, 0, 0, 255}};
+        shs::RT_ColorHDR hdr{64, 48, shs::ColorF{0.0f, 0.0f, 0.0f, 1.0f}, shs::HdrFormat::RGBA16F};
+        shs::RTRegistry rtr{};
+        const shs::RTHandle h_ldr = rtr.reg<shs::RTHandle>(&ldr);
+        const shs::RTHandle h_hdr = rtr.reg<shs::RTHandle>(&hdr);
+        shs::FrameBudgetGovernor dyn{};
+        dyn.set_dynamic_resolution_targets(h_ldr, {h_hdr});
+        shs::RenderDebugStats pixel_only{};
+        dyn.update(fp, 20.0f, pixel_only);
+        dyn.update(fp, 20.0f, pixel_only);
+        if (dyn.level(shs::BudgetKnob::Resolution) != 1) return false;
+
+        shs::Context ctx{};
+        ctx.job_system = &js;
+        const auto t0 = std::chrono::steady_clock::now();
+        const shs::FrameParams& g = dyn.begin_frame(rtr, fp);
+        if (g.w != 56 || g.h != 42) return false;
+        auto* scaled_ldr = static_cast<shs::RT_ColorLDR*>(rtr.get(h_ldr));
+        const auto* scaled_hdr = static_cast<const shs::RT_ColorHDR*>(rtr.get(h_hdr));
+        if (scaled_ldr == &ldr || scaled_hdr == &hdr) return false;
+        if (scaled_ldr->w != 56 || scaled_hdr->h != 42 || scaled_hdr->format != shs::HdrFormat::RGBA16F) return false;
+        scaled_ldr->color.clear(shs::Color{90, 60, 30, 255});
+        dyn.end_frame(ctx, rtr, fp, t0);
+        if (rtr.get(h_ldr) != &ldr || rtr.get(h_hdr) != &hdr) return false;
+        for (const shs::Color& c : ldr.color.data)
+        {
+            if (c.r != 90 || c.g != 60 || c.b != 30) return false;
+        }
+        if (ctx.debug.budget_render_w != 56 || ctx.debug.budget_render_h != 42) return false;
+        if (std::abs(ctx.debug.budget_render_scale - 0.875f) > 1e-6f || ctx.debug.budget_target_ms != 10.0f) return false;
+        if (ctx.debug.budget_shafts_steps != 48 || ctx.debug.budget_steps_down != 1) return false;
+        return true;
+    }
+
+    // Pipeline тестүүдийн software backend: on_resize дуудлагыг тоолно.
+    class CountingSoftwareBackend final : public shs::IRenderBackend
+    {
+    public:
+        shs::RenderBackendType type() const override { return shs::RenderBackendType::Software; }
+        void on_resize(shs::Context& ctx, int w, int h) override
+        {
+            (void)ctx;
+            ++resizes;
+            last_w = w;
+            last_h = h;
+        }
+        void begin_frame(shs::Context& ctx, const shs::RenderBackendFrameInfo& frame) override { (void)ctx; (void)frame; }
+        void end_frame(shs::Context& ctx, const shs::RenderBackendFrameInfo& frame) override { (void)ctx; (void)frame; }
+
+        int resizes = 0;
+        int last_w = 0;
+        int last_h = 0;
+    };
+
+    // HDR target-ийг тогтмол өнгөөр дүүргэдэг software pass.
+    class HdrFillPass final : public shs::IRenderPass
+    {
+    public:
+        static constexpr shs::ColorF k_fill{0.5f, 1.25f, 2.0f, 1.0f};
+
+        explicit HdrFillPass(shs::RTHandle hdr) : hdr_(hdr) {}
+
+        const char* id() const override { return "test.hdr_fill"; }
+
+        shs::TechniquePassContract describe_contract() const override
+        {
+            shs::TechniquePassContract c{};
+            c.role = shs::TechniquePassRole::Composite;
+            c.supported_modes_mask = shs::technique_mode_mask_all();
+            c.semantics = {shs::write_semantic(shs::PassSemantic::ColorHDR, shs::ContractDomain::Software, "hdr")};
+            return c;
+        }
+
+        shs::PassIODesc describe_io() const override
+        {
+            shs::PassIODesc io{};
+            io.write(shs::make_rt_resource_ref(hdr_, shs::PassResourceType::ColorHDR, "hdr", shs::PassResourceDomain::Software));
+            return io;
+        }
+
+        void on_resize(shs::Context& ctx, shs::RTRegistry& rtr, int w, int h) override
+        {
+            (void)ctx;
+            (void)rtr;
+            ++resizes;
+            last_w = w;
+            last_h = h;
+        }
+
+        shs::PassExecutionResult execute_resolved(shs::Context& ctx, const shs::PassExecutionRequest& request) override
+        {
+            (void)ctx;
+            auto* hdr = static_cast<shs::RT_ColorHDR*>(request.inputs.registry->get(hdr_));
+            if (!hdr) return shs::PassExecutionResult::not_executed();
+            fill_w = hdr->w;
+            fill_h = hdr->h;
+            for (int y = 0; y < hdr->h; ++y)
+            {
+                for (int x = 0; x < hdr->w; ++x) hdr->store(x, y, k_fill);
+            }
+            return shs::PassExecutionResult::executed_no_outputs();
+        }
+
+        int resizes = 0;
+        int last_w = 0;
+        int last_h = 0;
+        int fill_w = 0;
+        int fill_h = 0;
+
+    private:
+        shs::RTHandle hdr_{};
+    };
+
+    // fp.raster.hdr_format: pipeline-ийн pass-уудын бичдэг HDR target хадгалалтаа солино.
+    bool test_pipeline_hdr_format(shs::IJobSystem& js)
+    {
+        shs::RT_ColorHDR hdr{24, 12};
+        shs::RTRegistry rtr{};
+        const shs::RTHandle h_hdr = rtr.reg<shs::RTHandle>(&hdr);
+
+        CountingSoftwareBackend backend{};
+        shs::Context ctx{};
+        ctx.job_system = &js;
+        ctx.register_backend(&backend);
+        shs::PluggablePipeline pipeline{};
+        pipeline.add_pass<HdrFillPass>(h_hdr);
+
+        shs::Scene scene{};
+        shs::FrameParams fp{};
+        fp.w = hdr.w;
+        fp.h = hdr.h;
+        const shs::HdrFormat formats[3] = {shs::HdrFormat::RGBA16F, shs::HdrFormat::R11G11B10F, shs::HdrFormat::RGBA32F};
+        for (const shs::HdrFormat f : formats)
+        {
+            fp.raster.hdr_format = f;
+            pipeline.execute(ctx, scene, fp, rtr);
+            if (hdr.format != f || hdr.w != 24 || hdr.h != 12) return false;
+            // 0.5/1.25/2.0 нь гурван формат бүрт яг илэрхийлэгдэнэ.
+            const shs::ColorF c = hdr.load(23, 11);
+            if (c.r != HdrFillPass::k_fill.r || c.g != HdrFillPass::k_fill.g || c.b != HdrFillPass::k_fill.b) return false;
+        }
+        return true;
+    }
+
+    // Dynamic resolution-ий шат backend/pass-уудыг resize хийхгүй: зөвхөн гаралтын хэмжээ өөрчлөгдөхөд.
+    bool test_dynamic_resolution_does_not_resize_backend(shs::IJobSystem& js)
+    {
+        shs::RT_ColorHDR hdr{64, 32};
+        shs::RT_ColorLDR present{64, 32};
+        shs::RTRegistry rtr{};
+        const shs::RTHandle h_hdr = rtr.reg<shs::RTHandle>(&hdr);
+        const shs::RTHandle h_present = rtr.reg<shs::RTHandle>(&present);
+
+        CountingSoftwareBackend backend{};
+        shs::Context ctx{};
+        ctx.job_system = &js;
+        ctx.register_backend(&backend);
+        shs::PluggablePipeline pipeline{};
+        HdrFillPass& pass = pipeline.add_pass<HdrFillPass>(h_hdr);
+        shs::FrameBudgetGovernor& gov = pipeline.frame_budget();
+        gov.set_dynamic_resolution_targets(h_present, {h_hdr});
+
+        shs::Scene scene{};
+        shs::FrameParams fp{};
+        fp.w = 64;
+        fp.h = 32;
+        fp.budget.enable = true;
+        fp.budget.target_ms = 1000.0f;
+        fp.budget.settle_frames_down = 1;
+        fp.budget.settle_frames_up = 1000000;
+        fp.budget.quality_scaling = false;
+        fp.budget.resolution_step = 0.25f;
+        fp.budget.min_resolution_scale = 0.5f;
+        shs::FrameParams fp_up = fp;
+        fp_up.budget.settle_frames_up = 1;
+
+        auto frame = [&](int expect_w, int expect_h) {
+            pipeline.execute(ctx, scene, fp, rtr);
+            return pass.fill_w == expect_w && pass.fill_h == expect_h &&
+                backend.resizes == 1 && backend.last_w == 64 && backend.last_h == 32 &&
+                pass.resizes == 1 && pass.last_w == 64 && pass.last_h == 32;
+        };
+
+        if (!frame(64, 32)) return false;
+        // Хоёр шат буулгаад (48x24, 32x16) буцааж өргөнө.
+        if (!gov.update(fp, 1.0e6f, ctx.debug) || !frame(48, 24)) return false;
+        if (!gov.update(fp, 1.0e6f, ctx.debug) || !frame(32, 16)) return false;
+        if (!gov.update(fp_up, 0.0f, ctx.debug) || !frame(48, 24)) return false;
+        if (!gov.update(fp_up, 0.0f, ctx.debug) || !frame(64, 32)) return false;
+        if (gov.level(shs::BudgetKnob::Resolution) != 0) return false;
+
+        // Гаралтын хэмжээ өөрчлөгдвөл нэг удаа resize.
+        fp.w = 80;
+        fp.h = 40;
+        pipeline.execute(ctx, scene, fp, rtr);
+        return backend.resizes == 2 && backend.last_w == 80 && backend.last_h == 40 && pass.resizes == 2;
+    }
+}
+
+int main()
+{
+    shs::WorkStealingJobSystem js{4};
+
+    const bool ok_watertight = test_edge_raster_is_watertight();
+    const bool ok_tiled = test_tiled_matches_immediate(js);
+    const bool ok_tiled_depth = test_tiled_depth_only_matches_immediate(js);
+    const bool ok_simd = test_simd_fragments_match_scalar(js);
+    const bool ok_vcache = test_vertex_cache_shades_each_vertex_once(js);
+    const bool ok_hiz = test_hiz_rejects_hidden_triangles(js);
+    const bool ok_visibility = test_visibility_buffer_matches_forward(js);
+    const bool ok_static = test_static_program_matches_adapter(js);
+    const bool ok_permutations = test_shader_permutations_match_generic(js);
+    const bool ok_guard_band = test_guard_band_clipping();
+    const bool ok_motion = test_motion_vectors_match_reprojection(js);
+    const bool ok_mips = test_texture_mips_trilinear(js);
+    const bool ok_layout = test_tiled_layout_matches_linear(js);
+    const bool ok_bc = test_texture_block_compression();
+    const bool ok_fast_clear = test_fast_clear_matches_clear(js);
+    const bool ok_hdr_formats = test_hdr_formats(js);
+    const bool ok_transient_alias = test_transient_aliasing();
+    const bool ok_post_stack = test_post_stack_matches_passes(js);
+    const bool ok_shafts_coroutine = test_light_shafts_coroutine_matches_reference(js);
+    const bool ok_simd_lanes = test_simd_lane_primitives();
+    const bool ok_tonemap_lanes = test_tonemap_lanes_match_reference(js);
+    const bool ok_frame_budget = test_frame_budget_governor(js);
+    const bool ok_pipeline_hdr = test_pipeline_hdr_format(js);
+    const bool ok_dynres_resize = test_dynamic_resolution_does_not_resize_backend(js);
+
+    if (!ok_watertight) std::fprintf(stderr, "[raster-tests] edge rasterizer is not watertight\n");
+    if (!ok_tiled) std::fprintf(stderr, "[raster-tests] tiled rasterizer differs from rasterize_mesh\n");
+    if (!ok_tiled_depth) std::fprintf(stderr, "[raster-tests] tiled depth-only rasterizer differs from rasterize_mesh_depth\n");
+    if (!ok_vcache) std::fprintf(stderr, "[raster-tests] vertex cache output or vs invocation count is wrong\n");
+    if (!ok_hiz) std::fprintf(stderr, "[raster-tests] hierarchical-z changed the image or rejected nothing\n");
+    if (!ok_simd) std::fprintf(stderr, "[raster-tests] simd fragment path differs from scalar fs\n");
+    if (!ok_static) std::fprintf(stderr, "[raster-tests] static shader program differs from its ShaderProgram adapter\n");
+    if (!ok_permutations) std::fprintf(stderr, "[raster-tests] shader permutation differs from the generic program\n");
+    if (!ok_guard_band) std::fprintf(stderr, "[raster-tests] guard-band clipping produced wrong coverage/depth\n");
+    if (!ok_motion) std::fprintf(stderr, "[raster-tests] motion vectors differ from per-pixel reprojection\n");
+    if (!ok_mips) std::fprintf(stderr, "[raster-tests] texture mips/trilinear sampling/uv derivatives are wrong\n");
+    if (!ok_layout) std::fprintf(stderr, "[raster-tests] tiled pixel layout differs from linear\n");
+    if (!ok_bc) std::fprintf(stderr, "[raster-tests] block-compressed texture storage/decode/sampling is wrong\n");
+    if (!ok_fast_clear) std::fprintf(stderr, "[raster-tests] fast clear differs from a full clear\n");
+    if (!ok_hdr_formats) std::fprintf(stderr, "[raster-tests] half/r11g11b10 hdr encoding or rendering is wrong\n");
+    if (!ok_transient_alias) std::fprintf(stderr, "[raster-tests] transient render-target aliasing is wrong\n");
+    if (!ok_post_stack) std::fprintf(stderr, "[raster-tests] fused post stack differs from the separate post passes\n");
+    if (!ok_shafts_coroutine) std::fprintf(stderr, "[raster-tests] coroutine light shafts pass differs from the scalar reference\n");
+    if (!ok_simd_lanes) std::fprintf(stderr, "[raster-tests] simd lane primitives differ from scalar\n");
+    if (!ok_tonemap_lanes) std::fprintf(stderr, "[raster-tests] lane tonemap or gamma lut differs from the scalar reference\n");
+    if (!ok_frame_budget) std::fprintf(stderr, "[raster-tests] frame budget governor stepped or rebound targets incorrectly\n");
+    if (!ok_pipeline_hdr) std::fprintf(stderr, "[raster-tests] pipeline hdr_format was not applied to its hdr targets\n");
+    if (!ok_dynres_resize) std::fprintf(stderr, "[raster-tests] dynamic resolution step resized the backend or passes\n");
+    if (!ok_visibility) std::fprintf(stderr, "[raster-tests] visibility buffer differs from forward or shades a pixel twice\n");
+
+    const bool ok = ok_watertight && ok_tiled && ok_tiled_depth && ok_simd && ok_vcache && ok_hiz && ok_visibility && ok_static && ok_permutations && ok_guard_band && ok_motion && ok_mips && ok_layout && ok_bc && ok_fast_clear && ok_hdr_formats && ok_transient_alias && ok_post_stack && ok_shafts_coroutine && ok_simd_lanes && ok_tonemap_lanes && ok_frame_budget && ok_pipeline_hdr && ok_dynres_resize;
+    if (!ok) return 1;
+    std::fprintf(stderr, "[raster-tests] all tests passed\n");
+    return 0;
+}